@@ -0,0 +1,7 @@
+// espelho de BlocoCamera (BlocosUniform.h), atualizado uma vez por quadro
+layout (std140) uniform BlocoCamera {
+    mat4 projecao;
+    mat4 visao;
+    vec4 posicaoObservador;   // w sem uso
+    mat4 projecaoVisao;       // projecao * visao, feita na CPU
+};
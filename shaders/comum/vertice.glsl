@@ -0,0 +1,32 @@
+// Atributos de vértice comuns e a leitura deles em espaço local.
+//
+// Com VERTICE_COMPACTO (FormatoVertice::compacto() e outros formatos
+// empacotados) as constantes de dequantização chegam como atributos
+// genéricos, definidos por Mesh::desenhar:
+//   posicao = quantOrigem.xyz + quantEscala * atributo
+//   quantOrigem.w = 1 se a normal é octaédrica
+// Sem ele os atributos já são floats em espaço local e nada é convertido.
+
+layout (location = 0) in vec3 posicaoAtributo;
+layout (location = 1) in vec3 normalAtributo;
+layout (location = 2) in vec2 coordTexturaAtributo;
+
+#if VERTICE_COMPACTO
+layout (location = 3) in vec4 quantOrigem;
+layout (location = 4) in vec3 quantEscala;
+
+vec3 decodificarOctaedrica(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        vec2 sinal = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        n.xy = (1.0 - abs(n.yx)) * sinal;
+    }
+    return normalize(n);
+}
+
+vec3 posicaoLocal() { return quantOrigem.xyz + quantEscala * posicaoAtributo; }
+vec3 normalLocal()  { return quantOrigem.w > 0.5 ? decodificarOctaedrica(normalAtributo.xy) : normalAtributo; }
+#else
+vec3 posicaoLocal() { return posicaoAtributo; }
+vec3 normalLocal()  { return normalAtributo; }
+#endif
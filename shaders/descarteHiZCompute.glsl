@@ -0,0 +1,125 @@
+#version 430 core
+
+// Descarte por instância: frustum, oclusão contra a pirâmide Hi-Z do quadro
+// anterior e escolha do nível de LOD. Cada instância visível é acrescentada
+// ao comando do seu nível (atomicAdd em numInstancias) e o índice dela vai
+// para a faixa desse comando em visiveis[], que o vertex shader lê como
+// atributo por instância.
+
+layout (local_size_x = 64) in;
+
+struct Comando {   // DrawElementsIndirectCommand
+    uint numIndices;
+    uint numInstancias;
+    uint primeiroIndice;
+    int verticeBase;
+    uint instanciaBase;
+};
+
+layout (std430, binding = 0) readonly buffer Modelos { mat4 modelosObjetos[]; };
+layout (std430, binding = 2) buffer Comandos { Comando comandos[]; };
+layout (std430, binding = 3) writeonly buffer Visiveis { uint visiveis[]; };
+
+layout (binding = 0, offset = 0) uniform atomic_uint contadorVisiveis;
+layout (binding = 0, offset = 4) uniform atomic_uint contadorForaFrustum;
+layout (binding = 0, offset = 8) uniform atomic_uint contadorOcultos;
+
+layout (binding = 0) uniform sampler2D hiZ;
+
+const int MAXIMO_NIVEIS_LOD = 8;
+
+uniform int numObjetos;
+uniform vec4 planos[6];
+uniform vec3 minimoLocal;
+uniform vec3 maximoLocal;
+
+uniform bool usarHiZ;
+uniform mat4 projecaoVisaoAnterior;   // a do quadro em que a profundidade foi copiada
+uniform ivec2 tamanhoProfundidade;    // a pirâmide começa na metade disso
+uniform int niveisHiZ;
+
+uniform vec3 posicaoCamera;
+uniform float pixelsPorUnidade;       // altura da viewport / tan(fov / 2)
+uniform vec3 centroLocal;
+uniform float raioLocal;
+uniform int numNiveisLOD;
+uniform float pixelsMinimos[MAXIMO_NIVEIS_LOD];
+
+bool oculto(vec3 minimo, vec3 maximo) {
+    vec2 minimoTela = vec2(1.0), maximoTela = vec2(0.0);
+    float maisPerto = 1.0;
+    for (int i = 0; i < 8; i++) {
+        vec3 canto = vec3((i & 1) != 0 ? maximo.x : minimo.x,
+                          (i & 2) != 0 ? maximo.y : minimo.y,
+                          (i & 4) != 0 ? maximo.z : minimo.z);
+        vec4 clip = projecaoVisaoAnterior * vec4(canto, 1.0);
+        if (clip.w < 1e-4) return false;   // cruza o plano perto
+        vec3 ndc = clip.xyz / clip.w;
+        minimoTela = min(minimoTela, ndc.xy * 0.5 + 0.5);
+        maximoTela = max(maximoTela, ndc.xy * 0.5 + 0.5);
+        maisPerto = min(maisPerto, ndc.z * 0.5 + 0.5);
+    }
+    if (any(lessThan(maximoTela, vec2(0.0))) || any(greaterThan(minimoTela, vec2(1.0)))) return false;
+
+    // texels da profundidade original cobertos pela caixa; no nível n da
+    // pirâmide o texel t vira min(t >> (n + 1), tamanho - 1)
+    ivec2 a = clamp(ivec2(clamp(minimoTela, 0.0, 1.0) * vec2(tamanhoProfundidade)), ivec2(0), tamanhoProfundidade - 1);
+    ivec2 b = clamp(ivec2(clamp(maximoTela, 0.0, 1.0) * vec2(tamanhoProfundidade)), ivec2(0), tamanhoProfundidade - 1);
+    float maior = float(max(b.x - a.x, b.y - a.y) + 1);
+    int nivel = clamp(int(ceil(log2(maior))) - 1, 0, niveisHiZ - 1);
+
+    // sobe até a caixa caber em 2x2 texels (o topo da pirâmide tem 1x1).
+    // O tamanho do nível sai da conta, não de textureSize(): o nível varia
+    // entre invocações, e há drivers (llvmpipe) que usam o de uma só.
+    ivec2 ta, tb;
+    while (true) {
+        ivec2 tamanho = max(tamanhoProfundidade >> (nivel + 1), ivec2(1));
+        ta = min(a >> (nivel + 1), tamanho - 1);
+        tb = min(b >> (nivel + 1), tamanho - 1);
+        if ((tb.x - ta.x <= 1 && tb.y - ta.y <= 1) || nivel == niveisHiZ - 1) break;
+        nivel++;
+    }
+
+    float maisDistante = 0.0;
+    for (int y = ta.y; y <= tb.y; y++)
+        for (int x = ta.x; x <= tb.x; x++)
+            maisDistante = max(maisDistante, texelFetch(hiZ, ivec2(x, y), nivel).r);
+    return maisPerto > maisDistante;
+}
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= uint(numObjetos)) return;
+
+    // AABB em espaço de mundo (Arvo)
+    mat4 modelo = modelosObjetos[i];
+    vec3 centro = vec3(modelo * vec4((minimoLocal + maximoLocal) * 0.5, 1.0));
+    vec3 meiaExtensao = (maximoLocal - minimoLocal) * 0.5;
+    vec3 extensao = abs(modelo[0].xyz) * meiaExtensao.x + abs(modelo[1].xyz) * meiaExtensao.y +
+                    abs(modelo[2].xyz) * meiaExtensao.z;
+
+    for (int p = 0; p < 6; p++) {
+        if (dot(planos[p].xyz, centro) + planos[p].w + dot(abs(planos[p].xyz), extensao) < 0.0) {
+            atomicCounterIncrement(contadorForaFrustum);
+            return;
+        }
+    }
+
+    if (usarHiZ && oculto(centro - extensao, centro + extensao)) {
+        atomicCounterIncrement(contadorOcultos);
+        return;
+    }
+
+    // mesmo critério do GrupoLOD, sem a histerese (não há estado por objeto)
+    float escala = max(length(modelo[0].xyz), max(length(modelo[1].xyz), length(modelo[2].xyz)));
+    float raio = raioLocal * escala;
+    float distancia = length(vec3(modelo * vec4(centroLocal, 1.0)) - posicaoCamera);
+    float pixels = distancia <= raio ? 1e30 : raio / distancia * pixelsPorUnidade;
+    int nivel = numNiveisLOD - 1;
+    for (int n = numNiveisLOD - 2; n >= 0; n--)
+        if (pixels >= pixelsMinimos[n]) nivel = n;
+
+    uint posicao = atomicAdd(comandos[nivel].numInstancias, 1u);
+    visiveis[comandos[nivel].instanciaBase + posicao] = i;
+    atomicCounterIncrement(contadorVisiveis);
+}
@@ -2,8 +2,20 @@
 
 out vec4 corFinal;
 
+flat in int indiceMaterial;
+
+#define MAX_MATERIAIS 16
+
+#if INSTANCIADO
+uniform vec4 cores[MAX_MATERIAIS];   // por índice de material
+#else
 uniform vec4 cor;
+#endif
 
 void main() {
+#if INSTANCIADO
+    corFinal = cores[indiceMaterial];
+#else
     corFinal = cor;
+#endif
 }
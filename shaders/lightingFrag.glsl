@@ -1,10 +1,16 @@
 #version 330 core
 
+// Permutações (PermutacoesShader.h): ILUMINACAO desligada deixa só a
+// ambiente a 30%, sem nenhuma conta de luz; NUM_LUZES_PONTUAIS é o limite
+// do laço, constante para o compilador desenrolar; INSTANCIADO tira do
+// material a escolha entre uniform e tabela.
+
 out vec4 corFinal;
 
 in vec3 posicaoFragmento;
 in vec3 normalFragmento;
 in vec2 coordTextura;
+flat in int indiceMaterial;
 
 struct LuzDirecional {
     vec3 direcao;
@@ -31,12 +37,26 @@ struct Material {
 };
 
 #define MAX_LUZES_PONTUAIS 4
+#define MAX_MATERIAIS 16
+
+#include "comum/blocoCamera.glsl"
+
+// BlocoLuzes e BlocoMateriais seguem o std140: cada vec3 ocupa 16 bytes,
+// salvo quando um float vem logo depois (LuzPontual.constante, Material.brilho)
+layout (std140) uniform BlocoLuzes {
+    LuzDirecional luzDirecional;
+    LuzPontual luzesPontuais[MAX_LUZES_PONTUAIS];
+    int numLuzesPontuais;   // o laço usa NUM_LUZES_PONTUAIS
+};
 
-uniform vec3 posicaoObservador;
-uniform Material material;
-uniform LuzDirecional luzDirecional;
-uniform LuzPontual luzesPontuais[MAX_LUZES_PONTUAIS];
-uniform int numLuzesPontuais;
+layout (std140) uniform BlocoMateriais {
+    Material materiais[MAX_MATERIAIS];   // por índice de material, no desenho instanciado
+};
+
+uniform Material material;   // desenho por objeto, trocado pela fila
+
+// material deste fragmento: o uniform ou o da instância
+Material materialAtual;
 
 vec3 calcularLuzDirecional(LuzDirecional luz, vec3 normal, vec3 direcaoVisao) {
     vec3 direcaoLuz = normalize(-luz.direcao);
@@ -45,11 +65,11 @@ vec3 calcularLuzDirecional(LuzDirecional luz, vec3 normal, vec3 direcaoVisao) {
 
     // Blinn-Phong
     vec3 direcaoMeio = normalize(direcaoLuz + direcaoVisao);
-    float especular = pow(max(dot(normal, direcaoMeio), 0.0), material.brilho);
+    float especular = pow(max(dot(normal, direcaoMeio), 0.0), materialAtual.brilho);
 
-    vec3 ambiente       = luz.ambiente  * material.ambiente;
-    vec3 difusa         = luz.difusa    * diferencaDifusa * material.difusa;
-    vec3 especularFinal = luz.especular * especular       * material.especular;
+    vec3 ambiente       = luz.ambiente  * materialAtual.ambiente;
+    vec3 difusa         = luz.difusa    * diferencaDifusa * materialAtual.difusa;
+    vec3 especularFinal = luz.especular * especular       * materialAtual.especular;
 
     return (ambiente + difusa + especularFinal);
 }
@@ -61,16 +81,16 @@ vec3 calcularLuzPontual(LuzPontual luz, vec3 normal, vec3 posicaoFrag, vec3 dire
 
     // Blinn-Phong
     vec3 direcaoMeio = normalize(direcaoLuz + direcaoVisao);
-    float especular = pow(max(dot(normal, direcaoMeio), 0.0), material.brilho);
+    float especular = pow(max(dot(normal, direcaoMeio), 0.0), materialAtual.brilho);
 
     // atenuacao
     float distancia  = length(luz.posicao - posicaoFrag);
     float atenuacao  = 1.0 / (luz.constante + luz.linear * distancia +
                               luz.quadratica * (distancia * distancia));
 
-    vec3 ambiente       = luz.ambiente  * material.ambiente;
-    vec3 difusa         = luz.difusa    * diferencaDifusa * material.difusa;
-    vec3 especularFinal = luz.especular * especular       * material.especular;
+    vec3 ambiente       = luz.ambiente  * materialAtual.ambiente;
+    vec3 difusa         = luz.difusa    * diferencaDifusa * materialAtual.difusa;
+    vec3 especularFinal = luz.especular * especular       * materialAtual.especular;
 
     ambiente       *= atenuacao;
     difusa         *= atenuacao;
@@ -80,14 +100,24 @@ vec3 calcularLuzPontual(LuzPontual luz, vec3 normal, vec3 posicaoFrag, vec3 dire
 }
 
 void main() {
+#if INSTANCIADO
+    materialAtual = materiais[indiceMaterial];
+#else
+    materialAtual = indiceMaterial < 0 ? material : materiais[indiceMaterial];
+#endif
+
+#if ILUMINACAO
     vec3 normal       = normalize(normalFragmento);
-    vec3 direcaoVisao = normalize(posicaoObservador - posicaoFragmento);
+    vec3 direcaoVisao = normalize(posicaoObservador.xyz - posicaoFragmento);
 
     vec3 resultado = calcularLuzDirecional(luzDirecional, normal, direcaoVisao);
 
-    for (int i = 0; i < numLuzesPontuais; i++) {
+    for (int i = 0; i < NUM_LUZES_PONTUAIS; i++) {
         resultado += calcularLuzPontual(luzesPontuais[i], normal, posicaoFragmento, direcaoVisao);
     }
+#else
+    vec3 resultado = 0.3 * materialAtual.ambiente;
+#endif
 
     corFinal = vec4(resultado, 1.0);
 }
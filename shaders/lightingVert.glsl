@@ -1,24 +1,49 @@
 #version 330 core
 
-layout (location = 0) in vec3 posicaoAtributo;
-layout (location = 1) in vec3 normalAtributo;
-layout (location = 2) in vec2 coordTexturaAtributo;
+// Permutações (PermutacoesShader.h): VERTICE_COMPACTO escolhe a leitura dos
+// atributos e INSTANCIADO a origem da matriz modelo, da matriz normal e do
+// material: o registro do AnelObjetos (desenho por objeto, pela fila) ou
+// atributos por instância (BufferInstancias).
+
+#include "comum/vertice.glsl"
+#include "comum/blocoCamera.glsl"
 
 out vec3 posicaoFragmento;
 out vec3 normalFragmento;
 out vec2 coordTextura;
+flat out int indiceMaterial;   // -1: material do uniform (ver lightingFrag.glsl)
 
-uniform mat4 modelo;
-uniform mat4 visao;
-uniform mat4 projecao;
+#if INSTANCIADO
+// divisor 1: um valor por instância; a mat4 ocupa as locations 5 a 8
+layout (location = 5) in mat4 modeloInstancia;
+layout (location = 9) in uint materialInstancia;
+// transpose(inverse(mat3(modelo))), calculada na CPU; locations 10 a 12
+layout (location = 10) in mat3 normalInstancia;
+#else
+// registros do AnelObjetos, 8 texels cada: modelo (0..3), matriz normal
+// (4..6) e índice de material (7.x); indiceObjeto é a posição do desenho
+uniform samplerBuffer objetos;
+uniform int indiceObjeto;
+#endif
 
 void main() {
-    posicaoFragmento = vec3(modelo * vec4(posicaoAtributo, 1.0));
-
-    // transpose(inverse()) necessario para preservar normais com escala nao-uniforme
-    normalFragmento = mat3(transpose(inverse(modelo))) * normalAtributo;
+#if INSTANCIADO
+    mat4 modelo = modeloInstancia;
+    mat3 matrizNormal = normalInstancia;
+    indiceMaterial = int(materialInstancia);
+#else
+    int base = indiceObjeto * 8;
+    mat4 modelo = mat4(texelFetch(objetos, base), texelFetch(objetos, base + 1),
+                       texelFetch(objetos, base + 2), texelFetch(objetos, base + 3));
+    // transpose(inverse(mat3(modelo))), calculada na CPU uma vez por desenho
+    mat3 matrizNormal = mat3(texelFetch(objetos, base + 4).xyz, texelFetch(objetos, base + 5).xyz,
+                             texelFetch(objetos, base + 6).xyz);
+    indiceMaterial = int(texelFetch(objetos, base + 7).x);
+#endif
 
-    coordTextura = coordTexturaAtributo;
+    posicaoFragmento = vec3(modelo * vec4(posicaoLocal(), 1.0));
+    normalFragmento  = matrizNormal * normalLocal();
+    coordTextura     = coordTexturaAtributo;
 
-    gl_Position = projecao * visao * vec4(posicaoFragmento, 1.0);
+    gl_Position = projecaoVisao * vec4(posicaoFragmento, 1.0);
 }
@@ -0,0 +1,33 @@
+#version 430 core
+
+// lightingVert.glsl instanciado, para o descarte na GPU: o atributo por
+// instância é só o índice do objeto, escrito pelo descarteHiZCompute.glsl, e
+// a matriz, a matriz normal e o material são lidos dos buffers de entrada do
+// descarte. Vai com lightingFrag.glsl e INSTANCIADO ligado.
+
+#include "comum/vertice.glsl"
+#include "comum/blocoCamera.glsl"
+
+// divisor 1, a partir da instância base de cada comando
+layout (location = 5) in uint indiceObjeto;
+
+layout (std430, binding = 0) readonly buffer Modelos { mat4 modelosObjetos[]; };
+layout (std430, binding = 1) readonly buffer Materiais { uint materiaisObjetos[]; };
+// no std430 cada coluna de uma mat3 ocupa 16 bytes, como os três vec4 da CPU
+layout (std430, binding = 4) readonly buffer Normais { mat3 normaisObjetos[]; };
+
+out vec3 posicaoFragmento;
+out vec3 normalFragmento;
+out vec2 coordTextura;
+flat out int indiceMaterial;
+
+void main() {
+    mat4 modelo = modelosObjetos[indiceObjeto];
+
+    posicaoFragmento = vec3(modelo * vec4(posicaoLocal(), 1.0));
+    normalFragmento  = normaisObjetos[indiceObjeto] * normalLocal();
+    coordTextura     = coordTexturaAtributo;
+    indiceMaterial   = int(materiaisObjetos[indiceObjeto]);
+
+    gl_Position = projecaoVisao * vec4(posicaoFragmento, 1.0);
+}
@@ -0,0 +1,32 @@
+#version 430 core
+
+// Um nível da pirâmide Hi-Z: cada texel guarda a profundidade mais distante
+// do bloco 2x2 correspondente no nível de origem. A última linha e a última
+// coluna também cobrem o texel que sobra quando a origem tem tamanho ímpar,
+// então o texel (x, y) de um nível sempre contém o texel (x, y) * 2 da origem.
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (binding = 0) uniform sampler2D origem;   // profundidade copiada ou a própria pirâmide
+layout (r32f, binding = 0) uniform writeonly image2D destino;
+
+uniform int nivelOrigem;
+
+void main() {
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 tamanhoDestino = imageSize(destino);
+    if (any(greaterThanEqual(texel, tamanhoDestino))) return;
+
+    ivec2 tamanhoOrigem = textureSize(origem, nivelOrigem);
+    ivec2 inicio = texel * 2;
+    ivec2 fim = min(inicio + 1, tamanhoOrigem - 1);
+    if (texel.x == tamanhoDestino.x - 1) fim.x = tamanhoOrigem.x - 1;
+    if (texel.y == tamanhoDestino.y - 1) fim.y = tamanhoOrigem.y - 1;
+
+    float maisDistante = 0.0;
+    for (int y = inicio.y; y <= fim.y; y++)
+        for (int x = inicio.x; x <= fim.x; x++)
+            maisDistante = max(maisDistante, texelFetch(origem, ivec2(x, y), nivelOrigem).r);
+
+    imageStore(destino, texel, vec4(maisDistante));
+}
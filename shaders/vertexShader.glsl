@@ -1,12 +1,31 @@
 #version 330 core
 
-layout (location = 0) in vec3 posicaoAtributo;
+// Cor sólida (cubos das luzes). Com INSTANCIADO a matriz modelo e o índice
+// da cor vêm de atributos por instância, como em lightingVert.glsl; sem ele,
+// do registro do AnelObjetos, do qual só a matriz modelo é lida.
 
-uniform mat4 modelo;
-uniform mat4 visao;
-uniform mat4 projecao;
+#include "comum/vertice.glsl"
+#include "comum/blocoCamera.glsl"
+
+flat out int indiceMaterial;   // -1: cor do uniform
+
+#if INSTANCIADO
+layout (location = 5) in mat4 modeloInstancia;
+layout (location = 9) in uint materialInstancia;
+#else
+uniform samplerBuffer objetos;
+uniform int indiceObjeto;
+#endif
 
 void main() {
-    gl_Position = projecao * visao * modelo * vec4(posicaoAtributo, 1.0);
+#if INSTANCIADO
+    mat4 modelo = modeloInstancia;
+    indiceMaterial = int(materialInstancia);
+#else
+    int base = indiceObjeto * 8;
+    mat4 modelo = mat4(texelFetch(objetos, base), texelFetch(objetos, base + 1),
+                       texelFetch(objetos, base + 2), texelFetch(objetos, base + 3));
+    indiceMaterial = -1;
+#endif
+    gl_Position = projecaoVisao * (modelo * vec4(posicaoLocal(), 1.0));
 }
-
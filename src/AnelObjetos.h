@@ -0,0 +1,201 @@
+#ifndef ANEL_OBJETOS_H
+#define ANEL_OBJETOS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+#include "RecursosGL.h"
+#include "ExtensoesGL.h"
+
+// Dados de um desenho, lidos pelo vertex shader de um samplerBuffer RGBA32F,
+// 8 texels por registro: modelo nos texels 0..3 (colunas), matriz normal em
+// 4..6 (w sem uso) e o índice de material em 7.x (-1: uniform `material`).
+struct RegistroObjeto {
+    glm::mat4 modelo;
+    glm::vec4 normal[3];
+    float material;
+    float preenchimento[3];
+
+    // escreve campo a campo, em ordem: o destino costuma ser memória mapeada.
+    // matrizNormal são as três colunas de transformacoes::calcularNormais.
+    void definir(const glm::mat4& m, const glm::vec4* matrizNormal, GLint indiceMaterial) {
+        modelo = m;
+        normal[0] = matrizNormal[0];
+        normal[1] = matrizNormal[1];
+        normal[2] = matrizNormal[2];
+        material = (float)indiceMaterial;
+        preenchimento[0] = preenchimento[1] = preenchimento[2] = 0.0f;
+    }
+};
+
+static_assert(sizeof(RegistroObjeto) == 8 * sizeof(glm::vec4), "RegistroObjeto precisa ocupar 8 texels");
+
+const GLuint UNIDADE_TEXTURA_OBJETOS = 1;   // uniform samplerBuffer objetos
+
+struct EstatisticasAnel {
+    bool persistente = false;
+    size_t regioesUsadas = 0;      // mapear() desde o começo
+    size_t esperas = 0;            // regiões que a GPU ainda lia quando a CPU voltou a elas
+    size_t orfaos = 0;             // buffers substituídos no lugar de esperar (caminho 3.3)
+    double segundosEspera = 0.0;   // no último mapear(): teste da cerca e, se preciso, espera
+};
+
+// Anel de registros por desenho em três regiões: enquanto a GPU lê uma, a
+// CPU escreve a seguinte. Cada região ganha uma cerca (glFenceSync) depois
+// dos desenhos que a leem, e só é reescrita quando a cerca sinaliza.
+//
+// Com glBufferStorage (4.4 / ARB_buffer_storage) o buffer fica mapeado o
+// tempo todo (persistente e coerente) e uma cerca pendente é esperada. No
+// 3.3 cada região é mapeada sem sincronização (GL_MAP_UNSYNCHRONIZED_BIT),
+// o que só é seguro porque a cerca já sinalizou; se não sinalizou, o buffer
+// inteiro é trocado (orphaning) e as cercas antigas deixam de valer.
+class AnelObjetos {
+public:
+    static const int REGIOES = 3;
+
+    EstatisticasAnel estatisticas;
+
+    AnelObjetos() = default;
+    AnelObjetos(const AnelObjetos&) = delete;
+    AnelObjetos& operator=(const AnelObjetos&) = delete;
+    ~AnelObjetos() { liberarCercas(); }
+
+    // maior n aceito por mapear(): o samplerBuffer tem um limite de texels
+    size_t maximoPorRegiao() {
+        if (limiteTexels == 0) {
+            glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &limiteTexels);
+            limiteTexels = std::max(limiteTexels, (GLint)(8 * REGIOES));
+        }
+        return (size_t)limiteTexels / 8 / REGIOES;
+    }
+
+    // Próxima região, com lugar para n registros (até maximoPorRegiao()).
+    RegistroObjeto* mapear(size_t n) {
+        n = std::min(std::max<size_t>(n, 1), maximoPorRegiao());
+        if (!buffer || n > capacidade)
+            alocar(std::min(std::max({n, capacidade * 2, (size_t)256}), maximoPorRegiao()));
+
+        regiao = (regiao + 1) % REGIOES;
+        estatisticas.regioesUsadas++;
+        size_t deslocamento = regiao * capacidade * sizeof(RegistroObjeto);
+
+        auto inicio = std::chrono::steady_clock::now();
+        RegistroObjeto* registros = nullptr;
+        if (persistente) {
+            if (cercas[regiao]) {
+                if (!sinalizada(cercas[regiao])) {
+                    estatisticas.esperas++;
+                    while (glClientWaitSync(cercas[regiao], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) ==
+                           GL_TIMEOUT_EXPIRED) {
+                    }
+                }
+                glDeleteSync(cercas[regiao]);
+                cercas[regiao] = nullptr;
+            }
+            registros = (RegistroObjeto*)((char*)mapeado + deslocamento);
+        } else {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            if (cercas[regiao] && !sinalizada(cercas[regiao])) {
+                estatisticas.esperas++;
+                estatisticas.orfaos++;
+                glBufferData(GL_COPY_WRITE_BUFFER, bytesTotal(), nullptr, GL_STREAM_DRAW);
+                liberarCercas();
+            } else if (cercas[regiao]) {
+                glDeleteSync(cercas[regiao]);
+                cercas[regiao] = nullptr;
+            }
+            registros = (RegistroObjeto*)glMapBufferRange(
+                GL_COPY_WRITE_BUFFER, deslocamento, n * sizeof(RegistroObjeto),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        }
+        estatisticas.segundosEspera =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        return registros;
+    }
+
+    // fim da escrita; liga o anel à unidade de textura dos shaders
+    void desmapear() {
+        if (!persistente) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+        glActiveTexture(GL_TEXTURE0 + UNIDADE_TEXTURA_OBJETOS);
+        glBindTexture(GL_TEXTURE_BUFFER, textura);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    // índice, no samplerBuffer, do primeiro registro da região mapeada
+    GLint primeiroRegistro() const { return (GLint)(regiao * capacidade); }
+
+    // depois dos desenhos que leem a região
+    void cercar() {
+        if (cercas[regiao]) glDeleteSync(cercas[regiao]);
+        cercas[regiao] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+private:
+    BufferGL buffer;
+    TexturaGL textura;
+    GLsync cercas[REGIOES] = {};
+    void* mapeado = nullptr;
+    bool persistente = false;
+    bool falhaPersistente = false;
+    size_t capacidade = 0;   // registros por região
+    int regiao = REGIOES - 1;
+    GLint limiteTexels = 0;
+
+    size_t bytesTotal() const { return REGIOES * capacidade * sizeof(RegistroObjeto); }
+
+    static bool sinalizada(GLsync cerca) {
+        return glClientWaitSync(cerca, 0, 0) != GL_TIMEOUT_EXPIRED;
+    }
+
+    void liberarCercas() {
+        for (GLsync& cerca : cercas) {
+            if (cerca) glDeleteSync(cerca);
+            cerca = nullptr;
+        }
+    }
+
+    // Buffer novo (o armazenamento imutável não muda de tamanho). O antigo é
+    // apagado já; o OpenGL só o libera quando a GPU terminar de usá-lo.
+    void alocar(size_t novaCapacidade) {
+        liberarCercas();
+        capacidade = novaCapacidade;
+        persistente = ExtensoesGL::temMapeamentoPersistente() && !falhaPersistente;
+        mapeado = nullptr;
+
+        buffer = BufferGL();
+        buffer.gerar();
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        if (persistente) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            ExtensoesGL::bufferStorage(GL_COPY_WRITE_BUFFER, bytesTotal(), nullptr, flags);
+            mapeado = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bytesTotal(), flags);
+            if (!mapeado) {
+                std::cout << "ERRO::ANEL_OBJETOS::MAPEAMENTO_PERSISTENTE (seguindo com glMapBufferRange)"
+                          << std::endl;
+                falhaPersistente = true;
+                persistente = false;
+                buffer = BufferGL();   // o armazenamento imutável não aceita glBufferData
+                buffer.gerar();
+                glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            }
+        }
+        if (!persistente) glBufferData(GL_COPY_WRITE_BUFFER, bytesTotal(), nullptr, GL_STREAM_DRAW);
+        estatisticas.persistente = persistente;
+
+        textura.gerar();
+        glActiveTexture(GL_TEXTURE0 + UNIDADE_TEXTURA_OBJETOS);
+        glBindTexture(GL_TEXTURE_BUFFER, textura);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+        glActiveTexture(GL_TEXTURE0);
+        regiao = REGIOES - 1;
+    }
+};
+
+#endif
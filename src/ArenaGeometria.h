@@ -0,0 +1,392 @@
+#ifndef ARENA_GEOMETRIA_H
+#define ARENA_GEOMETRIA_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <map>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+
+#include "FormatoVertice.h"
+#include "EstadoGL.h"
+#include "RecursosGL.h"
+
+// Arena de geometria: as meshes estáticas são subalocadas em poucos buffers
+// grandes, um par VBO/EBO e um VAO por formato de vértice. Cada mesh guarda
+// só o bloco (vértice base e deslocamento dos índices) e desenha com
+// glDrawElementsBaseVertex; meshes do mesmo formato compartilham o VAO, então
+// trocar de objeto não troca estado.
+//
+// Os blocos são referenciados por id, não por deslocamento, para que
+// crescer e compactar possam mover os dados sem avisar as meshes.
+
+// Faixas livres de um buffer, ordenadas por início; vizinhas são fundidas.
+class AlocadorFaixas {
+public:
+    static const size_t FALHA = SIZE_MAX;
+
+    void reiniciar(size_t capacidadeTotal) {
+        livres.clear();
+        capacidade = capacidadeTotal;
+        if (capacidade > 0) livres[0] = capacidade;
+    }
+
+    // primeiro encaixe; devolve FALHA se nenhuma faixa comporta o pedido
+    size_t alocar(size_t tamanho, size_t alinhamento = 1) {
+        for (auto it = livres.begin(); it != livres.end(); ++it) {
+            size_t inicio = it->first, fim = it->first + it->second;
+            size_t alinhado = (inicio + alinhamento - 1) / alinhamento * alinhamento;
+            if (alinhado + tamanho > fim) continue;
+
+            livres.erase(it);
+            if (alinhado > inicio) livres[inicio] = alinhado - inicio;
+            if (alinhado + tamanho < fim) livres[alinhado + tamanho] = fim - (alinhado + tamanho);
+            return alinhado;
+        }
+        return FALHA;
+    }
+
+    void liberar(size_t inicio, size_t tamanho) {
+        if (tamanho == 0) return;
+        auto it = livres.emplace(inicio, tamanho).first;
+
+        auto proximo = std::next(it);
+        if (proximo != livres.end() && it->first + it->second == proximo->first) {
+            it->second += proximo->second;
+            livres.erase(proximo);
+        }
+        if (it != livres.begin()) {
+            auto anterior = std::prev(it);
+            if (anterior->first + anterior->second == it->first) {
+                anterior->second += it->second;
+                livres.erase(it);
+            }
+        }
+    }
+
+    void crescer(size_t novaCapacidade) {
+        if (novaCapacidade <= capacidade) return;
+        size_t antiga = capacidade;
+        capacidade = novaCapacidade;
+        liberar(antiga, novaCapacidade - antiga);
+    }
+
+    size_t capacidadeTotal() const { return capacidade; }
+
+    size_t bytesLivres() const {
+        size_t total = 0;
+        for (const auto& f : livres) total += f.second;
+        return total;
+    }
+
+    size_t maiorLivre() const {
+        size_t maior = 0;
+        for (const auto& f : livres) maior = std::max(maior, f.second);
+        return maior;
+    }
+
+    size_t numFaixasLivres() const { return livres.size(); }
+
+private:
+    std::map<size_t, size_t> livres;   // início -> tamanho
+    size_t capacidade = 0;
+};
+
+// Uma região da arena: vértices [baseVertice, baseVertice + numVertices) e
+// índices em [deslocIndices, deslocIndices + bytesIndices) do pool.
+struct BlocoArena {
+    uint32_t pool = 0;
+    size_t baseVertice = 0;
+    size_t numVertices = 0;
+    size_t deslocIndices = 0;
+    size_t bytesIndices = 0;
+    bool vivo = false;
+};
+
+struct EstatisticasArena {
+    size_t pools = 0;
+    size_t blocosVivos = 0;
+    size_t bytesVerticesUsados = 0, bytesVerticesCapacidade = 0;
+    size_t bytesIndicesUsados = 0, bytesIndicesCapacidade = 0;
+    size_t faixasLivres = 0;    // fragmentação: quantas lacunas existem
+    size_t crescimentos = 0;
+    size_t compactacoes = 0;
+};
+
+class ArenaGeometria {
+public:
+    // capacidade inicial de cada pool; crescem dobrando quando precisam
+    explicit ArenaGeometria(size_t bytesVerticesIniciais = size_t(8) << 20,
+                            size_t bytesIndicesIniciais = size_t(4) << 20)
+        : verticesIniciais(bytesVerticesIniciais), indicesIniciais(bytesIndicesIniciais) {}
+
+    // as meshes guardam ponteiro para a arena
+    ArenaGeometria(const ArenaGeometria&) = delete;
+    ArenaGeometria& operator=(const ArenaGeometria&) = delete;
+
+    // Reserva e envia um bloco. Os índices são relativos ao bloco (o vértice
+    // base é somado no desenho) e ficam alinhados em 4 bytes.
+    uint32_t alocar(const FormatoVertice& formato, const void* dadosVertices, size_t numVertices,
+                    const void* dadosIndices, size_t bytesIndices) {
+        uint32_t p = poolPara(formato);
+        PoolGeometria& pool = *pools[p];
+        const size_t stride = pool.layout.tamanhoVertice;
+
+        size_t base = pool.vertices.alocar(numVertices);
+        if (base == AlocadorFaixas::FALHA) {
+            crescer(pool, pool.vertices.capacidadeTotal() + numVertices, pool.indices.capacidadeTotal());
+            base = pool.vertices.alocar(numVertices);
+        }
+        size_t desloc = pool.indices.alocar(bytesIndices, 4);
+        if (desloc == AlocadorFaixas::FALHA) {
+            crescer(pool, pool.vertices.capacidadeTotal(), pool.indices.capacidadeTotal() + bytesIndices + 4);
+            desloc = pool.indices.alocar(bytesIndices, 4);
+        }
+
+        // GL_COPY_WRITE_BUFFER não faz parte do estado do VAO vinculado
+        glBindBuffer(GL_COPY_WRITE_BUFFER, pool.VBO);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, base * stride, numVertices * stride, dadosVertices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, pool.EBO);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, desloc, bytesIndices, dadosIndices);
+
+        uint32_t id;
+        if (!blocosLivres.empty()) {
+            id = blocosLivres.back();
+            blocosLivres.pop_back();
+        } else {
+            id = (uint32_t)blocos.size();
+            blocos.emplace_back();
+        }
+        BlocoArena& bloco = blocos[id];
+        bloco.pool = p;
+        bloco.baseVertice = base;
+        bloco.numVertices = numVertices;
+        bloco.deslocIndices = desloc;
+        bloco.bytesIndices = bytesIndices;
+        bloco.vivo = true;
+        return id;
+    }
+
+    void liberar(uint32_t id) {
+        if (id >= blocos.size() || !blocos[id].vivo) return;
+        BlocoArena& bloco = blocos[id];
+        PoolGeometria& pool = *pools[bloco.pool];
+        pool.vertices.liberar(bloco.baseVertice, bloco.numVertices);
+        pool.indices.liberar(bloco.deslocIndices, bloco.bytesIndices);
+        bloco.vivo = false;
+        blocosLivres.push_back(id);
+    }
+
+    const BlocoArena& bloco(uint32_t id) const { return blocos[id]; }
+
+    GLuint vao(const BlocoArena& bloco) const { return pools[bloco.pool]->VAO; }
+
+    // Junta os blocos vivos no começo de cada pool (cópia GPU -> GPU), deixando
+    // uma única faixa livre no fim. Os ids continuam valendo.
+    void compactar() {
+        for (uint32_t p = 0; p < pools.size(); p++) {
+            PoolGeometria& pool = *pools[p];
+            std::vector<uint32_t> vivos;
+            for (uint32_t id = 0; id < blocos.size(); id++)
+                if (blocos[id].vivo && blocos[id].pool == p) vivos.push_back(id);
+
+            // juntos, os índices de cada bloco começam alinhados em 4: o último
+            // arredondamento pode passar de uma capacidade que não é múltipla de 4
+            size_t totalVertices = 0, totalIndices = 0;
+            for (uint32_t id : vivos) {
+                totalVertices += blocos[id].numVertices;
+                totalIndices = (totalIndices + blocos[id].bytesIndices + 3) & ~size_t(3);
+            }
+            if (totalVertices > pool.vertices.capacidadeTotal() || totalIndices > pool.indices.capacidadeTotal())
+                crescer(pool, totalVertices, totalIndices);
+
+            BufferGL novoVBO, novoEBO;
+            criarBuffer(novoVBO, pool.vertices.capacidadeTotal() * pool.layout.tamanhoVertice);
+            criarBuffer(novoEBO, pool.indices.capacidadeTotal());
+
+            const size_t stride = pool.layout.tamanhoVertice;
+            size_t proximoVertice = 0, proximoIndice = 0;
+
+            std::sort(vivos.begin(), vivos.end(), [&](uint32_t a, uint32_t b) {
+                return blocos[a].baseVertice < blocos[b].baseVertice;
+            });
+            glBindBuffer(GL_COPY_READ_BUFFER, pool.VBO);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, novoVBO);
+            for (uint32_t id : vivos) {
+                BlocoArena& b = blocos[id];
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, b.baseVertice * stride,
+                                    proximoVertice * stride, b.numVertices * stride);
+                b.baseVertice = proximoVertice;
+                proximoVertice += b.numVertices;
+            }
+
+            std::sort(vivos.begin(), vivos.end(), [&](uint32_t a, uint32_t b) {
+                return blocos[a].deslocIndices < blocos[b].deslocIndices;
+            });
+            glBindBuffer(GL_COPY_READ_BUFFER, pool.EBO);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, novoEBO);
+            for (uint32_t id : vivos) {
+                BlocoArena& b = blocos[id];
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, b.deslocIndices,
+                                    proximoIndice, b.bytesIndices);
+                b.deslocIndices = proximoIndice;
+                proximoIndice = (proximoIndice + b.bytesIndices + 3) & ~size_t(3);
+            }
+
+            pool.VBO = std::move(novoVBO);
+            pool.EBO = std::move(novoEBO);
+            configurarVAO(pool);
+
+            size_t capacidadeVertices = pool.vertices.capacidadeTotal();
+            size_t capacidadeIndices = pool.indices.capacidadeTotal();
+            pool.vertices.reiniciar(capacidadeVertices);
+            pool.indices.reiniciar(capacidadeIndices);
+            if (pool.vertices.alocar(proximoVertice) == AlocadorFaixas::FALHA ||
+                pool.indices.alocar(proximoIndice) == AlocadorFaixas::FALHA)
+                std::cout << "ERRO::ARENA::COMPACTACAO_SEM_ESPACO (pool " << p << ")" << std::endl;
+        }
+        numCompactacoes++;
+    }
+
+    EstatisticasArena estatisticas() const {
+        EstatisticasArena e;
+        e.pools = pools.size();
+        e.crescimentos = numCrescimentos;
+        e.compactacoes = numCompactacoes;
+        for (const BlocoArena& b : blocos) {
+            if (!b.vivo) continue;
+            e.blocosVivos++;
+            e.bytesVerticesUsados += b.numVertices * pools[b.pool]->layout.tamanhoVertice;
+            e.bytesIndicesUsados += b.bytesIndices;
+        }
+        for (const auto& pool : pools) {
+            e.bytesVerticesCapacidade += pool->vertices.capacidadeTotal() * pool->layout.tamanhoVertice;
+            e.bytesIndicesCapacidade += pool->indices.capacidadeTotal();
+            e.faixasLivres += pool->vertices.numFaixasLivres() + pool->indices.numFaixasLivres();
+        }
+        return e;
+    }
+
+private:
+    struct PoolGeometria {
+        FormatoVertice formato;
+        LayoutVertice layout;
+        VertexArrayGL VAO;
+        BufferGL VBO, EBO;
+        AlocadorFaixas vertices;   // em vértices
+        AlocadorFaixas indices;    // em bytes
+    };
+
+    std::vector<std::unique_ptr<PoolGeometria>> pools;
+    std::vector<BlocoArena> blocos;
+    std::vector<uint32_t> blocosLivres;
+    size_t verticesIniciais, indicesIniciais;
+    size_t numCrescimentos = 0, numCompactacoes = 0;
+
+    static bool mesmoFormato(const FormatoVertice& a, const FormatoVertice& b) {
+        return a.posicao == b.posicao && a.normal == b.normal && a.uv == b.uv;
+    }
+
+    uint32_t poolPara(const FormatoVertice& formato) {
+        for (uint32_t p = 0; p < pools.size(); p++)
+            if (mesmoFormato(pools[p]->formato, formato)) return p;
+
+        std::unique_ptr<PoolGeometria> pool(new PoolGeometria());
+        pool->formato = formato;
+        pool->layout = LayoutVertice::para(formato);
+        size_t capacidadeVertices = std::max<size_t>(1, verticesIniciais / pool->layout.tamanhoVertice);
+        pool->vertices.reiniciar(capacidadeVertices);
+        pool->indices.reiniciar(indicesIniciais);
+        criarBuffer(pool->VBO, capacidadeVertices * pool->layout.tamanhoVertice);
+        criarBuffer(pool->EBO, indicesIniciais);
+        pool->VAO.gerar();
+        configurarVAO(*pool);
+
+        pools.push_back(std::move(pool));
+        return (uint32_t)pools.size() - 1;
+    }
+
+    static void criarBuffer(BufferGL& buffer, size_t bytes) {
+        buffer.gerar();
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, GL_STATIC_DRAW);
+    }
+
+    // o VAO guarda os ponteiros para o VBO e o EBO: refeito quando eles mudam
+    static void configurarVAO(PoolGeometria& pool) {
+        EstadoGL::vincularVAO(pool.VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, pool.VBO);
+        pool.layout.aplicar();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.EBO);
+    }
+
+    // realoca os buffers do pool (dobrando, ou até o mínimo pedido) e copia o conteúdo
+    void crescer(PoolGeometria& pool, size_t minimoVertices, size_t minimoBytesIndices) {
+        const size_t stride = pool.layout.tamanhoVertice;
+        size_t capacidadeVertices = pool.vertices.capacidadeTotal();
+        size_t capacidadeIndices = pool.indices.capacidadeTotal();
+
+        if (minimoVertices > capacidadeVertices) {
+            size_t nova = std::max(capacidadeVertices * 2, minimoVertices);
+            BufferGL novo;
+            criarBuffer(novo, nova * stride);
+            glBindBuffer(GL_COPY_READ_BUFFER, pool.VBO);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, capacidadeVertices * stride);
+            pool.VBO = std::move(novo);
+            pool.vertices.crescer(nova);
+        }
+        if (minimoBytesIndices > capacidadeIndices) {
+            size_t nova = std::max(capacidadeIndices * 2, minimoBytesIndices);
+            BufferGL novo;
+            criarBuffer(novo, nova);
+            glBindBuffer(GL_COPY_READ_BUFFER, pool.EBO);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, capacidadeIndices);
+            pool.EBO = std::move(novo);
+            pool.indices.crescer(nova);
+        }
+
+        configurarVAO(pool);
+        numCrescimentos++;
+    }
+};
+
+// Posse de um bloco da arena, no mesmo esquema move-only do BufferGL.
+class AlocacaoArena {
+public:
+    ArenaGeometria* arena = nullptr;
+    uint32_t bloco = 0;
+
+    AlocacaoArena() = default;
+    AlocacaoArena(const AlocacaoArena&) = delete;
+    AlocacaoArena& operator=(const AlocacaoArena&) = delete;
+
+    AlocacaoArena(AlocacaoArena&& outra) noexcept : arena(outra.arena), bloco(outra.bloco) {
+        outra.arena = nullptr;
+    }
+
+    AlocacaoArena& operator=(AlocacaoArena&& outra) noexcept {
+        if (this != &outra) {
+            liberar();
+            arena = outra.arena;
+            bloco = outra.bloco;
+            outra.arena = nullptr;
+        }
+        return *this;
+    }
+
+    ~AlocacaoArena() { liberar(); }
+
+    void liberar() {
+        if (arena) {
+            arena->liberar(bloco);
+            arena = nullptr;
+        }
+    }
+
+    bool ativa() const { return arena != nullptr; }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef ARQUIVO_MAPEADO_H
+#define ARQUIVO_MAPEADO_H
+
+#include <string>
+#include <utility>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Mapeamento somente leitura de um arquivo inteiro. Move-only, como os handles da Mesh.
+class ArquivoMapeado {
+public:
+    const char* dados = nullptr;
+    size_t tamanho = 0;
+
+    ArquivoMapeado() = default;
+    ArquivoMapeado(const ArquivoMapeado&) = delete;
+    ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
+
+    ArquivoMapeado(ArquivoMapeado&& outro) noexcept { trocar(outro); }
+
+    ArquivoMapeado& operator=(ArquivoMapeado&& outro) noexcept {
+        if (this != &outro) {
+            fechar();
+            trocar(outro);
+        }
+        return *this;
+    }
+
+    ~ArquivoMapeado() { fechar(); }
+
+    bool abrir(const std::string& caminho) {
+        fechar();
+#ifdef _WIN32
+        arquivo = CreateFileA(caminho.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (arquivo == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER tam;
+        if (!GetFileSizeEx(arquivo, &tam)) { fechar(); return false; }
+        tamanho = (size_t)tam.QuadPart;
+        if (tamanho == 0) return true;
+        mapeamento = CreateFileMappingA(arquivo, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapeamento == NULL) { fechar(); return false; }
+        dados = (const char*)MapViewOfFile(mapeamento, FILE_MAP_READ, 0, 0, 0);
+        if (dados == nullptr) { fechar(); return false; }
+#else
+        descritor = ::open(caminho.c_str(), O_RDONLY);
+        if (descritor < 0) return false;
+        struct stat info;
+        if (fstat(descritor, &info) != 0) { fechar(); return false; }
+        tamanho = (size_t)info.st_size;
+        if (tamanho == 0) return true;
+        void* p = mmap(nullptr, tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+        if (p == MAP_FAILED) { fechar(); return false; }
+        dados = (const char*)p;
+        madvise(p, tamanho, MADV_SEQUENTIAL);
+#endif
+        return true;
+    }
+
+    void fechar() {
+#ifdef _WIN32
+        if (dados) UnmapViewOfFile(dados);
+        if (mapeamento) CloseHandle(mapeamento);
+        if (arquivo != INVALID_HANDLE_VALUE) CloseHandle(arquivo);
+        mapeamento = NULL;
+        arquivo = INVALID_HANDLE_VALUE;
+#else
+        if (dados) munmap((void*)dados, tamanho);
+        if (descritor >= 0) ::close(descritor);
+        descritor = -1;
+#endif
+        dados = nullptr;
+        tamanho = 0;
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE arquivo = INVALID_HANDLE_VALUE;
+    HANDLE mapeamento = NULL;
+#else
+    int descritor = -1;
+#endif
+
+    void trocar(ArquivoMapeado& outro) {
+        std::swap(dados, outro.dados);
+        std::swap(tamanho, outro.tamanho);
+#ifdef _WIN32
+        std::swap(arquivo, outro.arquivo);
+        std::swap(mapeamento, outro.mapeamento);
+#else
+        std::swap(descritor, outro.descritor);
+#endif
+    }
+};
+
+// Nome do temporário para gravar destino e depois renomear: com o pid e um
+// contador, dois processos (ou duas gravações no mesmo) nunca escrevem no
+// mesmo arquivo, e o rename de cada um troca o destino inteiro.
+inline std::string caminhoTemporario(const std::string& destino) {
+    static std::atomic<uint64_t> contador{0};
+#ifdef _WIN32
+    unsigned long long processo = GetCurrentProcessId();
+#else
+    unsigned long long processo = (unsigned long long)getpid();
+#endif
+    return destino + "." + std::to_string(processo) + "." + std::to_string(contador++) + ".tmp";
+}
+
+#endif
@@ -0,0 +1,561 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+
+#include "Frustum.h"
+#include "Paralelo.h"
+
+struct CaixaBVH {
+    glm::vec3 minimo = glm::vec3(FLT_MAX);
+    glm::vec3 maximo = glm::vec3(-FLT_MAX);
+
+    void expandir(const CaixaBVH& c) {
+        minimo = glm::min(minimo, c.minimo);
+        maximo = glm::max(maximo, c.maximo);
+    }
+
+    void expandir(const glm::vec3& p) {
+        minimo = glm::min(minimo, p);
+        maximo = glm::max(maximo, p);
+    }
+
+    glm::vec3 centro() const { return (minimo + maximo) * 0.5f; }
+
+    // metade da área da superfície; só a proporção entre caixas importa para a SAH
+    float area() const {
+        glm::vec3 d = glm::max(maximo - minimo, glm::vec3(0.0f));
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    static CaixaBVH daEsfera(const glm::vec3& centro, float raio) {
+        CaixaBVH c;
+        c.minimo = centro - glm::vec3(raio);
+        c.maximo = centro + glm::vec3(raio);
+        return c;
+    }
+
+    static CaixaBVH daMesh(const Mesh& mesh, const glm::mat4& modelo) {
+        glm::vec3 centro, extensao;
+        Frustum::transformarCaixa(mesh.limiteMin, mesh.limiteMax, modelo, centro, extensao);
+        CaixaBVH c;
+        c.minimo = centro - extensao;
+        c.maximo = centro + extensao;
+        return c;
+    }
+};
+
+// 32 bytes, dois nós por linha de cache. Os filhos de um nó interno ficam
+// lado a lado (filho e filho + 1); numa folha, [primeiro, primeiro + quantidade)
+// indexa BVHCena::objetos.
+struct NoBVH {
+    glm::vec3 minimo;
+    uint32_t filhoOuPrimeiro;
+    glm::vec3 maximo;
+    uint32_t quantidade;   // 0 = nó interno
+
+    bool folha() const { return quantidade > 0; }
+};
+
+static_assert(sizeof(NoBVH) == 32, "NoBVH deve ter 32 bytes");
+
+struct EstatisticasBVH {
+    size_t objetos = 0;
+    size_t nos = 0;
+    size_t folhas = 0;
+    int profundidade = 0;
+    double segundosConstrucao = 0.0;
+    double segundosReajuste = 0.0;   // último reajustar()
+    double segundosConsulta = 0.0;   // última consulta (frustum, raio ou esfera)
+    size_t nosVisitados = 0;         // na última consulta
+};
+
+struct AcertoRaio {
+    int64_t objeto = -1;   // -1 = nada atingido
+    float distancia = FLT_MAX;
+};
+
+// Hierarquia de caixas sobre os objetos da cena, construída pela heurística
+// de área de superfície (SAH) com 12 baldes por eixo. Os nós ficam num vetor
+// único; a construção divide subárvores grandes entre as threads do
+// paralelo::PoolThreads, que reservam pares de nós com um contador atômico.
+// Quando só as matrizes mudam, as caixas são reajustadas de baixo para cima
+// sem reconstruir, o que piora a árvore aos poucos: degradacao() compara o
+// custo SAH atual com o da construção para quem quiser decidir quando
+// reconstruir.
+class BVHCena {
+public:
+    std::vector<NoBVH> nos;
+    std::vector<uint32_t> objetos;   // ids dos objetos, na ordem das folhas
+    EstatisticasBVH estatisticas;
+
+    void construir(const std::vector<CaixaBVH>& caixasObjetos) {
+        auto inicio = std::chrono::steady_clock::now();
+        caixas = caixasObjetos;
+        const size_t n = caixas.size();
+
+        referencias.resize(n);
+        for (size_t i = 0; i < n; i++) referencias[i] = {caixas[i], caixas[i].centro(), (uint32_t)i};
+
+        nos.assign(std::max<size_t>(1, 2 * n), NoBVH());
+        pais.assign(nos.size(), 0);
+        folhaDoObjeto.assign(n, 0);
+        usados = 1;
+        profundidadeMaxima = 0;
+        folhas = 0;
+
+        nos[0].filhoOuPrimeiro = 0;
+        nos[0].quantidade = (uint32_t)n;
+        if (n > 0) {
+            int niveisParalelos = 0;
+            while ((1u << niveisParalelos) < threadsDisponiveis()) niveisParalelos++;
+            construirNo(0, 0, n, 0, niveisParalelos);
+        } else {
+            nos[0].minimo = nos[0].maximo = glm::vec3(0.0f);
+            nos[0].quantidade = 0;
+        }
+        nos.resize(usados);
+        pais.resize(usados);
+
+        objetos.resize(n);
+        for (size_t i = 0; i < n; i++) objetos[i] = referencias[i].objeto;
+        for (const NoBVH& no : nos)
+            for (uint32_t i = 0; i < no.quantidade; i++) folhaDoObjeto[objetos[no.filhoOuPrimeiro + i]] = (uint32_t)(&no - nos.data());
+        referencias.clear();
+        referencias.shrink_to_fit();
+
+        somaAreas = somarAreas();
+        custoConstrucao = custoSAH();
+        custoAtual = custoConstrucao;
+
+        estatisticas.objetos = n;
+        estatisticas.nos = nos.size();
+        estatisticas.folhas = folhas;
+        estatisticas.profundidade = profundidadeMaxima;
+        estatisticas.segundosConstrucao =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    // Todos os objetos mudaram: folhas em paralelo, depois os nós internos do
+    // fim para o começo (um filho sempre tem índice maior que o pai).
+    void reajustar(const std::vector<CaixaBVH>& caixasObjetos) {
+        auto inicio = std::chrono::steady_clock::now();
+        caixas = caixasObjetos;
+        paraleloEmBlocos(nos.size(), 16384, [&](size_t a, size_t b) {
+            for (size_t i = a; i < b; i++)
+                if (nos[i].folha()) ajustarFolha(nos[i]);
+        });
+        for (size_t i = nos.size(); i-- > 0;)
+            if (!nos[i].folha() && !objetos.empty()) ajustarInterno(nos[i]);
+
+        somaAreas = somarAreas();
+        custoAtual = custoSAH();
+        estatisticas.segundosReajuste =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    // Só alguns objetos mudaram: sobe de cada folha até a raiz, parando
+    // quando a caixa de um ancestral não muda. O custo SAH acompanha pela
+    // diferença de área de cada nó reajustado, sem percorrer a árvore.
+    void reajustar(const std::vector<CaixaBVH>& caixasObjetos, const std::vector<uint32_t>& alterados) {
+        auto inicio = std::chrono::steady_clock::now();
+        for (uint32_t objeto : alterados) {
+            caixas[objeto] = caixasObjetos[objeto];
+            uint32_t no = folhaDoObjeto[objeto];
+            double areaAntes = areaNo(nos[no]);
+            ajustarFolha(nos[no]);
+            somaAreas += (areaNo(nos[no]) - areaAntes) * nos[no].quantidade;
+            while (no != 0) {
+                no = pais[no];
+                glm::vec3 minimo = nos[no].minimo, maximo = nos[no].maximo;
+                areaAntes = areaNo(nos[no]);
+                ajustarInterno(nos[no]);
+                if (minimo == nos[no].minimo && maximo == nos[no].maximo) break;
+                somaAreas += areaNo(nos[no]) - areaAntes;
+            }
+        }
+        custoAtual = custoSAH();
+        estatisticas.segundosReajuste =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    // custo SAH atual / custo na construção (1 = árvore recém-construída)
+    float degradacao() const {
+        return custoConstrucao > 0.0f ? custoAtual / custoConstrucao : 1.0f;
+    }
+
+    // Objetos cuja caixa toca o frustum. Cada nó testa só os planos que o pai
+    // ainda cortava; subárvores inteiramente dentro saem sem mais testes.
+    void recortar(const Frustum& frustum, std::vector<uint32_t>& saida) {
+        auto inicio = std::chrono::steady_clock::now();
+        saida.clear();
+        size_t visitados = 0;
+        if (!objetos.empty()) {
+            struct Entrada { uint32_t no; uint32_t planos; };
+            Entrada pilha[128];
+            int topo = 0;
+            pilha[topo++] = {0, 0x3F};
+            while (topo > 0) {
+                Entrada e = pilha[--topo];
+                const NoBVH& no = nos[e.no];
+                visitados++;
+
+                uint32_t planos = e.planos;
+                glm::vec3 centro = (no.minimo + no.maximo) * 0.5f;
+                glm::vec3 extensao = (no.maximo - no.minimo) * 0.5f;
+                bool fora = false;
+                for (int k = 0; k < 6 && !fora; k++) {
+                    if (!(planos & (1u << k))) continue;
+                    const glm::vec4& p = frustum.planos[k];
+                    float distancia = glm::dot(glm::vec3(p), centro) + p.w;
+                    float projecao = glm::dot(glm::abs(glm::vec3(p)), extensao);
+                    if (distancia < -projecao) fora = true;
+                    else if (distancia >= projecao) planos &= ~(1u << k);
+                }
+                if (fora) continue;
+
+                if (planos == 0) {
+                    visitados += adicionarSubarvore(e.no, saida);
+                } else if (no.folha()) {
+                    for (uint32_t i = 0; i < no.quantidade; i++) {
+                        uint32_t objeto = objetos[no.filhoOuPrimeiro + i];
+                        const CaixaBVH& c = caixas[objeto];
+                        if (frustum.caixaVisivel(c.centro(), (c.maximo - c.minimo) * 0.5f)) saida.push_back(objeto);
+                    }
+                } else {
+                    pilha[topo++] = {no.filhoOuPrimeiro, planos};
+                    pilha[topo++] = {no.filhoOuPrimeiro + 1, planos};
+                }
+            }
+        }
+        concluirConsulta(inicio, visitados);
+    }
+
+    // Objeto mais próximo atingido pelo raio. intersectar(objeto) devolve a
+    // distância do acerto exato ou um valor negativo; sem ela, vale a entrada
+    // na caixa do objeto. Os filhos são visitados do mais próximo para o mais
+    // distante, e nós além do melhor acerto são podados.
+    AcertoRaio raio(const glm::vec3& origem, const glm::vec3& direcao, float distanciaMaxima = FLT_MAX,
+                    const std::function<float(uint32_t)>& intersectar = nullptr) {
+        auto inicio = std::chrono::steady_clock::now();
+        AcertoRaio acerto;
+        acerto.distancia = distanciaMaxima;
+        size_t visitados = 0;
+
+        glm::vec3 inverso = 1.0f / direcao;
+        float entrada;
+        if (!objetos.empty() && intersectaCaixa(nos[0].minimo, nos[0].maximo, origem, inverso, acerto.distancia, entrada)) {
+            uint32_t pilha[128];
+            int topo = 0;
+            pilha[topo++] = 0;
+            while (topo > 0) {
+                const NoBVH& no = nos[pilha[--topo]];
+                visitados++;
+                if (no.folha()) {
+                    for (uint32_t i = 0; i < no.quantidade; i++) {
+                        uint32_t objeto = objetos[no.filhoOuPrimeiro + i];
+                        const CaixaBVH& c = caixas[objeto];
+                        float t;
+                        if (!intersectaCaixa(c.minimo, c.maximo, origem, inverso, acerto.distancia, t)) continue;
+                        if (intersectar) t = intersectar(objeto);
+                        if (t >= 0.0f && t < acerto.distancia) {
+                            acerto.distancia = t;
+                            acerto.objeto = objeto;
+                        }
+                    }
+                    continue;
+                }
+
+                uint32_t a = no.filhoOuPrimeiro, b = a + 1;
+                float ta, tb;
+                bool ia = intersectaCaixa(nos[a].minimo, nos[a].maximo, origem, inverso, acerto.distancia, ta);
+                bool ib = intersectaCaixa(nos[b].minimo, nos[b].maximo, origem, inverso, acerto.distancia, tb);
+                // o mais próximo vai por último na pilha, para sair primeiro
+                if (ia && ib) {
+                    if (ta < tb) std::swap(a, b);
+                    pilha[topo++] = a;
+                    pilha[topo++] = b;
+                } else if (ia) {
+                    pilha[topo++] = a;
+                } else if (ib) {
+                    pilha[topo++] = b;
+                }
+            }
+        }
+        if (acerto.objeto < 0) acerto.distancia = FLT_MAX;
+        concluirConsulta(inicio, visitados);
+        return acerto;
+    }
+
+    // Objetos cuja caixa toca a esfera.
+    void esfera(const glm::vec3& centro, float raioEsfera, std::vector<uint32_t>& saida) {
+        auto inicio = std::chrono::steady_clock::now();
+        saida.clear();
+        size_t visitados = 0;
+        const float raioQuadrado = raioEsfera * raioEsfera;
+        auto toca = [&](const glm::vec3& minimo, const glm::vec3& maximo) {
+            glm::vec3 d = centro - glm::clamp(centro, minimo, maximo);
+            return glm::dot(d, d) <= raioQuadrado;
+        };
+
+        if (!objetos.empty() && toca(nos[0].minimo, nos[0].maximo)) {
+            uint32_t pilha[128];
+            int topo = 0;
+            pilha[topo++] = 0;
+            while (topo > 0) {
+                const NoBVH& no = nos[pilha[--topo]];
+                visitados++;
+                if (no.folha()) {
+                    for (uint32_t i = 0; i < no.quantidade; i++) {
+                        uint32_t objeto = objetos[no.filhoOuPrimeiro + i];
+                        if (toca(caixas[objeto].minimo, caixas[objeto].maximo)) saida.push_back(objeto);
+                    }
+                    continue;
+                }
+                for (uint32_t f = no.filhoOuPrimeiro; f < no.filhoOuPrimeiro + 2; f++)
+                    if (toca(nos[f].minimo, nos[f].maximo)) pilha[topo++] = f;
+            }
+        }
+        concluirConsulta(inicio, visitados);
+    }
+
+private:
+    static const int NUM_BALDES = 12;
+    static const uint32_t MAXIMO_FOLHA = 8;
+    static const size_t MINIMO_PARALELO = 32768;   // objetos numa subárvore para valer uma parte no pool
+    static const int PROFUNDIDADE_SAH = 48;
+
+    // só durante a construção: particionar as caixas em si, e não índices
+    // para elas, mantém os acessos sequenciais
+    struct Referencia {
+        CaixaBVH caixa;
+        glm::vec3 centro;
+        uint32_t objeto;
+    };
+
+    std::vector<CaixaBVH> caixas;     // por id de objeto
+    std::vector<Referencia> referencias;
+    std::vector<uint32_t> pais;       // por nó; a raiz aponta para si mesma
+    std::vector<uint32_t> folhaDoObjeto;
+    std::atomic<uint32_t> usados{0};
+    std::atomic<int> profundidadeMaxima{0};
+    std::atomic<size_t> folhas{0};
+    float custoConstrucao = 0.0f, custoAtual = 0.0f;
+    double somaAreas = 0.0;   // numerador de custoSAH(), mantido pelo reajuste parcial
+
+    void construirNo(uint32_t indice, size_t inicio, size_t fim, int profundidade, int niveisParalelos) {
+        NoBVH& no = nos[indice];
+        CaixaBVH limites, limitesCentros;
+        for (size_t i = inicio; i < fim; i++) {
+            limites.expandir(referencias[i].caixa);
+            limitesCentros.expandir(referencias[i].centro);
+        }
+        no.minimo = limites.minimo;
+        no.maximo = limites.maximo;
+
+        size_t meio;
+        if (!dividir(inicio, fim, limites, limitesCentros, profundidade, meio)) {
+            tornarFolha(indice, inicio, fim, profundidade);
+            return;
+        }
+
+        uint32_t filho = usados.fetch_add(2);
+        no.filhoOuPrimeiro = filho;
+        no.quantidade = 0;
+        pais[filho] = pais[filho + 1] = indice;
+
+        if (niveisParalelos > 0 && fim - inicio >= MINIMO_PARALELO) {
+            // as duas metades como partes do pool; a da direita pode ser
+            // pega por um trabalhador ou, se todos estiverem ocupados, por esta thread
+            auto metade = [&](size_t lado) {
+                if (lado == 0) construirNo(filho, inicio, meio, profundidade + 1, niveisParalelos - 1);
+                else           construirNo(filho + 1, meio, fim, profundidade + 1, niveisParalelos - 1);
+            };
+            paralelo::PoolThreads::global().executar(2, metade);
+        } else {
+            construirNo(filho, inicio, meio, profundidade + 1, 0);
+            construirNo(filho + 1, meio, fim, profundidade + 1, 0);
+        }
+    }
+
+    // Escolhe eixo e balde de menor custo SAH e particiona objetos[inicio, fim).
+    // Devolve false quando uma folha sai mais barata. Abaixo de
+    // PROFUNDIDADE_SAH a divisão passa a ser pela mediana do maior eixo, o que
+    // limita a altura da árvore (e as pilhas de 128 entradas das consultas).
+    bool dividir(size_t inicio, size_t fim, const CaixaBVH& limites, const CaixaBVH& limitesCentros,
+                 int profundidade, size_t& meio) {
+        const size_t n = fim - inicio;
+        if (n < 2) return false;
+
+        glm::vec3 extensao = limitesCentros.maximo - limitesCentros.minimo;
+        if (profundidade >= PROFUNDIDADE_SAH) {
+            if (n <= MAXIMO_FOLHA) return false;
+            int eixo = extensao.x >= extensao.y && extensao.x >= extensao.z ? 0 : (extensao.y >= extensao.z ? 1 : 2);
+            meio = inicio + n / 2;
+            std::nth_element(referencias.begin() + inicio, referencias.begin() + meio, referencias.begin() + fim,
+                             [&](const Referencia& a, const Referencia& b) { return a.centro[eixo] < b.centro[eixo]; });
+            return true;
+        }
+
+        float melhorCusto = FLT_MAX;
+        int melhorBalde = -1;
+        int eixoEscolhido = -1;
+        // nós pequenos com menos baldes: perto das folhas o custo fixo dos
+        // baldes pesaria mais que a passada pelos objetos
+        const int numBaldes = (int)std::min<size_t>(NUM_BALDES, std::max<size_t>(2, n));
+
+        for (int eixo = 0; eixo < 3; eixo++) {
+            if (extensao[eixo] <= 0.0f) continue;
+            CaixaBVH baldes[NUM_BALDES];
+            size_t contagem[NUM_BALDES] = {};
+            float escala = numBaldes / extensao[eixo];
+            for (size_t i = inicio; i < fim; i++) {
+                int b = baldeDe(referencias[i].centro[eixo], limitesCentros.minimo[eixo], escala, numBaldes);
+                baldes[b].expandir(referencias[i].caixa);
+                contagem[b]++;
+            }
+
+            // áreas e contagens acumuladas da direita para a esquerda
+            float areaDireita[NUM_BALDES];
+            size_t contagemDireita[NUM_BALDES];
+            CaixaBVH acumulada;
+            size_t soma = 0;
+            for (int b = numBaldes - 1; b > 0; b--) {
+                acumulada.expandir(baldes[b]);
+                soma += contagem[b];
+                areaDireita[b] = acumulada.area();
+                contagemDireita[b] = soma;
+            }
+
+            acumulada = CaixaBVH();
+            soma = 0;
+            for (int b = 0; b < numBaldes - 1; b++) {
+                acumulada.expandir(baldes[b]);
+                soma += contagem[b];
+                if (soma == 0 || contagemDireita[b + 1] == 0) continue;
+                float custo = acumulada.area() * soma + areaDireita[b + 1] * contagemDireita[b + 1];
+                if (custo < melhorCusto) {
+                    melhorCusto = custo;
+                    melhorBalde = b;
+                    eixoEscolhido = eixo;
+                }
+            }
+        }
+
+        // custo relativo: percorrer o nó vale 1 teste de objeto
+        float custoFolha = (float)n;
+        float custoDivisao = 1.0f + melhorCusto / std::max(limites.area(), FLT_MIN);
+        if (eixoEscolhido < 0 || (n <= MAXIMO_FOLHA && custoDivisao >= custoFolha)) {
+            if (n <= MAXIMO_FOLHA) return false;
+            // centros coincidentes: metade para cada lado
+            meio = inicio + n / 2;
+            return true;
+        }
+
+        const int eixo = eixoEscolhido;
+        const float minimo = limitesCentros.minimo[eixo];
+        const float escala = numBaldes / extensao[eixo];
+        // estável: objetos vizinhos na entrada continuam vizinhos nas folhas,
+        // o que deixa as leituras do reajuste quase sequenciais
+        auto it = std::stable_partition(referencias.begin() + inicio, referencias.begin() + fim,
+                                        [&](const Referencia& r) {
+            return baldeDe(r.centro[eixo], minimo, escala, numBaldes) <= melhorBalde;
+        });
+        meio = (size_t)(it - referencias.begin());
+        if (meio == inicio || meio == fim) meio = inicio + n / 2;
+        return true;
+    }
+
+    static int baldeDe(float valor, float minimo, float escala, int numBaldes) {
+        return std::min(numBaldes - 1, (int)((valor - minimo) * escala));
+    }
+
+    void tornarFolha(uint32_t indice, size_t inicio, size_t fim, int profundidade) {
+        nos[indice].filhoOuPrimeiro = (uint32_t)inicio;
+        nos[indice].quantidade = (uint32_t)(fim - inicio);
+        folhas++;
+        int anterior = profundidadeMaxima.load();
+        while (profundidade > anterior && !profundidadeMaxima.compare_exchange_weak(anterior, profundidade)) {}
+    }
+
+    void ajustarFolha(NoBVH& no) {
+        CaixaBVH c;
+        for (uint32_t i = 0; i < no.quantidade; i++) c.expandir(caixas[objetos[no.filhoOuPrimeiro + i]]);
+        no.minimo = c.minimo;
+        no.maximo = c.maximo;
+    }
+
+    void ajustarInterno(NoBVH& no) {
+        const NoBVH& a = nos[no.filhoOuPrimeiro];
+        const NoBVH& b = nos[no.filhoOuPrimeiro + 1];
+        no.minimo = glm::min(a.minimo, b.minimo);
+        no.maximo = glm::max(a.maximo, b.maximo);
+    }
+
+    // meia área de superfície (a constante não importa: o custo é uma razão)
+    static float areaNo(const NoBVH& no) {
+        glm::vec3 d = glm::max(no.maximo - no.minimo, glm::vec3(0.0f));
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    // soma das áreas dos nós, com folhas pesadas pelo número de objetos
+    double somarAreas() const {
+        double soma = 0.0;
+        for (const NoBVH& no : nos) soma += areaNo(no) * (no.folha() ? no.quantidade : 1.0);
+        return soma;
+    }
+
+    // somaAreas relativa à área da raiz
+    float custoSAH() const {
+        if (objetos.empty()) return 0.0f;
+        return (float)(somaAreas / std::max(areaNo(nos[0]), FLT_MIN));
+    }
+
+    // todos os objetos de uma subárvore; devolve quantos nós foram percorridos
+    size_t adicionarSubarvore(uint32_t raiz, std::vector<uint32_t>& saida) const {
+        size_t visitados = 0;
+        uint32_t pilha[128];
+        int topo = 0;
+        pilha[topo++] = raiz;
+        while (topo > 0) {
+            const NoBVH& no = nos[pilha[--topo]];
+            visitados++;
+            if (no.folha()) {
+                saida.insert(saida.end(), objetos.begin() + no.filhoOuPrimeiro,
+                             objetos.begin() + no.filhoOuPrimeiro + no.quantidade);
+            } else {
+                pilha[topo++] = no.filhoOuPrimeiro;
+                pilha[topo++] = no.filhoOuPrimeiro + 1;
+            }
+        }
+        return visitados;
+    }
+
+    // teste de placas; entrada recebe a distância de entrada (0 se a origem está dentro)
+    static bool intersectaCaixa(const glm::vec3& minimo, const glm::vec3& maximo, const glm::vec3& origem,
+                                const glm::vec3& inverso, float distanciaMaxima, float& entrada) {
+        glm::vec3 t0 = (minimo - origem) * inverso;
+        glm::vec3 t1 = (maximo - origem) * inverso;
+        glm::vec3 tPerto = glm::min(t0, t1), tLonge = glm::max(t0, t1);
+        float perto = std::max(std::max(tPerto.x, tPerto.y), std::max(tPerto.z, 0.0f));
+        float longe = std::min(std::min(tLonge.x, tLonge.y), std::min(tLonge.z, distanciaMaxima));
+        entrada = perto;
+        return perto <= longe;
+    }
+
+    void concluirConsulta(std::chrono::steady_clock::time_point inicio, size_t visitados) {
+        estatisticas.nosVisitados = visitados;
+        estatisticas.segundosConsulta =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+};
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef BLOCOS_UNIFORM_H
+#define BLOCOS_UNIFORM_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "Light.h"
+#include "RecursosGL.h"
+#include "Shader.h"
+
+// Blocos de uniforms (UBOs) divididos por todos os shaders de desenho. Cada
+// struct abaixo é o espelho, byte a byte, do bloco de mesmo nome declarado
+// com layout(std140) nos shaders; o preenchimento é explícito porque no
+// std140 um vec3 ocupa 16 bytes, salvo quando um float vem logo depois.
+
+const GLuint PONTO_BLOCO_CAMERA = 0;
+const GLuint PONTO_BLOCO_LUZES = 1;
+const GLuint PONTO_BLOCO_MATERIAIS = 2;
+
+const int MAXIMO_LUZES_PONTUAIS = 4;   // MAX_LUZES_PONTUAIS em lightingFrag.glsl
+const int MAXIMO_MATERIAIS = 16;       // MAX_MATERIAIS
+
+struct BlocoCamera {
+    glm::mat4 projecao;
+    glm::mat4 visao;
+    glm::vec4 posicaoObservador;   // w sem uso
+    glm::mat4 projecaoVisao;       // o produto uma vez por quadro, não uma vez por vértice
+};
+
+struct LuzDirecionalStd140 {
+    glm::vec3 direcao;
+    float preenchimento0;
+    glm::vec3 ambiente;
+    float preenchimento1;
+    glm::vec3 difusa;
+    float preenchimento2;
+    glm::vec3 especular;
+    float preenchimento3;
+
+    LuzDirecionalStd140() = default;
+    explicit LuzDirecionalStd140(const LuzDirecional& luz)
+        : direcao(luz.direcao), preenchimento0(0.0f),
+          ambiente(luz.ambiente), preenchimento1(0.0f),
+          difusa(luz.difusa), preenchimento2(0.0f),
+          especular(luz.especular), preenchimento3(0.0f) {}
+};
+
+struct LuzPontualStd140 {
+    glm::vec3 posicao;
+    float preenchimento0;
+    glm::vec3 ambiente;
+    float preenchimento1;
+    glm::vec3 difusa;
+    float preenchimento2;
+    glm::vec3 especular;
+    float constante;   // no resto do vec3
+    float linear;
+    float quadratica;
+    float preenchimento3[2];
+
+    LuzPontualStd140() = default;
+    explicit LuzPontualStd140(const LuzPontual& luz)
+        : posicao(luz.posicao), preenchimento0(0.0f),
+          ambiente(luz.ambiente), preenchimento1(0.0f),
+          difusa(luz.difusa), preenchimento2(0.0f),
+          especular(luz.especular), constante(luz.constante),
+          linear(luz.linear), quadratica(luz.quadratica), preenchimento3{0.0f, 0.0f} {}
+};
+
+struct MaterialStd140 {
+    glm::vec3 ambiente;
+    float preenchimento0;
+    glm::vec3 difusa;
+    float preenchimento1;
+    glm::vec3 especular;
+    float brilho;
+
+    MaterialStd140() = default;
+    explicit MaterialStd140(const Material& material)
+        : ambiente(material.ambiente), preenchimento0(0.0f),
+          difusa(material.difusa), preenchimento1(0.0f),
+          especular(material.especular), brilho(material.brilho) {}
+};
+
+struct BlocoLuzes {
+    LuzDirecionalStd140 luzDirecional;
+    LuzPontualStd140 luzesPontuais[MAXIMO_LUZES_PONTUAIS];
+    GLint numLuzesPontuais;
+    GLint preenchimento[3];
+};
+
+struct BlocoMateriais {
+    MaterialStd140 materiais[MAXIMO_MATERIAIS];
+};
+
+// deslocamentos pelas regras do std140 (seção 7.6.2.2 da especificação 4.6)
+static_assert(offsetof(BlocoCamera, visao) == 64 && offsetof(BlocoCamera, posicaoObservador) == 128 &&
+              offsetof(BlocoCamera, projecaoVisao) == 144 && sizeof(BlocoCamera) == 208,
+              "BlocoCamera fora do std140");
+static_assert(offsetof(LuzDirecionalStd140, ambiente) == 16 && offsetof(LuzDirecionalStd140, especular) == 48 &&
+              sizeof(LuzDirecionalStd140) == 64, "LuzDirecional fora do std140");
+static_assert(offsetof(LuzPontualStd140, especular) == 48 && offsetof(LuzPontualStd140, constante) == 60 &&
+              offsetof(LuzPontualStd140, quadratica) == 68 && sizeof(LuzPontualStd140) == 80,
+              "LuzPontual fora do std140");
+static_assert(offsetof(MaterialStd140, especular) == 32 && offsetof(MaterialStd140, brilho) == 44 &&
+              sizeof(MaterialStd140) == 48, "Material fora do std140");
+static_assert(offsetof(BlocoLuzes, luzesPontuais) == 64 &&
+              offsetof(BlocoLuzes, numLuzesPontuais) == 64 + 80 * MAXIMO_LUZES_PONTUAIS,
+              "BlocoLuzes fora do std140");
+static_assert(sizeof(BlocoMateriais) == 48 * MAXIMO_MATERIAIS, "BlocoMateriais fora do std140");
+
+// Um UBO do tamanho de T, ligado a um ponto fixo; enviar() troca o conteúdo
+// inteiro com um glBufferSubData.
+template <typename T>
+class BufferUniform {
+public:
+    void iniciar(GLuint ponto) {
+        buffer.gerar();
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, ponto, buffer);
+    }
+
+    void enviar(const T& dados) {
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &dados);
+    }
+
+private:
+    BufferGL buffer;
+};
+
+namespace blocos {
+
+struct Membro {
+    std::string nome;   // como o OpenGL lista: "luzesPontuais[1].constante"
+    size_t deslocamento;
+};
+
+// Confere o deslocamento que o driver informa para cada membro contra o do
+// espelho em C++. Com std140 não deveria haver diferença; o teste pega
+// shader e struct que deixaram de andar juntos.
+inline bool conferir(const Shader& shader, const char* bloco, size_t tamanho, const std::vector<Membro>& membros) {
+    GLuint indice = glGetUniformBlockIndex(shader.idPrograma, bloco);
+    if (indice == GL_INVALID_INDEX) return true;
+
+    bool certo = true;
+    GLint tamanhoGLSL = 0;
+    glGetActiveUniformBlockiv(shader.idPrograma, indice, GL_UNIFORM_BLOCK_DATA_SIZE, &tamanhoGLSL);
+    if ((size_t)tamanhoGLSL > tamanho) {
+        std::cout << "ERRO::UBO::TAMANHO::" << bloco << " (GLSL " << tamanhoGLSL << ", C++ " << tamanho << ")"
+                  << std::endl;
+        certo = false;
+    }
+    for (const Membro& membro : membros) {
+        const GLchar* nome = membro.nome.c_str();
+        GLuint indiceMembro = GL_INVALID_INDEX;
+        glGetUniformIndices(shader.idPrograma, 1, &nome, &indiceMembro);
+        if (indiceMembro == GL_INVALID_INDEX) continue;
+        GLint deslocamento = -1;
+        glGetActiveUniformsiv(shader.idPrograma, 1, &indiceMembro, GL_UNIFORM_OFFSET, &deslocamento);
+        if ((size_t)deslocamento != membro.deslocamento) {
+            std::cout << "ERRO::UBO::LAYOUT::" << bloco << "::" << membro.nome << " (GLSL " << deslocamento
+                      << ", C++ " << membro.deslocamento << ")" << std::endl;
+            certo = false;
+        }
+    }
+    return certo;
+}
+
+// Membros de cada bloco, pelos nomes que o OpenGL lista, com o deslocamento
+// do espelho em C++.
+inline std::vector<Membro> membrosCamera() {
+    return {
+        {"projecao", offsetof(BlocoCamera, projecao)},
+        {"visao", offsetof(BlocoCamera, visao)},
+        {"posicaoObservador", offsetof(BlocoCamera, posicaoObservador)},
+        {"projecaoVisao", offsetof(BlocoCamera, projecaoVisao)},
+    };
+}
+
+inline std::vector<Membro> membrosLuzes() {
+    std::vector<Membro> luzes = {
+        {"luzDirecional.direcao", offsetof(LuzDirecionalStd140, direcao)},
+        {"luzDirecional.ambiente", offsetof(LuzDirecionalStd140, ambiente)},
+        {"luzDirecional.difusa", offsetof(LuzDirecionalStd140, difusa)},
+        {"luzDirecional.especular", offsetof(LuzDirecionalStd140, especular)},
+        {"numLuzesPontuais", offsetof(BlocoLuzes, numLuzesPontuais)},
+    };
+    for (int i = 0; i < MAXIMO_LUZES_PONTUAIS; i++) {
+        std::string base = "luzesPontuais[" + std::to_string(i) + "].";
+        size_t inicio = offsetof(BlocoLuzes, luzesPontuais) + i * sizeof(LuzPontualStd140);
+        luzes.push_back({base + "posicao", inicio + offsetof(LuzPontualStd140, posicao)});
+        luzes.push_back({base + "ambiente", inicio + offsetof(LuzPontualStd140, ambiente)});
+        luzes.push_back({base + "difusa", inicio + offsetof(LuzPontualStd140, difusa)});
+        luzes.push_back({base + "especular", inicio + offsetof(LuzPontualStd140, especular)});
+        luzes.push_back({base + "constante", inicio + offsetof(LuzPontualStd140, constante)});
+        luzes.push_back({base + "linear", inicio + offsetof(LuzPontualStd140, linear)});
+        luzes.push_back({base + "quadratica", inicio + offsetof(LuzPontualStd140, quadratica)});
+    }
+    return luzes;
+}
+
+inline std::vector<Membro> membrosMateriais() {
+    std::vector<Membro> materiais;
+    for (int m = 0; m < MAXIMO_MATERIAIS; m++) {
+        std::string base = "materiais[" + std::to_string(m) + "].";
+        size_t inicio = m * sizeof(MaterialStd140);
+        materiais.push_back({base + "ambiente", inicio + offsetof(MaterialStd140, ambiente)});
+        materiais.push_back({base + "difusa", inicio + offsetof(MaterialStd140, difusa)});
+        materiais.push_back({base + "especular", inicio + offsetof(MaterialStd140, especular)});
+        materiais.push_back({base + "brilho", inicio + offsetof(MaterialStd140, brilho)});
+    }
+    return materiais;
+}
+
+// Liga os blocos que o programa declara aos pontos fixos e confere o layout;
+// false se algum bloco não bate com o espelho. O GLSL 330 não aceita
+// layout(binding = n) em blocos, por isso a ligação é feita aqui, uma vez
+// por programa.
+inline bool vincular(const Shader& shader) {
+    const char* nomes[3] = {"BlocoCamera", "BlocoLuzes", "BlocoMateriais"};
+    const GLuint pontos[3] = {PONTO_BLOCO_CAMERA, PONTO_BLOCO_LUZES, PONTO_BLOCO_MATERIAIS};
+    for (int b = 0; b < 3; b++) {
+        GLuint indice = glGetUniformBlockIndex(shader.idPrograma, nomes[b]);
+        if (indice != GL_INVALID_INDEX) glUniformBlockBinding(shader.idPrograma, indice, pontos[b]);
+    }
+
+    bool certo = conferir(shader, "BlocoCamera", sizeof(BlocoCamera), membrosCamera());
+    certo = conferir(shader, "BlocoLuzes", sizeof(BlocoLuzes), membrosLuzes()) && certo;
+    certo = conferir(shader, "BlocoMateriais", sizeof(BlocoMateriais), membrosMateriais()) && certo;
+    return certo;
+}
+}
+
+#endif
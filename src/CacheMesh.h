@@ -0,0 +1,431 @@
+#ifndef CACHE_MESH_H
+#define CACHE_MESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "Mesh.h"
+#include "LOD.h"
+#include "Paralelo.h"
+#include "ArquivoMapeado.h"
+#include "Hash.h"
+
+// Cache binário de meshes já no formato da GPU. Carregar é mapear o arquivo e
+// passar os ponteiros do mapeamento para glBufferData, sem parse nem cópia
+// intermediária.
+//
+// Layout (little-endian, versão 2):
+//
+//   CabecalhoCacheMesh
+//   NivelCacheMesh[numNiveis]       formato, contagens, AABB, quantização, deslocamentos
+//   vértices e índices de cada nível, alinhados em 16 bytes
+//
+// O cabeçalho guarda tamanho, data de modificação e hash do conteúdo do
+// arquivo de origem. Se tamanho e data batem o cache é usado direto; se só a
+// data mudou o hash decide. Guarda também o hash dos parâmetros de montagem
+// (ParametrosCacheMesh): o mesmo arquivo lido com outro formato, sem
+// otimização ou com outra cadeia de LOD gera outro conteúdo, e um cache
+// gravado de um jeito não serve para o outro.
+
+const uint32_t VERSAO_CACHE_MESH = 2;
+
+struct CabecalhoCacheMesh {
+    char magica[4];             // "SVGM"
+    uint32_t versao;
+    uint64_t hashOrigem;
+    uint64_t tamanhoOrigem;
+    int64_t modificacaoOrigem;
+    uint64_t tamanhoArquivo;    // detecta arquivo truncado
+    uint64_t hashParametros;    // ParametrosCacheMesh::hash()
+    uint32_t numNiveis;
+    uint32_t reservado;
+};
+
+struct NivelCacheMesh {
+    uint8_t posicao, normal, uv;    // FormatoPosicao/FormatoNormal/FormatoUV
+    uint8_t reinicioPrimitiva;
+    uint32_t tamanhoVertice;        // conferido com LayoutVertice::para(formato)
+    uint32_t tipoIndice;            // GL_UNSIGNED_BYTE/SHORT/INT
+    uint32_t primitiva;             // GL_TRIANGLES / GL_TRIANGLE_STRIP
+    float pixelsMinimos;            // limiar do GrupoLOD
+    uint32_t normalOctaedrica;
+    float limiteMin[3], limiteMax[3];
+    float quantOrigem[3], quantEscala[3];
+    uint64_t numVertices, numIndices;
+    uint64_t deslocVertices, deslocIndices;   // a partir do início do arquivo
+};
+
+static_assert(sizeof(CabecalhoCacheMesh) == 56, "layout do cabeçalho do cache mudou");
+static_assert(sizeof(NivelCacheMesh) == 104, "layout do nível do cache mudou");
+
+struct EstatisticasCacheMesh {
+    bool acerto = false;
+    bool hashCalculado = false;     // a data mudou e o conteúdo foi conferido
+    size_t bytes = 0;
+    double segundos = 0.0;
+};
+
+namespace cache {
+
+const size_t ALINHAMENTO = 16;
+const size_t BYTES_POR_BLOCO_HASH = size_t(16) << 20;
+
+inline bool sistemaLittleEndian() {
+    uint16_t x = 1;
+    unsigned char primeiro;
+    std::memcpy(&primeiro, &x, 1);
+    return primeiro == 1;
+}
+
+inline size_t alinhar(size_t n) {
+    return (n + ALINHAMENTO - 1) & ~(ALINHAMENTO - 1);
+}
+
+// Blocos de tamanho fixo hasheados em paralelo e combinados; o resultado não
+// depende do número de threads.
+inline uint64_t hashConteudo(const char* dados, size_t tamanho) {
+    size_t numBlocos = (tamanho + BYTES_POR_BLOCO_HASH - 1) / BYTES_POR_BLOCO_HASH;
+    std::vector<uint64_t> hashes(numBlocos);
+    paraleloEmBlocos(numBlocos, 1, [&](size_t inicio, size_t fim) {
+        for (size_t b = inicio; b < fim; b++) {
+            size_t deslocamento = b * BYTES_POR_BLOCO_HASH;
+            hashes[b] = hashFNV(dados + deslocamento, std::min(BYTES_POR_BLOCO_HASH, tamanho - deslocamento));
+        }
+    });
+    uint64_t tamanho64 = tamanho;
+    return hashFNV(hashes.data(), hashes.size() * sizeof(uint64_t), hashFNV(&tamanho64, sizeof(tamanho64)));
+}
+
+}
+
+// Como a mesh foi montada a partir da origem: formato na GPU, otimização
+// para o cache de vértices, topologia e a cadeia de LOD depois do nível 0.
+struct ParametrosCacheMesh {
+    FormatoVertice formato;
+    bool otimizar = true;
+    Topologia topologia = Topologia::Triangulos;
+    std::vector<NivelSimplificado> niveis;
+    float erroMaximo = 0.05f;   // da simplificação, só conta com niveis
+
+    // campo a campo, sem o preenchimento das structs
+    uint64_t hash() const {
+        using cache::hashFNV;
+        uint8_t campos[5] = {(uint8_t)formato.posicao, (uint8_t)formato.normal, (uint8_t)formato.uv,
+                             (uint8_t)(otimizar ? 1 : 0), (uint8_t)topologia};
+        uint64_t h = hashFNV(campos, sizeof(campos));
+        uint64_t numNiveis = niveis.size();
+        h = hashFNV(&numNiveis, sizeof(numNiveis), h);
+        for (const NivelSimplificado& n : niveis) {
+            h = hashFNV(&n.fracaoTriangulos, sizeof(float), h);
+            h = hashFNV(&n.pixelsMinimos, sizeof(float), h);
+        }
+        if (!niveis.empty()) h = hashFNV(&erroMaximo, sizeof(float), h);
+        return h;
+    }
+};
+
+// Identidade do que gerou o cache: um arquivo (tamanho, data e hash calculado
+// sob demanda) ou uma chave qualquer, como os parâmetros de uma mesh procedural.
+struct OrigemCache {
+    std::string caminho;        // vazio para chave
+    uint64_t tamanho = 0;
+    int64_t modificacao = 0;
+    uint64_t hash = 0;
+    bool temHash = false;
+    bool valida = false;
+    uint64_t parametros = 0;    // ParametrosCacheMesh::hash()
+
+    static OrigemCache arquivo(const std::string& caminho,
+                               const ParametrosCacheMesh& parametros = ParametrosCacheMesh()) {
+        OrigemCache origem;
+        origem.caminho = caminho;
+        origem.parametros = parametros.hash();
+        std::error_code erro;
+        uintmax_t tamanho = std::filesystem::file_size(caminho, erro);
+        if (erro) return origem;
+        auto data = std::filesystem::last_write_time(caminho, erro);
+        if (erro) return origem;
+        origem.tamanho = tamanho;
+        origem.modificacao = (int64_t)data.time_since_epoch().count();
+        origem.valida = true;
+        return origem;
+    }
+
+    static OrigemCache chave(const void* dados, size_t bytes,
+                             const ParametrosCacheMesh& parametros = ParametrosCacheMesh()) {
+        OrigemCache origem;
+        origem.parametros = parametros.hash();
+        origem.tamanho = bytes;
+        origem.hash = cache::hashFNV(dados, bytes);
+        origem.temHash = true;
+        origem.valida = true;
+        return origem;
+    }
+
+    bool calcularHash() {
+        if (temHash) return true;
+        ArquivoMapeado arquivo;
+        if (!arquivo.abrir(caminho)) return false;
+        hash = cache::hashConteudo(arquivo.dados, arquivo.tamanho);
+        temHash = true;
+        return true;
+    }
+};
+
+// Grava os níveis no cache. As meshes precisam ter vertices/indices na CPU
+// (não servem meshes carregadas do próprio cache).
+inline bool salvarCacheMesh(const std::string& caminhoCache, OrigemCache& origem,
+                            const std::vector<const Mesh*>& niveis, const std::vector<float>& pixelsMinimos) {
+    using namespace cache;
+
+    if (!sistemaLittleEndian()) return false;
+    if (!origem.valida || !origem.calcularHash()) {
+        std::cout << "ERRO::CACHE::ORIGEM_INVALIDA: " << origem.caminho << std::endl;
+        return false;
+    }
+
+    std::vector<NivelCacheMesh> tabela(niveis.size());
+    std::vector<std::vector<unsigned char>> dadosVertices(niveis.size()), dadosIndices(niveis.size());
+
+    size_t deslocamento = alinhar(sizeof(CabecalhoCacheMesh) + tabela.size() * sizeof(NivelCacheMesh));
+
+    for (size_t n = 0; n < niveis.size(); n++) {
+        const Mesh& mesh = *niveis[n];
+        if (mesh.vertices.size() != (size_t)mesh.numVertices || mesh.indices.size() != (size_t)mesh.numIndices) {
+            std::cout << "ERRO::CACHE::MESH_SEM_DADOS_NA_CPU: nivel " << n << std::endl;
+            return false;
+        }
+
+        NivelCacheMesh& nivel = tabela[n];
+        std::memset(&nivel, 0, sizeof(nivel));
+        nivel.posicao = (uint8_t)mesh.formato.posicao;
+        nivel.normal = (uint8_t)mesh.formato.normal;
+        nivel.uv = (uint8_t)mesh.formato.uv;
+        nivel.reinicioPrimitiva = mesh.reinicioPrimitiva ? 1 : 0;
+        nivel.tamanhoVertice = (uint32_t)mesh.layout.tamanhoVertice;
+        nivel.tipoIndice = mesh.tipoIndice;
+        nivel.primitiva = mesh.primitiva;
+        nivel.pixelsMinimos = n < pixelsMinimos.size() ? pixelsMinimos[n] : 0.0f;
+        nivel.normalOctaedrica = mesh.quantizacao.normalOctaedrica ? 1 : 0;
+        for (int c = 0; c < 3; c++) {
+            nivel.limiteMin[c] = mesh.limiteMin[c];
+            nivel.limiteMax[c] = mesh.limiteMax[c];
+            nivel.quantOrigem[c] = mesh.quantizacao.origem[c];
+            nivel.quantEscala[c] = mesh.quantizacao.escala[c];
+        }
+        nivel.numVertices = mesh.vertices.size();
+        nivel.numIndices = mesh.indices.size();
+
+        // mesmos bytes que foram para a GPU
+        if (mesh.formato.padrao()) {
+            dadosVertices[n].resize(mesh.vertices.size() * sizeof(Vertice));
+            std::memcpy(dadosVertices[n].data(), mesh.vertices.data(), dadosVertices[n].size());
+        } else {
+            Quantizacao quant;
+            dadosVertices[n] = empacotarVertices(mesh.vertices, mesh.formato, mesh.layout,
+                                                 mesh.limiteMin, mesh.limiteMax, quant);
+        }
+        dadosIndices[n] = converterIndices(mesh.indices, mesh.tipoIndice);
+
+        nivel.deslocVertices = deslocamento;
+        deslocamento = alinhar(deslocamento + dadosVertices[n].size());
+        nivel.deslocIndices = deslocamento;
+        deslocamento = alinhar(deslocamento + dadosIndices[n].size());
+    }
+
+    CabecalhoCacheMesh cabecalho;
+    std::memset(&cabecalho, 0, sizeof(cabecalho));
+    std::memcpy(cabecalho.magica, "SVGM", 4);
+    cabecalho.versao = VERSAO_CACHE_MESH;
+    cabecalho.hashOrigem = origem.hash;
+    cabecalho.tamanhoOrigem = origem.tamanho;
+    cabecalho.modificacaoOrigem = origem.modificacao;
+    cabecalho.tamanhoArquivo = deslocamento;
+    cabecalho.hashParametros = origem.parametros;
+    cabecalho.numNiveis = (uint32_t)tabela.size();
+
+    // grava num temporário só desta gravação e renomeia, para nunca deixar
+    // um cache pela metade
+    std::string temporario = caminhoTemporario(caminhoCache);
+    {
+        std::ofstream saida(temporario, std::ios::binary | std::ios::trunc);
+        if (!saida) {
+            std::cout << "ERRO::CACHE::ARQUIVO_NAO_CRIADO: " << temporario << std::endl;
+            return false;
+        }
+
+        const char zeros[ALINHAMENTO] = {};
+        size_t escritos = 0;
+        auto escrever = [&](const void* dados, size_t bytes) {
+            saida.write(static_cast<const char*>(dados), (std::streamsize)bytes);
+            escritos += bytes;
+        };
+        auto preencherAte = [&](size_t alvo) {
+            escrever(zeros, alvo - escritos);
+        };
+
+        escrever(&cabecalho, sizeof(cabecalho));
+        escrever(tabela.data(), tabela.size() * sizeof(NivelCacheMesh));
+        for (size_t n = 0; n < tabela.size(); n++) {
+            preencherAte(tabela[n].deslocVertices);
+            escrever(dadosVertices[n].data(), dadosVertices[n].size());
+            preencherAte(tabela[n].deslocIndices);
+            escrever(dadosIndices[n].data(), dadosIndices[n].size());
+        }
+        preencherAte(deslocamento);
+
+        if (!saida) {
+            std::cout << "ERRO::CACHE::FALHA_NA_ESCRITA: " << temporario << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code erro;
+    std::filesystem::rename(temporario, caminhoCache, erro);
+    if (erro) {
+        std::cout << "ERRO::CACHE::FALHA_AO_RENOMEAR: " << erro.message() << std::endl;
+        std::filesystem::remove(temporario, erro);
+        return false;
+    }
+    return true;
+}
+
+inline bool salvarCacheMesh(const std::string& caminhoCache, OrigemCache& origem, const Mesh& mesh) {
+    return salvarCacheMesh(caminhoCache, origem, std::vector<const Mesh*>{&mesh}, std::vector<float>{0.0f});
+}
+
+inline bool salvarCacheMesh(const std::string& caminhoCache, OrigemCache& origem, const GrupoLOD& grupo) {
+    std::vector<const Mesh*> niveis;
+    for (const Mesh& mesh : grupo.niveis) niveis.push_back(&mesh);
+    return salvarCacheMesh(caminhoCache, origem, niveis, grupo.pixelsMinimos);
+}
+
+namespace cache {
+
+inline bool carregarNiveis(const std::string& caminhoCache, OrigemCache& origem, GrupoLOD& grupo,
+                           EstatisticasCacheMesh* estatisticas, size_t maximoNiveis) {
+    auto relogioInicio = std::chrono::steady_clock::now();
+
+    if (!sistemaLittleEndian() || !origem.valida) return false;
+
+    ArquivoMapeado arquivo;
+    if (!arquivo.abrir(caminhoCache)) return false;
+    if (arquivo.tamanho < sizeof(CabecalhoCacheMesh)) return false;
+
+    CabecalhoCacheMesh cabecalho;
+    std::memcpy(&cabecalho, arquivo.dados, sizeof(cabecalho));
+    if (std::memcmp(cabecalho.magica, "SVGM", 4) != 0 || cabecalho.versao != VERSAO_CACHE_MESH)
+        return false;
+
+    if (cabecalho.tamanhoOrigem != origem.tamanho || cabecalho.hashParametros != origem.parametros) return false;
+    bool hashCalculado = false;
+    if (origem.caminho.empty() || cabecalho.modificacaoOrigem != origem.modificacao) {
+        hashCalculado = !origem.temHash;
+        if (!origem.calcularHash() || origem.hash != cabecalho.hashOrigem) return false;
+    }
+
+    size_t fimTabela = sizeof(CabecalhoCacheMesh) + (size_t)cabecalho.numNiveis * sizeof(NivelCacheMesh);
+    if (cabecalho.tamanhoArquivo != arquivo.tamanho || fimTabela > arquivo.tamanho) {
+        std::cout << "ERRO::CACHE::ARQUIVO_CORROMPIDO: " << caminhoCache << std::endl;
+        return false;
+    }
+
+    std::vector<NivelCacheMesh> tabela(cabecalho.numNiveis);
+    std::memcpy(tabela.data(), arquivo.dados + sizeof(CabecalhoCacheMesh), tabela.size() * sizeof(NivelCacheMesh));
+
+    // valida tudo antes de tocar na GPU
+    for (const NivelCacheMesh& nivel : tabela) {
+        bool valido = nivel.posicao <= (uint8_t)FormatoPosicao::Snorm16 &&
+                      nivel.normal <= (uint8_t)FormatoNormal::Int2101010 &&
+                      nivel.uv <= (uint8_t)FormatoUV::Half &&
+                      (nivel.tipoIndice == GL_UNSIGNED_BYTE || nivel.tipoIndice == GL_UNSIGNED_SHORT ||
+                       nivel.tipoIndice == GL_UNSIGNED_INT) &&
+                      (nivel.primitiva == GL_TRIANGLES || nivel.primitiva == GL_TRIANGLE_STRIP);
+        if (valido) {
+            FormatoVertice formato;
+            formato.posicao = (FormatoPosicao)nivel.posicao;
+            formato.normal = (FormatoNormal)nivel.normal;
+            formato.uv = (FormatoUV)nivel.uv;
+            valido = (GLsizei)nivel.tamanhoVertice == LayoutVertice::para(formato).tamanhoVertice &&
+                     nivel.numVertices <= INT32_MAX && nivel.numIndices <= INT32_MAX;
+        }
+        if (valido) {
+            // contagens já limitadas, os produtos não estouram; as somas com o
+            // deslocamento (que vem do arquivo) poderiam, daí a subtração
+            uint64_t bytesVertices = nivel.numVertices * nivel.tamanhoVertice;
+            uint64_t bytesIndices = nivel.numIndices * tamanhoTipoIndice(nivel.tipoIndice);
+            uint64_t tamanho = arquivo.tamanho;
+            valido = nivel.deslocVertices <= tamanho && bytesVertices <= tamanho - nivel.deslocVertices &&
+                     nivel.deslocIndices <= tamanho && bytesIndices <= tamanho - nivel.deslocIndices;
+        }
+        if (!valido) {
+            std::cout << "ERRO::CACHE::ARQUIVO_CORROMPIDO: " << caminhoCache << std::endl;
+            return false;
+        }
+    }
+
+    GrupoLOD novo;
+    for (size_t n = 0; n < tabela.size() && n < maximoNiveis; n++) {
+        const NivelCacheMesh& nivel = tabela[n];
+        FormatoVertice formato;
+        formato.posicao = (FormatoPosicao)nivel.posicao;
+        formato.normal = (FormatoNormal)nivel.normal;
+        formato.uv = (FormatoUV)nivel.uv;
+
+        Quantizacao quant;
+        quant.origem = glm::vec3(nivel.quantOrigem[0], nivel.quantOrigem[1], nivel.quantOrigem[2]);
+        quant.escala = glm::vec3(nivel.quantEscala[0], nivel.quantEscala[1], nivel.quantEscala[2]);
+        quant.normalOctaedrica = nivel.normalOctaedrica != 0;
+
+        Mesh mesh;
+        mesh.primitiva = nivel.primitiva;
+        mesh.reinicioPrimitiva = nivel.reinicioPrimitiva != 0;
+        mesh.enviarEmpacotado(formato, arquivo.dados + nivel.deslocVertices, (size_t)nivel.numVertices,
+                              arquivo.dados + nivel.deslocIndices, nivel.tipoIndice, (size_t)nivel.numIndices,
+                              glm::vec3(nivel.limiteMin[0], nivel.limiteMin[1], nivel.limiteMin[2]),
+                              glm::vec3(nivel.limiteMax[0], nivel.limiteMax[1], nivel.limiteMax[2]),
+                              quant);
+        novo.adicionarNivel(std::move(mesh), nivel.pixelsMinimos);
+    }
+    grupo = std::move(novo);
+
+    if (estatisticas) {
+        estatisticas->acerto = true;
+        estatisticas->hashCalculado = hashCalculado;
+        estatisticas->bytes = arquivo.tamanho;
+        estatisticas->segundos =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - relogioInicio).count();
+    }
+    return true;
+}
+
+}
+
+// Carrega os níveis do cache direto do mapeamento para a GPU. Devolve false
+// sem mensagem quando o cache não existe ou está desatualizado (o chamador
+// reconstrói); cache corrompido é reportado.
+inline bool carregarCacheMesh(const std::string& caminhoCache, OrigemCache& origem, GrupoLOD& grupo,
+                              EstatisticasCacheMesh* estatisticas = nullptr) {
+    return cache::carregarNiveis(caminhoCache, origem, grupo, estatisticas, SIZE_MAX);
+}
+
+// Só o nível 0.
+inline bool carregarCacheMesh(const std::string& caminhoCache, OrigemCache& origem, Mesh& mesh,
+                              EstatisticasCacheMesh* estatisticas = nullptr) {
+    GrupoLOD grupo;
+    if (!cache::carregarNiveis(caminhoCache, origem, grupo, estatisticas, 1) || grupo.niveis.empty())
+        return false;
+    mesh = std::move(grupo.niveis[0]);
+    return true;
+}
+
+#endif
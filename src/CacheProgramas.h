@@ -0,0 +1,196 @@
+#ifndef CACHE_PROGRAMAS_H
+#define CACHE_PROGRAMAS_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "ExtensoesGL.h"
+#include "ArquivoMapeado.h"
+#include "Hash.h"
+
+// Cache em disco de programas já linkados (glGetProgramBinary /
+// glProgramBinary), para a partida não recompilar GLSL. Um arquivo por
+// combinação de fontes e definições:
+//
+//   CabecalhoCachePrograma
+//   binário do driver (tamanhoBinario bytes)
+//
+// A chave no cabeçalho junta o texto das fontes, as definições, fabricante,
+// renderer e versão do driver e a lista de formatos de binário que ele
+// aceita. Chave diferente é entrada velha e o programa é recompilado e
+// regravado; tamanho ou hash do binário errados são arquivo corrompido. O
+// driver ainda pode recusar um binário que parecia válido, e aí também se
+// compila.
+
+const uint32_t VERSAO_CACHE_PROGRAMA = 1;
+
+struct CabecalhoCachePrograma {
+    char magica[4];          // "SVGP"
+    uint32_t versao;
+    uint64_t chave;          // fontes, definições e driver
+    uint64_t hashBinario;
+    uint32_t formato;        // o binaryFormat devolvido por glGetProgramBinary
+    uint32_t tamanhoBinario;
+};
+
+static_assert(sizeof(CabecalhoCachePrograma) == 32, "layout do cabeçalho do cache de programas mudou");
+
+struct EstatisticasCacheProgramas {
+    size_t carregados = 0;   // aceitos pelo driver
+    size_t compilados = 0;   // sem cache, entrada velha ou corrompida, ou recusada
+    size_t recusados = 0;    // dentro de compilados: o driver não aceitou o binário
+    size_t gravados = 0;
+    double segundos = 0.0;   // construção dos Shader, com leitura das fontes
+};
+
+struct ChaveCachePrograma {
+    std::string caminho;   // vazio: sem cache (driver sem formatos de binário)
+    uint64_t hash = 0;
+};
+
+namespace cache {
+
+inline std::string diretorioProgramas = "shaders/cache";
+
+// Fabricante, renderer, versão e formatos aceitos; muda quando o driver é
+// atualizado ou a placa é trocada.
+inline uint64_t hashDriver() {
+    static uint64_t hash = 0;
+    if (hash != 0) return hash;
+    uint64_t h = hashFNV("SVGP", 4);
+    for (GLenum nome : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+        const char* texto = (const char*)glGetString(nome);
+        if (texto) h = hashFNV(texto, std::strlen(texto) + 1, h);
+    }
+    std::vector<GLint> formatos(std::max(ExtensoesGL::formatosBinario, 0));
+    if (!formatos.empty()) glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formatos.data());
+    h = hashFNV(formatos.data(), formatos.size() * sizeof(GLint), h);
+    hash = h;
+    return hash;
+}
+
+inline bool formatoAceito(GLenum formato) {
+    std::vector<GLint> formatos(std::max(ExtensoesGL::formatosBinario, 0));
+    if (!formatos.empty()) glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formatos.data());
+    return std::find(formatos.begin(), formatos.end(), (GLint)formato) != formatos.end();
+}
+
+}
+
+// O nome do arquivo sai dos caminhos e das definições, para cada variante ter
+// o seu; o hash, do conteúdo. Assim uma fonte editada regrava o mesmo arquivo
+// em vez de acumular entradas.
+inline ChaveCachePrograma chaveCachePrograma(const std::vector<std::string>& caminhos,
+                                             const std::vector<std::string>& fontes, const std::string& definicoes) {
+    using namespace cache;
+
+    ChaveCachePrograma chave;
+    if (!ExtensoesGL::temBinarioPrograma() || caminhos.empty()) return chave;
+
+    uint64_t nome = hashFNV(definicoes.data(), definicoes.size());
+    for (const std::string& caminho : caminhos) nome = hashFNV(caminho.data(), caminho.size() + 1, nome);
+    char hexa[17];
+    std::snprintf(hexa, sizeof(hexa), "%016llx", (unsigned long long)nome);
+    chave.caminho = diretorioProgramas + "/" + std::filesystem::path(caminhos[0]).stem().string() + "-" + hexa + ".bin";
+
+    uint64_t h = hashFNV(definicoes.data(), definicoes.size(), hashDriver());
+    for (const std::string& fonte : fontes) {
+        uint64_t tamanho = fonte.size();
+        h = hashFNV(&tamanho, sizeof(tamanho), h);
+        h = hashFNV(fonte.data(), fonte.size(), h);
+    }
+    chave.hash = h;
+    return chave;
+}
+
+// Passa o binário do mapeamento direto para glProgramBinary. Devolve false
+// sem mensagem quando não há entrada ou ela é velha; arquivo corrompido é
+// reportado. recusado indica que o driver rejeitou o binário: o programa
+// ficou sem link e o chamador deve criar outro.
+inline bool carregarCachePrograma(GLuint programa, const ChaveCachePrograma& chave, bool& recusado) {
+    recusado = false;
+    if (chave.caminho.empty()) return false;
+
+    ArquivoMapeado arquivo;
+    if (!arquivo.abrir(chave.caminho) || arquivo.tamanho < sizeof(CabecalhoCachePrograma)) return false;
+
+    CabecalhoCachePrograma cabecalho;
+    std::memcpy(&cabecalho, arquivo.dados, sizeof(cabecalho));
+    if (std::memcmp(cabecalho.magica, "SVGP", 4) != 0 || cabecalho.versao != VERSAO_CACHE_PROGRAMA ||
+        cabecalho.chave != chave.hash)
+        return false;
+
+    const char* binario = arquivo.dados + sizeof(CabecalhoCachePrograma);
+    if (arquivo.tamanho != sizeof(CabecalhoCachePrograma) + (size_t)cabecalho.tamanhoBinario ||
+        cache::hashFNV(binario, cabecalho.tamanhoBinario) != cabecalho.hashBinario) {
+        std::cout << "ERRO::CACHE_PROGRAMA::ARQUIVO_CORROMPIDO: " << chave.caminho << std::endl;
+        return false;
+    }
+    if (!cache::formatoAceito(cabecalho.formato)) return false;
+
+    ExtensoesGL::programBinary(programa, cabecalho.formato, binario, (GLsizei)cabecalho.tamanhoBinario);
+    GLint sucesso = 0;
+    glGetProgramiv(programa, GL_LINK_STATUS, &sucesso);
+    recusado = !sucesso;
+    return sucesso != 0;
+}
+
+// Grava num temporário só desta gravação e renomeia, para outro processo
+// nunca ler um binário pela metade nem escrever no mesmo temporário. O programa precisa ter sido linkado com
+// GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+inline bool salvarCachePrograma(GLuint programa, const ChaveCachePrograma& chave) {
+    if (chave.caminho.empty()) return false;
+
+    GLint tamanho = 0;
+    glGetProgramiv(programa, GL_PROGRAM_BINARY_LENGTH, &tamanho);
+    if (tamanho <= 0) return false;
+    std::vector<char> binario((size_t)tamanho);
+    GLsizei escritos = 0;
+    GLenum formato = 0;
+    ExtensoesGL::getProgramBinary(programa, tamanho, &escritos, &formato, binario.data());
+    if (escritos <= 0) return false;
+
+    CabecalhoCachePrograma cabecalho;
+    std::memset(&cabecalho, 0, sizeof(cabecalho));
+    std::memcpy(cabecalho.magica, "SVGP", 4);
+    cabecalho.versao = VERSAO_CACHE_PROGRAMA;
+    cabecalho.chave = chave.hash;
+    cabecalho.hashBinario = cache::hashFNV(binario.data(), (size_t)escritos);
+    cabecalho.formato = formato;
+    cabecalho.tamanhoBinario = (uint32_t)escritos;
+
+    std::error_code erro;
+    std::filesystem::create_directories(cache::diretorioProgramas, erro);
+    std::string temporario = caminhoTemporario(chave.caminho);
+    {
+        std::ofstream saida(temporario, std::ios::binary | std::ios::trunc);
+        if (!saida) {
+            std::cout << "ERRO::CACHE_PROGRAMA::ARQUIVO_NAO_CRIADO: " << temporario << std::endl;
+            return false;
+        }
+        saida.write((const char*)&cabecalho, sizeof(cabecalho));
+        saida.write(binario.data(), escritos);
+        if (!saida) {
+            std::cout << "ERRO::CACHE_PROGRAMA::FALHA_NA_ESCRITA: " << temporario << std::endl;
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporario, chave.caminho, erro);
+    if (erro) {
+        std::cout << "ERRO::CACHE_PROGRAMA::FALHA_AO_RENOMEAR: " << erro.message() << std::endl;
+        std::filesystem::remove(temporario, erro);
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,862 @@
+#ifndef CARREGADOR_GLB_H
+#define CARREGADOR_GLB_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <utility>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#include "Mesh.h"
+#include "Light.h"
+#include "Shader.h"
+#include "FilaRenderizacao.h"
+#include "ArquivoMapeado.h"
+#include "CarregadorOBJ.h"
+
+// Importador de glTF 2.0 binário (.glb). O arquivo é mapeado; o JSON é lido
+// por um parser mínimo e o chunk BIN é usado direto do mapeamento.
+//
+// Cada primitiva vira uma Mesh. Quando os acessores já têm tipos que o
+// OpenGL entende (o caso comum: POSITION/NORMAL float, TEXCOORD_0 float ou
+// normalizado), a faixa do BIN com os atributos é enviada de uma vez e cada
+// atributo aponta para o seu bufferView com o stride e deslocamento do
+// acessor: sem reempacotar nem copiar. Sem normais, com acessor esparso ou
+// com a faixa muito maior que os dados, os vértices são lidos para Vertice e
+// passam pelo configurarMesh() normal; é nessa leitura que as substituições
+// de um acessor esparso (sparse.indices/values) entram sobre a base, que é o
+// bufferView ou zeros. Um sparse malformado descarta a primitiva com erro.
+//
+// Nós da cena viram instâncias (primitiva + matriz de mundo) e o material
+// metálico-rugoso é aproximado por um Material de Phong. Texturas, skins,
+// morph targets e buffers externos (uri) não são suportados.
+
+namespace json {
+
+struct Valor {
+    enum class Tipo { Nulo, Booleano, Numero, Texto, Lista, Objeto };
+
+    Tipo tipo = Tipo::Nulo;
+    bool booleano = false;
+    double numero = 0.0;
+    std::string texto;
+    std::vector<Valor> lista;
+    std::vector<std::pair<std::string, Valor>> membros;
+
+    const Valor* membro(const char* nome) const {
+        for (const auto& m : membros)
+            if (m.first == nome) return &m.second;
+        return nullptr;
+    }
+
+    double numeroOu(const char* nome, double padrao) const {
+        const Valor* v = membro(nome);
+        return v && v->tipo == Tipo::Numero ? v->numero : padrao;
+    }
+
+    // Números do JSON são double: fora da faixa de int, ou com parte
+    // fracionária, o valor é tratado como ausente.
+    int comoInteiro(int padrao) const {
+        if (tipo != Tipo::Numero || !(numero >= INT_MIN && numero <= INT_MAX) || numero != std::floor(numero))
+            return padrao;
+        return (int)numero;
+    }
+
+    int inteiroOu(const char* nome, int padrao) const {
+        const Valor* v = membro(nome);
+        return v ? v->comoInteiro(padrao) : padrao;
+    }
+
+    // Para contagens, deslocamentos e tamanhos: falso se o membro existe mas
+    // não é um inteiro não negativo representável exatamente (até 2^53).
+    bool tamanhoOu(const char* nome, size_t padrao, size_t& saida) const {
+        const Valor* v = membro(nome);
+        if (!v) {
+            saida = padrao;
+            return true;
+        }
+        if (v->tipo != Tipo::Numero || !(v->numero >= 0.0 && v->numero <= 9007199254740992.0) ||
+            v->numero != std::floor(v->numero))
+            return false;
+        saida = (size_t)v->numero;
+        return true;
+    }
+
+    size_t tamanho() const { return lista.size(); }
+    const Valor& operator[](size_t i) const { return lista[i]; }
+};
+
+// Descida recursiva sobre um texto terminado em '\0'.
+class Leitor {
+public:
+    explicit Leitor(const char* texto) : p(texto) {}
+
+    bool ler(Valor& saida) {
+        bool ok = valor(saida, 0);
+        pularEspacos();
+        return ok && *p == '\0';
+    }
+
+private:
+    static const int PROFUNDIDADE_MAXIMA = 64;
+    const char* p;
+
+    void pularEspacos() {
+        while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++;
+    }
+
+    bool literal(const char* palavra) {
+        size_t n = std::strlen(palavra);
+        if (std::strncmp(p, palavra, n) != 0) return false;
+        p += n;
+        return true;
+    }
+
+    bool valor(Valor& v, int profundidade) {
+        if (profundidade > PROFUNDIDADE_MAXIMA) return false;
+        pularEspacos();
+        switch (*p) {
+        case '{': return objeto(v, profundidade);
+        case '[': return lista(v, profundidade);
+        case '"': v.tipo = Valor::Tipo::Texto; return texto(v.texto);
+        case 't': v.tipo = Valor::Tipo::Booleano; v.booleano = true; return literal("true");
+        case 'f': v.tipo = Valor::Tipo::Booleano; v.booleano = false; return literal("false");
+        case 'n': v.tipo = Valor::Tipo::Nulo; return literal("null");
+        default: {
+            char* fim = nullptr;
+            v.numero = std::strtod(p, &fim);
+            if (fim == p) return false;
+            v.tipo = Valor::Tipo::Numero;
+            p = fim;
+            return true;
+        }
+        }
+    }
+
+    bool objeto(Valor& v, int profundidade) {
+        v.tipo = Valor::Tipo::Objeto;
+        p++;
+        pularEspacos();
+        if (*p == '}') { p++; return true; }
+        while (true) {
+            pularEspacos();
+            std::string nome;
+            if (*p != '"' || !texto(nome)) return false;
+            pularEspacos();
+            if (*p != ':') return false;
+            p++;
+            v.membros.emplace_back(std::move(nome), Valor());
+            if (!valor(v.membros.back().second, profundidade + 1)) return false;
+            pularEspacos();
+            if (*p == ',') { p++; continue; }
+            if (*p == '}') { p++; return true; }
+            return false;
+        }
+    }
+
+    bool lista(Valor& v, int profundidade) {
+        v.tipo = Valor::Tipo::Lista;
+        p++;
+        pularEspacos();
+        if (*p == ']') { p++; return true; }
+        while (true) {
+            v.lista.emplace_back();
+            if (!valor(v.lista.back(), profundidade + 1)) return false;
+            pularEspacos();
+            if (*p == ',') { p++; continue; }
+            if (*p == ']') { p++; return true; }
+            return false;
+        }
+    }
+
+    static void anexarUTF8(std::string& s, uint32_t c) {
+        if (c < 0x80) {
+            s += (char)c;
+        } else if (c < 0x800) {
+            s += (char)(0xC0 | (c >> 6));
+            s += (char)(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            s += (char)(0xE0 | (c >> 12));
+            s += (char)(0x80 | ((c >> 6) & 0x3F));
+            s += (char)(0x80 | (c & 0x3F));
+        } else {
+            s += (char)(0xF0 | (c >> 18));
+            s += (char)(0x80 | ((c >> 12) & 0x3F));
+            s += (char)(0x80 | ((c >> 6) & 0x3F));
+            s += (char)(0x80 | (c & 0x3F));
+        }
+    }
+
+    bool hex4(uint32_t& c) {
+        c = 0;
+        for (int i = 0; i < 4; i++) {
+            char h = *p++;
+            c <<= 4;
+            if (h >= '0' && h <= '9') c |= (uint32_t)(h - '0');
+            else if (h >= 'a' && h <= 'f') c |= (uint32_t)(h - 'a' + 10);
+            else if (h >= 'A' && h <= 'F') c |= (uint32_t)(h - 'A' + 10);
+            else return false;
+        }
+        return true;
+    }
+
+    bool texto(std::string& s) {
+        p++;   // aspas
+        while (*p != '"') {
+            if (*p == '\0') return false;
+            if (*p != '\\') {
+                s += *p++;
+                continue;
+            }
+            p++;
+            switch (*p++) {
+            case '"':  s += '"'; break;
+            case '\\': s += '\\'; break;
+            case '/':  s += '/'; break;
+            case 'b':  s += '\b'; break;
+            case 'f':  s += '\f'; break;
+            case 'n':  s += '\n'; break;
+            case 'r':  s += '\r'; break;
+            case 't':  s += '\t'; break;
+            case 'u': {
+                uint32_t c;
+                if (!hex4(c)) return false;
+                if (c >= 0xD800 && c < 0xDC00 && p[0] == '\\' && p[1] == 'u') {
+                    p += 2;
+                    uint32_t baixo;
+                    if (!hex4(baixo)) return false;
+                    c = 0x10000 + ((c - 0xD800) << 10) + (baixo - 0xDC00);
+                }
+                anexarUTF8(s, c);
+                break;
+            }
+            default: return false;
+            }
+        }
+        p++;
+        return true;
+    }
+};
+
+}
+
+struct EstatisticasGLB {
+    size_t bytesArquivo = 0;
+    size_t bytesEnviados = 0;       // vértices + índices na GPU
+    size_t primitivasDiretas = 0;   // enviadas do mapeamento, sem reempacotar
+    size_t primitivasReempacotadas = 0;
+    double segundos = 0.0;
+    size_t picoMemoria = 0;
+
+    // quanto foi para a GPU em relação ao arquivo (1.0 = sem sobra)
+    double proporcaoEnviada() const {
+        return bytesArquivo > 0 ? (double)bytesEnviados / bytesArquivo : 0.0;
+    }
+};
+
+// Uma cópia de uma primitiva na cena.
+struct InstanciaGLB {
+    size_t mesh;
+    glm::mat4 transformacao;
+};
+
+namespace glb {
+
+const uint32_t MAGICA = 0x46546C67;       // "glTF"
+const uint32_t CHUNK_JSON = 0x4E4F534A;
+const uint32_t CHUNK_BIN = 0x004E4942;
+
+// Envio direto só compensa se a faixa do BIN não tiver muito mais que os atributos.
+const size_t SOBRA_MAXIMA_FAIXA = 2;
+
+// Acessor já resolvido contra bufferView e BIN.
+struct Acessor {
+    const unsigned char* dados = nullptr;   // primeiro elemento
+    size_t deslocamento = 0;                // do primeiro elemento, a partir do início do BIN
+    size_t quantidade = 0;
+    int componentes = 0;
+    GLenum tipoComponente = 0;
+    bool normalizado = false;
+    size_t stride = 0;
+    size_t tamanhoElemento = 0;
+    bool esparso = false;                   // sem bufferView ou com sparse: só pelo reempacotamento
+    std::vector<uint32_t> indicesEsparsos;  // crescentes, cada um < quantidade
+    const unsigned char* valoresEsparsos = nullptr;   // um elemento por índice, sem stride
+    bool esparsoInvalido = false;
+    bool valido = false;
+};
+
+inline size_t tamanhoComponente(GLenum tipo) {
+    switch (tipo) {
+    case GL_BYTE: case GL_UNSIGNED_BYTE: return 1;
+    case GL_SHORT: case GL_UNSIGNED_SHORT: return 2;
+    case GL_UNSIGNED_INT: case GL_FLOAT: return 4;
+    default: return 0;
+    }
+}
+
+inline int componentesDoTipo(const std::string& tipo) {
+    if (tipo == "SCALAR") return 1;
+    if (tipo == "VEC2") return 2;
+    if (tipo == "VEC3") return 3;
+    if (tipo == "VEC4") return 4;
+    if (tipo == "MAT4") return 16;
+    return 0;
+}
+
+// Início e tamanho de um bufferView dentro do BIN (e o byteStride, 0 se ausente).
+inline bool faixaDaVista(const json::Valor& v, size_t tamanhoBin, size_t& inicio, size_t& tamanho, size_t& stride) {
+    if (v.inteiroOu("buffer", 0) != 0) return false;   // só o BIN do próprio .glb
+    if (!v.tamanhoOu("byteOffset", 0, inicio) || !v.tamanhoOu("byteLength", 0, tamanho) ||
+        !v.tamanhoOu("byteStride", 0, stride))
+        return false;
+    return inicio <= tamanhoBin && tamanho <= tamanhoBin - inicio;
+}
+
+// sparse.indices (inteiros sem sinal, estritamente crescentes) e sparse.values
+// (elementos do tipo do acessor, sem stride), conferidos contra o BIN
+inline bool resolverEsparso(const json::Valor& esparso, const json::Valor* vistas, const unsigned char* bin,
+                            size_t tamanhoBin, Acessor& a) {
+    size_t contagem;
+    const json::Valor* indices = esparso.membro("indices");
+    const json::Valor* valores = esparso.membro("values");
+    if (!esparso.tamanhoOu("count", 0, contagem) || contagem == 0 || contagem > a.quantidade || !indices ||
+        !valores || !vistas)
+        return false;
+
+    auto faixa = [&](const json::Valor& origem, size_t tamanhoElemento, const unsigned char*& dados) {
+        int vista = origem.inteiroOu("bufferView", -1);
+        size_t inicio, tamanho, stride, deslocamento;
+        if (vista < 0 || (size_t)vista >= vistas->tamanho() ||
+            !faixaDaVista((*vistas)[vista], tamanhoBin, inicio, tamanho, stride) ||
+            !origem.tamanhoOu("byteOffset", 0, deslocamento) || deslocamento > tamanho ||
+            contagem > (tamanho - deslocamento) / tamanhoElemento)
+            return false;
+        dados = bin + inicio + deslocamento;
+        return true;
+    };
+
+    GLenum tipoIndice = (GLenum)indices->inteiroOu("componentType", 0);
+    if (tipoIndice != GL_UNSIGNED_BYTE && tipoIndice != GL_UNSIGNED_SHORT && tipoIndice != GL_UNSIGNED_INT)
+        return false;
+    const unsigned char* dadosIndices;
+    if (!faixa(*indices, tamanhoComponente(tipoIndice), dadosIndices) ||
+        !faixa(*valores, a.tamanhoElemento, a.valoresEsparsos))
+        return false;
+
+    a.indicesEsparsos.resize(contagem);
+    for (size_t k = 0; k < contagem; k++) {
+        uint32_t i;
+        if (tipoIndice == GL_UNSIGNED_BYTE) {
+            i = dadosIndices[k];
+        } else if (tipoIndice == GL_UNSIGNED_SHORT) {
+            uint16_t s;
+            std::memcpy(&s, dadosIndices + k * 2, 2);
+            i = s;
+        } else {
+            std::memcpy(&i, dadosIndices + k * 4, 4);
+        }
+        if (i >= a.quantidade || (k > 0 && i <= a.indicesEsparsos[k - 1])) return false;
+        a.indicesEsparsos[k] = i;
+    }
+    return true;
+}
+
+inline Acessor resolverAcessor(const json::Valor& raiz, int indice, const unsigned char* bin, size_t tamanhoBin) {
+    Acessor a;
+    const json::Valor* acessores = raiz.membro("accessors");
+    const json::Valor* vistas = raiz.membro("bufferViews");
+    if (!acessores || indice < 0 || (size_t)indice >= acessores->tamanho()) return a;
+    const json::Valor& acessor = (*acessores)[indice];
+
+    const json::Valor* tipo = acessor.membro("type");
+    a.componentes = tipo ? componentesDoTipo(tipo->texto) : 0;
+    a.tipoComponente = (GLenum)acessor.inteiroOu("componentType", 0);
+    if (!acessor.tamanhoOu("count", 0, a.quantidade)) return a;
+    const json::Valor* normalizado = acessor.membro("normalized");
+    a.normalizado = normalizado && normalizado->booleano;
+    a.tamanhoElemento = tamanhoComponente(a.tipoComponente) * a.componentes;
+    if (a.tamanhoElemento == 0 || a.quantidade == 0) return a;
+
+    if (const json::Valor* esparso = acessor.membro("sparse")) {
+        if (!resolverEsparso(*esparso, vistas, bin, tamanhoBin, a)) {
+            std::cout << "ERRO::GLB::ACESSOR_ESPARSO_INVALIDO: " << indice << std::endl;
+            a.esparsoInvalido = true;
+            return a;
+        }
+        a.esparso = true;
+    }
+
+    // sem bufferView a base do acessor é só zeros
+    int vista = acessor.inteiroOu("bufferView", -1);
+    if (!vistas || vista < 0 || (size_t)vista >= vistas->tamanho()) {
+        a.stride = a.tamanhoElemento;
+        a.esparso = true;
+        a.valido = true;
+        return a;
+    }
+
+    size_t inicioVista, tamanhoVista, deslocamento;
+    if (!faixaDaVista((*vistas)[vista], tamanhoBin, inicioVista, tamanhoVista, a.stride) ||
+        !acessor.tamanhoOu("byteOffset", 0, deslocamento))
+        return a;
+    if (a.stride == 0) a.stride = a.tamanhoElemento;
+
+    // comparações por subtração: com valores vindos do arquivo, as somas
+    // poderiam dar a volta em size_t e passar pelo teste
+    if (deslocamento > tamanhoVista || a.tamanhoElemento > tamanhoVista - deslocamento) return a;
+    if (a.quantidade - 1 > (tamanhoVista - deslocamento - a.tamanhoElemento) / a.stride) return a;
+
+    a.deslocamento = inicioVista + deslocamento;
+    a.dados = bin + a.deslocamento;
+    a.valido = true;
+    return a;
+}
+
+// Bytes do elemento i: a substituição do sparse, se houver, senão o
+// bufferView; nullptr quando a base é zeros.
+inline const unsigned char* enderecoElemento(const Acessor& a, size_t i) {
+    if (!a.indicesEsparsos.empty()) {
+        auto k = std::lower_bound(a.indicesEsparsos.begin(), a.indicesEsparsos.end(), (uint32_t)i);
+        if (k != a.indicesEsparsos.end() && *k == i)
+            return a.valoresEsparsos + (size_t)(k - a.indicesEsparsos.begin()) * a.tamanhoElemento;
+    }
+    return a.dados ? a.dados + i * a.stride : nullptr;
+}
+
+// Elemento i convertido para float, respeitando a normalização do glTF.
+inline void lerElemento(const Acessor& a, size_t i, float* saida, int maximo) {
+    int n = std::min(a.componentes, maximo);
+    const unsigned char* e = enderecoElemento(a, i);
+    if (!e) {
+        for (int c = 0; c < n; c++) saida[c] = 0.0f;
+        return;
+    }
+    for (int c = 0; c < n; c++) {
+        float x = 0.0f;
+        switch (a.tipoComponente) {
+        case GL_FLOAT: std::memcpy(&x, e + c * 4, 4); break;
+        case GL_BYTE: {
+            int8_t b = (int8_t)e[c];
+            x = a.normalizado ? std::max(b / 127.0f, -1.0f) : (float)b;
+            break;
+        }
+        case GL_UNSIGNED_BYTE:
+            x = a.normalizado ? e[c] / 255.0f : (float)e[c];
+            break;
+        case GL_SHORT: {
+            int16_t s;
+            std::memcpy(&s, e + c * 2, 2);
+            x = a.normalizado ? std::max(s / 32767.0f, -1.0f) : (float)s;
+            break;
+        }
+        case GL_UNSIGNED_SHORT: {
+            uint16_t s;
+            std::memcpy(&s, e + c * 2, 2);
+            x = a.normalizado ? s / 65535.0f : (float)s;
+            break;
+        }
+        case GL_UNSIGNED_INT: {
+            uint32_t u;
+            std::memcpy(&u, e + c * 4, 4);
+            x = (float)u;
+            break;
+        }
+        }
+        saida[c] = x;
+    }
+}
+
+inline GLuint lerIndice(const Acessor& a, size_t i) {
+    const unsigned char* e = enderecoElemento(a, i);
+    if (!e) return 0;
+    switch (a.tipoComponente) {
+    case GL_UNSIGNED_BYTE: return e[0];
+    case GL_UNSIGNED_SHORT: { uint16_t s; std::memcpy(&s, e, 2); return s; }
+    default: { uint32_t u; std::memcpy(&u, e, 4); return u; }
+    }
+}
+
+inline bool tipoAtributoDireto(const Acessor& a) {
+    if (!a.valido || a.esparso || a.stride % 4 != 0 || a.deslocamento % 4 != 0) return false;
+    if (a.tipoComponente == GL_FLOAT) return true;
+    // inteiros só normalizados (KHR_mesh_quantization ou UVs compactas)
+    return a.normalizado && a.tipoComponente != GL_UNSIGNED_INT;
+}
+
+inline glm::mat4 matrizDoNo(const json::Valor& no) {
+    const json::Valor* matriz = no.membro("matrix");
+    if (matriz && matriz->tamanho() == 16) {
+        glm::mat4 m(1.0f);
+        for (int c = 0; c < 4; c++)
+            for (int l = 0; l < 4; l++)
+                m[c][l] = (float)(*matriz)[c * 4 + l].numero;   // glTF também é por colunas
+        return m;
+    }
+
+    glm::vec3 t(0.0f), s(1.0f);
+    float qx = 0.0f, qy = 0.0f, qz = 0.0f, qw = 1.0f;
+    if (const json::Valor* v = no.membro("translation"); v && v->tamanho() == 3)
+        t = glm::vec3((float)(*v)[0].numero, (float)(*v)[1].numero, (float)(*v)[2].numero);
+    if (const json::Valor* v = no.membro("scale"); v && v->tamanho() == 3)
+        s = glm::vec3((float)(*v)[0].numero, (float)(*v)[1].numero, (float)(*v)[2].numero);
+    if (const json::Valor* v = no.membro("rotation"); v && v->tamanho() == 4) {
+        qx = (float)(*v)[0].numero; qy = (float)(*v)[1].numero;
+        qz = (float)(*v)[2].numero; qw = (float)(*v)[3].numero;
+    }
+
+    // T * R * S, com R do quatérnio (x, y, z, w)
+    glm::mat4 m(1.0f);
+    m[0][0] = (1.0f - 2.0f * (qy * qy + qz * qz)) * s.x;
+    m[0][1] = (2.0f * (qx * qy + qz * qw)) * s.x;
+    m[0][2] = (2.0f * (qx * qz - qy * qw)) * s.x;
+    m[1][0] = (2.0f * (qx * qy - qz * qw)) * s.y;
+    m[1][1] = (1.0f - 2.0f * (qx * qx + qz * qz)) * s.y;
+    m[1][2] = (2.0f * (qy * qz + qx * qw)) * s.y;
+    m[2][0] = (2.0f * (qx * qz + qy * qw)) * s.z;
+    m[2][1] = (2.0f * (qy * qz - qx * qw)) * s.z;
+    m[2][2] = (1.0f - 2.0f * (qx * qx + qy * qy)) * s.z;
+    m[3][0] = t.x;
+    m[3][1] = t.y;
+    m[3][2] = t.z;
+    return m;
+}
+
+// Metálico-rugoso -> Phong: a cor base vira difusa, o especular vai de 4%
+// (dielétrico) até a cor base (metal) e o brilho sai da rugosidade
+// (expoente de Blinn-Phong equivalente a alfa = rugosidade²).
+inline Material materialDePBR(const json::Valor& material) {
+    glm::vec3 base(1.0f);
+    float metalico = 1.0f, rugosidade = 1.0f;
+    if (const json::Valor* pbr = material.membro("pbrMetallicRoughness")) {
+        if (const json::Valor* cor = pbr->membro("baseColorFactor"); cor && cor->tamanho() >= 3)
+            base = glm::vec3((float)(*cor)[0].numero, (float)(*cor)[1].numero, (float)(*cor)[2].numero);
+        metalico = (float)pbr->numeroOu("metallicFactor", 1.0);
+        rugosidade = (float)pbr->numeroOu("roughnessFactor", 1.0);
+    }
+
+    float alfa = std::max(rugosidade * rugosidade, 0.01f);
+    float brilho = std::min(std::max(2.0f / (alfa * alfa) - 2.0f, 1.0f), 256.0f);
+    glm::vec3 especular = glm::vec3(0.04f) * (1.0f - metalico) + base * metalico;
+    return Material(base * 0.2f, base, especular, brilho);
+}
+
+}
+
+class ModeloGLB {
+public:
+    std::vector<Mesh> meshes;               // uma por primitiva
+    std::vector<int> materialDaMesh;        // índice em materiais, -1 = padrão
+    std::vector<Material> materiais;
+    std::vector<InstanciaGLB> instancias;
+
+    // AABB da cena, já com as transformações dos nós
+    glm::vec3 limiteMin = glm::vec3(0.0f);
+    glm::vec3 limiteMax = glm::vec3(0.0f);
+
+    EstatisticasGLB estatisticas;
+
+    ModeloGLB() = default;
+    explicit ModeloGLB(const std::string& caminho) { carregar(caminho); }
+
+    bool carregado() const { return !instancias.empty(); }
+
+    bool carregar(const std::string& caminho) {
+        using namespace glb;
+        auto relogioInicio = std::chrono::steady_clock::now();
+        *this = ModeloGLB();
+
+        ArquivoMapeado arquivo;
+        if (!arquivo.abrir(caminho)) {
+            std::cout << "ERRO::GLB::ARQUIVO_NAO_ABERTO: " << caminho << std::endl;
+            return false;
+        }
+
+        // cabeçalho (12 bytes) e chunks {tamanho, tipo, dados}
+        const unsigned char* dados = reinterpret_cast<const unsigned char*>(arquivo.dados);
+        uint32_t cabecalho[3] = {0, 0, 0};
+        if (arquivo.tamanho >= 12) std::memcpy(cabecalho, dados, 12);
+        if (cabecalho[0] != MAGICA || cabecalho[1] != 2 || cabecalho[2] > arquivo.tamanho) {
+            std::cout << "ERRO::GLB::FORMATO_INVALIDO: " << caminho << std::endl;
+            return false;
+        }
+
+        std::string textoJSON;
+        const unsigned char* bin = nullptr;
+        size_t tamanhoBin = 0;
+        for (size_t p = 12; p + 8 <= cabecalho[2];) {
+            uint32_t chunk[2];
+            std::memcpy(chunk, dados + p, 8);
+            if (p + 8 + chunk[0] > cabecalho[2]) break;
+            if (chunk[1] == CHUNK_JSON && textoJSON.empty())
+                textoJSON.assign(reinterpret_cast<const char*>(dados + p + 8), chunk[0]);
+            else if (chunk[1] == CHUNK_BIN && !bin) {
+                bin = dados + p + 8;
+                tamanhoBin = chunk[0];
+            }
+            p += 8 + ((chunk[0] + 3) & ~3u);
+        }
+
+        json::Valor raiz;
+        if (textoJSON.empty() || !json::Leitor(textoJSON.c_str()).ler(raiz)) {
+            std::cout << "ERRO::GLB::JSON_INVALIDO: " << caminho << std::endl;
+            return false;
+        }
+
+        if (const json::Valor* lista = raiz.membro("materials"))
+            for (size_t i = 0; i < lista->tamanho(); i++)
+                materiais.push_back(materialDePBR((*lista)[i]));
+
+        // primitivas de cada mesh do glTF -> faixa em this->meshes
+        std::vector<std::pair<size_t, size_t>> primitivasDaMesh;
+        if (const json::Valor* lista = raiz.membro("meshes")) {
+            for (size_t m = 0; m < lista->tamanho(); m++) {
+                size_t inicio = meshes.size();
+                if (const json::Valor* prims = (*lista)[m].membro("primitives"))
+                    for (size_t p = 0; p < prims->tamanho(); p++)
+                        carregarPrimitiva(raiz, (*prims)[p], bin, tamanhoBin);
+                primitivasDaMesh.emplace_back(inicio, meshes.size());
+            }
+        }
+
+        // nós a partir das raízes da cena (ou de todos os nós sem pai)
+        const json::Valor* nos = raiz.membro("nodes");
+        std::vector<int> raizes;
+        const json::Valor* cenas = raiz.membro("scenes");
+        int cena = raiz.inteiroOu("scene", 0);
+        if (cenas && cena >= 0 && (size_t)cena < cenas->tamanho()) {
+            if (const json::Valor* lista = (*cenas)[cena].membro("nodes"))
+                for (size_t i = 0; i < lista->tamanho(); i++) raizes.push_back((*lista)[i].comoInteiro(-1));
+        } else if (nos) {
+            std::vector<bool> temPai(nos->tamanho(), false);
+            for (size_t n = 0; n < nos->tamanho(); n++)
+                if (const json::Valor* filhos = (*nos)[n].membro("children"))
+                    for (size_t f = 0; f < filhos->tamanho(); f++) {
+                        int filho = (*filhos)[f].comoInteiro(-1);
+                        if (filho >= 0 && (size_t)filho < temPai.size()) temPai[filho] = true;
+                    }
+            for (size_t n = 0; n < nos->tamanho(); n++)
+                if (!temPai[n]) raizes.push_back((int)n);
+        }
+
+        if (nos) {
+            // pilha explícita; o limite de visitas protege contra ciclos em arquivos inválidos
+            std::vector<std::pair<int, glm::mat4>> pilha;
+            for (int r : raizes) pilha.emplace_back(r, glm::mat4(1.0f));
+            size_t visitas = 0;
+            while (!pilha.empty() && visitas++ < nos->tamanho() * 4) {
+                auto [indice, pai] = pilha.back();
+                pilha.pop_back();
+                if (indice < 0 || (size_t)indice >= nos->tamanho()) continue;
+                const json::Valor& no = (*nos)[indice];
+                glm::mat4 mundo = pai * matrizDoNo(no);
+
+                int mesh = no.inteiroOu("mesh", -1);
+                if (mesh >= 0 && (size_t)mesh < primitivasDaMesh.size())
+                    for (size_t p = primitivasDaMesh[mesh].first; p < primitivasDaMesh[mesh].second; p++)
+                        instancias.push_back({p, mundo});
+
+                if (const json::Valor* filhos = no.membro("children"))
+                    for (size_t f = 0; f < filhos->tamanho(); f++)
+                        pilha.emplace_back((*filhos)[f].comoInteiro(-1), mundo);
+            }
+        }
+
+        calcularLimites();
+
+        estatisticas.bytesArquivo = arquivo.tamanho;
+        estatisticas.segundos =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - relogioInicio).count();
+        estatisticas.picoMemoria = picoMemoriaResidente();
+        return carregado();
+    }
+
+    // cada instância vira um desenho da fila (que reordena por shader/material/mesh);
+    // shaderPara(const Mesh&) devolve o shader registrado na fila para a mesh
+    template <typename FuncaoShader>
+    void enfileirar(FilaRenderizacao& fila, FuncaoShader shaderPara, const glm::mat4& modelo,
+                    const Material& materialPadrao) const {
+        for (const InstanciaGLB& instancia : instancias) {
+            int m = materialDaMesh[instancia.mesh];
+            const Material& material = m >= 0 && (size_t)m < materiais.size() ? materiais[m] : materialPadrao;
+            const Mesh& mesh = meshes[instancia.mesh];
+            fila.adicionar(shaderPara(mesh), mesh, material, modelo * instancia.transformacao);
+        }
+    }
+
+private:
+    void carregarPrimitiva(const json::Valor& raiz, const json::Valor& primitiva,
+                           const unsigned char* bin, size_t tamanhoBin) {
+        using namespace glb;
+
+        int modo = primitiva.inteiroOu("mode", 4);
+        if (modo < 4 || modo > 6) return;   // pontos e linhas ficam de fora
+
+        const json::Valor* atributos = primitiva.membro("attributes");
+        if (!atributos) return;
+        Acessor posicao = resolverAcessor(raiz, atributos->inteiroOu("POSITION", -1), bin, tamanhoBin);
+        Acessor normal = resolverAcessor(raiz, atributos->inteiroOu("NORMAL", -1), bin, tamanhoBin);
+        Acessor uv = resolverAcessor(raiz, atributos->inteiroOu("TEXCOORD_0", -1), bin, tamanhoBin);
+        Acessor indices = resolverAcessor(raiz, primitiva.inteiroOu("indices", -1), bin, tamanhoBin);
+
+        // já reportado em resolverAcessor; sem isso a normal ou a UV sumiriam caladas
+        if (posicao.esparsoInvalido || normal.esparsoInvalido || uv.esparsoInvalido || indices.esparsoInvalido)
+            return;
+
+        if (!posicao.valido || posicao.componentes != 3) {
+            std::cout << "ERRO::GLB::PRIMITIVA_SEM_POSICAO" << std::endl;
+            return;
+        }
+        const size_t numVertices = posicao.quantidade;
+        bool normalOk = normal.valido && normal.componentes == 3 && normal.quantidade == numVertices;
+        bool uvOk = uv.valido && uv.componentes == 2 && uv.quantidade == numVertices;
+        bool indicesOk = indices.valido && indices.componentes == 1 &&
+                         (indices.tipoComponente == GL_UNSIGNED_BYTE || indices.tipoComponente == GL_UNSIGNED_SHORT ||
+                          indices.tipoComponente == GL_UNSIGNED_INT) &&
+                         indices.stride == indices.tamanhoElemento;
+        if (indices.valido && !indicesOk) {
+            std::cout << "ERRO::GLB::INDICES_INVALIDOS" << std::endl;
+            return;
+        }
+
+        int material = primitiva.inteiroOu("material", -1);
+
+        // AABB: o glTF exige min/max em POSITION
+        glm::vec3 minimo(0.0f), maximo(0.0f);
+        const json::Valor* acessorPos = &(*raiz.membro("accessors"))[atributos->inteiroOu("POSITION", -1)];
+        const json::Valor* vMin = acessorPos->membro("min");
+        const json::Valor* vMax = acessorPos->membro("max");
+        bool temLimites = vMin && vMax && vMin->tamanho() == 3 && vMax->tamanho() == 3;
+        if (temLimites) {
+            minimo = glm::vec3((float)(*vMin)[0].numero, (float)(*vMin)[1].numero, (float)(*vMin)[2].numero);
+            maximo = glm::vec3((float)(*vMax)[0].numero, (float)(*vMax)[1].numero, (float)(*vMax)[2].numero);
+        }
+
+        // faixa do BIN que contém os atributos usados
+        size_t inicio = posicao.deslocamento;
+        size_t fim = posicao.deslocamento + posicao.stride * (numVertices - 1) + posicao.tamanhoElemento;
+        size_t bytesUteis = posicao.tamanhoElemento * numVertices;
+        auto incluir = [&](const Acessor& a) {
+            inicio = std::min(inicio, a.deslocamento);
+            fim = std::max(fim, a.deslocamento + a.stride * (a.quantidade - 1) + a.tamanhoElemento);
+            bytesUteis += a.tamanhoElemento * a.quantidade;
+        };
+        if (normalOk) incluir(normal);
+        if (uvOk) incluir(uv);
+
+        bool direto = temLimites && normalOk && !indices.esparso && tipoAtributoDireto(posicao) &&
+                      tipoAtributoDireto(normal) && (!uvOk || tipoAtributoDireto(uv)) &&
+                      fim - inicio <= bytesUteis * SOBRA_MAXIMA_FAIXA;
+
+        // índices enviados como estão não passam por filtro nenhum: um
+        // índice fora dos vértices manda a primitiva para o reempacotamento,
+        // que descarta os triângulos inválidos
+        if (direto && indices.valido)
+            for (size_t i = 0; i < indices.quantidade && direto; i++)
+                if (lerIndice(indices, i) >= numVertices) direto = false;
+
+        Mesh mesh;
+        if (direto) {
+            LayoutVertice layout;
+            auto adicionar = [&](GLuint local, const Acessor& a) {
+                layout.adicionar(local, a.componentes, a.tipoComponente, a.normalizado ? GL_TRUE : GL_FALSE,
+                                 a.deslocamento - inicio, (GLsizei)a.stride);
+                layout.tamanhoVertice += (GLsizei)a.tamanhoElemento;
+            };
+            adicionar(0, posicao);
+            adicionar(1, normal);
+            if (uvOk) adicionar(2, uv);
+
+            std::vector<GLuint> sequencia;
+            const void* dadosIndices = indices.valido ? indices.dados : nullptr;
+            GLenum tipoIndice = indices.valido ? indices.tipoComponente : GL_UNSIGNED_INT;
+            size_t numIndices = indices.valido ? indices.quantidade : numVertices;
+            if (!indices.valido) {
+                sequencia.resize(numVertices);
+                for (size_t i = 0; i < numVertices; i++) sequencia[i] = (GLuint)i;
+                dadosIndices = sequencia.data();
+            }
+
+            mesh.primitiva = modo == 4 ? GL_TRIANGLES : (modo == 5 ? GL_TRIANGLE_STRIP : GL_TRIANGLE_FAN);
+            mesh.enviarComLayout(layout, bin + inicio, fim - inicio, numVertices, dadosIndices, tipoIndice,
+                                 numIndices, minimo, maximo, Quantizacao());
+            estatisticas.bytesEnviados += (fim - inicio) + numIndices * tamanhoTipoIndice(tipoIndice);
+            estatisticas.primitivasDiretas++;
+        } else {
+            std::vector<Vertice> vertices(numVertices);
+            for (size_t i = 0; i < numVertices; i++) {
+                Vertice& v = vertices[i];
+                lerElemento(posicao, i, &v.posicao.x, 3);
+                v.normal = glm::vec3(0.0f);
+                if (normalOk) lerElemento(normal, i, &v.normal.x, 3);
+                v.coordTextura = glm::vec2(0.0f);
+                if (uvOk) lerElemento(uv, i, &v.coordTextura.x, 2);
+            }
+
+            // faixas e leques viram lista de triângulos
+            std::vector<GLuint> lista;
+            size_t n = indices.valido ? indices.quantidade : numVertices;
+            auto indice = [&](size_t i) { return indices.valido ? lerIndice(indices, i) : (GLuint)i; };
+            for (size_t t = 0; t + 2 < n; t += (modo == 4 ? 3 : 1)) {
+                GLuint a = indice(modo == 6 ? 0 : t), b = indice(t + 1), c = indice(t + 2);
+                if (modo == 5 && (t & 1)) std::swap(a, b);
+                if (a >= numVertices || b >= numVertices || c >= numVertices) continue;
+                lista.push_back(a);
+                lista.push_back(b);
+                lista.push_back(c);
+            }
+
+            if (!normalOk) calcularNormais(vertices, lista);
+
+            mesh = Mesh(std::move(vertices), std::move(lista));
+            estatisticas.bytesEnviados += mesh.bytesVerticesGPU() + mesh.numIndices * tamanhoTipoIndice(mesh.tipoIndice);
+            estatisticas.primitivasReempacotadas++;
+        }
+
+        meshes.push_back(std::move(mesh));
+        materialDaMesh.push_back(material);
+    }
+
+    // normais suavizadas pelos triângulos que usam cada vértice (pesadas pela área)
+    static void calcularNormais(std::vector<Vertice>& vertices, const std::vector<GLuint>& indices) {
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            Vertice& a = vertices[indices[t]];
+            Vertice& b = vertices[indices[t + 1]];
+            Vertice& c = vertices[indices[t + 2]];
+            glm::vec3 n = glm::cross(b.posicao - a.posicao, c.posicao - a.posicao);
+            a.normal += n;
+            b.normal += n;
+            c.normal += n;
+        }
+        for (Vertice& v : vertices) {
+            float comprimento = glm::length(v.normal);
+            v.normal = comprimento > 0.0f ? v.normal / comprimento : glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+    }
+
+    void calcularLimites() {
+        bool primeiro = true;
+        for (const InstanciaGLB& instancia : instancias) {
+            const Mesh& mesh = meshes[instancia.mesh];
+            for (int canto = 0; canto < 8; canto++) {
+                glm::vec3 local((canto & 1) ? mesh.limiteMax.x : mesh.limiteMin.x,
+                                (canto & 2) ? mesh.limiteMax.y : mesh.limiteMin.y,
+                                (canto & 4) ? mesh.limiteMax.z : mesh.limiteMin.z);
+                glm::vec3 p = glm::vec3(instancia.transformacao * glm::vec4(local, 1.0f));
+                limiteMin = primeiro ? p : glm::min(limiteMin, p);
+                limiteMax = primeiro ? p : glm::max(limiteMax, p);
+                primeiro = false;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,607 @@
+#ifndef CARREGADOR_OBJ_H
+#define CARREGADOR_OBJ_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "Mesh.h"
+#include "Paralelo.h"
+#include "ArquivoMapeado.h"
+
+// Leitura de Wavefront OBJ (v, vt, vn, f) para arquivos de vários GB:
+//
+//   1. o arquivo é mapeado em memória e dividido em blocos que terminam em '\n'
+//   2. cada thread interpreta um bloco, com parser próprio de float/inteiro,
+//      e triangula os polígonos em leque
+//   3. índices negativos (relativos) são resolvidos com a soma prefixa das
+//      contagens de cada bloco
+//   4. as tuplas (v, vt, vn) são distribuídas em 64 partições pelo hash; cada
+//      partição é deduplicada por uma thread, sem trava, e vira um Vertice
+//
+// Normais ausentes são calculadas suavizadas por posição. Grupos, materiais,
+// linhas e pontos são ignorados.
+
+// Pico de memória residente do processo, em bytes (0 se não disponível).
+inline size_t picoMemoriaResidente() {
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return 0;
+#ifdef __APPLE__
+    return (size_t)uso.ru_maxrss;           // bytes no macOS
+#else
+    return (size_t)uso.ru_maxrss * 1024;    // KB no Linux
+#endif
+#endif
+}
+
+struct EstatisticasOBJ {
+    size_t bytes = 0;
+    double segundos = 0.0;
+    size_t posicoes = 0, normais = 0, uvs = 0;
+    size_t triangulos = 0;
+    size_t vertices = 0;        // depois de deduplicar
+    size_t linhasIgnoradas = 0; // malformadas
+    unsigned threads = 0;
+    bool normaisCalculadas = false;
+    size_t picoMemoria = 0;     // RSS do processo ao terminar
+
+    // cache pós-transformação simulado, antes e depois de otimizarMesh (MeshOBJ)
+    AnaliseCache cacheAntes, cacheDepois;
+
+    double mbPorSegundo() const {
+        return segundos > 0.0 ? (bytes / (1024.0 * 1024.0)) / segundos : 0.0;
+    }
+};
+
+namespace obj {
+
+// Blocos menores que isto não compensam uma thread.
+const size_t BYTES_MINIMOS_POR_BLOCO = 1 << 20;
+const int BITS_PARTICOES = 6;
+const size_t NUM_PARTICOES = size_t(1) << BITS_PARTICOES;
+
+// Um canto de face. Durante a leitura, índices com o bit em `relativos` são
+// relativos ao início do bloco (vieram de um índice negativo); depois da
+// resolução todos são absolutos, base 0, e -1 marca ausente.
+struct CantoOBJ {
+    int32_t v, vt, vn;
+    uint32_t relativos;
+
+    bool operator==(const CantoOBJ& o) const { return v == o.v && vt == o.vt && vn == o.vn; }
+};
+
+struct BlocoOBJ {
+    const char* inicio;
+    const char* fim;
+    std::vector<glm::vec3> posicoes;
+    std::vector<glm::vec3> normais;
+    std::vector<glm::vec2> uvs;
+    std::vector<CantoOBJ> cantos;   // 3 por triângulo
+    size_t linhasIgnoradas = 0;
+};
+
+inline bool ehEspaco(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* pularEspacos(const char* p, const char* fim) {
+    while (p < fim && ehEspaco(*p)) p++;
+    return p;
+}
+
+inline const char* proximaLinha(const char* p, const char* fim) {
+    const char* nl = (const char*)std::memchr(p, '\n', fim - p);
+    return nl ? nl + 1 : fim;
+}
+
+// Potências exatas em double; mantissa <= 2^53 dividida/multiplicada por elas
+// sai corretamente arredondada.
+inline double potencia10(int e) {
+    static const double tabela[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    return e <= 22 ? tabela[e] : std::pow(10.0, e);
+}
+
+// Float decimal sem locale e sem terminador nulo. Devolve nullptr se não
+// houver número. Formas raras (inf, nan, hexadecimal) vão para strtof.
+inline const char* lerFloat(const char* p, const char* fim, float& valor) {
+    const char* inicio = p;
+    bool negativo = false;
+    if (p < fim && (*p == '-' || *p == '+')) {
+        negativo = *p == '-';
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int expoente = 0;
+    int digitos = 0;
+    bool algumDigito = false;
+
+    while (p < fim && (unsigned)(*p - '0') < 10u) {
+        algumDigito = true;
+        if (digitos < 19) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            if (mantissa != 0) digitos++;
+        } else {
+            expoente++;
+        }
+        p++;
+    }
+    if (p < fim && *p == '.') {
+        p++;
+        while (p < fim && (unsigned)(*p - '0') < 10u) {
+            algumDigito = true;
+            if (digitos < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                if (mantissa != 0) digitos++;
+                expoente--;
+            }
+            p++;
+        }
+    }
+
+    if (!algumDigito) {
+        char buffer[64];
+        size_t n = 0;
+        while (inicio + n < fim && n < sizeof(buffer) - 1 && !ehEspaco(inicio[n]) && inicio[n] != '\n')
+            n++;
+        std::memcpy(buffer, inicio, n);
+        buffer[n] = '\0';
+        char* consumido = nullptr;
+        valor = std::strtof(buffer, &consumido);
+        return consumido == buffer ? nullptr : inicio + (consumido - buffer);
+    }
+
+    if (p < fim && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool expNegativo = false;
+        if (q < fim && (*q == '-' || *q == '+')) {
+            expNegativo = *q == '-';
+            q++;
+        }
+        if (q < fim && (unsigned)(*q - '0') < 10u) {
+            int e = 0;
+            while (q < fim && (unsigned)(*q - '0') < 10u) {
+                if (e < 10000) e = e * 10 + (*q - '0');
+                q++;
+            }
+            expoente += expNegativo ? -e : e;
+            p = q;
+        }
+    }
+
+    double v = (double)mantissa;
+    if (mantissa != 0 && expoente != 0) {
+        if (expoente < -330 || expoente > 330) v = expoente < 0 ? 0.0 : HUGE_VAL;
+        else if (expoente < 0) v /= potencia10(-expoente);
+        else v *= potencia10(expoente);
+    }
+    valor = (float)(negativo ? -v : v);
+    return p;
+}
+
+inline const char* lerInteiro(const char* p, const char* fim, int64_t& valor) {
+    bool negativo = false;
+    if (p < fim && (*p == '-' || *p == '+')) {
+        negativo = *p == '-';
+        p++;
+    }
+    if (p >= fim || (unsigned)(*p - '0') >= 10u) return nullptr;
+    int64_t v = 0;
+    while (p < fim && (unsigned)(*p - '0') < 10u) {
+        if (v < ((int64_t)1 << 40)) v = v * 10 + (*p - '0');
+        p++;
+    }
+    valor = negativo ? -v : v;
+    return p;
+}
+
+// Índice do OBJ (base 1, ou negativo relativo ao fim) -> base 0. Negativos
+// ficam relativos ao início do bloco até a resolução.
+inline bool converterIndice(int64_t indice, size_t contagemLocal, int32_t& saida, uint32_t& relativos,
+                            uint32_t bit) {
+    if (indice > 0 && indice <= INT32_MAX) {
+        saida = (int32_t)(indice - 1);
+        return true;
+    }
+    if (indice < 0) {
+        int64_t local = (int64_t)contagemLocal + indice;
+        if (local < INT32_MIN || local > INT32_MAX) return false;
+        saida = (int32_t)local;
+        relativos |= bit;
+        return true;
+    }
+    return false;
+}
+
+inline void interpretarBloco(BlocoOBJ& bloco) {
+    const char* p = bloco.inicio;
+    const char* fim = bloco.fim;
+    std::vector<CantoOBJ> poligono;
+
+    // estimativa grosseira (~30 bytes por linha) para evitar realocações
+    size_t linhasEstimadas = (size_t)(fim - p) / 30;
+    bloco.posicoes.reserve(linhasEstimadas / 3);
+    bloco.cantos.reserve(linhasEstimadas);
+
+    while (p < fim) {
+        p = pularEspacos(p, fim);
+        if (p >= fim) break;
+
+        if (p[0] == 'v' && p + 1 < fim) {
+            char tipo = p[1];
+            int componentes = ehEspaco(tipo) ? 3 : (tipo == 'n' ? 3 : (tipo == 't' ? 2 : 0));
+            if (componentes == 0) {
+                p = proximaLinha(p, fim);   // vp e afins
+                continue;
+            }
+            p += ehEspaco(tipo) ? 1 : 2;
+
+            float valores[3] = {0.0f, 0.0f, 0.0f};
+            bool ok = true;
+            for (int c = 0; c < componentes && ok; c++) {
+                p = pularEspacos(p, fim);
+                const char* q = lerFloat(p, fim, valores[c]);
+                // vt com uma coordenada só é válido
+                if (!q) ok = tipo == 't' && c == 1;
+                else p = q;
+            }
+            if (!ok) {
+                bloco.linhasIgnoradas++;
+            } else if (tipo == 'n') {
+                bloco.normais.push_back(glm::vec3(valores[0], valores[1], valores[2]));
+            } else if (tipo == 't') {
+                bloco.uvs.push_back(glm::vec2(valores[0], valores[1]));
+            } else {
+                bloco.posicoes.push_back(glm::vec3(valores[0], valores[1], valores[2]));
+            }
+        } else if (p[0] == 'f' && p + 1 < fim && ehEspaco(p[1])) {
+            p++;
+            poligono.clear();
+            bool ok = true;
+
+            while (true) {
+                p = pularEspacos(p, fim);
+                if (p >= fim || *p == '\n' || *p == '#') break;
+
+                CantoOBJ canto = {-1, -1, -1, 0};
+                int64_t indice;
+                const char* q = lerInteiro(p, fim, indice);
+                if (!q || !converterIndice(indice, bloco.posicoes.size(), canto.v, canto.relativos, 1u)) {
+                    ok = false;
+                    break;
+                }
+                p = q;
+                if (p < fim && *p == '/') {
+                    p++;
+                    if (p < fim && *p != '/') {
+                        q = lerInteiro(p, fim, indice);
+                        if (!q || !converterIndice(indice, bloco.uvs.size(), canto.vt, canto.relativos, 2u)) {
+                            ok = false;
+                            break;
+                        }
+                        p = q;
+                    }
+                    if (p < fim && *p == '/') {
+                        p++;
+                        q = lerInteiro(p, fim, indice);
+                        if (!q || !converterIndice(indice, bloco.normais.size(), canto.vn, canto.relativos, 4u)) {
+                            ok = false;
+                            break;
+                        }
+                        p = q;
+                    }
+                }
+                poligono.push_back(canto);
+            }
+
+            if (!ok || poligono.size() < 3) {
+                bloco.linhasIgnoradas++;
+            } else {
+                // leque a partir do primeiro canto
+                for (size_t i = 1; i + 1 < poligono.size(); i++) {
+                    bloco.cantos.push_back(poligono[0]);
+                    bloco.cantos.push_back(poligono[i]);
+                    bloco.cantos.push_back(poligono[i + 1]);
+                }
+            }
+        }
+
+        // comentários, o/g/s/usemtl/mtllib/l/p e o resto da linha
+        p = proximaLinha(p, fim);
+    }
+}
+
+inline uint64_t hashCanto(const CantoOBJ& c) {
+    uint64_t h = (uint64_t)(uint32_t)c.v * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)(uint32_t)c.vt * 0xC2B2AE3D27D4EB4Full + (h >> 29);
+    h ^= (uint64_t)(uint32_t)c.vn * 0x165667B19E3779F9ull + (h >> 32);
+    h *= 0xFF51AFD7ED558CCDull;
+    return h ^ (h >> 33);
+}
+
+inline size_t particaoDe(uint64_t hash) {
+    return (size_t)(hash >> (64 - BITS_PARTICOES));
+}
+
+}
+
+// Lê o OBJ em vertices/indices (GL_TRIANGLES). Devolve false e mantém os
+// vetores vazios se o arquivo não abrir ou referenciar elementos inexistentes.
+inline bool carregarOBJ(const std::string& caminho, std::vector<Vertice>& vertices,
+                        std::vector<GLuint>& indices, EstatisticasOBJ* estatisticas = nullptr) {
+    using namespace obj;
+    auto relogioInicio = std::chrono::steady_clock::now();
+
+    vertices.clear();
+    indices.clear();
+
+    ArquivoMapeado arquivo;
+    if (!arquivo.abrir(caminho)) {
+        std::cout << "ERRO::OBJ::ARQUIVO_NAO_ABERTO: " << caminho << std::endl;
+        return false;
+    }
+
+    // blocos alinhados em fim de linha
+    const char* dados = arquivo.dados;
+    const char* fimDados = dados + arquivo.tamanho;
+    size_t numBlocos = std::max<size_t>(1, std::min<size_t>(threadsDisponiveis(),
+                                                            arquivo.tamanho / BYTES_MINIMOS_POR_BLOCO));
+    std::vector<BlocoOBJ> blocos(numBlocos);
+    const char* corte = dados;
+    for (size_t b = 0; b < numBlocos; b++) {
+        blocos[b].inicio = corte;
+        if (b + 1 == numBlocos) {
+            corte = fimDados;
+        } else {
+            const char* alvo = std::max(corte, dados + arquivo.tamanho / numBlocos * (b + 1));
+            corte = alvo < fimDados ? proximaLinha(alvo, fimDados) : fimDados;
+        }
+        blocos[b].fim = corte;
+    }
+
+    paraleloEmBlocos(numBlocos, 1, [&](size_t inicio, size_t fim) {
+        for (size_t b = inicio; b < fim; b++) interpretarBloco(blocos[b]);
+    });
+
+    // bases de cada bloco para resolver índices e concatenar
+    std::vector<size_t> basePos(numBlocos + 1, 0), baseNormal(numBlocos + 1, 0),
+                        baseUV(numBlocos + 1, 0), baseCanto(numBlocos + 1, 0);
+    size_t linhasIgnoradas = 0;
+    for (size_t b = 0; b < numBlocos; b++) {
+        basePos[b + 1] = basePos[b] + blocos[b].posicoes.size();
+        baseNormal[b + 1] = baseNormal[b] + blocos[b].normais.size();
+        baseUV[b + 1] = baseUV[b] + blocos[b].uvs.size();
+        baseCanto[b + 1] = baseCanto[b] + blocos[b].cantos.size();
+        linhasIgnoradas += blocos[b].linhasIgnoradas;
+    }
+    const size_t totalPos = basePos[numBlocos];
+    const size_t totalNormais = baseNormal[numBlocos];
+    const size_t totalUVs = baseUV[numBlocos];
+    const size_t totalCantos = baseCanto[numBlocos];
+
+    if (totalPos > INT32_MAX || totalCantos > UINT32_MAX) {
+        std::cout << "ERRO::OBJ::ARQUIVO_GRANDE_DEMAIS: " << caminho << std::endl;
+        return false;
+    }
+
+    std::vector<glm::vec3> posicoes(totalPos), normais(totalNormais);
+    std::vector<glm::vec2> uvs(totalUVs);
+
+    // resolve os índices, conta por partição e concatena os atributos
+    std::vector<size_t> contagem(numBlocos * NUM_PARTICOES, 0);
+    std::vector<unsigned char> invalido(numBlocos, 0);
+
+    paraleloEmBlocos(numBlocos, 1, [&](size_t inicio, size_t fim) {
+        for (size_t b = inicio; b < fim; b++) {
+            BlocoOBJ& bloco = blocos[b];
+            size_t* cont = &contagem[b * NUM_PARTICOES];
+
+            for (CantoOBJ& c : bloco.cantos) {
+                int64_t v = c.v + ((c.relativos & 1u) ? (int64_t)basePos[b] : 0);
+                int64_t vt = c.vt + ((c.relativos & 2u) ? (int64_t)baseUV[b] : 0);
+                int64_t vn = c.vn + ((c.relativos & 4u) ? (int64_t)baseNormal[b] : 0);
+
+                if (v < 0 || v >= (int64_t)totalPos) {
+                    invalido[b] = 1;
+                    v = 0;
+                }
+                if (vt >= (int64_t)totalUVs || vt < -1 || ((c.relativos & 2u) && vt < 0)) vt = -1;
+                if (vn >= (int64_t)totalNormais || vn < -1 || ((c.relativos & 4u) && vn < 0)) vn = -1;
+
+                c = {(int32_t)v, (int32_t)vt, (int32_t)vn, 0};
+                cont[particaoDe(hashCanto(c))]++;
+            }
+
+            std::copy(bloco.posicoes.begin(), bloco.posicoes.end(), posicoes.begin() + basePos[b]);
+            std::copy(bloco.normais.begin(), bloco.normais.end(), normais.begin() + baseNormal[b]);
+            std::copy(bloco.uvs.begin(), bloco.uvs.end(), uvs.begin() + baseUV[b]);
+            std::vector<glm::vec3>().swap(bloco.posicoes);
+            std::vector<glm::vec3>().swap(bloco.normais);
+            std::vector<glm::vec2>().swap(bloco.uvs);
+        }
+    });
+
+    for (size_t b = 0; b < numBlocos; b++) {
+        if (invalido[b]) {
+            std::cout << "ERRO::OBJ::INDICE_INVALIDO: face referencia vertice inexistente em "
+                      << caminho << std::endl;
+            return false;
+        }
+    }
+
+    // deslocamento de cada (bloco, partição) no arranjo ordenado por partição
+    std::vector<size_t> inicioParticao(NUM_PARTICOES + 1, 0);
+    std::vector<size_t> deslocamento(numBlocos * NUM_PARTICOES);
+    {
+        size_t soma = 0;
+        for (size_t s = 0; s < NUM_PARTICOES; s++) {
+            inicioParticao[s] = soma;
+            for (size_t b = 0; b < numBlocos; b++) {
+                deslocamento[b * NUM_PARTICOES + s] = soma;
+                soma += contagem[b * NUM_PARTICOES + s];
+            }
+        }
+        inicioParticao[NUM_PARTICOES] = soma;
+    }
+
+    std::vector<CantoOBJ> cantosParticionados(totalCantos);
+    std::vector<uint32_t> destino(totalCantos);      // posição do canto nos índices
+
+    paraleloEmBlocos(numBlocos, 1, [&](size_t inicio, size_t fim) {
+        for (size_t b = inicio; b < fim; b++) {
+            size_t* desl = &deslocamento[b * NUM_PARTICOES];
+            const std::vector<CantoOBJ>& cantos = blocos[b].cantos;
+            for (size_t i = 0; i < cantos.size(); i++) {
+                size_t k = desl[particaoDe(hashCanto(cantos[i]))]++;
+                cantosParticionados[k] = cantos[i];
+                destino[k] = (uint32_t)(baseCanto[b] + i);
+            }
+            std::vector<CantoOBJ>().swap(blocos[b].cantos);
+        }
+    });
+
+    // deduplicação: cada partição tem sua tabela (endereçamento aberto) e
+    // escreve o índice local; a base da partição é somada depois
+    indices.resize(totalCantos);
+    std::vector<std::vector<CantoOBJ>> unicos(NUM_PARTICOES);
+
+    paraleloEmBlocos(NUM_PARTICOES, 1, [&](size_t inicio, size_t fim) {
+        std::vector<uint32_t> tabela;
+        for (size_t s = inicio; s < fim; s++) {
+            size_t n = inicioParticao[s + 1] - inicioParticao[s];
+            if (n == 0) continue;
+
+            size_t capacidade = 16;
+            while (capacidade < n * 2) capacidade <<= 1;
+            tabela.assign(capacidade, 0);   // 0 = vazio, senão índice local + 1
+            const size_t mascara = capacidade - 1;
+
+            std::vector<CantoOBJ>& saida = unicos[s];
+            for (size_t k = inicioParticao[s]; k < inicioParticao[s + 1]; k++) {
+                const CantoOBJ& c = cantosParticionados[k];
+                size_t slot = (size_t)hashCanto(c) & mascara;
+                while (tabela[slot] != 0 && !(saida[tabela[slot] - 1] == c))
+                    slot = (slot + 1) & mascara;
+                if (tabela[slot] == 0) {
+                    saida.push_back(c);
+                    tabela[slot] = (uint32_t)saida.size();
+                }
+                indices[destino[k]] = tabela[slot] - 1;
+            }
+        }
+    });
+
+    std::vector<size_t> baseVertice(NUM_PARTICOES + 1, 0);
+    for (size_t s = 0; s < NUM_PARTICOES; s++)
+        baseVertice[s + 1] = baseVertice[s] + unicos[s].size();
+    const size_t totalVertices = baseVertice[NUM_PARTICOES];
+
+    vertices.resize(totalVertices);
+    std::vector<int32_t> posicaoDoVertice(totalVertices);
+    bool faltamNormais = false;
+
+    paraleloEmBlocos(NUM_PARTICOES, 1, [&](size_t inicio, size_t fim) {
+        for (size_t s = inicio; s < fim; s++) {
+            GLuint base = (GLuint)baseVertice[s];
+            for (size_t k = inicioParticao[s]; k < inicioParticao[s + 1]; k++)
+                indices[destino[k]] += base;
+
+            for (size_t i = 0; i < unicos[s].size(); i++) {
+                const CantoOBJ& c = unicos[s][i];
+                Vertice& v = vertices[base + i];
+                v.posicao = posicoes[c.v];
+                v.normal = c.vn >= 0 ? normais[c.vn] : glm::vec3(0.0f);
+                v.coordTextura = c.vt >= 0 ? uvs[c.vt] : glm::vec2(0.0f);
+                posicaoDoVertice[base + i] = c.vn >= 0 ? -1 : c.v;
+            }
+        }
+    });
+    for (int32_t p : posicaoDoVertice)
+        if (p >= 0) { faltamNormais = true; break; }
+
+    // normais suavizadas por posição (soma dos triângulos pesada pela área),
+    // só para os vértices sem vn
+    if (faltamNormais) {
+        std::vector<glm::vec3> acumulada(totalPos, glm::vec3(0.0f));
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            const Vertice& a = vertices[indices[t]];
+            const Vertice& b = vertices[indices[t + 1]];
+            const Vertice& c = vertices[indices[t + 2]];
+            glm::vec3 n = glm::cross(b.posicao - a.posicao, c.posicao - a.posicao);
+            for (int k = 0; k < 3; k++) {
+                int32_t p = posicaoDoVertice[indices[t + k]];
+                if (p >= 0) acumulada[p] += n;
+            }
+        }
+        paraleloEmBlocos(totalVertices, VERTICES_MINIMOS_POR_THREAD, [&](size_t inicio, size_t fim) {
+            for (size_t v = inicio; v < fim; v++) {
+                int32_t p = posicaoDoVertice[v];
+                if (p < 0) continue;
+                float comprimento = glm::length(acumulada[p]);
+                vertices[v].normal = comprimento > 0.0f ? acumulada[p] / comprimento : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+        });
+    }
+
+    // as partições embaralham os vértices; volta para a ordem de uso
+    otimizarBuscaVertices(vertices, indices);
+
+    if (estatisticas) {
+        EstatisticasOBJ& e = *estatisticas;
+        e.bytes = arquivo.tamanho;
+        e.posicoes = totalPos;
+        e.normais = totalNormais;
+        e.uvs = totalUVs;
+        e.triangulos = indices.size() / 3;
+        e.vertices = vertices.size();
+        e.linhasIgnoradas = linhasIgnoradas;
+        e.threads = (unsigned)std::min<size_t>(numBlocos, threadsDisponiveis());
+        e.normaisCalculadas = faltamNormais;
+        e.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - relogioInicio).count();
+        e.picoMemoria = picoMemoriaResidente();
+    }
+    return true;
+}
+
+// Mesh lida de um arquivo OBJ. Se a leitura falhar fica vazia (numIndices == 0).
+class MeshOBJ : public Mesh {
+public:
+    EstatisticasOBJ estatisticas;
+
+    MeshOBJ(MeshOBJ&&) = default;
+    MeshOBJ& operator=(MeshOBJ&&) = default;
+
+    explicit MeshOBJ(const std::string& caminho, FormatoVertice formatoGPU = FormatoVertice(),
+                     bool otimizarCache = true) {
+        formato = formatoGPU;
+        if (!carregarOBJ(caminho, vertices, indices, &estatisticas)) return;
+        estatisticas.cacheAntes = estatisticas.cacheDepois = analisarCache(indices, vertices.size());
+        if (otimizarCache) {
+            otimizarMesh(vertices, indices);
+            estatisticas.cacheDepois = analisarCache(indices, vertices.size());
+        }
+        configurarMesh();
+    }
+
+    bool carregado() const { return numIndices > 0; }
+};
+
+#endif
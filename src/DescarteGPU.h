@@ -0,0 +1,340 @@
+#ifndef DESCARTE_GPU_H
+#define DESCARTE_GPU_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "Shader.h"
+#include "LOD.h"
+#include "Frustum.h"
+#include "Instancias.h"
+#include "DesenhoIndireto.h"
+#include "RecursosGL.h"
+#include "ExtensoesGL.h"
+
+// Os contadores são os do quadro retrasado, para a leitura não esperar a GPU.
+struct EstatisticasDescarteGPU {
+    GLuint visiveis = 0, foraFrustum = 0, ocultos = 0;
+    std::vector<GLuint> visiveisPorNivel;   // numInstancias de cada comando
+    bool hiZ = false;             // o quadro usou a pirâmide do anterior
+    double segundosCPU = 0.0;     // recortar() + desenhar(), sem contar a GPU
+
+    GLuint testados() const { return visiveis + foraFrustum + ocultos; }
+};
+
+// Descarte e escolha de LOD na GPU (OpenGL 4.3). A CPU envia as matrizes de
+// todos os objetos (BufferInstancias) e, a cada quadro, só os comandos de
+// desenho zerados, um por nível do GrupoLOD. descarteHiZCompute.glsl testa
+// cada objeto contra o frustum e contra a pirâmide Hi-Z, escolhe o nível e
+// acrescenta o índice dele ao comando desse nível; desenhar() manda os
+// comandos por glMultiDrawElementsIndirect, sem ler nada de volta.
+//
+// A pirâmide é montada no fim do quadro com capturarProfundidade(): a
+// profundidade da tela é copiada e reduzida pelo máximo de 2x2 até 1x1. O
+// teste de oclusão usa essa profundidade com a projecao * visao do quadro em
+// que ela foi copiada, então um objeto que acaba de sair de trás de outro
+// pode faltar por um quadro.
+class DescarteGPU {
+public:
+    static const int MAXIMO_NIVEIS_LOD = 8;   // o mesmo do shader
+    static const int TOTAL_CONTADORES = 3 + MAXIMO_NIVEIS_LOD;
+
+    EstatisticasDescarteGPU estatisticas;
+
+    DescarteGPU() = default;
+    DescarteGPU(const DescarteGPU&) = delete;
+    DescarteGPU& operator=(const DescarteGPU&) = delete;
+
+    bool iniciar() {
+        if (!ExtensoesGL::temComputacao()) {
+            std::cout << "ERRO::DESCARTE_GPU::OPENGL_4_3_INDISPONIVEL" << std::endl;
+            return false;
+        }
+        programaReducao.reset(new Shader("shaders/reducaoHiZCompute.glsl"));
+        programaDescarte.reset(new Shader("shaders/descarteHiZCompute.glsl"));
+        const Shader& d = *programaDescarte;
+        for (int p = 0; p < 6; p++)
+            uDescarte.planos[p] = d.uniform<glm::vec4>("planos[" + std::to_string(p) + "]");
+        for (int n = 0; n < MAXIMO_NIVEIS_LOD; n++)
+            uDescarte.pixelsMinimos[n] = d.uniform<float>("pixelsMinimos[" + std::to_string(n) + "]");
+        uDescarte.numObjetos = d.uniform<int>("numObjetos");
+        uDescarte.minimoLocal = d.uniform<glm::vec3>("minimoLocal");
+        uDescarte.maximoLocal = d.uniform<glm::vec3>("maximoLocal");
+        uDescarte.usarHiZ = d.uniform<bool>("usarHiZ");
+        uDescarte.hiZ = d.uniform<int>("hiZ");
+        uDescarte.projecaoVisaoAnterior = d.uniform<glm::mat4>("projecaoVisaoAnterior");
+        uDescarte.tamanhoProfundidade = d.localizacao("tamanhoProfundidade");
+        uDescarte.niveisHiZ = d.uniform<int>("niveisHiZ");
+        uDescarte.posicaoCamera = d.uniform<glm::vec3>("posicaoCamera");
+        uDescarte.pixelsPorUnidade = d.uniform<float>("pixelsPorUnidade");
+        uDescarte.centroLocal = d.uniform<glm::vec3>("centroLocal");
+        uDescarte.raioLocal = d.uniform<float>("raioLocal");
+        uDescarte.numNiveisLOD = d.uniform<int>("numNiveisLOD");
+        uReducao.origem = programaReducao->uniform<int>("origem");
+        uReducao.nivelOrigem = programaReducao->uniform<int>("nivelOrigem");
+        return true;
+    }
+
+    bool pronto() const { return programaDescarte != nullptr; }
+
+    // entrada tem uma matriz e um material por objeto, todos desenhados com o grupo
+    void recortar(const GrupoLOD& grupo, const BufferInstancias& entrada, const glm::mat4& projecao,
+                  const glm::mat4& visao, const glm::vec3& posicaoCamera, float fovGraus, float alturaViewport) {
+        auto inicio = std::chrono::steady_clock::now();
+        numObjetos = (size_t)entrada.quantidade;
+        numNiveis = std::min((int)grupo.niveis.size(), MAXIMO_NIVEIS_LOD);
+
+        // cada nível tem uma faixa com lugar para todos os objetos
+        if (numObjetos > capacidade || !visiveis) {
+            capacidade = std::max<size_t>(numObjetos, 1);
+            visiveis.gerar();
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, visiveis);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, capacidade * MAXIMO_NIVEIS_LOD * sizeof(GLuint), nullptr,
+                         GL_DYNAMIC_COPY);
+        }
+
+        comandos.resize(numNiveis);
+        for (int n = 0; n < numNiveis; n++) {
+            FaixaDesenho faixa = grupo.niveis[n].faixaDesenho();
+            comandos[n].numIndices = (GLuint)faixa.numIndices;
+            comandos[n].numInstancias = 0;
+            comandos[n].primeiroIndice = faixa.primeiroIndice;
+            comandos[n].verticeBase = faixa.verticeBase;
+            comandos[n].instanciaBase = (GLuint)(n * capacidade);
+        }
+        bufferComandos.gerar();
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, bufferComandos);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, comandos.size() * sizeof(ComandoDesenhoIndireto), comandos.data(),
+                     GL_STREAM_DRAW);
+
+        // contadores em dois buffers alternados: o lido agora foi escrito dois quadros atrás;
+        // depois dos três atômicos vêm as instâncias de cada nível, copiadas dos comandos
+        BufferGL& contador = contadores[quadro++ % 2];
+        const GLuint zeros[TOTAL_CONTADORES] = {};
+        if (contador) {
+            GLuint lidos[TOTAL_CONTADORES];
+            glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, contador);
+            glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(lidos), lidos);
+            glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(zeros), zeros);
+            estatisticas.visiveis = lidos[0];
+            estatisticas.foraFrustum = lidos[1];
+            estatisticas.ocultos = lidos[2];
+            estatisticas.visiveisPorNivel.assign(lidos + 3, lidos + 3 + numNiveis);
+        } else {
+            contador.gerar();
+            glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, contador);
+            glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(zeros), zeros, GL_DYNAMIC_READ);
+        }
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, entrada.matrizes);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, bufferComandos);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, visiveis);
+        glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, contador);
+
+        programaDescarte->usar();
+        uDescarte.numObjetos.definir((int)numObjetos);
+        Frustum frustum = Frustum::daMatriz(projecao * visao);
+        for (int p = 0; p < 6; p++) uDescarte.planos[p].definir(frustum.planos[p]);
+        uDescarte.minimoLocal.definir(grupo.niveis[0].limiteMin);
+        uDescarte.maximoLocal.definir(grupo.niveis[0].limiteMax);
+
+        estatisticas.hiZ = temHiZ;
+        uDescarte.usarHiZ.definir(temHiZ);
+        if (temHiZ) {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, hiZ);
+            uDescarte.hiZ.definir(0);
+            uDescarte.projecaoVisaoAnterior.definir(projecaoVisaoAnterior);
+            glUniform2i(uDescarte.tamanhoProfundidade, larguraProfundidade, alturaProfundidade);
+            uDescarte.niveisHiZ.definir(niveisHiZ);
+        }
+
+        uDescarte.posicaoCamera.definir(posicaoCamera);
+        uDescarte.pixelsPorUnidade.definir(alturaViewport / std::tan(glm::radians(fovGraus) * 0.5f));
+        uDescarte.centroLocal.definir(grupo.centroLocal);
+        uDescarte.raioLocal.definir(grupo.raioLocal);
+        uDescarte.numNiveisLOD.definir(numNiveis);
+        for (int n = 0; n < numNiveis; n++) uDescarte.pixelsMinimos[n].definir(grupo.pixelsMinimos[n]);
+
+        if (numObjetos > 0) ExtensoesGL::dispatchCompute((GLuint)((numObjetos + 63) / 64), 1, 1);
+        // os comandos e os índices são lidos como indireto e atributo, os comandos também pela cópia
+        // para os contadores; os contadores, por glGetBufferSubData
+        ExtensoesGL::memoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+                                   GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+        glBindBuffer(GL_COPY_READ_BUFFER, bufferComandos);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, contador);
+        for (int n = 0; n < numNiveis; n++)
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                                n * sizeof(ComandoDesenhoIndireto) + offsetof(ComandoDesenhoIndireto, numInstancias),
+                                (3 + n) * sizeof(GLuint), sizeof(GLuint));
+
+        segundosRecorte = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    // Com o programa de lightingVertDescarteGPU.glsl em uso e a cena definida;
+    // entrada é a mesma passada a recortar().
+    void desenhar(const GrupoLOD& grupo, const BufferInstancias& entrada) {
+        auto inicio = std::chrono::steady_clock::now();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, entrada.matrizes);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, entrada.materiais);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, entrada.normais);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, bufferComandos);
+
+        for (int n = 0; n < numNiveis; n++) {
+            const Mesh& mesh = grupo.niveis[n];
+            FaixaDesenho faixa = mesh.prepararDesenho();
+            glBindBuffer(GL_ARRAY_BUFFER, visiveis);
+            glEnableVertexAttribArray(LOCAL_MODELO_INSTANCIA);
+            glVertexAttribIPointer(LOCAL_MODELO_INSTANCIA, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+            glVertexAttribDivisor(LOCAL_MODELO_INSTANCIA, 1);
+            ExtensoesGL::multiDrawElementsIndirect(mesh.primitiva, faixa.tipoIndice,
+                                                   (const void*)(n * sizeof(ComandoDesenhoIndireto)), 1,
+                                                   sizeof(ComandoDesenhoIndireto));
+        }
+
+        estatisticas.segundosCPU =
+            segundosRecorte + std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    // No fim do quadro, antes da troca de buffers: copia a profundidade da
+    // tela (framebuffer padrão, largura x altura) e monta a pirâmide.
+    void capturarProfundidade(int largura, int altura, const glm::mat4& projecaoVisao) {
+        if (!pronto() || falhaCopia || largura <= 0 || altura <= 0) return;
+        if (largura != larguraProfundidade || altura != alturaProfundidade) alocarTexturas(largura, altura);
+        if (falhaCopia) return;
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, copia);
+        glBlitFramebuffer(0, 0, largura, altura, 0, 0, largura, altura, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (!copiaConferida) {
+            // a cópia de profundidade exige o mesmo formato nos dois lados
+            copiaConferida = true;
+            if (glGetError() != GL_NO_ERROR) {
+                std::cout << "ERRO::DESCARTE_GPU::COPIA_PROFUNDIDADE (seguindo so com o frustum)" << std::endl;
+                falhaCopia = true;
+                temHiZ = false;
+                return;
+            }
+        }
+
+        programaReducao->usar();
+        uReducao.origem.definir(0);
+        glActiveTexture(GL_TEXTURE0);
+        int larguraNivel = larguraProfundidade, alturaNivel = alturaProfundidade;
+        for (int nivel = 0; nivel < niveisHiZ; nivel++) {
+            // o nível 0 sai da profundidade copiada; os outros, do nível anterior
+            glBindTexture(GL_TEXTURE_2D, nivel == 0 ? (GLuint)profundidade : (GLuint)hiZ);
+            uReducao.nivelOrigem.definir(nivel == 0 ? 0 : nivel - 1);
+            ExtensoesGL::bindImageTexture(0, hiZ, nivel, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+            larguraNivel = std::max(1, larguraNivel / 2);
+            alturaNivel = std::max(1, alturaNivel / 2);
+            ExtensoesGL::dispatchCompute((GLuint)(larguraNivel + 7) / 8, (GLuint)(alturaNivel + 7) / 8, 1);
+            ExtensoesGL::memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        }
+
+        projecaoVisaoAnterior = projecaoVisao;
+        temHiZ = true;
+    }
+
+    // a próxima chamada de recortar() roda sem oclusão (ex.: a câmera saltou)
+    void descartarHiZ() { temHiZ = false; }
+
+    // Para conferir o resultado de fora (testes/TesteDescarteGPU.cpp): os
+    // comandos do último recortar(), os índices visíveis em faixas de
+    // capacidadeNivel() por nível e a pirâmide do último capturarProfundidade().
+    GLuint bufferComandosGPU() const { return bufferComandos; }
+    GLuint bufferVisiveisGPU() const { return visiveis; }
+    size_t capacidadeNivel() const { return capacidade; }
+    int niveisLOD() const { return numNiveis; }
+    GLuint texturaHiZ() const { return hiZ; }
+    int niveisPiramide() const { return niveisHiZ; }
+
+private:
+    std::unique_ptr<Shader> programaReducao, programaDescarte;
+    // uniforms dos dois programas, resolvidos em iniciar()
+    struct {
+        Uniform<int> numObjetos, hiZ, niveisHiZ, numNiveisLOD;
+        Uniform<glm::vec4> planos[6];
+        Uniform<glm::vec3> minimoLocal, maximoLocal, posicaoCamera, centroLocal;
+        Uniform<float> pixelsPorUnidade, raioLocal, pixelsMinimos[MAXIMO_NIVEIS_LOD];
+        Uniform<bool> usarHiZ;
+        Uniform<glm::mat4> projecaoVisaoAnterior;
+        GLint tamanhoProfundidade = -1;   // ivec2
+    } uDescarte;
+    struct {
+        Uniform<int> origem, nivelOrigem;
+    } uReducao;
+
+    BufferGL visiveis;        // índices dos objetos, uma faixa de `capacidade` por nível
+    BufferGL bufferComandos;
+    BufferGL contadores[2];
+    std::vector<ComandoDesenhoIndireto> comandos;
+    size_t capacidade = 0;
+    size_t numObjetos = 0;
+    int numNiveis = 0;
+    unsigned quadro = 0;
+    double segundosRecorte = 0.0;
+
+    TexturaGL profundidade;   // DEPTH24_STENCIL8, o formato usual do framebuffer padrão
+    TexturaGL hiZ;            // R32F, nível 0 com metade do tamanho da tela
+    FramebufferGL copia;
+    int larguraProfundidade = 0, alturaProfundidade = 0;
+    int niveisHiZ = 0;
+    bool temHiZ = false;
+    bool copiaConferida = false, falhaCopia = false;
+    glm::mat4 projecaoVisaoAnterior = glm::mat4(1.0f);
+
+    void alocarTexturas(int largura, int altura) {
+        larguraProfundidade = largura;
+        alturaProfundidade = altura;
+        temHiZ = false;
+
+        profundidade.liberar();
+        profundidade.gerar();
+        glBindTexture(GL_TEXTURE_2D, profundidade);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, largura, altura, 0, GL_DEPTH_STENCIL,
+                     GL_UNSIGNED_INT_24_8, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+        copia.gerar();
+        glBindFramebuffer(GL_FRAMEBUFFER, copia);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, profundidade, 0);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cout << "ERRO::DESCARTE_GPU::FRAMEBUFFER_INCOMPLETO" << std::endl;
+            falhaCopia = true;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // imutável só na 4.2 (glTexStorage2D); aqui cada nível é alocado à parte
+        hiZ.liberar();
+        hiZ.gerar();
+        glBindTexture(GL_TEXTURE_2D, hiZ);
+        niveisHiZ = 0;
+        int l = std::max(1, largura / 2), a = std::max(1, altura / 2);
+        while (true) {
+            glTexImage2D(GL_TEXTURE_2D, niveisHiZ++, GL_R32F, l, a, 0, GL_RED, GL_FLOAT, nullptr);
+            if (l == 1 && a == 1) break;
+            l = std::max(1, l / 2);
+            a = std::max(1, a / 2);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, niveisHiZ - 1);
+    }
+};
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef DESENHO_INDIRETO_H
+#define DESENHO_INDIRETO_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <tuple>
+#include <chrono>
+#include <cstdint>
+
+#include "Mesh.h"
+#include "Instancias.h"
+#include "ExtensoesGL.h"
+
+// Mesmo layout de DrawElementsIndirectCommand.
+struct ComandoDesenhoIndireto {
+    GLuint numIndices;
+    GLuint numInstancias;
+    GLuint primeiroIndice;
+    GLint verticeBase;
+    GLuint instanciaBase;
+};
+
+static_assert(sizeof(ComandoDesenhoIndireto) == 20, "ComandoDesenhoIndireto precisa ter o layout do OpenGL");
+
+struct EstatisticasDesenhoIndireto {
+    size_t objetos = 0;      // adicionar() desde o último limpar()
+    size_t comandos = 0;     // um por mesh distinta
+    size_t lotes = 0;        // VAO + tipo de índice + primitiva + quantização
+    size_t chamadasGL = 0;   // glMultiDrawElementsIndirect ou glDrawElementsInstancedBaseVertex
+    bool multiDraw = false;
+    double segundosEnvio = 0.0;   // CPU em enviar(): comandos, buffers e submissão
+};
+
+// Cena inteira submetida de uma vez. Os objetos da mesma mesh viram um único
+// comando com várias instâncias, e a matriz e o material de cada um são
+// lidos dos fluxos de BufferInstancias a partir da instância base (shaders
+// com INSTANCIADO, PermutacoesShader.h). Comandos que dividem VAO, tipo de índice, primitiva e
+// quantização vão num só glMultiDrawElementsIndirect (OpenGL 4.3); sem ele,
+// cada comando vira um glDrawElementsInstancedBaseVertex.
+class ListaDesenhoIndireto {
+public:
+    EstatisticasDesenhoIndireto estatisticas;
+
+    ListaDesenhoIndireto() = default;
+    ListaDesenhoIndireto(const ListaDesenhoIndireto&) = delete;
+    ListaDesenhoIndireto& operator=(const ListaDesenhoIndireto&) = delete;
+
+    // Esquece as meshes do quadro: o mapa por endereço volta vazio, então
+    // meshes destruídas não deixam chaves para trás. Os grupos ficam alocados
+    // de um quadro para o outro e são reaproveitados, com os vetores esvaziados.
+    void limpar() {
+        for (uint32_t g = 0; g < gruposEmUso; g++) {
+            grupos[g].modelos.clear();
+            grupos[g].materiais.clear();
+        }
+        gruposEmUso = 0;
+        grupoPorMesh.clear();
+        ultimaMesh = nullptr;
+        estatisticas.objetos = 0;
+    }
+
+    // meshes distintas desde o último limpar()
+    size_t numGrupos() const { return gruposEmUso; }
+
+    // a mesh precisa continuar viva (e no mesmo endereço) até enviar()
+    void adicionar(const Mesh& mesh, const glm::mat4& modelo, GLuint material) {
+        GrupoMesh& grupo = grupoDe(mesh);
+        grupo.modelos.push_back(modelo);
+        grupo.materiais.push_back(material);
+        estatisticas.objetos++;
+    }
+
+    // alguma mesh da lista precisa de dequantização (variante VERTICE_COMPACTO)
+    bool quantizada() const {
+        for (uint32_t g = 0; g < gruposEmUso; g++)
+            if (!grupos[g].mesh->quantizacao.identidade()) return true;
+        return false;
+    }
+
+    void enviar(bool usarMultiDraw = true) {
+        auto inicio = std::chrono::steady_clock::now();
+        bool multiDraw = usarMultiDraw && ExtensoesGL::temMultiDrawIndireto();
+
+        // grupos do quadro, agrupados por lote
+        ordem.clear();
+        size_t totalInstancias = 0;
+        for (uint32_t g = 0; g < gruposEmUso; g++) {
+            grupos[g].faixa = grupos[g].mesh->faixaDesenho();
+            ordem.push_back(g);
+            totalInstancias += grupos[g].modelos.size();
+        }
+        std::sort(ordem.begin(), ordem.end(), [&](uint32_t a, uint32_t b) {
+            return chaveLote(grupos[a]) < chaveLote(grupos[b]);
+        });
+
+        // fluxos de instância e comandos, na ordem dos lotes
+        comandos.clear();
+        instancias.reservar(totalInstancias);
+        GLuint proximaInstancia = 0;
+        for (uint32_t g : ordem) {
+            GrupoMesh& grupo = grupos[g];
+            instancias.enviarFaixa(proximaInstancia, grupo.modelos.data(), grupo.materiais.data(),
+                                   grupo.modelos.size());
+
+            ComandoDesenhoIndireto comando;
+            comando.numIndices = (GLuint)grupo.faixa.numIndices;
+            comando.numInstancias = (GLuint)grupo.modelos.size();
+            comando.primeiroIndice = grupo.faixa.primeiroIndice;
+            comando.verticeBase = grupo.faixa.verticeBase;
+            comando.instanciaBase = proximaInstancia;
+            comandos.push_back(comando);
+            proximaInstancia += comando.numInstancias;
+        }
+
+        if (multiDraw && !comandos.empty()) {
+            bufferComandos.gerar();
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, bufferComandos);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, comandos.size() * sizeof(ComandoDesenhoIndireto),
+                         comandos.data(), GL_STREAM_DRAW);
+        }
+
+        // submissão, um lote por vez
+        estatisticas.comandos = comandos.size();
+        estatisticas.lotes = 0;
+        estatisticas.chamadasGL = 0;
+        estatisticas.multiDraw = multiDraw;
+        for (size_t i = 0; i < ordem.size();) {
+            size_t fim = i + 1;
+            while (fim < ordem.size() && chaveLote(grupos[ordem[fim]]) == chaveLote(grupos[ordem[i]])) fim++;
+
+            const GrupoMesh& primeiro = grupos[ordem[i]];
+            primeiro.mesh->prepararDesenho();
+            GLenum modo = primeiro.mesh->primitiva;
+            GLenum tipo = primeiro.faixa.tipoIndice;
+
+            if (multiDraw) {
+                instancias.vincularAtributos();
+                ExtensoesGL::multiDrawElementsIndirect(modo, tipo, (const void*)(i * sizeof(ComandoDesenhoIndireto)),
+                                                       (GLsizei)(fim - i), sizeof(ComandoDesenhoIndireto));
+                estatisticas.chamadasGL++;
+            } else {
+                // OpenGL 3.3: sem instância base, os ponteiros de instância são deslocados a cada comando
+                for (size_t c = i; c < fim; c++) {
+                    const ComandoDesenhoIndireto& comando = comandos[c];
+                    instancias.vincularAtributos(comando.instanciaBase);
+                    glDrawElementsInstancedBaseVertex(modo, comando.numIndices, tipo,
+                                                      (const void*)(comando.primeiroIndice * tamanhoTipoIndice(tipo)),
+                                                      comando.numInstancias, comando.verticeBase);
+                    estatisticas.chamadasGL++;
+                }
+            }
+            estatisticas.lotes++;
+            i = fim;
+        }
+
+        estatisticas.segundosEnvio =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+private:
+    struct GrupoMesh {
+        const Mesh* mesh = nullptr;
+        FaixaDesenho faixa;
+        std::vector<glm::mat4> modelos;
+        std::vector<GLuint> materiais;
+    };
+
+    std::vector<GrupoMesh> grupos;   // [0, gruposEmUso) em uso neste quadro
+    uint32_t gruposEmUso = 0;
+    std::unordered_map<const Mesh*, uint32_t> grupoPorMesh;   // só meshes do quadro atual
+    const Mesh* ultimaMesh = nullptr;   // objetos seguidos costumam repetir a mesh
+    uint32_t ultimoGrupo = 0;
+
+    std::vector<uint32_t> ordem;
+    std::vector<ComandoDesenhoIndireto> comandos;
+    BufferInstancias instancias;
+    BufferGL bufferComandos;
+
+    GrupoMesh& grupoDe(const Mesh& mesh) {
+        if (&mesh == ultimaMesh) return grupos[ultimoGrupo];
+
+        auto it = grupoPorMesh.find(&mesh);
+        if (it == grupoPorMesh.end()) {
+            it = grupoPorMesh.emplace(&mesh, gruposEmUso).first;
+            if (gruposEmUso == grupos.size()) grupos.emplace_back();
+            gruposEmUso++;
+        }
+        ultimaMesh = &mesh;
+        ultimoGrupo = it->second;
+        grupos[ultimoGrupo].mesh = &mesh;
+        return grupos[ultimoGrupo];
+    }
+
+    // desenhos com a mesma chave podem ir juntos num glMultiDrawElementsIndirect
+    typedef std::tuple<GLuint, GLenum, GLenum, bool, bool, float, float, float, float, float, float> ChaveLote;
+
+    static ChaveLote chaveLote(const GrupoMesh& grupo) {
+        const Quantizacao& q = grupo.mesh->quantizacao;
+        return std::make_tuple(grupo.faixa.vao, grupo.mesh->primitiva, grupo.faixa.tipoIndice,
+                               grupo.mesh->reinicioPrimitiva, q.normalOctaedrica,
+                               q.origem.x, q.origem.y, q.origem.z, q.escala.x, q.escala.y, q.escala.z);
+    }
+};
+
+#endif
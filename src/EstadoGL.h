@@ -0,0 +1,68 @@
+#ifndef ESTADO_GL_H
+#define ESTADO_GL_H
+
+#include <glad/glad.h>
+
+// Chamadas ao driver feitas e evitadas pelo cache, desde o último zerar().
+struct ContadoresEstadoGL {
+    size_t trocasPrograma = 0, programasEvitados = 0;
+    size_t trocasVAO = 0, vaosEvitados = 0;
+
+    void zerar() { *this = ContadoresEstadoGL(); }
+};
+
+// Cache do estado global do OpenGL que muda entre desenhos. Só chama o driver
+// quando o valor realmente muda.
+class EstadoGL {
+public:
+    inline static ContadoresEstadoGL contadores;
+
+    static void definirReinicioPrimitiva(bool ativo, GLuint indice) {
+        if (ativo != reinicioAtivo) {
+            if (ativo) glEnable(GL_PRIMITIVE_RESTART);
+            else       glDisable(GL_PRIMITIVE_RESTART);
+            reinicioAtivo = ativo;
+        }
+        if (ativo && indice != indiceReinicio) {
+            glPrimitiveRestartIndex(indice);
+            indiceReinicio = indice;
+        }
+    }
+
+    // Todo vínculo de VAO passa por aqui; desenhos seguidos do mesmo VAO (ex.:
+    // meshes da mesma arena) não chamam o driver, e ninguém precisa desvincular.
+    static void vincularVAO(GLuint vao) {
+        if (vao != vaoAtual) {
+            glBindVertexArray(vao);
+            vaoAtual = vao;
+            contadores.trocasVAO++;
+        } else {
+            contadores.vaosEvitados++;
+        }
+    }
+
+    // ao deletar o VAO vinculado o OpenGL volta para o 0
+    static void esquecerVAO(GLuint vao) {
+        if (vao == vaoAtual) vaoAtual = 0;
+    }
+
+    // usado por Shader::usar()
+    static void usarPrograma(GLuint programa) {
+        if (programa != programaAtual) {
+            glUseProgram(programa);
+            programaAtual = programa;
+            contadores.trocasPrograma++;
+        } else {
+            contadores.programasEvitados++;
+        }
+    }
+
+private:
+    // valores iniciais do OpenGL
+    inline static bool reinicioAtivo = false;
+    inline static GLuint indiceReinicio = 0;
+    inline static GLuint vaoAtual = 0;
+    inline static GLuint programaAtual = 0;
+};
+
+#endif
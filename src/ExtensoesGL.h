@@ -0,0 +1,142 @@
+#ifndef EXTENSOES_GL_H
+#define EXTENSOES_GL_H
+
+#include <glad/glad.h>
+#include <cstring>
+
+// O glad do projeto é gerado para OpenGL 3.3 core. Funções de versões mais
+// novas são carregadas aqui, em tempo de execução, e ficam nulas quando o
+// contexto não as oferece; quem usa testa antes e cai num caminho 3.3.
+
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+// computação (4.2/4.3)
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#define GL_ATOMIC_COUNTER_BUFFER 0x92C0
+#define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT 0x00000001
+#define GL_TEXTURE_FETCH_BARRIER_BIT 0x00000008
+#define GL_SHADER_IMAGE_ACCESS_BARRIER_BIT 0x00000020
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#define GL_ATOMIC_COUNTER_BARRIER_BIT 0x00001000
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+
+// armazenamento imutável e mapeamento persistente (4.4 / ARB_buffer_storage)
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+
+// tipos de uniform depois da 3.3: samplers de cubo em array (4.0) e imagens
+// (4.2), que vão de GL_IMAGE_1D a GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY
+#ifndef GL_SAMPLER_CUBE_MAP_ARRAY
+#define GL_SAMPLER_CUBE_MAP_ARRAY 0x900C
+#define GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW 0x900D
+#define GL_INT_SAMPLER_CUBE_MAP_ARRAY 0x900E
+#define GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY 0x900F
+#endif
+#ifndef GL_IMAGE_1D
+#define GL_IMAGE_1D 0x904C
+#define GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY 0x906C
+#endif
+
+// binário de programa (4.1 / ARB_get_program_binary)
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+typedef void (APIENTRYP FuncMultiDrawElementsIndirect)(GLenum modo, GLenum tipo, const void* indireto,
+                                                       GLsizei numDesenhos, GLsizei stride);
+typedef void (APIENTRYP FuncDispatchCompute)(GLuint gruposX, GLuint gruposY, GLuint gruposZ);
+typedef void (APIENTRYP FuncMemoryBarrier)(GLbitfield barreiras);
+typedef void (APIENTRYP FuncBindImageTexture)(GLuint unidade, GLuint textura, GLint nivel, GLboolean camadas,
+                                              GLint camada, GLenum acesso, GLenum formato);
+typedef void (APIENTRYP FuncBufferStorage)(GLenum alvo, GLsizeiptr tamanho, const void* dados, GLbitfield flags);
+typedef void (APIENTRYP FuncGetProgramBinary)(GLuint programa, GLsizei tamanhoBuffer, GLsizei* tamanho,
+                                              GLenum* formato, void* binario);
+typedef void (APIENTRYP FuncProgramBinary)(GLuint programa, GLenum formato, const void* binario, GLsizei tamanho);
+typedef void (APIENTRYP FuncProgramParameteri)(GLuint programa, GLenum nome, GLint valor);
+
+class ExtensoesGL {
+public:
+    inline static GLint versaoMaior = 3;
+    inline static GLint versaoMenor = 3;
+
+    // 4.3 (ARB_multi_draw_indirect)
+    inline static FuncMultiDrawElementsIndirect multiDrawElementsIndirect = nullptr;
+
+    // 4.3 (compute shaders, com imagens e barreiras da 4.2)
+    inline static FuncDispatchCompute dispatchCompute = nullptr;
+    inline static FuncMemoryBarrier memoryBarrier = nullptr;
+    inline static FuncBindImageTexture bindImageTexture = nullptr;
+
+    // 4.4 (ARB_buffer_storage, que também existe como extensão em contextos 3.3)
+    inline static FuncBufferStorage bufferStorage = nullptr;
+
+    // 4.1 (ARB_get_program_binary, também como extensão em contextos 3.3)
+    inline static FuncGetProgramBinary getProgramBinary = nullptr;
+    inline static FuncProgramBinary programBinary = nullptr;
+    inline static FuncProgramParameteri programParameteri = nullptr;
+    inline static GLint formatosBinario = 0;   // GL_NUM_PROGRAM_BINARY_FORMATS
+
+    // chamar depois do gladLoadGLLoader, com o mesmo carregador
+    static void carregar(GLADloadproc carregador) {
+        glGetIntegerv(GL_MAJOR_VERSION, &versaoMaior);
+        glGetIntegerv(GL_MINOR_VERSION, &versaoMenor);
+
+        if (versao(4, 3)) {
+            multiDrawElementsIndirect = (FuncMultiDrawElementsIndirect)carregador("glMultiDrawElementsIndirect");
+            dispatchCompute = (FuncDispatchCompute)carregador("glDispatchCompute");
+            memoryBarrier = (FuncMemoryBarrier)carregador("glMemoryBarrier");
+            bindImageTexture = (FuncBindImageTexture)carregador("glBindImageTexture");
+        }
+        if (versao(4, 4) || temExtensao("GL_ARB_buffer_storage"))
+            bufferStorage = (FuncBufferStorage)carregador("glBufferStorage");
+        if (versao(4, 1) || temExtensao("GL_ARB_get_program_binary")) {
+            getProgramBinary = (FuncGetProgramBinary)carregador("glGetProgramBinary");
+            programBinary = (FuncProgramBinary)carregador("glProgramBinary");
+            programParameteri = (FuncProgramParameteri)carregador("glProgramParameteri");
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatosBinario);
+        }
+    }
+
+    static bool temExtensao(const char* nome) {
+        GLint quantidade = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &quantidade);
+        for (GLint i = 0; i < quantidade; i++) {
+            const char* extensao = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+            if (extensao && std::strcmp(extensao, nome) == 0) return true;
+        }
+        return false;
+    }
+
+    static bool versao(int maior, int menor) {
+        return versaoMaior > maior || (versaoMaior == maior && versaoMenor >= menor);
+    }
+
+    static bool temMultiDrawIndireto() { return multiDrawElementsIndirect != nullptr; }
+
+    static bool temMapeamentoPersistente() { return bufferStorage != nullptr; }
+
+    // o driver pode ter as funções e nenhum formato (alguns Mesa antigos)
+    static bool temBinarioPrograma() {
+        return getProgramBinary != nullptr && programBinary != nullptr && programParameteri != nullptr &&
+               formatosBinario > 0;
+    }
+
+    static bool temComputacao() {
+        return dispatchCompute != nullptr && memoryBarrier != nullptr && bindImageTexture != nullptr &&
+               temMultiDrawIndireto();
+    }
+};
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef FILA_RENDERIZACAO_H
+#define FILA_RENDERIZACAO_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "Shader.h"
+#include "Mesh.h"
+#include "Light.h"
+#include "EstadoGL.h"
+#include "AnelObjetos.h"
+#include "Transformacoes.h"
+
+enum class PasseRenderizacao : uint8_t {
+    Opaco = 0,
+    Transparente = 1
+};
+
+struct EstatisticasFila {
+    size_t desenhos = 0;
+    size_t trocasPrograma = 0, programasEvitados = 0;
+    size_t trocasVAO = 0, vaosEvitados = 0;
+    size_t trocasMaterial = 0, uniformsEvitados = 0;   // uniforms de material não reenviados
+    size_t regioesAnel = 0;          // mapeamentos do AnelObjetos no quadro
+    double segundosEsperaAnel = 0.0;   // dentro de segundosExecucao: cercas testadas ou esperadas
+    double segundosOrdenacao = 0.0;
+    double segundosExecucao = 0.0;
+};
+
+// Ordena radix (LSD, 8 bits por passada) pares chave/item pela chave. Os oito
+// histogramas saem de uma leitura só, e passadas em que todos têm o mesmo
+// byte são puladas, o que é comum nos bytes altos (poucos passes e shaders).
+struct ChaveItem {
+    uint64_t chave;
+    uint32_t item;
+};
+
+inline void ordenarRadix(std::vector<ChaveItem>& itens, std::vector<ChaveItem>& auxiliar) {
+    if (itens.size() < 2) return;
+    auxiliar.resize(itens.size());
+
+    static thread_local size_t contagem[8][256];
+    std::memset(contagem, 0, sizeof(contagem));
+    for (const ChaveItem& c : itens)
+        for (int b = 0; b < 8; b++) contagem[b][(c.chave >> (b * 8)) & 0xFF]++;
+
+    for (int b = 0; b < 8; b++) {
+        const int deslocamento = b * 8;
+        if (contagem[b][(itens[0].chave >> deslocamento) & 0xFF] == itens.size()) continue;
+
+        size_t soma = 0;
+        for (size_t& n : contagem[b]) {
+            size_t atual = n;
+            n = soma;
+            soma += atual;
+        }
+        for (const ChaveItem& c : itens) auxiliar[contagem[b][(c.chave >> deslocamento) & 0xFF]++] = c;
+        itens.swap(auxiliar);
+    }
+}
+
+// Fila de desenhos por objeto, ordenada a cada quadro por uma chave de 64 bits
+// para agrupar estado:
+//
+//   opaco:        passe(4) | shader(8) | material(12) | mesh(16) | profundidade(24)
+//   transparente: passe(4) | profundidade invertida(24) | shader(8) | material(12) | mesh(16)
+//
+// Opacos saem da frente para trás dentro do mesmo estado (aproveita o early-z);
+// transparentes, de trás para frente, que é o que a mistura exige. Na execução
+// o programa e o VAO passam pelo EstadoGL, e os uniforms de material só são
+// enviados quando o material muda para aquele shader.
+//
+// Matriz modelo, matriz normal e índice de material de cada desenho vão para
+// um AnelObjetos, escritos de uma vez na ordem da execução; as matrizes
+// normais saem antes, todas num lote só (Transformacoes.h). Por desenho sobra
+// um glUniform1i (indiceObjeto) com a posição do registro. Os shaders
+// registrados leem os registros do samplerBuffer `objetos`.
+//
+// Os ids na chave são atribuídos no primeiro uso de cada shader, material e
+// mesh; passar do limite de bits só piora o agrupamento, já que a execução
+// compara ponteiros e não ids.
+class FilaRenderizacao {
+public:
+    typedef std::function<void(const Shader&)> FuncaoPreparar;
+    typedef std::function<void(const Shader&, const Material&)> FuncaoMaterial;
+
+    EstatisticasFila estatisticas;
+
+    // preparar roda uma vez por quadro, antes do primeiro desenho do shader
+    // (câmera, luzes); definirMaterial roda a cada troca de material e faz
+    // uniformsPorMaterial envios, o que entra na contagem de evitados.
+    uint32_t registrarShader(const Shader& shader, FuncaoPreparar preparar, FuncaoMaterial definirMaterial,
+                             size_t uniformsPorMaterial = 4) {
+        shaders.push_back({&shader, std::move(preparar), std::move(definirMaterial), uniformsPorMaterial,
+                           shader.uniform<int>("indiceObjeto")});
+        shader.usar();
+        shader.uniform<int>("objetos").definir((int)UNIDADE_TEXTURA_OBJETOS);
+        return (uint32_t)shaders.size() - 1;
+    }
+
+    // A profundidade é a distância ao longo de direcaoCamera, quantizada em
+    // 24 bits até distanciaMaxima.
+    void iniciar(const glm::vec3& posicaoCamera, const glm::vec3& direcaoCamera, float distanciaMaxima) {
+        camera = posicaoCamera;
+        direcao = glm::normalize(direcaoCamera);
+        escalaProfundidade = distanciaMaxima > 0.0f ? (float)MASCARA_PROFUNDIDADE / distanciaMaxima : 0.0f;
+        itens.clear();
+        chaves.clear();
+    }
+
+    // indiceMaterial >= 0 escolhe um dos materiais[] do BlocoMateriais no
+    // lugar dos uniforms de `material`
+    void adicionar(uint32_t shader, const Mesh& mesh, const Material& material, const glm::mat4& modelo,
+                   PasseRenderizacao passe = PasseRenderizacao::Opaco, GLint indiceMaterial = -1) {
+        glm::vec3 centroLocal = (mesh.limiteMin + mesh.limiteMax) * 0.5f;
+        glm::vec3 centro = glm::vec3(modelo * glm::vec4(centroLocal, 1.0f));
+        float distancia = glm::dot(centro - camera, direcao) * escalaProfundidade;
+        uint64_t profundidade = (uint64_t)std::min(std::max(distancia, 0.0f), (float)MASCARA_PROFUNDIDADE);
+
+        uint64_t idShader = shader & 0xFF;
+        uint64_t idMaterial = idDe(idsMaterial, &material) & 0xFFF;
+        uint64_t idMesh = idDe(idsMesh, &mesh) & 0xFFFF;
+        uint64_t chave = (uint64_t)passe << 60;
+        if (passe == PasseRenderizacao::Opaco)
+            chave |= idShader << 52 | idMaterial << 40 | idMesh << 24 | profundidade;
+        else
+            chave |= (MASCARA_PROFUNDIDADE - profundidade) << 36 | idShader << 28 | idMaterial << 16 | idMesh;
+
+        chaves.push_back({chave, (uint32_t)itens.size()});
+        itens.push_back({shader, &mesh, &material, modelo, indiceMaterial});
+    }
+
+    const EstatisticasAnel& estatisticasAnel() const { return anel.estatisticas; }
+
+    void executar() {
+        auto inicio = std::chrono::steady_clock::now();
+        ordenarRadix(chaves, auxiliar);
+        auto ordenado = std::chrono::steady_clock::now();
+
+        ContadoresEstadoGL antes = EstadoGL::contadores;
+        estatisticas.trocasMaterial = 0;
+        estatisticas.uniformsEvitados = 0;
+
+        estatisticas.regioesAnel = 0;
+        estatisticas.segundosEsperaAnel = 0.0;
+
+        // uniforms de material são estado do programa: um "último material" por shader
+        materialAtual.assign(shaders.size(), nullptr);
+        preparado.assign(shaders.size(), false);
+
+        // na ordem de adicionar(); a fila recebe qualquer modelo, então sem o caminho de escala uniforme
+        normais.resize(itens.size() * 3);
+        if (!itens.empty())
+            transformacoes::calcularNormais(&itens[0].modelo, sizeof(Item), normais.data(), 3 * sizeof(glm::vec4),
+                                            itens.size(), false);
+
+        // em partes quando a fila passa do que cabe numa região do anel
+        for (size_t primeiro = 0; primeiro < chaves.size();) {
+            size_t n = std::min(chaves.size() - primeiro, anel.maximoPorRegiao());
+            RegistroObjeto* registros = anel.mapear(n);
+            if (!registros) {
+                std::cout << "ERRO::FILA::ANEL_NAO_MAPEADO" << std::endl;
+                break;
+            }
+            for (size_t k = 0; k < n; k++) {
+                uint32_t i = chaves[primeiro + k].item;
+                registros[k].definir(itens[i].modelo, &normais[i * 3], itens[i].indiceMaterial);
+            }
+            anel.desmapear();
+            estatisticas.regioesAnel++;
+            estatisticas.segundosEsperaAnel += anel.estatisticas.segundosEspera;
+
+            GLint registroBase = anel.primeiroRegistro();
+            for (size_t k = 0; k < n; k++) {
+                const Item& item = itens[chaves[primeiro + k].item];
+                const EntradaShader& entrada = shaders[item.shader];
+
+                entrada.shader->usar();
+                if (!preparado[item.shader]) {
+                    if (entrada.preparar) entrada.preparar(*entrada.shader);
+                    preparado[item.shader] = true;
+                }
+                if (materialAtual[item.shader] != item.material) {
+                    entrada.definirMaterial(*entrada.shader, *item.material);
+                    materialAtual[item.shader] = item.material;
+                    estatisticas.trocasMaterial++;
+                } else {
+                    estatisticas.uniformsEvitados += entrada.uniformsPorMaterial;
+                }
+
+                entrada.indiceObjeto.definir(registroBase + (GLint)k);
+                item.mesh->desenhar();
+            }
+            anel.cercar();
+            primeiro += n;
+        }
+
+        const ContadoresEstadoGL& depois = EstadoGL::contadores;
+        estatisticas.desenhos = chaves.size();
+        estatisticas.trocasPrograma = depois.trocasPrograma - antes.trocasPrograma;
+        estatisticas.programasEvitados = depois.programasEvitados - antes.programasEvitados;
+        estatisticas.trocasVAO = depois.trocasVAO - antes.trocasVAO;
+        estatisticas.vaosEvitados = depois.vaosEvitados - antes.vaosEvitados;
+        estatisticas.segundosOrdenacao = std::chrono::duration<double>(ordenado - inicio).count();
+        estatisticas.segundosExecucao =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - ordenado).count();
+    }
+
+private:
+    static const uint64_t MASCARA_PROFUNDIDADE = 0xFFFFFF;
+
+    struct EntradaShader {
+        const Shader* shader;
+        FuncaoPreparar preparar;
+        FuncaoMaterial definirMaterial;
+        size_t uniformsPorMaterial;
+        Uniform<int> indiceObjeto;
+    };
+
+    struct Item {
+        uint32_t shader;
+        const Mesh* mesh;
+        const Material* material;
+        glm::mat4 modelo;
+        GLint indiceMaterial;
+    };
+
+    std::vector<EntradaShader> shaders;
+    std::vector<Item> itens;
+    std::vector<ChaveItem> chaves, auxiliar;
+    std::vector<glm::vec4> normais;   // três colunas por item
+    std::vector<const Material*> materialAtual;
+    std::vector<bool> preparado;
+    AnelObjetos anel;
+    std::unordered_map<const void*, uint32_t> idsMaterial, idsMesh;
+
+    glm::vec3 camera = glm::vec3(0.0f);
+    glm::vec3 direcao = glm::vec3(0.0f, 0.0f, -1.0f);
+    float escalaProfundidade = 0.0f;
+
+    static uint32_t idDe(std::unordered_map<const void*, uint32_t>& ids, const void* ponteiro) {
+        auto it = ids.find(ponteiro);
+        if (it != ids.end()) return it->second;
+        uint32_t id = (uint32_t)ids.size();
+        ids.emplace(ponteiro, id);
+        return id;
+    }
+};
+
+#endif
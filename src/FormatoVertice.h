@@ -0,0 +1,295 @@
+#ifndef FORMATO_VERTICE_H
+#define FORMATO_VERTICE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+struct Vertice {
+    glm::vec3 posicao;
+    glm::vec3 normal;
+    glm::vec2 coordTextura;
+};
+
+// o layout Float/Float/Float envia o vetor de Vertice direto, sem reempacotar
+static_assert(sizeof(Vertice) == 8 * sizeof(float), "Vertice precisa ser 8 floats sem padding");
+
+// Formatos de armazenamento na GPU. Na CPU os vértices continuam como Vertice
+// (8 floats); o empacotamento só acontece no upload.
+enum class FormatoPosicao {
+    Float,      // 3 floats (12 B)
+    Snorm16     // 3 shorts normalizados relativos à AABB da mesh (8 B com padding)
+};
+
+enum class FormatoNormal {
+    Float,          // 3 floats (12 B)
+    Octaedrica16,   // 2 shorts normalizados, codificação octaédrica (4 B)
+    Int2101010      // GL_INT_2_10_10_10_REV (4 B)
+};
+
+enum class FormatoUV {
+    Float,  // 2 floats (8 B)
+    Half    // 2 half floats (4 B)
+};
+
+struct FormatoVertice {
+    FormatoPosicao posicao = FormatoPosicao::Float;
+    FormatoNormal normal   = FormatoNormal::Float;
+    FormatoUV uv           = FormatoUV::Float;
+
+    // 16 bytes por vértice em vez de 32
+    static FormatoVertice compacto() {
+        FormatoVertice f;
+        f.posicao = FormatoPosicao::Snorm16;
+        f.normal  = FormatoNormal::Octaedrica16;
+        f.uv      = FormatoUV::Half;
+        return f;
+    }
+
+    bool padrao() const {
+        return posicao == FormatoPosicao::Float && normal == FormatoNormal::Float && uv == FormatoUV::Float;
+    }
+};
+
+// Descrição de um atributo: é exatamente o que vai para glVertexAttribPointer.
+struct AtributoVertice {
+    GLuint local;
+    GLint componentes;
+    GLenum tipo;
+    GLboolean normalizado;
+    GLsizei stride;
+    size_t deslocamento;
+};
+
+// O layout é quem configura o VAO; nenhum tipo/offset fica hardcoded na Mesh.
+struct LayoutVertice {
+    static const int MAX_ATRIBUTOS = 3;
+
+    AtributoVertice atributos[MAX_ATRIBUTOS];
+    int numAtributos = 0;
+    GLsizei tamanhoVertice = 0;
+
+    // stride 0 = tamanhoVertice (vértice intercalado)
+    void adicionar(GLuint local, GLint componentes, GLenum tipo, GLboolean normalizado, size_t deslocamento,
+                   GLsizei stride = 0) {
+        atributos[numAtributos++] = {local, componentes, tipo, normalizado, stride, deslocamento};
+    }
+
+    // aplica no VAO/VBO atualmente vinculados
+    void aplicar() const {
+        for (int i = 0; i < numAtributos; i++) {
+            const AtributoVertice& a = atributos[i];
+            GLsizei stride = a.stride != 0 ? a.stride : tamanhoVertice;
+            glEnableVertexAttribArray(a.local);
+            glVertexAttribPointer(a.local, a.componentes, a.tipo, a.normalizado, stride, (void*)a.deslocamento);
+        }
+    }
+
+    static LayoutVertice para(const FormatoVertice& formato) {
+        LayoutVertice layout;
+        size_t deslocamento = 0;
+
+        if (formato.posicao == FormatoPosicao::Float) {
+            layout.adicionar(0, 3, GL_FLOAT, GL_FALSE, deslocamento);
+            deslocamento += 3 * sizeof(float);
+        } else {
+            layout.adicionar(0, 3, GL_SHORT, GL_TRUE, deslocamento);
+            deslocamento += 4 * sizeof(int16_t);   // 4º short é padding para alinhar em 4
+        }
+
+        switch (formato.normal) {
+        case FormatoNormal::Float:
+            layout.adicionar(1, 3, GL_FLOAT, GL_FALSE, deslocamento);
+            deslocamento += 3 * sizeof(float);
+            break;
+        case FormatoNormal::Octaedrica16:
+            layout.adicionar(1, 2, GL_SHORT, GL_TRUE, deslocamento);
+            deslocamento += 2 * sizeof(int16_t);
+            break;
+        case FormatoNormal::Int2101010:
+            // formatos empacotados exigem 4 componentes; o shader usa só xyz
+            layout.adicionar(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, deslocamento);
+            deslocamento += sizeof(uint32_t);
+            break;
+        }
+
+        if (formato.uv == FormatoUV::Float) {
+            layout.adicionar(2, 2, GL_FLOAT, GL_FALSE, deslocamento);
+            deslocamento += 2 * sizeof(float);
+        } else {
+            layout.adicionar(2, 2, GL_HALF_FLOAT, GL_FALSE, deslocamento);
+            deslocamento += 2 * sizeof(uint16_t);
+        }
+
+        layout.tamanhoVertice = (GLsizei)deslocamento;
+        return layout;
+    }
+};
+
+// Constantes para os shaders reconstruírem os dados. Vão como atributos
+// genéricos (locations 3 e 4, sem array ativo no VAO), então não dependem de
+// nenhum uniform específico de programa:
+//   posicao = origem + escala * atributo
+//   origem.w = 1 quando a normal está em codificação octaédrica
+struct Quantizacao {
+    glm::vec3 origem = glm::vec3(0.0f);
+    glm::vec3 escala = glm::vec3(1.0f);
+    bool normalOctaedrica = false;
+
+    // atributos já em float: o shader sem VERTICE_COMPACTO basta
+    bool identidade() const {
+        return !normalOctaedrica && origem == glm::vec3(0.0f) && escala == glm::vec3(1.0f);
+    }
+
+    void aplicar() const {
+        glVertexAttrib4f(3, origem.x, origem.y, origem.z, normalOctaedrica ? 1.0f : 0.0f);
+        glVertexAttrib3f(4, escala.x, escala.y, escala.z);
+    }
+};
+
+namespace empacotamento {
+
+inline int16_t paraSnorm16(float v) {
+    v = std::min(std::max(v, -1.0f), 1.0f);
+    return (int16_t)std::lround(v * 32767.0f);
+}
+
+// float32 -> float16 com arredondamento para o par mais próximo
+inline uint16_t paraHalf(float valor) {
+    uint32_t x;
+    std::memcpy(&x, &valor, sizeof(x));
+
+    uint32_t sinal = (x >> 16) & 0x8000u;
+    uint32_t expBruto = (x >> 23) & 0xFFu;
+    uint32_t mantissa = x & 0x7FFFFFu;
+
+    if (expBruto == 0xFFu)  // inf / NaN
+        return (uint16_t)(sinal | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+    int32_t exp = (int32_t)expBruto - 127 + 15;
+    if (exp >= 31)
+        return (uint16_t)(sinal | 0x7C00u);
+
+    if (exp <= 0) {
+        // subnormal em half
+        if (exp < -10) return (uint16_t)sinal;
+        mantissa |= 0x800000u;
+        uint32_t deslocamento = (uint32_t)(14 - exp);
+        uint32_t h = mantissa >> deslocamento;
+        uint32_t resto = mantissa & ((1u << deslocamento) - 1u);
+        uint32_t meio = 1u << (deslocamento - 1u);
+        if (resto > meio || (resto == meio && (h & 1u))) h++;
+        return (uint16_t)(sinal | h);
+    }
+
+    uint32_t h = sinal | ((uint32_t)exp << 10) | (mantissa >> 13);
+    uint32_t resto = mantissa & 0x1FFFu;
+    if (resto > 0x1000u || (resto == 0x1000u && (h & 1u))) h++;  // o carry pode subir para o expoente, o que é correto
+    return (uint16_t)h;
+}
+
+// normal unitária -> quadrado [-1,1]² (projeção no octaedro, hemisfério de baixo dobrado)
+inline glm::vec2 paraOctaedrica(glm::vec3 n) {
+    float soma = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+    if (soma == 0.0f) return glm::vec2(0.0f, 0.0f);
+    n /= soma;
+
+    glm::vec2 e(n.x, n.y);
+    if (n.z < 0.0f) {
+        float sx = e.x >= 0.0f ? 1.0f : -1.0f;
+        float sy = e.y >= 0.0f ? 1.0f : -1.0f;
+        e = glm::vec2((1.0f - std::fabs(n.y)) * sx, (1.0f - std::fabs(n.x)) * sy);
+    }
+    return e;
+}
+
+inline uint32_t paraInt2101010(const glm::vec3& n) {
+    auto componente = [](float v) {
+        v = std::min(std::max(v, -1.0f), 1.0f);
+        return (uint32_t)((int32_t)std::lround(v * 511.0f) & 0x3FF);
+    };
+    return componente(n.x) | (componente(n.y) << 10) | (componente(n.z) << 20);
+}
+
+}
+
+// Empacota os vértices no formato pedido. limiteMin/limiteMax são a AABB usada
+// na quantização das posições.
+inline std::vector<unsigned char> empacotarVertices(const std::vector<Vertice>& vertices,
+                                                    const FormatoVertice& formato,
+                                                    const LayoutVertice& layout,
+                                                    const glm::vec3& limiteMin,
+                                                    const glm::vec3& limiteMax,
+                                                    Quantizacao& quant) {
+    using namespace empacotamento;
+
+    quant = Quantizacao();
+    quant.normalOctaedrica = formato.normal == FormatoNormal::Octaedrica16;
+
+    glm::vec3 centro = (limiteMin + limiteMax) * 0.5f;
+    glm::vec3 meiaExtensao = (limiteMax - limiteMin) * 0.5f;
+    glm::vec3 inversoExtensao(0.0f);
+    if (formato.posicao == FormatoPosicao::Snorm16) {
+        quant.origem = centro;
+        quant.escala = meiaExtensao;
+        for (int c = 0; c < 3; c++)
+            inversoExtensao[c] = meiaExtensao[c] > 0.0f ? 1.0f / meiaExtensao[c] : 0.0f;
+    }
+
+    const size_t stride = layout.tamanhoVertice;
+    const size_t desPos = layout.atributos[0].deslocamento;
+    const size_t desNormal = layout.atributos[1].deslocamento;
+    const size_t desUV = layout.atributos[2].deslocamento;
+
+    std::vector<unsigned char> dados(vertices.size() * stride, 0);
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        const Vertice& v = vertices[i];
+        unsigned char* destino = dados.data() + i * stride;
+
+        if (formato.posicao == FormatoPosicao::Float) {
+            std::memcpy(destino + desPos, &v.posicao, sizeof(glm::vec3));
+        } else {
+            int16_t q[4] = {
+                paraSnorm16((v.posicao.x - centro.x) * inversoExtensao.x),
+                paraSnorm16((v.posicao.y - centro.y) * inversoExtensao.y),
+                paraSnorm16((v.posicao.z - centro.z) * inversoExtensao.z),
+                0
+            };
+            std::memcpy(destino + desPos, q, sizeof(q));
+        }
+
+        switch (formato.normal) {
+        case FormatoNormal::Float:
+            std::memcpy(destino + desNormal, &v.normal, sizeof(glm::vec3));
+            break;
+        case FormatoNormal::Octaedrica16: {
+            glm::vec2 e = paraOctaedrica(v.normal);
+            int16_t q[2] = { paraSnorm16(e.x), paraSnorm16(e.y) };
+            std::memcpy(destino + desNormal, q, sizeof(q));
+            break;
+        }
+        case FormatoNormal::Int2101010: {
+            uint32_t p = paraInt2101010(v.normal);
+            std::memcpy(destino + desNormal, &p, sizeof(p));
+            break;
+        }
+        }
+
+        if (formato.uv == FormatoUV::Float) {
+            std::memcpy(destino + desUV, &v.coordTextura, sizeof(glm::vec2));
+        } else {
+            uint16_t h[2] = { paraHalf(v.coordTextura.x), paraHalf(v.coordTextura.y) };
+            std::memcpy(destino + desUV, h, sizeof(h));
+        }
+    }
+
+    return dados;
+}
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRUSTUM_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRUSTUM_SSE2 1
+#endif
+
+#include "Mesh.h"
+#include "Paralelo.h"
+
+// Seis planos (esquerda, direita, baixo, cima, perto, longe) com a normal
+// apontando para dentro: um ponto p está do lado de dentro quando
+// dot(normal, p) + d >= 0.
+struct Frustum {
+    glm::vec4 planos[6];
+
+    // Extração de Gribb e Hartmann a partir de projecao * visao; os planos
+    // saem em espaço de mundo e normalizados, para a distância valer em unidades.
+    static Frustum daMatriz(const glm::mat4& projecaoVisao) {
+        const glm::mat4& m = projecaoVisao;
+        glm::vec4 linha[4];
+        for (int i = 0; i < 4; i++) linha[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+        Frustum f;
+        f.planos[0] = linha[3] + linha[0];
+        f.planos[1] = linha[3] - linha[0];
+        f.planos[2] = linha[3] + linha[1];
+        f.planos[3] = linha[3] - linha[1];
+        f.planos[4] = linha[3] + linha[2];
+        f.planos[5] = linha[3] - linha[2];
+        for (glm::vec4& p : f.planos) p /= glm::length(glm::vec3(p));
+        return f;
+    }
+
+    // AABB dada por centro e meia extensão, em espaço de mundo
+    bool caixaVisivel(const glm::vec3& centro, const glm::vec3& extensao) const {
+        for (const glm::vec4& p : planos) {
+            glm::vec3 n(p);
+            float distancia = glm::dot(n, centro) + p.w;
+            if (distancia < -glm::dot(glm::abs(n), extensao)) return false;
+        }
+        return true;
+    }
+
+    bool esferaVisivel(const glm::vec3& centro, float raio) const {
+        for (const glm::vec4& p : planos)
+            if (glm::dot(glm::vec3(p), centro) + p.w < -raio) return false;
+        return true;
+    }
+
+    // AABB local levada pelo modelo (a caixa que envolve a caixa transformada)
+    bool caixaVisivel(const glm::vec3& minimo, const glm::vec3& maximo, const glm::mat4& modelo) const {
+        glm::vec3 centro, extensao;
+        transformarCaixa(minimo, maximo, modelo, centro, extensao);
+        return caixaVisivel(centro, extensao);
+    }
+
+    bool visivel(const Mesh& mesh, const glm::mat4& modelo) const {
+        return caixaVisivel(mesh.limiteMin, mesh.limiteMax, modelo);
+    }
+
+    // centro = M * c; extensão = |M3x3| * e (Arvo)
+    static void transformarCaixa(const glm::vec3& minimo, const glm::vec3& maximo, const glm::mat4& modelo,
+                                 glm::vec3& centro, glm::vec3& extensao) {
+        glm::vec3 c = (minimo + maximo) * 0.5f;
+        glm::vec3 e = (maximo - minimo) * 0.5f;
+        centro = glm::vec3(modelo * glm::vec4(c, 1.0f));
+        extensao = glm::abs(glm::vec3(modelo[0])) * e.x + glm::abs(glm::vec3(modelo[1])) * e.y +
+                   glm::abs(glm::vec3(modelo[2])) * e.z;
+    }
+};
+
+struct EstatisticasDescarte {
+    size_t testados = 0;
+    size_t visiveis = 0;
+    unsigned threads = 1;
+    double segundos = 0.0;   // só o teste e a compactação, sem o adicionar()
+};
+
+// Descarte em lote. Os limites de cada objeto ficam em espaço de mundo e em
+// SoA (um vetor por componente), para que o teste carregue 4 objetos por
+// registrador SSE2 (8 com AVX) e compare contra os seis planos de uma vez.
+// Um objeto é descartado quando sai por algum plano pela esfera ou pela
+// AABB, o que for mais justo para aquele plano. Com muitos objetos o
+// trabalho é dividido entre threads em blocos de tamanho fixo, que depois são
+// compactados numa lista única de índices visíveis.
+class DescarteFrustum {
+public:
+    EstatisticasDescarte estatisticas;
+
+    void limpar() {
+        for (std::vector<float>* v : {&cx, &cy, &cz, &ex, &ey, &ez, &raios}) v->clear();
+    }
+
+    void reservar(size_t n) {
+        for (std::vector<float>* v : {&cx, &cy, &cz, &ex, &ey, &ez, &raios}) v->reserve(n);
+    }
+
+    size_t tamanho() const { return cx.size(); }
+
+    // devolve o índice do objeto, que é o que recortar() lista
+    uint32_t adicionar(const glm::vec3& centro, const glm::vec3& extensao, float raio) {
+        cx.push_back(centro.x);
+        cy.push_back(centro.y);
+        cz.push_back(centro.z);
+        ex.push_back(extensao.x);
+        ey.push_back(extensao.y);
+        ez.push_back(extensao.z);
+        raios.push_back(raio);
+        return (uint32_t)cx.size() - 1;
+    }
+
+    // A esfera acompanha a maior escala do modelo.
+    uint32_t adicionar(const Mesh& mesh, const glm::mat4& modelo) {
+        glm::vec3 centro, extensao;
+        Frustum::transformarCaixa(mesh.limiteMin, mesh.limiteMax, modelo, centro, extensao);
+        float escalaQuadrada = std::max(glm::dot(glm::vec3(modelo[0]), glm::vec3(modelo[0])),
+                               std::max(glm::dot(glm::vec3(modelo[1]), glm::vec3(modelo[1])),
+                                        glm::dot(glm::vec3(modelo[2]), glm::vec3(modelo[2]))));
+        // a esfera da mesh é centrada na AABB, então os centros coincidem
+        return adicionar(centro, extensao, mesh.raioEsfera * std::sqrt(escalaQuadrada));
+    }
+
+    // Índices (na ordem de adicionar) dos objetos que tocam o frustum.
+    const std::vector<uint32_t>& recortar(const Frustum& frustum) {
+        auto inicio = std::chrono::steady_clock::now();
+        const size_t total = cx.size();
+        const size_t numBlocos = (total + TAMANHO_BLOCO - 1) / TAMANHO_BLOCO;
+        visiveis.resize(total);
+        contagemBloco.assign(numBlocos, 0);
+
+        paraleloEmBlocos(numBlocos, BLOCOS_POR_THREAD, [&](size_t primeiro, size_t ultimo) {
+            for (size_t b = primeiro; b < ultimo; b++) {
+                size_t fim = std::min(total, (b + 1) * TAMANHO_BLOCO);
+                contagemBloco[b] = testarFaixa(frustum, b * TAMANHO_BLOCO, fim, visiveis.data() + b * TAMANHO_BLOCO);
+            }
+        });
+
+        // junta os blocos; cada um começou a escrever no próprio início
+        size_t n = 0;
+        for (size_t b = 0; b < numBlocos; b++) {
+            if (n != b * TAMANHO_BLOCO)
+                std::memmove(visiveis.data() + n, visiveis.data() + b * TAMANHO_BLOCO,
+                             contagemBloco[b] * sizeof(uint32_t));
+            n += contagemBloco[b];
+        }
+        visiveis.resize(n);
+
+        estatisticas.testados = total;
+        estatisticas.visiveis = n;
+        estatisticas.threads = (unsigned)std::min<size_t>(threadsDisponiveis(),
+                                                          std::max<size_t>(1, numBlocos / BLOCOS_POR_THREAD));
+        estatisticas.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        return visiveis;
+    }
+
+private:
+    static const size_t TAMANHO_BLOCO = 16384;
+    static const size_t BLOCOS_POR_THREAD = 4;   // abaixo de ~64k objetos roda numa thread só
+
+    std::vector<float> cx, cy, cz;   // centro da AABB (e da esfera)
+    std::vector<float> ex, ey, ez;   // meia extensão da AABB
+    std::vector<float> raios;
+    std::vector<uint32_t> visiveis;
+    std::vector<size_t> contagemBloco;
+
+    // Escreve em saida os índices visíveis de [inicio, fim) e devolve quantos.
+    size_t testarFaixa(const Frustum& frustum, size_t inicio, size_t fim, uint32_t* saida) const {
+        size_t n = 0;
+        size_t i = inicio;
+
+#if defined(FRUSTUM_AVX)
+        __m256 planos8[6][7];   // nx, ny, nz, d, |nx|, |ny|, |nz| replicados
+        for (int k = 0; k < 6; k++)
+            for (int c = 0; c < 7; c++) planos8[k][c] = _mm256_set1_ps(componentePlano(frustum.planos[k], c));
+
+        for (; i + 8 <= fim; i += 8) {
+            __m256 x = _mm256_loadu_ps(&cx[i]), y = _mm256_loadu_ps(&cy[i]), z = _mm256_loadu_ps(&cz[i]);
+            __m256 hx = _mm256_loadu_ps(&ex[i]), hy = _mm256_loadu_ps(&ey[i]), hz = _mm256_loadu_ps(&ez[i]);
+            __m256 r = _mm256_loadu_ps(&raios[i]);
+            __m256 fora = _mm256_setzero_ps();
+            for (const __m256* p : planos8) {
+                __m256 distancia = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p[0], x), _mm256_mul_ps(p[1], y)),
+                                                 _mm256_add_ps(_mm256_mul_ps(p[2], z), p[3]));
+                __m256 projecao = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p[4], hx), _mm256_mul_ps(p[5], hy)),
+                                                _mm256_mul_ps(p[6], hz));
+                __m256 folga = _mm256_add_ps(distancia, _mm256_min_ps(r, projecao));
+                fora = _mm256_or_ps(fora, _mm256_cmp_ps(folga, _mm256_setzero_ps(), _CMP_LT_OQ));
+            }
+            n += escreverVisiveis(~_mm256_movemask_ps(fora), 8, (uint32_t)i, saida + n);
+        }
+#endif
+
+#if defined(FRUSTUM_SSE2)
+        __m128 planos4[6][7];
+        for (int k = 0; k < 6; k++)
+            for (int c = 0; c < 7; c++) planos4[k][c] = _mm_set1_ps(componentePlano(frustum.planos[k], c));
+
+        for (; i + 4 <= fim; i += 4) {
+            __m128 x = _mm_loadu_ps(&cx[i]), y = _mm_loadu_ps(&cy[i]), z = _mm_loadu_ps(&cz[i]);
+            __m128 hx = _mm_loadu_ps(&ex[i]), hy = _mm_loadu_ps(&ey[i]), hz = _mm_loadu_ps(&ez[i]);
+            __m128 r = _mm_loadu_ps(&raios[i]);
+            __m128 fora = _mm_setzero_ps();
+            for (const __m128* p : planos4) {
+                __m128 distancia = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[0], x), _mm_mul_ps(p[1], y)),
+                                              _mm_add_ps(_mm_mul_ps(p[2], z), p[3]));
+                __m128 projecao = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p[4], hx), _mm_mul_ps(p[5], hy)),
+                                             _mm_mul_ps(p[6], hz));
+                __m128 folga = _mm_add_ps(distancia, _mm_min_ps(r, projecao));
+                fora = _mm_or_ps(fora, _mm_cmplt_ps(folga, _mm_setzero_ps()));
+            }
+            n += escreverVisiveis(~_mm_movemask_ps(fora), 4, (uint32_t)i, saida + n);
+        }
+#endif
+
+        // resto (ou tudo, sem SSE2); mesmas contas, na mesma ordem
+        for (; i < fim; i++) {
+            bool dentro = true;
+            for (const glm::vec4& p : frustum.planos) {
+                float distancia = (p.x * cx[i] + p.y * cy[i]) + (p.z * cz[i] + p.w);
+                float projecao = (std::fabs(p.x) * ex[i] + std::fabs(p.y) * ey[i]) + std::fabs(p.z) * ez[i];
+                if (distancia + std::min(raios[i], projecao) < 0.0f) {
+                    dentro = false;
+                    break;
+                }
+            }
+            if (dentro) saida[n++] = (uint32_t)i;
+        }
+        return n;
+    }
+
+    static float componentePlano(const glm::vec4& p, int c) {
+        return c < 4 ? p[c] : std::fabs(p[c - 4]);
+    }
+
+    // bit k de mascara = objeto base + k visível; sem desvio por objeto
+    static size_t escreverVisiveis(int mascara, int largura, uint32_t base, uint32_t* saida) {
+        size_t n = 0;
+        for (int k = 0; k < largura; k++) {
+            saida[n] = base + (uint32_t)k;
+            n += (mascara >> k) & 1;
+        }
+        return n;
+    }
+};
+
+#endif
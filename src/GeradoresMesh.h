@@ -0,0 +1,379 @@
+#ifndef GERADORES_MESH_H
+#define GERADORES_MESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <utility>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GERADORES_SSE2 1
+#endif
+
+#include "FormatoVertice.h"
+#include "Paralelo.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+enum class Topologia {
+    Triangulos, // GL_TRIANGLES, 3 índices por triângulo
+    Faixas      // GL_TRIANGLE_STRIP, uma faixa por linha da grade separadas por INDICE_REINICIO
+};
+
+// Marcador de fim de faixa nos índices da CPU. No upload vira o maior valor do
+// tipo escolhido (0xFF, 0xFFFF ou 0xFFFFFFFF), que é o índice de reinício.
+const GLuint INDICE_REINICIO = 0xFFFFFFFFu;
+
+// Geradores de esfera e plano que escrevem em buffers já alocados com o
+// tamanho exato (contar* abaixo). Senos/cossenos são tabelados por setor e por
+// pilha, as linhas da grade são geradas em paralelo e o miolo de cada linha usa
+// SSE2 quando disponível. O resultado é bit a bit igual à versão escalar
+// original: as mesmas operações float, na mesma ordem.
+
+// abaixo disso não compensa abrir threads
+const size_t VERTICES_MINIMOS_POR_THREAD = 1 << 16;
+
+// Sem setores/pilhas (ou divisões) a grade fica vazia: nada de vértices nem
+// índices, em vez de termos como (pilhas - 1) darem a volta em size_t.
+inline bool gradeVazia(int colunas, int linhas) {
+    return colunas <= 0 || linhas <= 0;
+}
+
+inline size_t contarVerticesEsfera(int setores, int pilhas) {
+    if (gradeVazia(setores, pilhas)) return 0;
+    return (size_t)(setores + 1) * (pilhas + 1);
+}
+
+inline size_t contarIndicesEsfera(int setores, int pilhas, Topologia topologia) {
+    if (gradeVazia(setores, pilhas)) return 0;
+    if (topologia == Topologia::Faixas)
+        return (size_t)pilhas * (setores + 1) * 2 + (pilhas - 1);
+    // a primeira e a última pilha têm só um triângulo por setor
+    return pilhas > 1 ? (size_t)6 * setores * (pilhas - 1) : 0;
+}
+
+inline size_t contarVerticesPlano(int divisoesX, int divisoesZ) {
+    if (gradeVazia(divisoesX, divisoesZ)) return 0;
+    return (size_t)(divisoesX + 1) * (divisoesZ + 1);
+}
+
+inline size_t contarIndicesPlano(int divisoesX, int divisoesZ, Topologia topologia) {
+    if (gradeVazia(divisoesX, divisoesZ)) return 0;
+    if (topologia == Topologia::Faixas)
+        return (size_t)divisoesZ * (divisoesX + 1) * 2 + (divisoesZ - 1);
+    return (size_t)6 * divisoesX * divisoesZ;
+}
+
+// Visita os triângulos de índices em GL_TRIANGLES, GL_TRIANGLE_STRIP ou
+// GL_TRIANGLE_FAN, já com a orientação da lista; em faixas e leques cada
+// INDICE_REINICIO começa uma parte nova. Os degenerados das faixas (usados
+// para costurar partes) são pulados.
+template <typename Funcao>
+inline void paraCadaTriangulo(const std::vector<GLuint>& indices, GLenum primitiva, Funcao&& funcao) {
+    if (primitiva == GL_TRIANGLES) {
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) funcao(indices[t], indices[t + 1], indices[t + 2]);
+        return;
+    }
+    size_t inicio = 0;
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (indices[i] == INDICE_REINICIO) {
+            inicio = i + 1;
+            continue;
+        }
+        size_t k = i - inicio;   // posição na parte atual
+        if (k < 2) continue;
+        GLuint a = primitiva == GL_TRIANGLE_FAN ? indices[inicio] : indices[i - 2];
+        GLuint b = indices[i - 1], c = indices[i];
+        if (primitiva == GL_TRIANGLE_STRIP && (k & 1)) std::swap(a, b);
+        if (a == b || b == c || a == c) continue;
+        funcao(a, b, c);
+    }
+}
+
+inline size_t contarTriangulos(const std::vector<GLuint>& indices, GLenum primitiva) {
+    if (primitiva == GL_TRIANGLES) return indices.size() / 3;
+    size_t n = 0;
+    paraCadaTriangulo(indices, primitiva, [&](GLuint, GLuint, GLuint) { n++; });
+    return n;
+}
+
+// Faixas ou leques convertidos em lista de triângulos.
+inline std::vector<GLuint> paraListaTriangulos(const std::vector<GLuint>& indices, GLenum primitiva) {
+    if (primitiva == GL_TRIANGLES) return indices;
+    std::vector<GLuint> lista;
+    lista.reserve(contarTriangulos(indices, primitiva) * 3);
+    paraCadaTriangulo(indices, primitiva, [&](GLuint a, GLuint b, GLuint c) {
+        lista.push_back(a);
+        lista.push_back(b);
+        lista.push_back(c);
+    });
+    return lista;
+}
+
+// Lista de triângulos em faixas com INDICE_REINICIO. Um triângulo que
+// continua a faixa atual (mesma última aresta, na orientação que a faixa
+// espera nessa posição) custa um índice; os outros abrem faixa nova. Listas
+// em ordem de grade (como as de gerarIndicesGrade) voltam a uma faixa por linha.
+inline std::vector<GLuint> paraFaixasTriangulos(const std::vector<GLuint>& lista) {
+    std::vector<GLuint> faixas;
+    faixas.reserve(lista.size() + lista.size() / 3);
+    size_t inicio = 0;   // começo da faixa atual
+    for (size_t t = 0; t + 2 < lista.size(); t += 3) {
+        const GLuint v[3] = {lista[t], lista[t + 1], lista[t + 2]};
+        size_t k = faixas.size() - inicio;
+        bool continua = false;
+        if (k >= 3) {
+            // o próximo triângulo é (penúltimo, último, novo), trocados em posição ímpar
+            GLuint a = faixas[faixas.size() - 2], b = faixas.back();
+            if (k & 1) std::swap(a, b);
+            for (int r = 0; r < 3 && !continua; r++)
+                if (v[r] == a && v[(r + 1) % 3] == b) {
+                    faixas.push_back(v[(r + 2) % 3]);
+                    continua = true;
+                }
+        }
+        if (!continua) {
+            if (!faixas.empty()) faixas.push_back(INDICE_REINICIO);
+            inicio = faixas.size();
+            faixas.insert(faixas.end(), v, v + 3);
+        }
+    }
+    return faixas;
+}
+
+namespace geracao {
+
+// Uma linha da grade. Esfera: posição = (escala*tabX[j], escala*tabY[j], z) e
+// normal = posição*inverso. Plano: posição = (tabX[j], 0, z) e normal = (0, 1, 0).
+// UV = (tabU[j], v) nos dois.
+struct LinhaVertices {
+    const float* tabX;
+    const float* tabY;
+    const float* tabU;
+    float escala;
+    float z, nz, v;
+    float inverso;
+    bool esfera;
+};
+
+inline void escreverLinhaEscalar(const LinhaVertices& l, Vertice* destino, size_t inicio, size_t fim) {
+    for (size_t j = inicio; j < fim; j++) {
+        Vertice& vert = destino[j];
+        if (l.esfera) {
+            float x = l.escala * l.tabX[j];
+            float y = l.escala * l.tabY[j];
+            vert.posicao      = glm::vec3(x, y, l.z);
+            vert.normal       = glm::vec3(x * l.inverso, y * l.inverso, l.nz);
+        } else {
+            vert.posicao      = glm::vec3(l.tabX[j], 0.0f, l.z);
+            vert.normal       = glm::vec3(0.0f, 1.0f, 0.0f);
+        }
+        vert.coordTextura = glm::vec2(l.tabU[j], l.v);
+    }
+}
+
+#ifdef GERADORES_SSE2
+// 4 vértices por iteração: calcula em SoA e transpõe para o Vertice (AoS)
+// com unpack/movelh/movehl, duas escritas de 16 bytes por vértice.
+inline void escreverLinha(const LinhaVertices& l, Vertice* destino, size_t n) {
+    const __m128 vz  = _mm_set1_ps(l.z);
+    const __m128 vnz = _mm_set1_ps(l.nz);
+    const __m128 vv  = _mm_set1_ps(l.v);
+    const __m128 zero = _mm_setzero_ps();
+    size_t j = 0;
+
+    if (l.esfera) {
+        const __m128 vxy  = _mm_set1_ps(l.escala);
+        const __m128 vinv = _mm_set1_ps(l.inverso);
+        for (; j + 4 <= n; j += 4) {
+            __m128 x  = _mm_mul_ps(vxy, _mm_loadu_ps(l.tabX + j));
+            __m128 y  = _mm_mul_ps(vxy, _mm_loadu_ps(l.tabY + j));
+            __m128 nx = _mm_mul_ps(x, vinv);
+            __m128 ny = _mm_mul_ps(y, vinv);
+            __m128 u  = _mm_loadu_ps(l.tabU + j);
+
+            __m128 xy01 = _mm_unpacklo_ps(x, y),   xy23 = _mm_unpackhi_ps(x, y);     // x0 y0 x1 y1
+            __m128 zn01 = _mm_unpacklo_ps(vz, nx), zn23 = _mm_unpackhi_ps(vz, nx);   // z nx0 z nx1
+            __m128 nn01 = _mm_unpacklo_ps(ny, vnz), nn23 = _mm_unpackhi_ps(ny, vnz); // ny0 nz ny1 nz
+            __m128 uv01 = _mm_unpacklo_ps(u, vv),  uv23 = _mm_unpackhi_ps(u, vv);    // u0 v u1 v
+
+            float* d = reinterpret_cast<float*>(destino + j);
+            _mm_storeu_ps(d + 0,  _mm_movelh_ps(xy01, zn01));
+            _mm_storeu_ps(d + 4,  _mm_movelh_ps(nn01, uv01));
+            _mm_storeu_ps(d + 8,  _mm_movehl_ps(zn01, xy01));
+            _mm_storeu_ps(d + 12, _mm_movehl_ps(uv01, nn01));
+            _mm_storeu_ps(d + 16, _mm_movelh_ps(xy23, zn23));
+            _mm_storeu_ps(d + 20, _mm_movelh_ps(nn23, uv23));
+            _mm_storeu_ps(d + 24, _mm_movehl_ps(zn23, xy23));
+            _mm_storeu_ps(d + 28, _mm_movehl_ps(uv23, nn23));
+        }
+    } else {
+        const __m128 normal = _mm_setr_ps(1.0f, 0.0f, 1.0f, 0.0f);   // ny nz | ny nz
+        const __m128 zz = _mm_unpacklo_ps(vz, zero);                  // z 0 z 0
+        for (; j + 4 <= n; j += 4) {
+            __m128 x = _mm_loadu_ps(l.tabX + j);
+            __m128 u = _mm_loadu_ps(l.tabU + j);
+
+            __m128 x01 = _mm_unpacklo_ps(x, zero), x23 = _mm_unpackhi_ps(x, zero);  // x0 0 x1 0
+            __m128 uv01 = _mm_unpacklo_ps(u, vv),  uv23 = _mm_unpackhi_ps(u, vv);   // u0 v u1 v
+
+            float* d = reinterpret_cast<float*>(destino + j);
+            _mm_storeu_ps(d + 0,  _mm_movelh_ps(x01, zz));
+            _mm_storeu_ps(d + 4,  _mm_movelh_ps(normal, uv01));
+            _mm_storeu_ps(d + 8,  _mm_movehl_ps(zz, x01));
+            _mm_storeu_ps(d + 12, _mm_movehl_ps(uv01, normal));
+            _mm_storeu_ps(d + 16, _mm_movelh_ps(x23, zz));
+            _mm_storeu_ps(d + 20, _mm_movelh_ps(normal, uv23));
+            _mm_storeu_ps(d + 24, _mm_movehl_ps(zz, x23));
+            _mm_storeu_ps(d + 28, _mm_movehl_ps(uv23, normal));
+        }
+    }
+
+    escreverLinhaEscalar(l, destino, j, n);
+}
+#else
+inline void escreverLinha(const LinhaVertices& l, Vertice* destino, size_t n) {
+    escreverLinhaEscalar(l, destino, 0, n);
+}
+#endif
+
+// Índices de uma grade de (linhas+1) × (colunas+1) vértices, linha a linha.
+// pularPolos remove os triângulos degenerados da primeira e da última linha (esfera).
+inline void gerarIndicesGrade(int colunas, int linhas, Topologia topologia,
+                              bool pularPolos, GLuint* destino) {
+    const size_t largura = (size_t)colunas + 1;
+
+    if (topologia == Topologia::Faixas) {
+        const size_t porLinha = largura * 2 + 1;   // + reinício (ausente na primeira)
+        paraleloEmBlocos((size_t)linhas, VERTICES_MINIMOS_POR_THREAD / porLinha + 1,
+                         [&](size_t inicio, size_t fim) {
+            for (size_t i = inicio; i < fim; i++) {
+                GLuint* d = destino + (i == 0 ? 0 : i * porLinha - 1);
+                if (i != 0) *d++ = INDICE_REINICIO;
+                GLuint k1 = (GLuint)(i * largura);
+                GLuint k2 = (GLuint)(k1 + largura);
+                for (size_t j = 0; j < largura; j++) {
+                    *d++ = k1 + (GLuint)j;
+                    *d++ = k2 + (GLuint)j;
+                }
+            }
+        });
+        return;
+    }
+
+    auto inicioLinha = [&](size_t i) -> size_t {
+        if (!pularPolos) return i * colunas * 6;
+        return i == 0 ? 0 : (size_t)colunas * 3 + (i - 1) * colunas * 6;
+    };
+
+    paraleloEmBlocos((size_t)linhas, VERTICES_MINIMOS_POR_THREAD / (colunas * 6 + 1) + 1,
+                     [&](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; i++) {
+            GLuint* d = destino + inicioLinha(i);
+            GLuint k1 = (GLuint)(i * largura);
+            GLuint k2 = (GLuint)(k1 + largura);
+            bool primeiro = !pularPolos || i != 0;
+            bool segundo  = !pularPolos || i != (size_t)(linhas - 1);
+
+            for (int j = 0; j < colunas; j++, k1++, k2++) {
+                if (primeiro) {
+                    *d++ = k1;
+                    *d++ = k2;
+                    *d++ = k1 + 1;
+                }
+                if (segundo) {
+                    *d++ = k1 + 1;
+                    *d++ = k2;
+                    *d++ = k2 + 1;
+                }
+            }
+        }
+    });
+}
+
+}
+
+// vertices/indices precisam ter contarVerticesEsfera / contarIndicesEsfera posições
+inline void gerarEsfera(float raio, int setores, int pilhas, Topologia topologia,
+                        Vertice* vertices, GLuint* indices) {
+    if (gradeVazia(setores, pilhas)) return;
+    const float comprimentoInverso = 1.0f / raio;
+    const float setorPasso = 2 * M_PI / setores;
+    const float pilhaPasso = M_PI / pilhas;
+    const size_t porLinha = (size_t)setores + 1;
+
+    // tabelas por setor (iguais em todas as pilhas)
+    std::vector<float> cosSetor(porLinha), sinSetor(porLinha), sSetor(porLinha);
+    for (int j = 0; j <= setores; j++) {
+        float anguloSetor = j * setorPasso;
+        cosSetor[j] = cosf(anguloSetor);
+        sinSetor[j] = sinf(anguloSetor);
+        sSetor[j]   = (float)j / setores;
+    }
+
+    paraleloEmBlocos((size_t)pilhas + 1, VERTICES_MINIMOS_POR_THREAD / porLinha + 1,
+                     [&](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; i++) {
+            float anguloPilha = M_PI / 2 - (int)i * pilhaPasso;
+
+            geracao::LinhaVertices linha;
+            linha.tabX = cosSetor.data();
+            linha.tabY = sinSetor.data();
+            linha.tabU = sSetor.data();
+            linha.escala = raio * cosf(anguloPilha);
+            linha.z = raio * sinf(anguloPilha);
+            linha.nz = linha.z * comprimentoInverso;
+            linha.v = (float)(int)i / pilhas;
+            linha.inverso = comprimentoInverso;
+            linha.esfera = true;
+
+            geracao::escreverLinha(linha, vertices + i * porLinha, porLinha);
+        }
+    });
+
+    geracao::gerarIndicesGrade(setores, pilhas, topologia, true, indices);
+}
+
+inline void gerarPlano(float largura, float profundidade, int divisoesX, int divisoesZ,
+                       Topologia topologia, Vertice* vertices, GLuint* indices) {
+    if (gradeVazia(divisoesX, divisoesZ)) return;
+    const float meiaLargura      = largura / 2.0f;
+    const float meiaProfundidade = profundidade / 2.0f;
+    const float passoX    = largura / divisoesX;
+    const float passoZ    = profundidade / divisoesZ;
+    const float passoTexX = 1.0f / divisoesX;
+    const float passoTexZ = 1.0f / divisoesZ;
+    const size_t porLinha = (size_t)divisoesX + 1;
+
+    std::vector<float> posX(porLinha), texX(porLinha);
+    for (int x = 0; x <= divisoesX; x++) {
+        posX[x] = -meiaLargura + x * passoX;
+        texX[x] = x * passoTexX;
+    }
+
+    paraleloEmBlocos((size_t)divisoesZ + 1, VERTICES_MINIMOS_POR_THREAD / porLinha + 1,
+                     [&](size_t inicio, size_t fim) {
+        for (size_t z = inicio; z < fim; z++) {
+            geracao::LinhaVertices linha;
+            linha.tabX = posX.data();
+            linha.tabY = nullptr;
+            linha.tabU = texX.data();
+            linha.escala = 1.0f;
+            linha.z = -meiaProfundidade + (int)z * passoZ;
+            linha.nz = 0.0f;
+            linha.v = (int)z * passoTexZ;
+            linha.inverso = 0.0f;
+            linha.esfera = false;
+
+            geracao::escreverLinha(linha, vertices + z * porLinha, porLinha);
+        }
+    });
+
+    geracao::gerarIndicesGrade(divisoesX, divisoesZ, topologia, false, indices);
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace cache {
+
+// No estilo do FNV-1a, uma palavra de 8 bytes por vez; o xor-shift espalha
+// os bits altos para baixo.
+inline uint64_t hashFNV(const void* dados, size_t tamanho, uint64_t h = 0xCBF29CE484222325ull) {
+    const uint64_t PRIMO = 0x100000001B3ull;
+    const unsigned char* p = static_cast<const unsigned char*>(dados);
+    size_t i = 0;
+    for (; i + 8 <= tamanho; i += 8) {
+        uint64_t palavra;
+        std::memcpy(&palavra, p + i, 8);
+        h = (h ^ palavra) * PRIMO;
+        h ^= h >> 32;
+    }
+    for (; i < tamanho; i++)
+        h = (h ^ p[i]) * PRIMO;
+    return h;
+}
+
+}
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef INSTANCIAS_H
+#define INSTANCIAS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#include "RecursosGL.h"
+#include "Transformacoes.h"
+
+// Atributos por instância, lidos pelos shaders com INSTANCIADO. A mat4
+// ocupa quatro locations seguidas (uma por coluna).
+const GLuint LOCAL_MODELO_INSTANCIA = 5;     // 5..8
+const GLuint LOCAL_MATERIAL_INSTANCIA = 9;
+const GLuint LOCAL_NORMAL_INSTANCIA = 10;    // 10..12, mat3 em três vec4
+
+// Três fluxos separados (matrizes, matrizes normais e índices de material),
+// para que a cena possa reenviar só as matrizes a cada quadro; as normais
+// acompanham as matrizes e são calculadas aqui (Transformacoes.h), para os
+// shaders não inverterem a matriz por vértice. Os buffers são substituídos
+// por um novo a cada envio (orphaning), então escrever no quadro seguinte não
+// espera a GPU terminar de ler o anterior.
+class BufferInstancias {
+public:
+    BufferGL matrizes;
+    BufferGL materiais;
+    BufferGL normais;
+    GLsizei quantidade = 0;
+
+    // todas as matrizes são rotação, translação e escala uniforme: as normais
+    // saem pelo caminho sem inversa (ver Transformacoes.h)
+    bool escalaUniforme = false;
+
+    BufferInstancias() = default;
+    BufferInstancias(BufferInstancias&&) = default;
+    BufferInstancias& operator=(BufferInstancias&&) = default;
+
+    // indicesMaterial nulo = todas as instâncias com o material 0
+    void atualizar(const glm::mat4* modelos, const GLuint* indicesMaterial, size_t n) {
+        if (indicesMaterial) indices.assign(indicesMaterial, indicesMaterial + n);
+        else indices.assign(n, 0);
+        enviar(materiais, indices.data(), sizeof(GLuint), n, capacidadeMateriais);
+        enviarMatrizes(modelos, n);
+        quantidade = (GLsizei)n;
+    }
+
+    void atualizar(const std::vector<glm::mat4>& modelos, const std::vector<GLuint>& indicesMaterial) {
+        atualizar(modelos.data(), indicesMaterial.empty() ? nullptr : indicesMaterial.data(), modelos.size());
+    }
+
+    // Só as matrizes; os materiais enviados antes continuam valendo, e
+    // instâncias além deles ficam com o material 0.
+    void atualizarMatrizes(const glm::mat4* modelos, size_t n) {
+        if (n > indices.size()) {
+            indices.resize(n, 0);
+            enviar(materiais, indices.data(), sizeof(GLuint), n, capacidadeMateriais);
+        }
+        enviarMatrizes(modelos, n);
+        quantidade = (GLsizei)n;
+    }
+
+    // Envio em partes: reservar() descarta o conteúdo e fixa a quantidade, e
+    // cada enviarFaixa() preenche [primeira, primeira + n).
+    void reservar(size_t n) {
+        indices.resize(n);
+        capacidadeMateriais = std::max(capacidadeMateriais, n);
+        capacidadeMatrizes = std::max(capacidadeMatrizes, n);
+        descartar(materiais, capacidadeMateriais * sizeof(GLuint));
+        descartar(matrizes, capacidadeMatrizes * sizeof(glm::mat4));
+        descartar(normais, capacidadeMatrizes * sizeof(NormalInstancia));
+        quantidade = (GLsizei)n;
+    }
+
+    void enviarFaixa(size_t primeira, const glm::mat4* modelos, const GLuint* indicesMaterial, size_t n) {
+        std::copy(indicesMaterial, indicesMaterial + n, indices.begin() + primeira);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, materiais);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, primeira * sizeof(GLuint), n * sizeof(GLuint), indicesMaterial);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, matrizes);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, primeira * sizeof(glm::mat4), n * sizeof(glm::mat4), modelos);
+        calcularNormais(modelos, n);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, normais);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, primeira * sizeof(NormalInstancia), n * sizeof(NormalInstancia),
+                        normaisCPU.data());
+    }
+
+    // Liga os três fluxos ao VAO vinculado. O divisor 1 avança um elemento por
+    // instância em vez de por vértice. primeiraInstancia desloca os ponteiros,
+    // o que faz o papel da instância base no OpenGL 3.3.
+    void vincularAtributos(GLuint primeiraInstancia = 0) const {
+        glBindBuffer(GL_ARRAY_BUFFER, matrizes);
+        for (GLuint coluna = 0; coluna < 4; coluna++) {
+            GLuint local = LOCAL_MODELO_INSTANCIA + coluna;
+            glEnableVertexAttribArray(local);
+            glVertexAttribPointer(local, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                                  (void*)(primeiraInstancia * sizeof(glm::mat4) + coluna * sizeof(glm::vec4)));
+            glVertexAttribDivisor(local, 1);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, normais);
+        for (GLuint coluna = 0; coluna < 3; coluna++) {
+            GLuint local = LOCAL_NORMAL_INSTANCIA + coluna;
+            glEnableVertexAttribArray(local);
+            glVertexAttribPointer(local, 3, GL_FLOAT, GL_FALSE, sizeof(NormalInstancia),
+                                  (void*)(primeiraInstancia * sizeof(NormalInstancia) + coluna * sizeof(glm::vec4)));
+            glVertexAttribDivisor(local, 1);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, materiais);
+        glEnableVertexAttribArray(LOCAL_MATERIAL_INSTANCIA);
+        glVertexAttribIPointer(LOCAL_MATERIAL_INSTANCIA, 1, GL_UNSIGNED_INT, sizeof(GLuint),
+                               (void*)(primeiraInstancia * sizeof(GLuint)));
+        glVertexAttribDivisor(LOCAL_MATERIAL_INSTANCIA, 1);
+    }
+
+private:
+    struct NormalInstancia {
+        glm::vec4 colunas[3];
+    };
+
+    std::vector<GLuint> indices;     // cópia dos materiais, para completar o fluxo quando ele cresce
+    std::vector<NormalInstancia> normaisCPU;
+    size_t capacidadeMatrizes = 0;   // em instâncias, também a das normais
+    size_t capacidadeMateriais = 0;
+
+    void calcularNormais(const glm::mat4* modelos, size_t n) {
+        if (normaisCPU.size() < n) normaisCPU.resize(n);
+        transformacoes::calcularNormais(modelos, n, (glm::vec4*)normaisCPU.data(), escalaUniforme);
+    }
+
+    void enviarMatrizes(const glm::mat4* modelos, size_t n) {
+        calcularNormais(modelos, n);
+        enviar(normais, normaisCPU.data(), sizeof(NormalInstancia), n, capacidadeMatrizes);
+        enviar(matrizes, modelos, sizeof(glm::mat4), n, capacidadeMatrizes);
+    }
+
+    static void enviar(BufferGL& buffer, const void* dados, size_t tamanhoElemento, size_t n, size_t& capacidade) {
+        capacidade = std::max(capacidade, n);
+        descartar(buffer, capacidade * tamanhoElemento);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, 0, n * tamanhoElemento, dados);
+    }
+
+    // deixa o buffer vinculado em GL_COPY_WRITE_BUFFER, que não mexe no
+    // GL_ARRAY_BUFFER de quem estiver desenhando
+    static void descartar(BufferGL& buffer, size_t bytes) {
+        buffer.gerar();
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    }
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "Mesh.h"
+#include "Simplificacao.h"
+
+// Quantos desenhos cada nível recebeu desde o último zerar().
+struct EstatisticasLOD {
+    std::vector<size_t> desenhosPorNivel;
+
+    void zerar() {
+        std::fill(desenhosPorNivel.begin(), desenhosPorNivel.end(), 0);
+    }
+};
+
+struct NivelEsfera {
+    int setores;
+    int pilhas;
+    float pixelsMinimos;    // altura projetada mínima (em pixels) para usar este nível
+};
+
+struct NivelSimplificado {
+    float fracaoTriangulos;  // em relação ao nível 0
+    float pixelsMinimos;
+};
+
+// Várias resoluções da mesma mesh. O nível é escolhido pela altura que a
+// esfera envolvente ocupa na tela, com histerese para não alternar entre dois
+// níveis quando o objeto fica perto do limiar.
+class GrupoLOD {
+public:
+    std::vector<Mesh> niveis;           // 0 = mais detalhado
+    std::vector<float> pixelsMinimos;   // decrescente; o último nível aceita qualquer tamanho
+    float histerese = 0.15f;            // margem relativa em torno de cada limiar
+
+    // esfera envolvente do nível 0, em espaço local
+    glm::vec3 centroLocal = glm::vec3(0.0f);
+    float raioLocal = 0.0f;
+
+    EstatisticasLOD estatisticas;
+
+    GrupoLOD() = default;
+    GrupoLOD(GrupoLOD&&) = default;
+    GrupoLOD& operator=(GrupoLOD&&) = default;
+
+    void adicionarNivel(Mesh&& mesh, float pixels) {
+        if (niveis.empty()) {
+            centroLocal = (mesh.limiteMin + mesh.limiteMax) * 0.5f;
+            raioLocal = glm::length(mesh.limiteMax - mesh.limiteMin) * 0.5f;
+        }
+        niveis.push_back(std::move(mesh));
+        pixelsMinimos.push_back(pixels);
+        estatisticas.desenhosPorNivel.push_back(0);
+    }
+
+    static GrupoLOD esfera(float raio, const std::vector<NivelEsfera>& resolucoes,
+                           Topologia topologia = Topologia::Triangulos) {
+        GrupoLOD grupo;
+        for (const NivelEsfera& r : resolucoes)
+            grupo.adicionarNivel(Esfera(raio, r.setores, r.pilhas, topologia), r.pixelsMinimos);
+        return grupo;
+    }
+
+    // Cadeia a partir de uma mesh carregada: cada nível é simplificado a partir
+    // do anterior (mais rápido que partir sempre do original).
+    static GrupoLOD simplificado(Mesh&& base, float pixelsBase, const std::vector<NivelSimplificado>& resolucoes,
+                                 float erroMaximo = 0.05f) {
+        GrupoLOD grupo;
+        size_t triangulosBase = contarTriangulos(base.indices, base.primitiva);
+        grupo.adicionarNivel(std::move(base), pixelsBase);
+
+        for (const NivelSimplificado& r : resolucoes) {
+            ParametrosSimplificacao parametros;
+            parametros.triangulosAlvo = (size_t)(triangulosBase * r.fracaoTriangulos);
+            parametros.erroMaximo = erroMaximo;
+
+            Mesh nivel = simplificarMesh(grupo.niveis.back(), parametros);
+            grupo.adicionarNivel(std::move(nivel), r.pixelsMinimos);
+        }
+        return grupo;
+    }
+
+    // Altura em pixels da esfera envolvente vista pela câmera.
+    // fovGraus é o Camera::zoom; alturaViewport em pixels.
+    float tamanhoProjetado(const glm::mat4& modelo, float escala, const glm::vec3& posicaoCamera,
+                           float fovGraus, float alturaViewport) const {
+        glm::vec3 centro = glm::vec3(modelo * glm::vec4(centroLocal, 1.0f));
+        float raio = raioLocal * escala;
+        float distancia = glm::length(centro - posicaoCamera);
+        if (distancia <= raio) return alturaViewport;   // câmera dentro da esfera
+
+        float tanMeioFov = std::tan(glm::radians(fovGraus) * 0.5f);
+        return raio / (distancia * tanMeioFov) * alturaViewport;
+    }
+
+    // nivelAnterior é o estado por objeto (comece com -1); é atualizado.
+    int selecionar(float tamanhoPixels, int& nivelAnterior) const {
+        int nivel = nivelPara(tamanhoPixels, 1.0f);
+
+        if (nivelAnterior >= 0 && nivelAnterior < (int)niveis.size()) {
+            if (nivel < nivelAnterior) {
+                // só refina se passar do limiar com folga
+                nivel = std::min(nivelAnterior, nivelPara(tamanhoPixels, 1.0f + histerese));
+            } else if (nivel > nivelAnterior &&
+                       tamanhoPixels >= pixelsMinimos[nivelAnterior] * (1.0f - histerese)) {
+                // ainda dentro da margem do nível atual
+                nivel = nivelAnterior;
+            }
+        }
+
+        nivelAnterior = nivel;
+        return nivel;
+    }
+
+    int selecionar(const glm::mat4& modelo, float escala, const glm::vec3& posicaoCamera,
+                   float fovGraus, float alturaViewport, int& nivelAnterior) const {
+        return selecionar(tamanhoProjetado(modelo, escala, posicaoCamera, fovGraus, alturaViewport),
+                          nivelAnterior);
+    }
+
+    void desenhar(int nivel) {
+        usarNivel(nivel).desenhar();
+    }
+
+    // para quem desenha por outro caminho (ex.: ListaDesenhoIndireto): conta o desenho e devolve a mesh
+    Mesh& usarNivel(int nivel) {
+        estatisticas.desenhosPorNivel[nivel]++;
+        return niveis[nivel];
+    }
+
+    // todas as instâncias do buffer usam o mesmo nível; conta cada uma como um desenho
+    void desenharInstanciado(int nivel, const BufferInstancias& instancias) {
+        niveis[nivel].desenharInstanciado(instancias);
+        estatisticas.desenhosPorNivel[nivel] += instancias.quantidade;
+    }
+
+private:
+    int nivelPara(float tamanhoPixels, float fator) const {
+        for (size_t i = 0; i + 1 < niveis.size(); i++)
+            if (tamanhoPixels >= pixelsMinimos[i] * fator)
+                return (int)i;
+        return (int)niveis.size() - 1;
+    }
+};
+
+#endif
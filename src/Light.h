@@ -2,6 +2,9 @@
 #define LIGHT_H
 
 #include <glm/glm.hpp>
+#include <string>
+
+#include "Shader.h"
 
 struct LuzPontual {
     glm::vec3 posicao;
@@ -73,4 +76,26 @@ struct Material {
           brilho(bril) {}
 };
 
+// Locais dos membros de um Material num programa, resolvidos uma vez com
+// Shader::uniform; base é o nome no GLSL ("material"). Câmera, luzes e a
+// tabela de materiais vão por blocos de uniforms (BlocosUniform.h).
+struct UniformsMaterial {
+    Uniform<glm::vec3> ambiente, difusa, especular;
+    Uniform<float> brilho;
+
+    UniformsMaterial() = default;
+    UniformsMaterial(const Shader& shader, const std::string& base)
+        : ambiente(shader.uniform<glm::vec3>(base + ".ambiente")),
+          difusa(shader.uniform<glm::vec3>(base + ".difusa")),
+          especular(shader.uniform<glm::vec3>(base + ".especular")),
+          brilho(shader.uniform<float>(base + ".brilho")) {}
+
+    void definir(const Material& material) const {
+        ambiente.definir(material.ambiente);
+        difusa.definir(material.difusa);
+        especular.definir(material.especular);
+        brilho.definir(material.brilho);
+    }
+};
+
 #endif
@@ -5,92 +5,410 @@
 #include <glm/glm.hpp>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <cstring>
+
+#include "FormatoVertice.h"
+#include "OtimizacaoMesh.h"
+#include "EstadoGL.h"
+#include "RecursosGL.h"
+#include "ArenaGeometria.h"
+#include "Instancias.h"
+#include "GeradoresMesh.h"
+
+// Menor tipo de índice que endereça numVertices vértices. Com reinício de
+// primitiva o maior valor do tipo fica reservado para o marcador.
+inline GLenum tipoIndiceParaVertices(size_t numVertices, bool reservarReinicio = false) {
+    size_t folga = reservarReinicio ? 1 : 0;
+    if (numVertices + folga <= 0x100u)   return GL_UNSIGNED_BYTE;
+    if (numVertices + folga <= 0x10000u) return GL_UNSIGNED_SHORT;
+    return GL_UNSIGNED_INT;
+}
+
+inline GLuint indiceReinicioPara(GLenum tipo) {
+    switch (tipo) {
+    case GL_UNSIGNED_BYTE:  return 0xFFu;
+    case GL_UNSIGNED_SHORT: return 0xFFFFu;
+    default:                return 0xFFFFFFFFu;
+    }
+}
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+inline size_t tamanhoTipoIndice(GLenum tipo) {
+    switch (tipo) {
+    case GL_UNSIGNED_BYTE:  return 1;
+    case GL_UNSIGNED_SHORT: return 2;
+    default:                return 4;
+    }
+}
+
+// Converte os índices (sempre GLuint na CPU) para o tipo escolhido no upload.
+// O truncamento leva INDICE_REINICIO direto ao reinício do tipo menor.
+inline std::vector<unsigned char> converterIndices(const std::vector<GLuint>& indices, GLenum tipo) {
+    std::vector<unsigned char> dados(indices.size() * tamanhoTipoIndice(tipo));
+    if (tipo == GL_UNSIGNED_BYTE) {
+        for (size_t i = 0; i < indices.size(); i++)
+            dados[i] = (unsigned char)indices[i];
+    } else if (tipo == GL_UNSIGNED_SHORT) {
+        GLushort* destino = reinterpret_cast<GLushort*>(dados.data());
+        for (size_t i = 0; i < indices.size(); i++)
+            destino[i] = (GLushort)indices[i];
+    } else {
+        std::memcpy(dados.data(), indices.data(), dados.size());
+    }
+    return dados;
+}
+
+// Bytes de índice enviados à GPU, comparados com o que seria gasto só com GLuint.
+struct EstatisticasIndices {
+    size_t bytesComoUint = 0;
+    size_t bytesEnviados = 0;
+
+    size_t bytesEconomizados() const { return bytesComoUint - bytesEnviados; }
+};
+
+// Parcela de uma mesh num EstatisticasIndices: trocada a cada upload e
+// retirada quando a mesh é destruída; mover a mesh leva a parcela junto.
+class ParcelaIndices {
+public:
+    ParcelaIndices() = default;
+    ParcelaIndices(const ParcelaIndices&) = delete;
+    ParcelaIndices& operator=(const ParcelaIndices&) = delete;
+
+    ParcelaIndices(ParcelaIndices&& outra) noexcept
+        : total(outra.total), bytesComoUint(outra.bytesComoUint), bytesEnviados(outra.bytesEnviados) {
+        outra.total = nullptr;
+    }
+
+    ParcelaIndices& operator=(ParcelaIndices&& outra) noexcept {
+        if (this != &outra) {
+            retirar();
+            total = outra.total;
+            bytesComoUint = outra.bytesComoUint;
+            bytesEnviados = outra.bytesEnviados;
+            outra.total = nullptr;
+        }
+        return *this;
+    }
+
+    ~ParcelaIndices() { retirar(); }
+
+    void definir(EstatisticasIndices& destino, size_t comoUint, size_t enviados) {
+        retirar();
+        total = &destino;
+        bytesComoUint = comoUint;
+        bytesEnviados = enviados;
+        total->bytesComoUint += bytesComoUint;
+        total->bytesEnviados += bytesEnviados;
+    }
+
+    void retirar() {
+        if (!total) return;
+        total->bytesComoUint -= bytesComoUint;
+        total->bytesEnviados -= bytesEnviados;
+        total = nullptr;
+    }
 
-struct Vertice {
-    glm::vec3 posicao;
-    glm::vec3 normal;
-    glm::vec2 coordTextura;
+private:
+    EstatisticasIndices* total = nullptr;
+    size_t bytesComoUint = 0;
+    size_t bytesEnviados = 0;
 };
 
+// Onde os índices de uma mesh estão na GPU: VAO, tipo, primeiro índice (em
+// elementos do tipo) e vértice base. Serve para montar desenhos indiretos.
+struct FaixaDesenho {
+    GLuint vao = 0;
+    GLenum tipoIndice = GL_UNSIGNED_INT;
+    GLuint primeiroIndice = 0;
+    GLsizei numIndices = 0;
+    GLint verticeBase = 0;
+
+    const void* deslocamento() const {
+        return (const void*)(primeiroIndice * tamanhoTipoIndice(tipoIndice));
+    }
+};
+
+// Mesh é move-only: os handles de RecursosGL.h liberam a GPU sozinhos, e copiar
+// implicitamente megabytes de vértices nunca é o que se quer.
 class Mesh {
 public:
     std::vector<Vertice> vertices;
     std::vector<GLuint> indices;
-    GLuint VAO, VBO, EBO;
+    VertexArrayGL VAO;
+    BufferGL VBO, EBO;
+
+    // bloco na arena compartilhada; quando ativo, VAO/VBO/EBO ficam vazios
+    AlocacaoArena alocacao;
+
+    // Meshes criadas com uma arena ativa são subalocadas nela (vale para
+    // Cubo, Esfera, Plano, OBJ e cache). enviarComLayout sempre usa buffers
+    // próprios, já que cada layout arbitrário precisaria do seu VAO.
+    inline static ArenaGeometria* arenaAtiva = nullptr;
+
+    // formato na GPU; os vértices na CPU são sempre Vertice
+    FormatoVertice formato;
+    LayoutVertice layout;
+    Quantizacao quantizacao;
+
+    // tipo e quantidade de índices na GPU; o tipo é escolhido no upload pelo número de vértices
+    GLenum tipoIndice = GL_UNSIGNED_INT;
+    GLsizei numIndices = 0;
+    GLsizei numVertices = 0;
+
+    // topologia dos índices; faixas usam reinício de primitiva
+    GLenum primitiva = GL_TRIANGLES;
+    bool reinicioPrimitiva = false;
+
+    // índices das meshes vivas na GPU (cada uma conta o último upload)
+    inline static EstatisticasIndices estatisticasIndices;
+    ParcelaIndices parcelaIndices;
 
-    Mesh() : VAO(0), VBO(0), EBO(0) {}
+    // AABB em espaço local, calculada no upload
+    glm::vec3 limiteMin = glm::vec3(0.0f);
+    glm::vec3 limiteMax = glm::vec3(0.0f);
 
-    Mesh(std::vector<Vertice> verts, std::vector<GLuint> inds) {
-        vertices = verts;
-        indices = inds;
+    // esfera envolvente em espaço local, centrada na AABB
+    glm::vec3 centroEsfera = glm::vec3(0.0f);
+    float raioEsfera = 0.0f;
+
+    Mesh() = default;
+
+    // assume a posse dos vetores (passe com std::move), sem copiar os dados
+    Mesh(std::vector<Vertice>&& verts, std::vector<GLuint>&& inds,
+         FormatoVertice formatoGPU = FormatoVertice())
+        : vertices(std::move(verts)), indices(std::move(inds)), formato(formatoGPU) {
         configurarMesh();
     }
 
-    void desenhar() {
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&&) = default;
+    Mesh& operator=(Mesh&&) = default;
+
+    // Converte os índices entre lista e faixas (leques de um .glb também
+    // viram lista) e reenvia se a mesh já estiver na GPU.
+    void definirTopologia(Topologia topologia) {
+        GLenum nova = topologia == Topologia::Faixas ? GL_TRIANGLE_STRIP : GL_TRIANGLES;
+        if (nova == primitiva) {
+            reinicioPrimitiva = nova == GL_TRIANGLE_STRIP;
+            return;
+        }
+        if (indices.empty() && numIndices > 0) return;   // sem cópia na CPU (enviarEmpacotado)
+        std::vector<GLuint> lista = paraListaTriangulos(indices, primitiva);
+        indices = nova == GL_TRIANGLE_STRIP ? paraFaixasTriangulos(lista) : std::move(lista);
+        primitiva = nova;
+        reinicioPrimitiva = nova == GL_TRIANGLE_STRIP;
+        if (naGPU()) configurarMesh();
     }
 
-    void desenhar(GLenum modo) {
-        glBindVertexArray(VAO);
-        glDrawElements(modo, indices.size(), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+    // reenvia os vértices para a GPU em outro formato (ex.: FormatoVertice::compacto())
+    void definirFormato(const FormatoVertice& novoFormato) {
+        if (vertices.empty() && numVertices > 0) return;   // sem cópia na CPU (enviarEmpacotado)
+        formato = novoFormato;
+        configurarMesh();
     }
 
-    void limpar() {
-        if (VAO != 0) {
-            glDeleteVertexArrays(1, &VAO);
-            glDeleteBuffers(1, &VBO);
-            glDeleteBuffers(1, &EBO);
-            VAO = VBO = EBO = 0;
+    // Reordena triângulos (cache pós-transformação) e vértices (busca). O ideal é
+    // chamar antes do upload; se a mesh já estiver na GPU ela é reenviada.
+    void otimizar(unsigned tamanhoCache = TAMANHO_CACHE_PADRAO) {
+        if (primitiva != GL_TRIANGLES) return;   // faixas já têm ordem de grade
+        if (vertices.empty()) return;
+        otimizarMesh(vertices, indices, tamanhoCache);
+        if (naGPU()) configurarMesh();
+    }
+
+    bool naGPU() const {
+        return VAO != 0 || alocacao.ativa();
+    }
+
+    size_t bytesVerticesGPU() const {
+        return (size_t)numVertices * layout.tamanhoVertice;
+    }
+
+    // Envia dados que já estão no formato da GPU (por exemplo, direto de um
+    // arquivo mapeado). vertices/indices da CPU ficam vazios: a mesh pode ser
+    // desenhada, mas não otimizada, simplificada ou reenviada em outro formato.
+    // primitiva/reinicioPrimitiva devem estar definidos antes.
+    void enviarEmpacotado(const FormatoVertice& formatoGPU, const void* dadosVertices, size_t numVerts,
+                          const void* dadosIndices, GLenum tipo, size_t numInds,
+                          const glm::vec3& minimo, const glm::vec3& maximo, const Quantizacao& quant) {
+        LayoutVertice layoutGPU = LayoutVertice::para(formatoGPU);
+        definirDadosGPU(layoutGPU, numVerts, tipo, numInds, minimo, maximo, quant);
+        formato = formatoGPU;
+        enviarParaGPU(dadosVertices, numVerts * layoutGPU.tamanhoVertice,
+                      dadosIndices, numInds * tamanhoTipoIndice(tipo), arenaAtiva);
+    }
+
+    // Igual, com um layout qualquer: cada atributo com seu stride e deslocamento
+    // dentro de bytesVertices (atributos planares ou intercalados, como no glTF).
+    void enviarComLayout(const LayoutVertice& layoutGPU, const void* dadosVertices, size_t bytesVertices,
+                         size_t numVerts, const void* dadosIndices, GLenum tipo, size_t numInds,
+                         const glm::vec3& minimo, const glm::vec3& maximo, const Quantizacao& quant) {
+        definirDadosGPU(layoutGPU, numVerts, tipo, numInds, minimo, maximo, quant);
+        enviarParaGPU(dadosVertices, bytesVertices, dadosIndices, numInds * tamanhoTipoIndice(tipo), nullptr);
+    }
+
+    void desenhar() const {
+        desenhar(primitiva);
+    }
+
+    // modo sobrescreve só a primitiva; o reinício continua sendo o da mesh
+    void desenhar(GLenum modo) const {
+        FaixaDesenho faixa = prepararDesenho();
+        glDrawElementsBaseVertex(modo, faixa.numIndices, faixa.tipoIndice, faixa.deslocamento(), faixa.verticeBase);
+    }
+
+    // Desenha as primeiras `quantidade` instâncias (todas, se negativo) numa
+    // chamada só; use com as variantes INSTANCIADO. Os fluxos são ligados
+    // ao VAO a cada chamada, pois meshes da arena dividem o mesmo VAO.
+    void desenharInstanciado(const BufferInstancias& instancias, GLsizei quantidade = -1) const {
+        if (quantidade < 0 || quantidade > instancias.quantidade) quantidade = instancias.quantidade;
+        if (quantidade == 0) return;
+
+        FaixaDesenho faixa = prepararDesenho();
+        instancias.vincularAtributos();
+        glDrawElementsInstancedBaseVertex(primitiva, faixa.numIndices, faixa.tipoIndice, faixa.deslocamento(),
+                                          quantidade, faixa.verticeBase);
+    }
+
+    FaixaDesenho faixaDesenho() const {
+        FaixaDesenho faixa;
+        faixa.tipoIndice = tipoIndice;
+        faixa.numIndices = numIndices;
+        if (alocacao.ativa()) {
+            const BlocoArena& bloco = alocacao.arena->bloco(alocacao.bloco);
+            faixa.vao = alocacao.arena->vao(bloco);
+            faixa.primeiroIndice = (GLuint)(bloco.deslocIndices / tamanhoTipoIndice(tipoIndice));
+            faixa.verticeBase = (GLint)bloco.baseVertice;
+        } else {
+            faixa.vao = VAO;
         }
+        return faixa;
     }
 
-    ~Mesh() {
-        limpar();
+    // constantes de dequantização, reinício de primitiva e VAO
+    FaixaDesenho prepararDesenho() const {
+        quantizacao.aplicar();
+        EstadoGL::definirReinicioPrimitiva(reinicioPrimitiva, indiceReinicioPara(tipoIndice));
+        FaixaDesenho faixa = faixaDesenho();
+        EstadoGL::vincularVAO(faixa.vao);
+        return faixa;
+    }
+
+    void limpar() {
+        alocacao.liberar();
+        VAO.liberar();
+        VBO.liberar();
+        EBO.liberar();
     }
 
 protected:
     void configurarMesh() {
-        glGenVertexArrays(1, &VAO);
-        glGenBuffers(1, &VBO);
-        glGenBuffers(1, &EBO);
+        calcularLimites();
+        layout = LayoutVertice::para(formato);
+
+        tipoIndice = tipoIndiceParaVertices(vertices.size(), reinicioPrimitiva);
+        numVertices = (GLsizei)vertices.size();
+        numIndices = (GLsizei)indices.size();
+
+        // vértices e índices vão direto quando já estão no formato da GPU
+        std::vector<unsigned char> empacotados, convertidos;
+        const void* dadosVertices = vertices.data();
+        const void* dadosIndices = indices.data();
+
+        if (formato.padrao()) {
+            quantizacao = Quantizacao();
+        } else {
+            empacotados = empacotarVertices(vertices, formato, layout, limiteMin, limiteMax, quantizacao);
+            dadosVertices = empacotados.data();
+        }
+        if (tipoIndice != GL_UNSIGNED_INT) {
+            convertidos = converterIndices(indices, tipoIndice);
+            dadosIndices = convertidos.data();
+        }
 
-        glBindVertexArray(VAO);
+        enviarParaGPU(dadosVertices, vertices.size() * layout.tamanhoVertice,
+                      dadosIndices, indices.size() * tamanhoTipoIndice(tipoIndice), arenaAtiva);
+    }
+
+    void definirDadosGPU(const LayoutVertice& layoutGPU, size_t numVerts, GLenum tipo, size_t numInds,
+                         const glm::vec3& minimo, const glm::vec3& maximo, const Quantizacao& quant) {
+        vertices.clear();
+        indices.clear();
+        formato = FormatoVertice();
+        layout = layoutGPU;
+        quantizacao = quant;
+        limiteMin = minimo;
+        limiteMax = maximo;
+        // sem os vértices, a esfera é a que passa pelos cantos da AABB
+        centroEsfera = (minimo + maximo) * 0.5f;
+        raioEsfera = glm::length(maximo - minimo) * 0.5f;
+        tipoIndice = tipo;
+        numVertices = (GLsizei)numVerts;
+        numIndices = (GLsizei)numInds;
+    }
+
+    // Com arena, o reenvio troca o bloco antigo por um novo; sem, usa buffers próprios.
+    void enviarParaGPU(const void* dadosVertices, size_t bytesVertices,
+                       const void* dadosIndices, size_t bytesIndices, ArenaGeometria* arena) {
+        parcelaIndices.definir(estatisticasIndices, (size_t)numIndices * sizeof(GLuint), bytesIndices);
+
+        alocacao.liberar();
+        if (arena) {
+            VAO.liberar();
+            VBO.liberar();
+            EBO.liberar();
+            alocacao.arena = arena;
+            alocacao.bloco = arena->alocar(formato, dadosVertices, numVertices, dadosIndices, bytesIndices);
+            return;
+        }
+
+        VAO.gerar();
+        VBO.gerar();
+        EBO.gerar();
+
+        EstadoGL::vincularVAO(VAO);
 
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertice),
-                     &vertices[0], GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, bytesVertices, dadosVertices, GL_STATIC_DRAW);
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint),
-                     &indices[0], GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, bytesIndices, dadosIndices, GL_STATIC_DRAW);
 
-        // posição
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertice), (void*)0);
-
-        // normal
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertice),
-                              (void*)offsetof(Vertice, normal));
+        // posição, normal e UV conforme o layout
+        layout.aplicar();
+    }
 
-        // UV
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertice),
-                              (void*)offsetof(Vertice, coordTextura));
+    void calcularLimites() {
+        if (vertices.empty()) {
+            limiteMin = limiteMax = centroEsfera = glm::vec3(0.0f);
+            raioEsfera = 0.0f;
+            return;
+        }
+        limiteMin = limiteMax = vertices[0].posicao;
+        for (const Vertice& v : vertices) {
+            limiteMin = glm::min(limiteMin, v.posicao);
+            limiteMax = glm::max(limiteMax, v.posicao);
+        }
 
-        glBindVertexArray(0);
+        // raio até o vértice mais distante, mais justo que a meia diagonal da AABB
+        centroEsfera = (limiteMin + limiteMax) * 0.5f;
+        float raioQuadrado = 0.0f;
+        for (const Vertice& v : vertices) {
+            glm::vec3 d = v.posicao - centroEsfera;
+            raioQuadrado = std::max(raioQuadrado, glm::dot(d, d));
+        }
+        raioEsfera = std::sqrt(raioQuadrado);
     }
 };
 
 class Cubo : public Mesh {
 public:
+    Cubo(Cubo&&) = default;
+    Cubo& operator=(Cubo&&) = default;
+
     Cubo(float tamanho = 1.0f) {
         float meio = tamanho / 2.0f;
 
@@ -148,60 +466,16 @@ public:
 
 class Esfera : public Mesh {
 public:
-    Esfera(float raio = 1.0f, int setores = 36, int pilhas = 18) {
-        float x, y, z, xy;
-        float nx, ny, nz, comprimentoInverso = 1.0f / raio;
-        float s, t;
-
-        float setorPasso = 2 * M_PI / setores;
-        float pilhaPasso = M_PI / pilhas;
-        float anguloSetor, anguloPilha;
-
-        for (int i = 0; i <= pilhas; i++) {
-            anguloPilha = M_PI / 2 - i * pilhaPasso;
-            xy = raio * cosf(anguloPilha);
-            z  = raio * sinf(anguloPilha);
-
-            for (int j = 0; j <= setores; j++) {
-                anguloSetor = j * setorPasso;
-
-                x = xy * cosf(anguloSetor);
-                y = xy * sinf(anguloSetor);
-
-                nx = x * comprimentoInverso;
-                ny = y * comprimentoInverso;
-                nz = z * comprimentoInverso;
-
-                s = (float)j / setores;
-                t = (float)i / pilhas;
-
-                Vertice vert;
-                vert.posicao     = glm::vec3(x, y, z);
-                vert.normal      = glm::vec3(nx, ny, nz);
-                vert.coordTextura = glm::vec2(s, t);
-                vertices.push_back(vert);
-            }
-        }
+    Esfera(Esfera&&) = default;
+    Esfera& operator=(Esfera&&) = default;
 
-        int k1, k2;
-        for (int i = 0; i < pilhas; i++) {
-            k1 = i * (setores + 1);
-            k2 = k1 + setores + 1;
-
-            for (int j = 0; j < setores; j++, k1++, k2++) {
-                if (i != 0) {
-                    indices.push_back(k1);
-                    indices.push_back(k2);
-                    indices.push_back(k1 + 1);
-                }
-
-                if (i != (pilhas - 1)) {
-                    indices.push_back(k1 + 1);
-                    indices.push_back(k2);
-                    indices.push_back(k2 + 1);
-                }
-            }
-        }
+    Esfera(float raio = 1.0f, int setores = 36, int pilhas = 18,
+           Topologia topologia = Topologia::Triangulos) {
+        definirTopologia(topologia);
+
+        vertices.resize(contarVerticesEsfera(setores, pilhas));
+        indices.resize(contarIndicesEsfera(setores, pilhas, topologia));
+        gerarEsfera(raio, setores, pilhas, topologia, vertices.data(), indices.data());
 
         configurarMesh();
     }
@@ -209,44 +483,23 @@ public:
 
 class Plano : public Mesh {
 public:
-    Plano(float largura = 10.0f, float profundidade = 10.0f, int divisoesX = 10, int divisoesZ = 10) {
-        float meiaLargura    = largura / 2.0f;
-        float meiaProfundidade = profundidade / 2.0f;
-
-        float passoX    = largura / divisoesX;
-        float passoZ    = profundidade / divisoesZ;
-        float passoTexX = 1.0f / divisoesX;
-        float passoTexZ = 1.0f / divisoesZ;
-
-        for (int z = 0; z <= divisoesZ; z++) {
-            for (int x = 0; x <= divisoesX; x++) {
-                Vertice vert;
-                vert.posicao      = glm::vec3(-meiaLargura + x * passoX, 0.0f, -meiaProfundidade + z * passoZ);
-                vert.normal       = glm::vec3(0.0f, 1.0f, 0.0f);
-                vert.coordTextura = glm::vec2(x * passoTexX, z * passoTexZ);
-                vertices.push_back(vert);
-            }
-        }
+    Plano(Plano&&) = default;
+    Plano& operator=(Plano&&) = default;
 
-        for (int z = 0; z < divisoesZ; z++) {
-            for (int x = 0; x < divisoesX; x++) {
-                int topLeft     = z * (divisoesX + 1) + x;
-                int topRight    = topLeft + 1;
-                int bottomLeft  = (z + 1) * (divisoesX + 1) + x;
-                int bottomRight = bottomLeft + 1;
-
-                indices.push_back(topLeft);
-                indices.push_back(bottomLeft);
-                indices.push_back(topRight);
-
-                indices.push_back(topRight);
-                indices.push_back(bottomLeft);
-                indices.push_back(bottomRight);
-            }
-        }
+    Plano(float largura = 10.0f, float profundidade = 10.0f, int divisoesX = 10, int divisoesZ = 10,
+          Topologia topologia = Topologia::Triangulos) {
+        definirTopologia(topologia);
+
+        vertices.resize(contarVerticesPlano(divisoesX, divisoesZ));
+        indices.resize(contarIndicesPlano(divisoesX, divisoesZ, topologia));
+        gerarPlano(largura, profundidade, divisoesX, divisoesZ, topologia, vertices.data(), indices.data());
 
         configurarMesh();
     }
 };
 
+// garante que std::vector<Mesh> realoca movendo, nunca copiando
+static_assert(std::is_nothrow_move_constructible<Mesh>::value, "Mesh precisa ser movível sem exceção");
+static_assert(!std::is_copy_constructible<Mesh>::value, "Mesh não deve ser copiável");
+
 #endif
@@ -0,0 +1,251 @@
+#ifndef OCLUSAO_SOFTWARE_H
+#define OCLUSAO_SOFTWARE_H
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OCLUSAO_SSE2 1
+#endif
+
+#include "Paralelo.h"
+
+struct EstatisticasOclusao {
+    size_t oclusores = 0;
+    size_t triangulos = 0;        // enviados por oclusores (antes de descartar os que cruzam o plano perto)
+    size_t testados = 0;
+    size_t rejeitados = 0;
+    double segundosRasterizacao = 0.0;
+    double segundosTeste = 0.0;
+
+    double fracaoRejeitada() const { return testados ? (double)rejeitados / testados : 0.0; }
+};
+
+// Descarte por oclusão na CPU, sem OpenGL (dá para usar e testar sem contexto).
+//
+// A cada quadro: iniciar() com projecao * visao, adicionarOclusor() para as
+// meshes grandes e fechadas, rasterizar(), e então visivel()/testarLote()
+// para as caixas dos objetos candidatos. O buffer guarda, por pixel, a
+// profundidade (z/w em [0, 1]) do oclusor mais próximo; uma caixa está
+// escondida quando, em todo o retângulo que ela cobre na tela, há oclusor
+// mais perto que o ponto mais próximo dela.
+//
+// A resolução é baixa e a cobertura é pelo centro do pixel, como nos
+// rasterizadores de oclusão usuais; triângulos que cruzam o plano perto são
+// ignorados, o que só deixa passar mais objetos. A tela é dividida em faixas
+// horizontais, uma por vez em cada thread, com 4 pixels por iteração em SSE2.
+class OclusaoSoftware {
+public:
+    EstatisticasOclusao estatisticas;
+
+    OclusaoSoftware(int largura = 320, int altura = 180)
+        : largura((largura + 3) & ~3), altura(altura), profundidade((size_t)this->largura * altura, 1.0f) {}
+
+    int larguraBuffer() const { return largura; }
+    int alturaBuffer() const { return altura; }
+    const std::vector<float>& buffer() const { return profundidade; }
+
+    void iniciar(const glm::mat4& projecaoVisao) {
+        matrizVP = projecaoVisao;
+        telas.clear();
+        triangulos.clear();
+        estatisticas.oclusores = 0;
+        estatisticas.triangulos = 0;
+        estatisticas.testados = 0;
+        estatisticas.rejeitados = 0;
+        estatisticas.segundosTeste = 0.0;
+    }
+
+    // posicoes aponta para o primeiro vec3, com passo de stride bytes entre vértices;
+    // indices é uma lista de triângulos
+    void adicionarOclusor(const void* posicoes, size_t stride, size_t numVertices,
+                          const uint32_t* indices, size_t numIndices, const glm::mat4& modelo) {
+        glm::mat4 mvp = matrizVP * modelo;
+        size_t base = telas.size();
+        telas.resize(base + numVertices);
+        const unsigned char* p = (const unsigned char*)posicoes;
+        for (size_t i = 0; i < numVertices; i++, p += stride) {
+            glm::vec4 clip = mvp * glm::vec4(*(const glm::vec3*)p, 1.0f);
+            VerticeTela& v = telas[base + i];
+            v.atras = clip.w < PERTO;
+            float invW = v.atras ? 0.0f : 1.0f / clip.w;
+            v.x = (clip.x * invW * 0.5f + 0.5f) * largura;
+            v.y = (clip.y * invW * 0.5f + 0.5f) * altura;
+            v.z = clip.z * invW * 0.5f + 0.5f;
+        }
+
+        for (size_t i = 0; i + 2 < numIndices; i += 3) {
+            uint32_t a = (uint32_t)base + indices[i], b = (uint32_t)base + indices[i + 1],
+                     c = (uint32_t)base + indices[i + 2];
+            if (telas[a].atras || telas[b].atras || telas[c].atras) continue;
+            triangulos.push_back({a, b, c});
+        }
+        estatisticas.oclusores++;
+        estatisticas.triangulos += numIndices / 3;
+    }
+
+    // Mesh, Vertice e afins: qualquer tipo com vertices (posicao no começo) e
+    // indices. Faixas com reinício de primitiva ficam de fora.
+    template <typename M>
+    void adicionarOclusor(const M& mesh, const glm::mat4& modelo) {
+        if (mesh.vertices.empty() || mesh.indices.empty() || mesh.reinicioPrimitiva) return;
+        adicionarOclusor(&mesh.vertices[0].posicao, sizeof(mesh.vertices[0]), mesh.vertices.size(),
+                         mesh.indices.data(), mesh.indices.size(), modelo);
+    }
+
+    void rasterizar() {
+        auto inicio = std::chrono::steady_clock::now();
+        const int numFaixas = (altura + ALTURA_FAIXA - 1) / ALTURA_FAIXA;
+        paraleloEmBlocos((size_t)numFaixas, 1, [&](size_t primeira, size_t ultima) {
+            for (size_t f = primeira; f < ultima; f++) {
+                int y0 = (int)f * ALTURA_FAIXA;
+                int y1 = std::min(altura, y0 + ALTURA_FAIXA);
+                std::fill(profundidade.begin() + (size_t)y0 * largura, profundidade.begin() + (size_t)y1 * largura, 1.0f);
+                for (const Triangulo& t : triangulos) rasterizarTriangulo(t, y0, y1);
+            }
+        });
+        estatisticas.segundosRasterizacao =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    // AABB em espaço de mundo. Pode ser chamada de várias threads depois de rasterizar().
+    bool visivel(const glm::vec3& minimo, const glm::vec3& maximo) const {
+        float xMin = 1e30f, yMin = 1e30f, xMax = -1e30f, yMax = -1e30f, zMin = 1.0f;
+        for (int canto = 0; canto < 8; canto++) {
+            glm::vec4 clip = matrizVP * glm::vec4((canto & 1) ? maximo.x : minimo.x,
+                                                  (canto & 2) ? maximo.y : minimo.y,
+                                                  (canto & 4) ? maximo.z : minimo.z, 1.0f);
+            if (clip.w < PERTO) return true;   // cruza o plano perto: sem como afirmar nada
+            float invW = 1.0f / clip.w;
+            float x = (clip.x * invW * 0.5f + 0.5f) * largura;
+            float y = (clip.y * invW * 0.5f + 0.5f) * altura;
+            xMin = std::min(xMin, x);
+            xMax = std::max(xMax, x);
+            yMin = std::min(yMin, y);
+            yMax = std::max(yMax, y);
+            zMin = std::min(zMin, clip.z * invW * 0.5f + 0.5f);
+        }
+
+        if (xMax < 0.0f || yMax < 0.0f || xMin > largura || yMin > altura) return true;   // fora da tela: fica para o descarte por frustum
+
+        // O oclusor marca os pixels com o centro coberto, então passa da aresta em
+        // até meio pixel. Um ponto da caixa fora do oclusor tem, entre os quatro
+        // centros de pixel em volta dele, pelo menos um também fora: o retângulo
+        // testado vai meio pixel além da caixa de cada lado para incluí-los.
+        int x0 = std::max(0, (int)std::floor(xMin - 0.5f));
+        int x1 = std::min(largura - 1, (int)std::floor(xMax + 0.5f));
+        int y0 = std::max(0, (int)std::floor(yMin - 0.5f));
+        int y1 = std::min(altura - 1, (int)std::floor(yMax + 0.5f));
+        for (int y = y0; y <= y1; y++) {
+            const float* linha = &profundidade[(size_t)y * largura];
+            int x = x0;
+#if defined(OCLUSAO_SSE2)
+            __m128 z = _mm_set1_ps(zMin);
+            for (; x + 4 <= x1 + 1; x += 4)
+                if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(linha + x), z))) return true;
+#endif
+            for (; x <= x1; x++)
+                if (linha[x] >= zMin) return true;
+        }
+        return false;
+    }
+
+    // visiveis[i] = visivel(minimos[i], maximos[i]), dividido entre threads
+    void testarLote(const glm::vec3* minimos, const glm::vec3* maximos, size_t n, uint8_t* visiveis) {
+        auto inicio = std::chrono::steady_clock::now();
+        paraleloEmBlocos(n, 4096, [&](size_t a, size_t b) {
+            for (size_t i = a; i < b; i++) visiveis[i] = visivel(minimos[i], maximos[i]) ? 1 : 0;
+        });
+        size_t rejeitados = 0;
+        for (size_t i = 0; i < n; i++) rejeitados += !visiveis[i];
+        estatisticas.testados += n;
+        estatisticas.rejeitados += rejeitados;
+        estatisticas.segundosTeste += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+private:
+    static constexpr float PERTO = 1e-4f;   // w mínimo para projetar
+    static const int ALTURA_FAIXA = 16;
+
+    struct VerticeTela {
+        float x, y, z;   // pixels e profundidade em [0, 1]
+        bool atras;      // w abaixo de PERTO
+    };
+
+    struct Triangulo {
+        uint32_t a, b, c;
+    };
+
+    int largura, altura;
+    std::vector<float> profundidade;
+    glm::mat4 matrizVP = glm::mat4(1.0f);
+    std::vector<VerticeTela> telas;
+    std::vector<Triangulo> triangulos;
+
+    // Funções de aresta avaliadas no centro do pixel; os dois sentidos de
+    // enrolamento são aceitos, então não depende da orientação da mesh.
+    void rasterizarTriangulo(const Triangulo& t, int faixaY0, int faixaY1) {
+        const VerticeTela& v0 = telas[t.a];
+        const VerticeTela& v1 = telas[t.b];
+        const VerticeTela& v2 = telas[t.c];
+
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        if (std::fabs(area) < 1e-8f) return;
+
+        int x0 = std::max(0, (int)std::floor(std::min({v0.x, v1.x, v2.x})));
+        int x1 = std::min(largura - 1, (int)std::ceil(std::max({v0.x, v1.x, v2.x})));
+        int y0 = std::max(faixaY0, (int)std::floor(std::min({v0.y, v1.y, v2.y})));
+        int y1 = std::min(faixaY1 - 1, (int)std::ceil(std::max({v0.y, v1.y, v2.y})));
+        if (x0 > x1 || y0 > y1) return;
+        x0 &= ~3;   // começa alinhado a 4 pixels
+
+        // com a área positiva, dentro = as três arestas >= 0
+        float sinal = area > 0.0f ? 1.0f : -1.0f;
+        float invArea = 1.0f / std::fabs(area);
+        // e_i(x, y) = A_i * x + B_i * y + C_i
+        float A0 = (v1.y - v2.y) * sinal, B0 = (v2.x - v1.x) * sinal, C0 = (v1.x * v2.y - v1.y * v2.x) * sinal;
+        float A1 = (v2.y - v0.y) * sinal, B1 = (v0.x - v2.x) * sinal, C1 = (v2.x * v0.y - v2.y * v0.x) * sinal;
+        float A2 = (v0.y - v1.y) * sinal, B2 = (v1.x - v0.x) * sinal, C2 = (v0.x * v1.y - v0.y * v1.x) * sinal;
+        // z = z0 * e0 + z1 * e1 + z2 * e2, normalizado pela área
+        float Az = (v0.z * A0 + v1.z * A1 + v2.z * A2) * invArea;
+        float Bz = (v0.z * B0 + v1.z * B1 + v2.z * B2) * invArea;
+        float Cz = (v0.z * C0 + v1.z * C1 + v2.z * C2) * invArea;
+
+        for (int y = y0; y <= y1; y++) {
+            float py = y + 0.5f;
+            float* linha = &profundidade[(size_t)y * largura];
+            int x = x0;
+#if defined(OCLUSAO_SSE2)
+            const __m128 passo = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            const __m128 zero = _mm_setzero_ps();
+            for (; x <= x1; x += 4) {   // a largura é múltipla de 4: o último grupo não sai da linha
+                __m128 px = _mm_add_ps(_mm_set1_ps((float)x), passo);
+                __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A0), px), _mm_set1_ps(B0 * py + C0));
+                __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A1), px), _mm_set1_ps(B1 * py + C1));
+                __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(A2), px), _mm_set1_ps(B2 * py + C2));
+                __m128 dentro = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                           _mm_cmpge_ps(e2, zero));
+                if (!_mm_movemask_ps(dentro)) continue;
+
+                __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Az), px), _mm_set1_ps(Bz * py + Cz));
+                __m128 atual = _mm_loadu_ps(linha + x);
+                __m128 novo = _mm_min_ps(atual, z);
+                _mm_storeu_ps(linha + x, _mm_or_ps(_mm_and_ps(dentro, novo), _mm_andnot_ps(dentro, atual)));
+            }
+#endif
+            for (; x <= x1; x++) {
+                float px = x + 0.5f;
+                if (A0 * px + B0 * py + C0 < 0.0f || A1 * px + B1 * py + C1 < 0.0f || A2 * px + B2 * py + C2 < 0.0f)
+                    continue;
+                linha[x] = std::min(linha[x], Az * px + Bz * py + Cz);
+            }
+        }
+    }
+};
+
+#endif
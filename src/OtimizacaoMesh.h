@@ -0,0 +1,169 @@
+#ifndef OTIMIZACAO_MESH_H
+#define OTIMIZACAO_MESH_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <cstdint>
+
+#include "FormatoVertice.h"
+
+// Reordenação de índices/vértices para o cache pós-transformação e para a
+// busca de vértices. Trabalha em listas de triângulos (GL_TRIANGLES).
+
+const unsigned TAMANHO_CACHE_PADRAO = 16;
+
+struct AnaliseCache {
+    size_t triangulos = 0;
+    size_t verticesUsados = 0;
+    size_t falhas = 0;       // vértices transformados (misses no cache)
+    float acmr = 0.0f;       // falhas por triângulo (ótimo ~0.5 em grades, pior caso 3)
+    float atvr = 0.0f;       // falhas por vértice único (ótimo 1.0)
+};
+
+// Simula um cache FIFO de tamanhoCache entradas, como o das GPUs.
+inline AnaliseCache analisarCache(const std::vector<GLuint>& indices, size_t numVertices,
+                                  unsigned tamanhoCache = TAMANHO_CACHE_PADRAO) {
+    AnaliseCache analise;
+    analise.triangulos = indices.size() / 3;
+
+    // instante em que cada vértice entrou no cache; está no cache se
+    // entrou há menos de tamanhoCache falhas
+    std::vector<size_t> entrada(numVertices, SIZE_MAX);
+    std::vector<bool> usado(numVertices, false);
+
+    for (GLuint v : indices) {
+        if (!usado[v]) {
+            usado[v] = true;
+            analise.verticesUsados++;
+        }
+        if (entrada[v] == SIZE_MAX || analise.falhas - entrada[v] >= tamanhoCache) {
+            entrada[v] = analise.falhas;
+            analise.falhas++;
+        }
+    }
+
+    if (analise.triangulos > 0)
+        analise.acmr = (float)analise.falhas / analise.triangulos;
+    if (analise.verticesUsados > 0)
+        analise.atvr = (float)analise.falhas / analise.verticesUsados;
+    return analise;
+}
+
+// Tipsify (Sander, Nehab e Barczak, 2007): percorre a malha em leques em torno
+// de um vértice, escolhendo o próximo entre os vizinhos que ainda estão no
+// cache e têm triângulos pendentes. Linear no número de índices.
+inline void otimizarCacheVertices(std::vector<GLuint>& indices, size_t numVertices,
+                                  unsigned tamanhoCache = TAMANHO_CACHE_PADRAO) {
+    const size_t numTriangulos = indices.size() / 3;
+    if (numTriangulos == 0 || numVertices == 0) return;
+
+    // adjacência vértice -> triângulos (CSR)
+    std::vector<uint32_t> inicio(numVertices + 1, 0);
+    for (GLuint v : indices) inicio[v + 1]++;
+    for (size_t v = 0; v < numVertices; v++) inicio[v + 1] += inicio[v];
+
+    std::vector<uint32_t> adjacencia(indices.size());
+    std::vector<uint32_t> preenchidos(inicio.begin(), inicio.end() - 1);
+    for (size_t t = 0; t < numTriangulos; t++)
+        for (int c = 0; c < 3; c++)
+            adjacencia[preenchidos[indices[t * 3 + c]]++] = (uint32_t)t;
+
+    std::vector<uint32_t> vivos(numVertices);           // triângulos ainda não emitidos por vértice
+    for (size_t v = 0; v < numVertices; v++) vivos[v] = inicio[v + 1] - inicio[v];
+
+    std::vector<size_t> marca(numVertices, 0);          // instante em que entrou no cache
+    std::vector<bool> emitido(numTriangulos, false);
+    std::vector<uint32_t> becoSemSaida;                 // vértices recentes, para retomar o percurso
+    std::vector<uint32_t> candidatos;
+
+    std::vector<GLuint> saida;
+    saida.reserve(indices.size());
+
+    size_t instante = tamanhoCache + 1;
+    size_t cursor = 0;
+
+    auto pularBecoSemSaida = [&]() -> int64_t {
+        while (!becoSemSaida.empty()) {
+            uint32_t d = becoSemSaida.back();
+            becoSemSaida.pop_back();
+            if (vivos[d] > 0) return d;
+        }
+        while (cursor < numVertices) {
+            if (vivos[cursor] > 0) return (int64_t)cursor;
+            cursor++;
+        }
+        return -1;
+    };
+
+    int64_t leque = pularBecoSemSaida();
+
+    while (leque >= 0) {
+        candidatos.clear();
+
+        for (uint32_t a = inicio[leque]; a < inicio[leque + 1]; a++) {
+            uint32_t t = adjacencia[a];
+            if (emitido[t]) continue;
+
+            for (int c = 0; c < 3; c++) {
+                GLuint v = indices[t * 3 + c];
+                saida.push_back(v);
+                becoSemSaida.push_back(v);
+                candidatos.push_back(v);
+                vivos[v]--;
+                if (instante - marca[v] > tamanhoCache) {
+                    marca[v] = instante;
+                    instante++;
+                }
+            }
+            emitido[t] = true;
+        }
+
+        // próximo leque: o vizinho que ainda vai estar no cache depois de emitir os seus triângulos
+        int64_t proximo = -1;
+        int64_t melhor = -1;
+        for (uint32_t v : candidatos) {
+            if (vivos[v] == 0) continue;
+            int64_t prioridade = 0;
+            if (instante - marca[v] + 2 * vivos[v] <= tamanhoCache)
+                prioridade = (int64_t)(instante - marca[v]);
+            if (prioridade > melhor) {
+                melhor = prioridade;
+                proximo = v;
+            }
+        }
+        if (proximo < 0) proximo = pularBecoSemSaida();
+
+        leque = proximo;
+    }
+
+    indices.swap(saida);
+}
+
+// Renumera os vértices na ordem do primeiro uso pelos índices, para a busca
+// de vértices andar para frente na memória. Vértices não referenciados vão para o fim.
+inline void otimizarBuscaVertices(std::vector<Vertice>& vertices, std::vector<GLuint>& indices) {
+    const GLuint SEM_MAPA = ~0u;
+    std::vector<GLuint> remapa(vertices.size(), SEM_MAPA);
+
+    GLuint proximo = 0;
+    for (GLuint& v : indices) {
+        if (remapa[v] == SEM_MAPA) remapa[v] = proximo++;
+        v = remapa[v];
+    }
+    for (GLuint& r : remapa)
+        if (r == SEM_MAPA) r = proximo++;
+
+    std::vector<Vertice> reordenados(vertices.size());
+    for (size_t v = 0; v < vertices.size(); v++)
+        reordenados[remapa[v]] = vertices[v];
+    vertices.swap(reordenados);
+}
+
+// Os dois passos, na ordem certa (a busca depende da ordem final dos triângulos).
+inline void otimizarMesh(std::vector<Vertice>& vertices, std::vector<GLuint>& indices,
+                         unsigned tamanhoCache = TAMANHO_CACHE_PADRAO) {
+    otimizarCacheVertices(indices, vertices.size(), tamanhoCache);
+    otimizarBuscaVertices(vertices, indices);
+}
+
+#endif
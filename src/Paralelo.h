@@ -0,0 +1,149 @@
+#ifndef PARALELO_H
+#define PARALELO_H
+
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+
+inline unsigned threadsDisponiveis() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+namespace paralelo {
+
+// Threads criadas uma vez e reaproveitadas: o descarte, a oclusão e as
+// matrizes normais dividem trabalho a cada quadro, e abrir e fechar threads
+// a cada chamada custava mais que o próprio trabalho em cenas pequenas.
+//
+// executar() põe as partes 1..n-1 na fila, roda a parte 0 na thread que
+// chamou e, enquanto espera, também tira partes da fila. Assim chamadas de
+// dentro de uma parte (ou de várias threads ao mesmo tempo) não travam
+// esperando trabalhadores ocupados.
+class PoolThreads {
+public:
+    explicit PoolThreads(unsigned trabalhadores) {
+        for (unsigned t = 0; t < trabalhadores; t++) threads.emplace_back([this]() { laco(); });
+    }
+
+    PoolThreads(const PoolThreads&) = delete;
+    PoolThreads& operator=(const PoolThreads&) = delete;
+
+    ~PoolThreads() {
+        {
+            std::lock_guard<std::mutex> trava(mutex);
+            parar = true;
+        }
+        sinal.notify_all();
+        for (std::thread& t : threads) t.join();
+    }
+
+    // uma thread a menos que os núcleos: a que chama também trabalha
+    static PoolThreads& global() {
+        static PoolThreads pool(threadsDisponiveis() - 1);
+        return pool;
+    }
+
+    // funcao(parte) para parte em [0, partes); volta quando todas terminaram
+    template <typename Funcao>
+    void executar(size_t partes, Funcao& funcao) {
+        if (partes == 0) return;
+        Lote lote;
+        lote.contexto = &funcao;
+        lote.chamar = [](void* contexto, size_t parte) { (*static_cast<Funcao*>(contexto))(parte); };
+        lote.pendentes.store(partes);
+
+        if (partes > 1) {
+            {
+                std::lock_guard<std::mutex> trava(mutex);
+                for (size_t p = 1; p < partes; p++) fila.push_back({&lote, p});
+            }
+            sinal.notify_all();
+        }
+        rodar({&lote, 0});
+
+        std::unique_lock<std::mutex> trava(mutex);
+        while (lote.pendentes.load() > 0) {
+            if (!fila.empty()) {
+                Item item = fila.front();
+                fila.pop_front();
+                trava.unlock();
+                rodar(item);
+                trava.lock();
+                continue;
+            }
+            sinal.wait(trava, [&]() { return lote.pendentes.load() == 0 || !fila.empty(); });
+        }
+    }
+
+private:
+    struct Lote {
+        void (*chamar)(void*, size_t) = nullptr;
+        void* contexto = nullptr;
+        std::atomic<size_t> pendentes{0};
+    };
+
+    struct Item {
+        Lote* lote;
+        size_t parte;
+    };
+
+    std::vector<std::thread> threads;
+    std::deque<Item> fila;
+    std::mutex mutex;
+    std::condition_variable sinal;   // parte nova na fila ou lote terminado
+    bool parar = false;
+
+    // depois de decrementar, o lote pode já ter saído da pilha de quem chamou:
+    // só o mutex e o sinal são tocados
+    void rodar(const Item& item) {
+        item.lote->chamar(item.lote->contexto, item.parte);
+        if (item.lote->pendentes.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> trava(mutex);
+            sinal.notify_all();
+        }
+    }
+
+    void laco() {
+        std::unique_lock<std::mutex> trava(mutex);
+        for (;;) {
+            sinal.wait(trava, [&]() { return parar || !fila.empty(); });
+            if (fila.empty()) return;   // parar, sem trabalho pendente
+            Item item = fila.front();
+            fila.pop_front();
+            trava.unlock();
+            rodar(item);
+            trava.lock();
+        }
+    }
+};
+
+}
+
+// Divide [0, total) em blocos contíguos, um por thread, e chama
+// funcao(inicio, fim) em cada um, nas threads de paralelo::PoolThreads.
+// Cada thread recebe pelo menos minimoPorThread itens; com pouco trabalho
+// roda tudo na thread atual, sem passar pela fila.
+template <typename Funcao>
+void paraleloEmBlocos(size_t total, size_t minimoPorThread, Funcao&& funcao) {
+    if (total == 0) return;
+
+    size_t numThreads = std::min<size_t>(threadsDisponiveis(),
+                                         std::max<size_t>(1, total / std::max<size_t>(1, minimoPorThread)));
+    if (numThreads <= 1) {
+        funcao((size_t)0, total);
+        return;
+    }
+
+    size_t bloco = (total + numThreads - 1) / numThreads;
+    size_t numBlocos = (total + bloco - 1) / bloco;
+    auto parte = [&](size_t b) { funcao(b * bloco, std::min(total, (b + 1) * bloco)); };
+    paralelo::PoolThreads::global().executar(numBlocos, parte);
+}
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef PERMUTACOES_SHADER_H
+#define PERMUTACOES_SHADER_H
+
+#include <glad/glad.h>
+#include <string>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <initializer_list>
+#include <cstdint>
+
+#include "Shader.h"
+#include "BlocosUniform.h"
+
+// Variantes de um mesmo par de shaders, especializadas na compilação por
+// #defines (Shader::preprocessar) em vez de decididas no shader a cada
+// vértice ou fragmento. A chave de uma variante é um inteiro pequeno:
+//
+//   bit 0      RECURSO_ILUMINACAO         ILUMINACAO
+//   bit 1      RECURSO_VERTICE_COMPACTO   VERTICE_COMPACTO
+//   bit 2      RECURSO_INSTANCIADO        INSTANCIADO
+//   bits 3..5  luzes pontuais (0 a 4)     NUM_LUZES_PONTUAIS
+//
+// e indexa direto uma tabela de 64 entradas, preenchida na primeira vez que
+// cada chave é pedida. Os shaders recebem sempre as quatro definições (0/1,
+// ou a quantidade de luzes), então um recurso que o par não usa só deixa de
+// entrar na chave.
+
+const uint32_t RECURSO_ILUMINACAO = 1u << 0;
+const uint32_t RECURSO_VERTICE_COMPACTO = 1u << 1;
+const uint32_t RECURSO_INSTANCIADO = 1u << 2;
+const uint32_t MASCARA_RECURSOS = 0x7;
+const int DESLOCAMENTO_LUZES = 3;
+const uint32_t NUM_CHAVES_PERMUTACAO = 64;
+
+inline uint32_t chavePermutacao(uint32_t recursos, size_t numLuzes) {
+    size_t luzes = std::min(numLuzes, (size_t)MAXIMO_LUZES_PONTUAIS);
+    return (recursos & MASCARA_RECURSOS) | (uint32_t)luzes << DESLOCAMENTO_LUZES;
+}
+
+inline int luzesDaChave(uint32_t chave) { return (int)(chave >> DESLOCAMENTO_LUZES); }
+
+inline std::string definicoesPermutacao(uint32_t chave) {
+    std::string d;
+    d += "#define ILUMINACAO " + std::to_string((chave & RECURSO_ILUMINACAO) ? 1 : 0) + "\n";
+    d += "#define NUM_LUZES_PONTUAIS " + std::to_string(luzesDaChave(chave)) + "\n";
+    d += "#define VERTICE_COMPACTO " + std::to_string((chave & RECURSO_VERTICE_COMPACTO) ? 1 : 0) + "\n";
+    d += "#define INSTANCIADO " + std::to_string((chave & RECURSO_INSTANCIADO) ? 1 : 0) + "\n";
+    return d;
+}
+
+// para os relatórios do console: "iluminacao 3 luzes, compacto, instanciado"
+inline std::string descreverPermutacao(uint32_t chave) {
+    std::string d = (chave & RECURSO_ILUMINACAO) ? "iluminacao " + std::to_string(luzesDaChave(chave)) + " luzes"
+                                                 : "sem iluminacao";
+    if (chave & RECURSO_VERTICE_COMPACTO) d += ", compacto";
+    if (chave & RECURSO_INSTANCIADO) d += ", instanciado";
+    return d;
+}
+
+struct EstatisticasPermutacoes {
+    size_t compiladas = 0;   // variantes criadas (do cache de programas ou compiladas)
+    size_t possiveis = 0;    // chaves distintas que o par aceita
+    double segundos = 0.0;   // criação das variantes, com o iniciar de cada uma
+    uint32_t ultimaChave = 0;
+    double segundosUltima = 0.0;
+};
+
+// Tabela de variantes de um par vertex/fragment. recursos são os bits que o
+// par distingue; fixos entram em toda chave (ex.: RECURSO_INSTANCIADO no
+// shader do descarte na GPU, que só existe instanciado). obter() normaliza a
+// chave pedida, então quem desenha pode montá-la sempre do mesmo jeito.
+//
+// iniciar roda uma vez por variante, logo depois da criação: vincula os
+// blocos de uniforms, resolve uniforms e, se for o caso, registra o programa
+// na FilaRenderizacao. O que ele devolve fica em Variante::identificador.
+class PermutacoesShader {
+public:
+    typedef std::function<uint32_t(const Shader&, uint32_t chave)> FuncaoIniciar;
+
+    struct Variante {
+        std::unique_ptr<Shader> shader;   // endereço estável: a fila guarda o ponteiro
+        uint32_t identificador = 0;
+    };
+
+    EstatisticasPermutacoes estatisticas;
+
+    PermutacoesShader(const char* caminhoVertexShader, const char* caminhoFragmentShader, uint32_t recursos,
+                      uint32_t fixos, FuncaoIniciar iniciar)
+        : vertexShader(caminhoVertexShader), fragmentShader(caminhoFragmentShader),
+          recursos(recursos & MASCARA_RECURSOS), fixos(fixos & MASCARA_RECURSOS), iniciar(std::move(iniciar)) {
+        size_t combinacoes = 1;
+        for (uint32_t bit : {RECURSO_VERTICE_COMPACTO, RECURSO_INSTANCIADO})
+            if (this->recursos & bit) combinacoes *= 2;
+        estatisticas.possiveis = (this->recursos & RECURSO_ILUMINACAO)
+            ? combinacoes * (2 + MAXIMO_LUZES_PONTUAIS)   // desligada, ou ligada com 0 a 4 luzes
+            : combinacoes;
+    }
+
+    PermutacoesShader(const PermutacoesShader&) = delete;
+    PermutacoesShader& operator=(const PermutacoesShader&) = delete;
+
+    // Bits que o par não usa saem da chave e, sem iluminação, a quantidade
+    // de luzes vira 0: chaves equivalentes caem na mesma variante.
+    uint32_t normalizar(uint32_t chave) const {
+        uint32_t r = ((chave & recursos) | fixos) & MASCARA_RECURSOS;
+        int luzes = (r & RECURSO_ILUMINACAO) ? std::min(luzesDaChave(chave), MAXIMO_LUZES_PONTUAIS) : 0;
+        return r | (uint32_t)luzes << DESLOCAMENTO_LUZES;
+    }
+
+    // Cria a variante se ainda não existe; no laço de desenho, uma variante
+    // nova custa a compilação (ou a leitura do cache) no quadro em que aparece.
+    const Variante& obter(uint32_t chave) {
+        chave = normalizar(chave);
+        Variante& v = variantes[chave];
+        if (!v.shader) criar(v, chave);
+        return v;
+    }
+
+    const Shader& shader(uint32_t chave) { return *obter(chave).shader; }
+    uint32_t identificador(uint32_t chave) { return obter(chave).identificador; }
+
+    // para criar na partida as variantes que a cena certamente usa
+    void preparar(uint32_t chave) { obter(chave); }
+
+    bool criada(uint32_t chave) const { return variantes[normalizar(chave)].shader != nullptr; }
+
+    const char* nome() const { return vertexShader; }
+
+private:
+    const char* vertexShader;
+    const char* fragmentShader;
+    uint32_t recursos, fixos;
+    FuncaoIniciar iniciar;
+    Variante variantes[NUM_CHAVES_PERMUTACAO];
+
+    void criar(Variante& v, uint32_t chave) {
+        auto inicio = std::chrono::steady_clock::now();
+        v.shader.reset(new Shader(vertexShader, fragmentShader, definicoesPermutacao(chave)));
+        v.identificador = iniciar ? iniciar(*v.shader, chave) : 0;
+        estatisticas.compiladas++;
+        estatisticas.ultimaChave = chave;
+        estatisticas.segundosUltima = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        estatisticas.segundos += estatisticas.segundosUltima;
+    }
+};
+
+#endif
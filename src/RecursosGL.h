@@ -0,0 +1,154 @@
+#ifndef RECURSOS_GL_H
+#define RECURSOS_GL_H
+
+#include <glad/glad.h>
+
+#include "EstadoGL.h"
+
+// Dono exclusivo de um buffer OpenGL (VBO/EBO). Só pode ser movido, então
+// nunca existem duas cópias tentando deletar o mesmo id.
+class BufferGL {
+public:
+    GLuint id = 0;
+
+    BufferGL() = default;
+    BufferGL(const BufferGL&) = delete;
+    BufferGL& operator=(const BufferGL&) = delete;
+
+    BufferGL(BufferGL&& outro) noexcept : id(outro.id) { outro.id = 0; }
+
+    BufferGL& operator=(BufferGL&& outro) noexcept {
+        if (this != &outro) {
+            liberar();
+            id = outro.id;
+            outro.id = 0;
+        }
+        return *this;
+    }
+
+    ~BufferGL() { liberar(); }
+
+    void gerar() {
+        if (id == 0) glGenBuffers(1, &id);
+    }
+
+    void liberar() {
+        if (id != 0) {
+            glDeleteBuffers(1, &id);
+            id = 0;
+        }
+    }
+
+    operator GLuint() const { return id; }
+};
+
+// Mesmo esquema do BufferGL, para o VAO.
+class VertexArrayGL {
+public:
+    GLuint id = 0;
+
+    VertexArrayGL() = default;
+    VertexArrayGL(const VertexArrayGL&) = delete;
+    VertexArrayGL& operator=(const VertexArrayGL&) = delete;
+
+    VertexArrayGL(VertexArrayGL&& outro) noexcept : id(outro.id) { outro.id = 0; }
+
+    VertexArrayGL& operator=(VertexArrayGL&& outro) noexcept {
+        if (this != &outro) {
+            liberar();
+            id = outro.id;
+            outro.id = 0;
+        }
+        return *this;
+    }
+
+    ~VertexArrayGL() { liberar(); }
+
+    void gerar() {
+        if (id == 0) glGenVertexArrays(1, &id);
+    }
+
+    void liberar() {
+        if (id != 0) {
+            EstadoGL::esquecerVAO(id);
+            glDeleteVertexArrays(1, &id);
+            id = 0;
+        }
+    }
+
+    operator GLuint() const { return id; }
+};
+
+// Mesmo esquema, para texturas.
+class TexturaGL {
+public:
+    GLuint id = 0;
+
+    TexturaGL() = default;
+    TexturaGL(const TexturaGL&) = delete;
+    TexturaGL& operator=(const TexturaGL&) = delete;
+
+    TexturaGL(TexturaGL&& outro) noexcept : id(outro.id) { outro.id = 0; }
+
+    TexturaGL& operator=(TexturaGL&& outro) noexcept {
+        if (this != &outro) {
+            liberar();
+            id = outro.id;
+            outro.id = 0;
+        }
+        return *this;
+    }
+
+    ~TexturaGL() { liberar(); }
+
+    void gerar() {
+        if (id == 0) glGenTextures(1, &id);
+    }
+
+    void liberar() {
+        if (id != 0) {
+            glDeleteTextures(1, &id);
+            id = 0;
+        }
+    }
+
+    operator GLuint() const { return id; }
+};
+
+// Mesmo esquema, para framebuffers.
+class FramebufferGL {
+public:
+    GLuint id = 0;
+
+    FramebufferGL() = default;
+    FramebufferGL(const FramebufferGL&) = delete;
+    FramebufferGL& operator=(const FramebufferGL&) = delete;
+
+    FramebufferGL(FramebufferGL&& outro) noexcept : id(outro.id) { outro.id = 0; }
+
+    FramebufferGL& operator=(FramebufferGL&& outro) noexcept {
+        if (this != &outro) {
+            liberar();
+            id = outro.id;
+            outro.id = 0;
+        }
+        return *this;
+    }
+
+    ~FramebufferGL() { liberar(); }
+
+    void gerar() {
+        if (id == 0) glGenFramebuffers(1, &id);
+    }
+
+    void liberar() {
+        if (id != 0) {
+            glDeleteFramebuffers(1, &id);
+            id = 0;
+        }
+    }
+
+    operator GLuint() const { return id; }
+};
+
+#endif
@@ -6,98 +6,285 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <initializer_list>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "EstadoGL.h"
+#include "ExtensoesGL.h"
+#include "CacheProgramas.h"
+
+inline void enviarUniform(GLint local, bool valor) { glUniform1i(local, (int)valor); }
+inline void enviarUniform(GLint local, int valor) { glUniform1i(local, valor); }
+inline void enviarUniform(GLint local, GLuint valor) { glUniform1ui(local, valor); }
+inline void enviarUniform(GLint local, float valor) { glUniform1f(local, valor); }
+inline void enviarUniform(GLint local, const glm::vec3& valor) { glUniform3fv(local, 1, glm::value_ptr(valor)); }
+inline void enviarUniform(GLint local, const glm::vec4& valor) { glUniform4fv(local, 1, glm::value_ptr(valor)); }
+inline void enviarUniform(GLint local, const glm::mat4& valor) {
+    glUniformMatrix4fv(local, 1, GL_FALSE, glm::value_ptr(valor));
+}
+
+// Local de um uniform já resolvido, com o tipo do valor. Vale para o programa
+// de onde saiu e, como os glUniform*, age sobre o programa em uso. Um local -1
+// (uniform inexistente ou removido pelo compilador) é ignorado pelo OpenGL.
+template <typename T>
+struct Uniform {
+    GLint local = -1;
+
+    bool valido() const { return local >= 0; }
+    void definir(const T& valor) const { enviarUniform(local, valor); }
+};
+
 class Shader {
 public:
     GLuint idPrograma;
 
-    Shader(const char* caminhoVertexShader, const char* caminhoFragmentShader) {
-        std::string codigoVertex, codigoFragment;
-        std::ifstream arquivoVertex, arquivoFragment;
+    // Criação de todos os programas até aqui: quantos vieram do cache em
+    // disco (CacheProgramas.h) e quanto tempo levou.
+    inline static EstatisticasCacheProgramas estatisticasCache;
 
-        arquivoVertex.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        arquivoFragment.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    // definicoes são linhas "#define NOME valor" postas depois do #version
+    // de cada estágio (ver preprocessar()); entram na chave do cache.
+    Shader(const char* caminhoVertexShader, const char* caminhoFragmentShader, const std::string& definicoes = "") {
+        montar({{GL_VERTEX_SHADER, "VERTEX", caminhoVertexShader},
+                {GL_FRAGMENT_SHADER, "FRAGMENT", caminhoFragmentShader}}, definicoes);
+    }
 
-        try {
-            arquivoVertex.open(caminhoVertexShader);
-            arquivoFragment.open(caminhoFragmentShader);
+    // Programa de computação (OpenGL 4.3); só crie depois de conferir
+    // ExtensoesGL::temComputacao().
+    explicit Shader(const char* caminhoComputeShader, const std::string& definicoes = "") {
+        montar({{GL_COMPUTE_SHADER, "COMPUTE", caminhoComputeShader}}, definicoes);
+    }
 
-            std::stringstream streamVertex, streamFragment;
-            streamVertex << arquivoVertex.rdbuf();
-            streamFragment << arquivoFragment.rdbuf();
+    // só troca de programa se outro estiver em uso
+    void usar() const {
+        EstadoGL::usarPrograma(idPrograma);
+    }
 
-            arquivoVertex.close();
-            arquivoFragment.close();
+    // -1 se o programa não tem o uniform; busca na tabela, sem chamar o OpenGL
+    GLint localizacao(const char* nome) const {
+        const UniformAtivo* u = buscar(nome);
+        return u ? u->local : -1;
+    }
 
-            codigoVertex = streamVertex.str();
-            codigoFragment = streamFragment.str();
-        }
-        catch (std::ifstream::failure& erro) {
-            std::cout << "ERRO::SHADER::ARQUIVO_NAO_LIDO: " << erro.what() << std::endl;
+    // Para resolver fora do laço de desenho. Nomes como no GLSL:
+    // "luzesPontuais[2].difusa", "pixelsMinimos[3]".
+    template <typename T>
+    Uniform<T> uniform(const char* nome) const {
+        Uniform<T> u;
+        const UniformAtivo* ativo = buscar(nome);
+        if (!ativo) return u;
+        if (!tipoCompativel<T>(ativo->tipo)) {
+            std::cout << "ERRO::SHADER::UNIFORM_TIPO::" << nome << std::endl;
+            return u;
         }
+        u.local = ativo->local;
+        return u;
+    }
 
-        const char* codigoVShader = codigoVertex.c_str();
-        const char* codigoFShader = codigoFragment.c_str();
+    template <typename T>
+    Uniform<T> uniform(const std::string& nome) const { return uniform<T>(nome.c_str()); }
 
-        GLuint vertex, fragment;
+    size_t numUniforms() const { return uniforms.size(); }
 
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &codigoVShader, NULL);
-        glCompileShader(vertex);
-        verificarErros(vertex, "VERTEX");
+    // Por nome, a cada chamada; para o laço de desenho, prefira uniform<T>().
+    void definirBool(const char* nome, bool valor) const { enviarUniform(localizacao(nome), valor); }
+    void definirInt(const char* nome, int valor) const { enviarUniform(localizacao(nome), valor); }
+    void definirFloat(const char* nome, float valor) const { enviarUniform(localizacao(nome), valor); }
+    void definirVec3(const char* nome, const glm::vec3& valor) const { enviarUniform(localizacao(nome), valor); }
+    void definirVec3(const char* nome, float x, float y, float z) const { glUniform3f(localizacao(nome), x, y, z); }
+    void definirVec4(const char* nome, const glm::vec4& valor) const { enviarUniform(localizacao(nome), valor); }
+    void definirMat4(const char* nome, const glm::mat4& matriz) const { enviarUniform(localizacao(nome), matriz); }
+
+    void definirBool(const std::string& nome, bool valor) const { definirBool(nome.c_str(), valor); }
+    void definirInt(const std::string& nome, int valor) const { definirInt(nome.c_str(), valor); }
+    void definirFloat(const std::string& nome, float valor) const { definirFloat(nome.c_str(), valor); }
+    void definirVec3(const std::string& nome, const glm::vec3& valor) const { definirVec3(nome.c_str(), valor); }
+    void definirVec4(const std::string& nome, const glm::vec4& valor) const { definirVec4(nome.c_str(), valor); }
+    void definirMat4(const std::string& nome, const glm::mat4& matriz) const { definirMat4(nome.c_str(), matriz); }
+
+private:
+    struct UniformAtivo {
+        std::string nome;
+        GLint local;
+        GLenum tipo;
+    };
 
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &codigoFShader, NULL);
-        glCompileShader(fragment);
-        verificarErros(fragment, "FRAGMENT");
+    struct Estagio {
+        GLenum tipo;
+        const char* nome;   // para as mensagens de erro
+        const char* caminho;
+    };
 
+    std::vector<UniformAtivo> uniforms;   // ordenada por nome
+
+    // Lê e preprocessa as fontes e tenta o binário do cache; se não houver
+    // entrada válida, compila, linka e grava uma.
+    void montar(std::initializer_list<Estagio> estagios, const std::string& definicoes) {
+        auto inicio = std::chrono::steady_clock::now();
+        std::vector<std::string> caminhos, fontes;
+        for (const Estagio& estagio : estagios) {
+            caminhos.push_back(estagio.caminho);
+            fontes.push_back(preprocessar(estagio.caminho, definicoes));
+        }
+
+        // as fontes já vêm com os includes expandidos, então editar um include também invalida
+        ChaveCachePrograma chave = chaveCachePrograma(caminhos, fontes, definicoes);
         idPrograma = glCreateProgram();
-        glAttachShader(idPrograma, vertex);
-        glAttachShader(idPrograma, fragment);
-        glLinkProgram(idPrograma);
-        verificarErros(idPrograma, "PROGRAMA");
-
-        // shaders já linkados, podem ser deletados
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
-    }
+        bool recusado = false;
+        if (carregarCachePrograma(idPrograma, chave, recusado)) {
+            estatisticasCache.carregados++;
+        } else {
+            if (recusado) {
+                // recomeça de um programa limpo
+                glDeleteProgram(idPrograma);
+                idPrograma = glCreateProgram();
+                estatisticasCache.recusados++;
+            }
+            std::vector<GLuint> objetos;
+            size_t f = 0;
+            for (const Estagio& estagio : estagios) objetos.push_back(compilar(estagio.tipo, fontes[f++], estagio.nome));
+            for (GLuint objeto : objetos) glAttachShader(idPrograma, objeto);
+            if (!chave.caminho.empty())
+                ExtensoesGL::programParameteri(idPrograma, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            glLinkProgram(idPrograma);
+            bool linkado = verificarErros(idPrograma, "PROGRAMA");
 
-    void usar() {
-        glUseProgram(idPrograma);
-    }
+            // shaders já linkados, podem ser deletados
+            for (GLuint objeto : objetos) glDeleteShader(objeto);
 
-    void definirBool(const std::string& nome, bool valor) const {
-        glUniform1i(glGetUniformLocation(idPrograma, nome.c_str()), (int)valor);
+            estatisticasCache.compilados++;
+            if (linkado && salvarCachePrograma(idPrograma, chave)) estatisticasCache.gravados++;
+        }
+        refletirUniforms();
+        estatisticasCache.segundos +=
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
     }
 
-    void definirInt(const std::string& nome, int valor) const {
-        glUniform1i(glGetUniformLocation(idPrograma, nome.c_str()), valor);
+    static std::string lerArquivo(const char* caminho) {
+        std::ifstream arquivo;
+        arquivo.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        try {
+            arquivo.open(caminho);
+            std::stringstream stream;
+            stream << arquivo.rdbuf();
+            return stream.str();
+        }
+        catch (std::ifstream::failure& erro) {
+            std::cout << "ERRO::SHADER::ARQUIVO_NAO_LIDO: " << erro.what() << std::endl;
+        }
+        return std::string();
     }
 
-    void definirFloat(const std::string& nome, float valor) const {
-        glUniform1f(glGetUniformLocation(idPrograma, nome.c_str()), valor);
+    // Expande #include "arquivo" (relativo ao arquivo que inclui; cada um
+    // entra uma vez só, como se tivesse include guard) e põe as definições
+    // logo depois do #version. Diretivas #line mantêm as linhas dos erros de
+    // compilação: a fonte 0 é o arquivo principal, e os includes seguem a
+    // ordem em que aparecem.
+    static std::string preprocessar(const std::string& caminho, const std::string& definicoes) {
+        std::vector<std::string> incluidos;
+        std::string saida;
+        incluir(caminho, definicoes, incluidos, saida);
+        return saida;
     }
 
-    void definirVec3(const std::string& nome, const glm::vec3& valor) const {
-        glUniform3fv(glGetUniformLocation(idPrograma, nome.c_str()), 1, glm::value_ptr(valor));
+    static void incluir(const std::string& caminho, const std::string& definicoes,
+                        std::vector<std::string>& incluidos, std::string& saida) {
+        int fonte = (int)incluidos.size();
+        incluidos.push_back(caminho);
+        std::string codigo = lerArquivo(caminho.c_str());
+        std::string diretorio = caminho.substr(0, caminho.find_last_of("/\\") + 1);
+
+        std::istringstream linhas(codigo);
+        std::string linha;
+        for (int numero = 1; std::getline(linhas, linha); numero++) {
+            size_t inicio = linha.find_first_not_of(" \t");
+            bool diretiva = inicio != std::string::npos && linha[inicio] == '#';
+            size_t palavra = diretiva ? linha.find_first_not_of(" \t", inicio + 1) : std::string::npos;
+
+            if (palavra != std::string::npos && linha.compare(palavra, 7, "version") == 0) {
+                if (fonte != 0) continue;   // só vale o do arquivo principal
+                saida += linha + "\n" + definicoes;
+                if (!definicoes.empty() && definicoes.back() != '\n') saida += "\n";
+                saida += "#line " + std::to_string(numero + 1) + " 0\n";
+                continue;
+            }
+            if (palavra != std::string::npos && linha.compare(palavra, 7, "include") == 0) {
+                size_t abre = linha.find('"', palavra + 7);
+                size_t fecha = abre == std::string::npos ? abre : linha.find('"', abre + 1);
+                if (fecha == std::string::npos) {
+                    std::cout << "ERRO::SHADER::INCLUDE_MALFORMADO: " << caminho << ":" << numero << std::endl;
+                    continue;
+                }
+                std::string alvo = diretorio + linha.substr(abre + 1, fecha - abre - 1);
+                if (std::find(incluidos.begin(), incluidos.end(), alvo) == incluidos.end()) {
+                    saida += "#line 1 " + std::to_string(incluidos.size()) + "\n";
+                    incluir(alvo, definicoes, incluidos, saida);
+                    saida += "#line " + std::to_string(numero + 1) + " " + std::to_string(fonte) + "\n";
+                }
+                continue;
+            }
+            saida += linha + "\n";
+        }
     }
 
-    void definirVec3(const std::string& nome, float x, float y, float z) const {
-        glUniform3f(glGetUniformLocation(idPrograma, nome.c_str()), x, y, z);
+    // Lê os uniforms ativos uma vez, depois do link. Arrays de tipos básicos
+    // vêm como "nome[0]" com tamanho n; cada elemento ganha uma entrada (os
+    // locais são seguidos) e "nome" vale o primeiro. Membros de blocos de
+    // uniforms não têm local e ficam de fora.
+    void refletirUniforms() {
+        GLint quantidade = 0, tamanhoMaximo = 0;
+        glGetProgramiv(idPrograma, GL_ACTIVE_UNIFORMS, &quantidade);
+        glGetProgramiv(idPrograma, GL_ACTIVE_UNIFORM_MAX_LENGTH, &tamanhoMaximo);
+        std::vector<GLchar> nome(std::max(tamanhoMaximo, 1));
+
+        for (GLint i = 0; i < quantidade; i++) {
+            GLsizei comprimento = 0;
+            GLint tamanho = 0;
+            GLenum tipo = 0;
+            glGetActiveUniform(idPrograma, (GLuint)i, (GLsizei)nome.size(), &comprimento, &tamanho, &tipo, nome.data());
+            std::string nomeUniform(nome.data(), comprimento);
+            GLint local = glGetUniformLocation(idPrograma, nomeUniform.c_str());
+            if (local < 0) continue;
+
+            bool array = nomeUniform.size() > 3 && nomeUniform.compare(nomeUniform.size() - 3, 3, "[0]") == 0;
+            if (!array) {
+                uniforms.push_back({nomeUniform, local, tipo});
+                continue;
+            }
+            std::string base = nomeUniform.substr(0, nomeUniform.size() - 3);
+            uniforms.push_back({base, local, tipo});
+            for (GLint e = 0; e < tamanho; e++)
+                uniforms.push_back({base + "[" + std::to_string(e) + "]", local + e, tipo});
+        }
+        std::sort(uniforms.begin(), uniforms.end(),
+                  [](const UniformAtivo& a, const UniformAtivo& b) { return a.nome < b.nome; });
     }
 
-    void definirVec4(const std::string& nome, const glm::vec4& valor) const {
-        glUniform4fv(glGetUniformLocation(idPrograma, nome.c_str()), 1, glm::value_ptr(valor));
+    const UniformAtivo* buscar(const char* nome) const {
+        auto it = std::lower_bound(uniforms.begin(), uniforms.end(), nome, [](const UniformAtivo& u, const char* n) {
+            return std::strcmp(u.nome.c_str(), n) < 0;
+        });
+        return it != uniforms.end() && it->nome == nome ? &*it : nullptr;
     }
 
-    void definirMat4(const std::string& nome, const glm::mat4& matriz) const {
-        glUniformMatrix4fv(glGetUniformLocation(idPrograma, nome.c_str()), 1, GL_FALSE, glm::value_ptr(matriz));
+    template <typename T>
+    static bool tipoCompativel(GLenum tipo);
+
+    GLuint compilar(GLenum tipo, const std::string& codigo, const std::string& nome) {
+        const char* fonte = codigo.c_str();
+        GLuint shader = glCreateShader(tipo);
+        glShaderSource(shader, 1, &fonte, NULL);
+        glCompileShader(shader);
+        verificarErros(shader, nome);
+        return shader;
     }
 
-private:
-    void verificarErros(GLuint shader, std::string tipo) {
+    bool verificarErros(GLuint shader, std::string tipo) {
         GLint sucesso;
         GLchar logErro[1024];
 
@@ -114,7 +301,40 @@ private:
                 std::cout << "ERRO::SHADER::LINKAGEM::" << tipo << "\n" << logErro << std::endl;
             }
         }
+        return sucesso != 0;
     }
 };
 
+template <> inline bool Shader::tipoCompativel<bool>(GLenum tipo) { return tipo == GL_BOOL; }
+template <> inline bool Shader::tipoCompativel<GLuint>(GLenum tipo) { return tipo == GL_UNSIGNED_INT; }
+template <> inline bool Shader::tipoCompativel<float>(GLenum tipo) { return tipo == GL_FLOAT; }
+template <> inline bool Shader::tipoCompativel<glm::vec3>(GLenum tipo) { return tipo == GL_FLOAT_VEC3; }
+template <> inline bool Shader::tipoCompativel<glm::vec4>(GLenum tipo) { return tipo == GL_FLOAT_VEC4; }
+template <> inline bool Shader::tipoCompativel<glm::mat4>(GLenum tipo) { return tipo == GL_FLOAT_MAT4; }
+
+// int serve para int, bool, samplers e imagens (que recebem a unidade); o resto é recusado
+template <> inline bool Shader::tipoCompativel<int>(GLenum tipo) {
+    switch (tipo) {
+    case GL_INT: case GL_BOOL:
+    case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+    case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_1D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_ARRAY_SHADOW: case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+    case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW: case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_CUBE_MAP_ARRAY: case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+    case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+    case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_INT_SAMPLER_2D_RECT: case GL_INT_SAMPLER_BUFFER:
+    case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_CUBE: case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+    case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+    case GL_UNSIGNED_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+        return true;
+    default:
+        return tipo >= GL_IMAGE_1D && tipo <= GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY;
+    }
+}
+
 #endif
@@ -0,0 +1,341 @@
+#ifndef SIMPLIFICACAO_H
+#define SIMPLIFICACAO_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "Mesh.h"
+#include "Paralelo.h"
+
+// Simplificação por colapso de arestas com métrica de erro quádrica
+// (Garland e Heckbert, 1997), em passes como no meshoptimizer:
+//
+//   1. quádricas por vértice (soma dos planos dos triângulos vizinhos, pesados pela área)
+//   2. custo de cada aresta = erro quádrico no destino + diferença de normal/UV
+//   3. ordena os custos e colapsa os mais baratos, cada vértice no máximo uma vez por passe,
+//      rejeitando colapsos que invertem triângulos
+//   4. reescreve os índices e repete até o alvo ou o erro máximo
+//
+// O colapso é de meia aresta (o vértice de origem vai para o de destino), então
+// os atributos do destino são mantidos sem interpolação. Vértices de borda ficam
+// travados; costuras de UV/normal (vértices duplicados na mesma posição)
+// aparecem como borda para cada cópia e também ficam travadas, o que preserva
+// as costuras sem precisar soldar posições. A memória é linear no tamanho da
+// mesh (~100 bytes por vértice) e as etapas por vértice/triângulo rodam em paralelo.
+
+struct ParametrosSimplificacao {
+    size_t triangulosAlvo = 0;   // para ao chegar aqui (0 = só pelo erro)
+    float erroMaximo = 0.01f;    // distância máxima, relativa à maior dimensão da AABB
+    float pesoNormal = 0.05f;    // peso de |n_origem - n_destino|²
+    float pesoUV = 0.05f;        // peso de |uv_origem - uv_destino|²
+    bool travarBordas = true;
+};
+
+struct ResultadoSimplificacao {
+    size_t triangulosAntes = 0;
+    size_t triangulosDepois = 0;
+    size_t passes = 0;
+    float erro = 0.0f;           // maior erro aceito, na mesma escala de erroMaximo
+};
+
+namespace simplificacao {
+
+struct Quadrica {
+    float a00, a01, a02, a03;
+    float a11, a12, a13;
+    float a22, a23;
+    float a33;
+    float peso;
+
+    void somar(const Quadrica& q) {
+        a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+        a11 += q.a11; a12 += q.a12; a13 += q.a13;
+        a22 += q.a22; a23 += q.a23;
+        a33 += q.a33;
+        peso += q.peso;
+    }
+
+    // soma das distâncias² aos planos, dividida pelo peso total
+    float erro(const glm::vec3& p) const {
+        float x = p.x, y = p.y, z = p.z;
+        float r = x * x * a00 + y * y * a11 + z * z * a22
+                + 2.0f * (x * y * a01 + x * z * a02 + y * z * a12)
+                + 2.0f * (x * a03 + y * a13 + z * a23)
+                + a33;
+        return peso > 0.0f ? std::max(r, 0.0f) / peso : 0.0f;
+    }
+};
+
+inline Quadrica quadricaPlano(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) {
+    glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+    float comprimento = glm::length(n);
+    Quadrica q;
+    std::memset(&q, 0, sizeof(q));
+    if (comprimento == 0.0f) return q;
+
+    n /= comprimento;
+    float area = comprimento * 0.5f;
+    float d = -glm::dot(n, p0);
+
+    q.a00 = n.x * n.x * area; q.a01 = n.x * n.y * area; q.a02 = n.x * n.z * area; q.a03 = n.x * d * area;
+    q.a11 = n.y * n.y * area; q.a12 = n.y * n.z * area; q.a13 = n.y * d * area;
+    q.a22 = n.z * n.z * area; q.a23 = n.z * d * area;
+    q.a33 = d * d * area;
+    q.peso = area;
+    return q;
+}
+
+// adjacência vértice -> triângulos (CSR)
+struct Adjacencia {
+    std::vector<uint32_t> inicio;
+    std::vector<uint32_t> triangulos;
+
+    void construir(const std::vector<GLuint>& indices, size_t numVertices) {
+        inicio.assign(numVertices + 1, 0);
+        for (GLuint v : indices) inicio[v + 1]++;
+        for (size_t v = 0; v < numVertices; v++) inicio[v + 1] += inicio[v];
+
+        triangulos.resize(indices.size());
+        std::vector<uint32_t> preenchidos(inicio.begin(), inicio.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+            triangulos[preenchidos[indices[i]]++] = (uint32_t)(i / 3);
+    }
+};
+
+struct Colapso {
+    uint32_t origem;
+    uint32_t destino;
+    float custo;
+};
+
+// Ordenação aproximada por custo: counting sort nos 16 bits altos do float
+// (custos são >= 0, então a ordem dos bits é a ordem dos valores). O(n).
+inline void ordenarColapsos(std::vector<Colapso>& colapsos) {
+    const size_t BALDES = 1 << 16;
+    std::vector<uint32_t> contagem(BALDES + 1, 0);
+
+    auto balde = [](float custo) {
+        uint32_t bits;
+        std::memcpy(&bits, &custo, sizeof(bits));
+        return bits >> 16;
+    };
+
+    for (const Colapso& c : colapsos) contagem[balde(c.custo) + 1]++;
+    for (size_t b = 0; b < BALDES; b++) contagem[b + 1] += contagem[b];
+
+    std::vector<Colapso> ordenados(colapsos.size());
+    for (const Colapso& c : colapsos) ordenados[contagem[balde(c.custo)]++] = c;
+    colapsos.swap(ordenados);
+}
+
+}
+
+inline ResultadoSimplificacao simplificar(std::vector<Vertice>& vertices, std::vector<GLuint>& indices,
+                                          const ParametrosSimplificacao& parametros) {
+    using namespace simplificacao;
+
+    ResultadoSimplificacao resultado;
+    resultado.triangulosAntes = resultado.triangulosDepois = indices.size() / 3;
+
+    const size_t numVertices = vertices.size();
+    if (numVertices == 0 || indices.size() < 3) return resultado;
+
+    // posições normalizadas na AABB: melhora a precisão das quádricas em float
+    // e deixa o erro relativo ao tamanho da mesh
+    glm::vec3 minimo = vertices[0].posicao, maximo = vertices[0].posicao;
+    for (const Vertice& v : vertices) {
+        minimo = glm::min(minimo, v.posicao);
+        maximo = glm::max(maximo, v.posicao);
+    }
+    glm::vec3 extensao = maximo - minimo;
+    float escala = std::max(extensao.x, std::max(extensao.y, extensao.z));
+    float inversoEscala = escala > 0.0f ? 1.0f / escala : 0.0f;
+
+    std::vector<glm::vec3> posicoes(numVertices);
+    paraleloEmBlocos(numVertices, 1 << 16, [&](size_t inicio, size_t fim) {
+        for (size_t v = inicio; v < fim; v++)
+            posicoes[v] = (vertices[v].posicao - minimo) * inversoEscala;
+    });
+
+    Adjacencia adjacencia;
+    adjacencia.construir(indices, numVertices);
+
+    // 1. quádricas, em paralelo por vértice (cada thread só escreve nos seus vértices)
+    std::vector<Quadrica> quadricas(numVertices);
+    paraleloEmBlocos(numVertices, 1 << 15, [&](size_t inicio, size_t fim) {
+        for (size_t v = inicio; v < fim; v++) {
+            Quadrica q;
+            std::memset(&q, 0, sizeof(q));
+            for (uint32_t a = adjacencia.inicio[v]; a < adjacencia.inicio[v + 1]; a++) {
+                const GLuint* t = &indices[adjacencia.triangulos[a] * 3];
+                q.somar(quadricaPlano(posicoes[t[0]], posicoes[t[1]], posicoes[t[2]]));
+            }
+            quadricas[v] = q;
+        }
+    });
+
+    const float limiteErro = parametros.erroMaximo * parametros.erroMaximo;
+    const size_t alvo = parametros.triangulosAlvo;
+
+    std::vector<uint8_t> travado(numVertices);
+    std::vector<uint8_t> tocado(numVertices);
+    std::vector<uint32_t> remapa(numVertices);
+    std::vector<Colapso> colapsos;
+
+    auto custoColapso = [&](uint32_t origem, uint32_t destino) {
+        Quadrica q = quadricas[origem];
+        q.somar(quadricas[destino]);
+        glm::vec3 dn = vertices[origem].normal - vertices[destino].normal;
+        glm::vec2 duv = vertices[origem].coordTextura - vertices[destino].coordTextura;
+        return q.erro(posicoes[destino])
+             + parametros.pesoNormal * glm::dot(dn, dn)
+             + parametros.pesoUV * glm::dot(duv, duv);
+    };
+
+    // mover origem para destino não pode inverter, dobrar nem degenerar nenhum triângulo que sobra
+    auto colapsoValido = [&](uint32_t origem, uint32_t destino) {
+        for (uint32_t a = adjacencia.inicio[origem]; a < adjacencia.inicio[origem + 1]; a++) {
+            const GLuint* t = &indices[adjacencia.triangulos[a] * 3];
+            if (t[0] == destino || t[1] == destino || t[2] == destino) continue;
+
+            int k = t[0] == origem ? 0 : (t[1] == origem ? 1 : 2);
+            const glm::vec3& b = posicoes[t[(k + 1) % 3]];
+            const glm::vec3& c = posicoes[t[(k + 2) % 3]];
+            glm::vec3 antes  = glm::cross(b - posicoes[origem], c - posicoes[origem]);
+            glm::vec3 depois = glm::cross(b - posicoes[destino], c - posicoes[destino]);
+            // mais de ~75° de rotação conta como dobra
+            if (glm::dot(antes, depois) <= 0.25f * glm::length(antes) * glm::length(depois)) return false;
+        }
+        return true;
+    };
+
+    while (indices.size() / 3 > alvo) {
+        const size_t numTriangulos = indices.size() / 3;
+
+        // bordas: aresta (v, w) que aparece em um só triângulo em volta de v
+        paraleloEmBlocos(numVertices, 1 << 15, [&](size_t inicio, size_t fim) {
+            std::vector<std::pair<GLuint, int>> vizinhos;
+            for (size_t v = inicio; v < fim; v++) {
+                travado[v] = 0;
+                if (!parametros.travarBordas) continue;
+
+                vizinhos.clear();
+                for (uint32_t a = adjacencia.inicio[v]; a < adjacencia.inicio[v + 1]; a++) {
+                    const GLuint* t = &indices[adjacencia.triangulos[a] * 3];
+                    for (int c = 0; c < 3; c++) {
+                        if (t[c] == v) continue;
+                        auto it = std::find_if(vizinhos.begin(), vizinhos.end(),
+                                               [&](const std::pair<GLuint, int>& p) { return p.first == t[c]; });
+                        if (it == vizinhos.end()) vizinhos.push_back({t[c], 1});
+                        else it->second++;
+                    }
+                }
+                for (const auto& p : vizinhos)
+                    if (p.second == 1) { travado[v] = 1; break; }
+            }
+        });
+
+        // 2. candidatos: arestas internas aparecem em dois triângulos, uma vez como (a<b);
+        // arestas só com a>b são de borda, e aí os dois lados estão travados
+        colapsos.resize(numTriangulos * 3);
+        paraleloEmBlocos(numTriangulos, 1 << 14, [&](size_t inicio, size_t fim) {
+            for (size_t t = inicio; t < fim; t++) {
+                for (int c = 0; c < 3; c++) {
+                    uint32_t a = indices[t * 3 + c];
+                    uint32_t b = indices[t * 3 + (c + 1) % 3];
+                    Colapso& colapso = colapsos[t * 3 + c];
+                    colapso.custo = -1.0f;
+                    if (a >= b) continue;
+
+                    float custoAB = travado[a] ? -1.0f : custoColapso(a, b);
+                    float custoBA = travado[b] ? -1.0f : custoColapso(b, a);
+                    if (custoAB >= 0.0f && (custoBA < 0.0f || custoAB <= custoBA))
+                        colapso = {a, b, custoAB};
+                    else if (custoBA >= 0.0f)
+                        colapso = {b, a, custoBA};
+                }
+            }
+        });
+        colapsos.erase(std::remove_if(colapsos.begin(), colapsos.end(),
+                                      [&](const Colapso& c) { return c.custo < 0.0f || c.custo > limiteErro; }),
+                       colapsos.end());
+        if (colapsos.empty()) break;
+
+        ordenarColapsos(colapsos);
+
+        // 3. colapsos independentes, do mais barato para o mais caro
+        std::fill(tocado.begin(), tocado.end(), 0);
+        for (size_t v = 0; v < numVertices; v++) remapa[v] = (uint32_t)v;
+
+        size_t removidos = 0;
+        size_t orcamento = numTriangulos - alvo;
+        size_t aceitos = 0;
+
+        for (const Colapso& c : colapsos) {
+            if (removidos >= orcamento) break;
+            if (tocado[c.origem] || tocado[c.destino]) continue;
+            if (!colapsoValido(c.origem, c.destino)) continue;
+
+            remapa[c.origem] = c.destino;
+            quadricas[c.destino].somar(quadricas[c.origem]);
+            resultado.erro = std::max(resultado.erro, c.custo);
+            aceitos++;
+
+            // a vizinhança da origem muda: nada nela pode colapsar de novo neste passe
+            for (uint32_t a = adjacencia.inicio[c.origem]; a < adjacencia.inicio[c.origem + 1]; a++) {
+                const GLuint* t = &indices[adjacencia.triangulos[a] * 3];
+                if (t[0] == c.destino || t[1] == c.destino || t[2] == c.destino) removidos++;
+                tocado[t[0]] = tocado[t[1]] = tocado[t[2]] = 1;
+            }
+        }
+        if (aceitos == 0) break;
+        resultado.passes++;
+
+        // 4. aplica o remapeamento e descarta os triângulos degenerados
+        size_t escrita = 0;
+        for (size_t t = 0; t < numTriangulos; t++) {
+            GLuint a = remapa[indices[t * 3 + 0]];
+            GLuint b = remapa[indices[t * 3 + 1]];
+            GLuint c = remapa[indices[t * 3 + 2]];
+            if (a == b || b == c || a == c) continue;
+            indices[escrita++] = a;
+            indices[escrita++] = b;
+            indices[escrita++] = c;
+        }
+        indices.resize(escrita);
+
+        adjacencia.construir(indices, numVertices);
+    }
+
+    // compacta: só os vértices ainda referenciados, na ordem de uso
+    otimizarBuscaVertices(vertices, indices);
+    GLuint usados = 0;
+    for (GLuint v : indices) usados = std::max(usados, v + 1);
+    vertices.resize(usados);
+    vertices.shrink_to_fit();
+    indices.shrink_to_fit();
+
+    resultado.triangulosDepois = indices.size() / 3;
+    resultado.erro = std::sqrt(resultado.erro);
+    return resultado;
+}
+
+// Nova Mesh simplificada; a original não muda. Faixas e leques viram lista
+// antes (os marcadores de reinício não são vértices), então o resultado é
+// sempre GL_TRIANGLES.
+inline Mesh simplificarMesh(const Mesh& origem, const ParametrosSimplificacao& parametros,
+                            ResultadoSimplificacao* resultado = nullptr) {
+    std::vector<Vertice> vertices = origem.vertices;
+    std::vector<GLuint> indices = paraListaTriangulos(origem.indices, origem.primitiva);
+
+    ResultadoSimplificacao r = simplificar(vertices, indices, parametros);
+    if (resultado) *resultado = r;
+
+    return Mesh(std::move(vertices), std::move(indices), origem.formato);
+}
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef TRANSFORMACOES_H
+#define TRANSFORMACOES_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRANSFORMACOES_SSE2 1
+#endif
+
+#include "Paralelo.h"
+
+// Matrizes normais (transpose(inverse(mat3(modelo)))) calculadas na CPU, em
+// lote, para que os vertex shaders não invertam uma matriz por vértice. Cada
+// matriz sai como três vec4 (colunas, w = 0): o layout de uma mat3 em std430
+// e o de três atributos vec4 seguidos.
+//
+// Com as colunas a, b, c de mat3(modelo), a inversa transposta tem colunas
+// (b x c, c x a, a x b) / det, com det = a . (b x c). Se o modelo é rotação
+// com escala uniforme s (mais translação, que não entra), a inversa
+// transposta é o próprio mat3(modelo) / s², e s² = |a|²: sem produto
+// vetorial nem determinante.
+namespace transformacoes {
+
+const size_t MINIMO_POR_THREAD = 16384;
+
+namespace detalhe {
+
+inline const float* coluna(const glm::mat4* modelos, size_t passo, size_t i, int c) {
+    return &(*(const glm::mat4*)((const char*)modelos + i * passo))[c][0];
+}
+
+inline glm::vec4* saida(glm::vec4* normais, size_t passo, size_t i) {
+    return (glm::vec4*)((char*)normais + i * passo);
+}
+
+inline void calcularUma(const glm::mat4& m, glm::vec4* n, bool escalaUniforme) {
+    glm::vec3 a(m[0]), b(m[1]), c(m[2]);
+    if (escalaUniforme) {
+        float k = 1.0f / glm::dot(a, a);
+        n[0] = glm::vec4(a * k, 0.0f);
+        n[1] = glm::vec4(b * k, 0.0f);
+        n[2] = glm::vec4(c * k, 0.0f);
+        return;
+    }
+    glm::vec3 bc = glm::cross(b, c), ca = glm::cross(c, a), ab = glm::cross(a, b);
+    float k = 1.0f / glm::dot(a, bc);
+    n[0] = glm::vec4(bc * k, 0.0f);
+    n[1] = glm::vec4(ca * k, 0.0f);
+    n[2] = glm::vec4(ab * k, 0.0f);
+}
+
+inline void calcularFaixa(const glm::mat4* modelos, size_t passoModelo, glm::vec4* normais, size_t passoNormal,
+                          size_t inicio, size_t fim, bool escalaUniforme) {
+    size_t i = inicio;
+
+#if defined(TRANSFORMACOES_SSE2)
+    // Quatro objetos por vez: as colunas de cada um são lidas inteiras e
+    // transpostas para SoA (um registrador por componente), e a saída volta
+    // para AoS do mesmo jeito.
+    for (; i + 4 <= fim; i += 4) {
+        __m128 x[3], y[3], z[3];
+        for (int c = 0; c < 3; c++) {
+            __m128 c0 = _mm_loadu_ps(coluna(modelos, passoModelo, i, c));
+            __m128 c1 = _mm_loadu_ps(coluna(modelos, passoModelo, i + 1, c));
+            __m128 c2 = _mm_loadu_ps(coluna(modelos, passoModelo, i + 2, c));
+            __m128 c3 = _mm_loadu_ps(coluna(modelos, passoModelo, i + 3, c));
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            x[c] = c0;
+            y[c] = c1;
+            z[c] = c2;
+        }
+
+        __m128 nx[3], ny[3], nz[3];
+        if (escalaUniforme) {
+            __m128 s2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x[0], x[0]), _mm_mul_ps(y[0], y[0])),
+                                   _mm_mul_ps(z[0], z[0]));
+            __m128 k = _mm_div_ps(_mm_set1_ps(1.0f), s2);
+            for (int c = 0; c < 3; c++) {
+                nx[c] = _mm_mul_ps(x[c], k);
+                ny[c] = _mm_mul_ps(y[c], k);
+                nz[c] = _mm_mul_ps(z[c], k);
+            }
+        } else {
+            // coluna j da saída = coluna (j+1) x coluna (j+2)
+            for (int j = 0; j < 3; j++) {
+                int p = (j + 1) % 3, q = (j + 2) % 3;
+                nx[j] = _mm_sub_ps(_mm_mul_ps(y[p], z[q]), _mm_mul_ps(z[p], y[q]));
+                ny[j] = _mm_sub_ps(_mm_mul_ps(z[p], x[q]), _mm_mul_ps(x[p], z[q]));
+                nz[j] = _mm_sub_ps(_mm_mul_ps(x[p], y[q]), _mm_mul_ps(y[p], x[q]));
+            }
+            __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x[0], nx[0]), _mm_mul_ps(y[0], ny[0])),
+                                    _mm_mul_ps(z[0], nz[0]));
+            __m128 k = _mm_div_ps(_mm_set1_ps(1.0f), det);
+            for (int j = 0; j < 3; j++) {
+                nx[j] = _mm_mul_ps(nx[j], k);
+                ny[j] = _mm_mul_ps(ny[j], k);
+                nz[j] = _mm_mul_ps(nz[j], k);
+            }
+        }
+
+        for (int j = 0; j < 3; j++) {
+            __m128 o0 = nx[j], o1 = ny[j], o2 = nz[j], o3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(o0, o1, o2, o3);
+            _mm_storeu_ps(&saida(normais, passoNormal, i)[j][0], o0);
+            _mm_storeu_ps(&saida(normais, passoNormal, i + 1)[j][0], o1);
+            _mm_storeu_ps(&saida(normais, passoNormal, i + 2)[j][0], o2);
+            _mm_storeu_ps(&saida(normais, passoNormal, i + 3)[j][0], o3);
+        }
+    }
+#endif
+
+    // resto (ou tudo, sem SSE2)
+    for (; i < fim; i++)
+        calcularUma(*(const glm::mat4*)((const char*)modelos + i * passoModelo), saida(normais, passoNormal, i),
+                    escalaUniforme);
+}
+
+}
+
+// n matrizes normais de modelos com passo em bytes (sizeof(glm::mat4) para
+// um vetor de matrizes, ou o tamanho de uma struct que contém a matriz);
+// cada saída ocupa três vec4 a partir de normais + i * passoNormal bytes.
+// escalaUniforme promete que todos os modelos são rotação com escala
+// uniforme; um modelo com cisalhamento ou escala desigual sai errado.
+inline void calcularNormais(const glm::mat4* modelos, size_t passoModelo, glm::vec4* normais, size_t passoNormal,
+                            size_t n, bool escalaUniforme) {
+    paraleloEmBlocos(n, MINIMO_POR_THREAD, [&](size_t inicio, size_t fim) {
+        detalhe::calcularFaixa(modelos, passoModelo, normais, passoNormal, inicio, fim, escalaUniforme);
+    });
+}
+
+// vetor de matrizes para um vetor com três vec4 por matriz
+inline void calcularNormais(const glm::mat4* modelos, size_t n, glm::vec4* normais, bool escalaUniforme) {
+    calcularNormais(modelos, sizeof(glm::mat4), normais, 3 * sizeof(glm::vec4), n, escalaUniforme);
+}
+
+}
+
+#endif
@@ -6,11 +6,24 @@
 
 #include <iostream>
 #include <vector>
+#include <memory>
 
 #include "Shader.h"
 #include "Camera.h"
 #include "Mesh.h"
 #include "Light.h"
+#include "BlocosUniform.h"
+#include "LOD.h"
+#include "CarregadorOBJ.h"
+#include "CacheMesh.h"
+#include "CarregadorGLB.h"
+#include "DesenhoIndireto.h"
+#include "FilaRenderizacao.h"
+#include "Frustum.h"
+#include "BVH.h"
+#include "OclusaoSoftware.h"
+#include "DescarteGPU.h"
+#include "PermutacoesShader.h"
 
 // callbacks
 void callbackRedimensionamento(GLFWwindow* janela, int largura, int altura);
@@ -33,7 +46,54 @@ bool modoWireframe = false;
 bool iluminacaoAtivada = true;
 float rotacaoObjetos = 0.0f;
 
-int main() {
+// cena de teste de submissão: N alterna a quantidade de esferas, I o modo de desenho
+const size_t QUANTIDADES_ESFERAS[] = {4, 1000, 10000, 100000, 1000000};
+size_t indiceQuantidadeEsferas = 0;
+
+enum class ModoDesenho {
+    PorObjeto,        // um desenho por objeto, pela FilaRenderizacao
+    Instanciado,      // esferas agrupadas por nível de LOD
+    Indireto,         // cena inteira por ListaDesenhoIndireto (multi-draw se houver 4.3)
+    IndiretoEmLaco,   // mesma lista, forçando o caminho 3.3
+    DescarteGPU       // esferas descartadas e com LOD escolhido na GPU (4.3)
+};
+const char* NOMES_MODO_DESENHO[] = {"um desenho por objeto", "instanciado", "indireto", "indireto em laco (3.3)",
+                                    "descarte na GPU (4.3)"};
+ModoDesenho modoDesenho = ModoDesenho::Instanciado;
+// C alterna o descarte das esferas: nenhum, teste linear em lote (SIMD) ou pela BVH
+enum class ModoDescarte {
+    Desligado,
+    Linear,
+    BVH
+};
+const char* NOMES_MODO_DESCARTE[] = {"desligado", "linear (SIMD)", "BVH"};
+ModoDescarte modoDescarte = ModoDescarte::Linear;
+bool pedidoSelecao = false;   // P: seleciona a esfera no centro da tela (modo BVH)
+// O: esferas escondidas atrás do cubo, do modelo ou de outras esferas não são desenhadas
+bool oclusaoAtivada = false;
+const size_t MAXIMO_ESFERAS_OCLUSORAS = 64;
+
+// posição de cada esfera em anéis concêntricos; o primeiro anel é o das 4 originais
+struct OrbitaEsfera {
+    float raio;
+    float anguloBase;
+};
+
+std::vector<OrbitaEsfera> calcularOrbitas(size_t quantidade) {
+    std::vector<OrbitaEsfera> orbitas;
+    orbitas.reserve(quantidade);
+    for (int anel = 0; orbitas.size() < quantidade; anel++) {
+        float raio = 3.5f + 2.0f * anel;
+        // uma esfera a cada 2 unidades de arco
+        size_t porAnel = anel == 0 ? 4 : (size_t)(M_PI * raio);
+        porAnel = std::min(porAnel, quantidade - orbitas.size());
+        for (size_t j = 0; j < porAnel; j++)
+            orbitas.push_back({raio, 360.0f * j / porAnel});
+    }
+    return orbitas;
+}
+
+int main(int argc, char* argv[]) {
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -61,17 +121,125 @@ int main() {
         std::cout << "ERRO: Falha ao inicializar GLAD" << std::endl;
         return -1;
     }
+    ExtensoesGL::carregar((GLADloadproc)glfwGetProcAddress);
+    std::cout << "OpenGL " << ExtensoesGL::versaoMaior << "." << ExtensoesGL::versaoMenor
+              << (ExtensoesGL::temMultiDrawIndireto() ? " (multi-draw indireto disponivel)" : "") << std::endl;
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_MULTISAMPLE);
 
-    Shader shaderIluminacao("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl");
-    Shader shaderLuz("shaders/vertexShader.glsl", "shaders/fragmentShader.glsl");
+    // geometria estática subalocada em poucos buffers (um VAO por formato);
+    // declarada antes das meshes para ser destruída depois delas
+    ArenaGeometria arena;
+    Mesh::arenaAtiva = &arena;
 
     Cubo cubo(1.0f);
-    Esfera esfera(0.8f, 36, 18);
+    // esferas com 3 níveis de detalhe; limiares em pixels de altura na tela
+    GrupoLOD lodEsfera = GrupoLOD::esfera(0.8f, {
+        {36, 18, 120.0f},
+        {18,  9,  40.0f},
+        { 8,  4,   0.0f}
+    });
+    std::vector<int> nivelEsferas;
+    std::vector<OrbitaEsfera> orbitas;
+
+    // um buffer de instâncias por nível de LOD, reenviado a cada quadro
+    std::vector<BufferInstancias> instanciasEsferas(lodEsfera.niveis.size());
+    std::vector<std::vector<glm::mat4>> modelosPorNivel(lodEsfera.niveis.size());
+    std::vector<std::vector<GLuint>> materiaisPorNivel(lodEsfera.niveis.size());
+    BufferInstancias instanciasLuzes;
+    // esferas e cubos de luz só giram, andam e mudam de tamanho por igual
+    for (BufferInstancias& instancias : instanciasEsferas) instancias.escalaUniforme = true;
+    instanciasLuzes.escalaUniforme = true;
+    std::vector<glm::mat4> modelosLuzes;
+    std::vector<GLuint> coresLuzes;
+    ListaDesenhoIndireto cenaIndireta;
+    FilaRenderizacao fila;
+    DescarteFrustum descarteEsferas;
+    // BVH das esferas no referencial da órbita: o giro comum vai para o
+    // frustum e só a oscilação vertical precisa de reajuste a cada quadro
+    BVHCena bvhEsferas;
+    std::vector<CaixaBVH> caixasEsferas;
+    std::vector<uint32_t> visiveisBVH, vizinhasSelecao, esferasAlteradas;
+    bool bvhConstruida = false;
+    std::vector<glm::mat4> modelosEsferas;
+    // oclusão na CPU, depois do frustum: buffer de 320x180 e as caixas das esferas que sobraram
+    OclusaoSoftware oclusao(320, 180);
+    std::vector<glm::vec3> minimosOclusao, maximosOclusao;
+    std::vector<uint8_t> naoOcultas;
+    std::vector<uint32_t> esferasNaoOcultas;
+    // descarte na GPU: todas as matrizes vão para entradaGPU e o resto fica com os compute shaders
+    DescarteGPU descarteGPU;
+    BufferInstancias entradaGPU;
+    entradaGPU.escalaUniforme = true;
+    std::vector<GLuint> materiaisEsferas;
+    if (ExtensoesGL::temComputacao()) descarteGPU.iniciar();
+
+    // tempo de CPU da cena (e só da submissão, no modo indireto), acumulado até o próximo relatório
+    double tempoCPU = 0.0, tempoEnvio = 0.0, tempoDescarte = 0.0, tempoReajuste = 0.0, tempoOclusao = 0.0;
+    double inicioRelatorio = 0.0;
+    int quadrosRelatorio = 0;
     Plano plano(20.0f, 20.0f, 20, 20);
 
+    // modelo opcional: ./SistemaVisualizacaoGrafica arquivo.obj (ou .glb)
+    // a primeira execução lê o OBJ e grava arquivo.obj.cache; as seguintes só mapeiam o cache
+    Mesh modelo3D;
+    ModeloGLB cenaGLB;
+    glm::vec3 minimoModelo(0.0f), maximoModelo(0.0f);
+    std::string caminhoModelo = argc > 1 ? argv[1] : "";
+    bool ehGLB = caminhoModelo.size() > 4 && caminhoModelo.compare(caminhoModelo.size() - 4, 4, ".glb") == 0;
+
+    if (ehGLB) {
+        if (cenaGLB.carregar(caminhoModelo)) {
+            const EstatisticasGLB& e = cenaGLB.estatisticas;
+            std::cout << "GLB: " << cenaGLB.meshes.size() << " primitivas (" << e.primitivasDiretas
+                      << " direto do arquivo), " << cenaGLB.instancias.size() << " instancias em " << e.segundos
+                      << " s; GPU " << e.proporcaoEnviada() * 100.0 << "% do arquivo, pico "
+                      << (e.picoMemoria >> 20) << " MB" << std::endl;
+            minimoModelo = cenaGLB.limiteMin;
+            maximoModelo = cenaGLB.limiteMax;
+        }
+    } else if (argc > 1) {
+        std::string caminhoCache = std::string(argv[1]) + ".cache";
+        ParametrosCacheMesh parametrosModelo;   // float, otimizado, sem LOD
+        OrigemCache origem = OrigemCache::arquivo(argv[1], parametrosModelo);
+        EstatisticasCacheMesh estatisticasCache;
+
+        if (carregarCacheMesh(caminhoCache, origem, modelo3D, &estatisticasCache)) {
+            std::cout << "Cache: " << modelo3D.numIndices / 3 << " triangulos em " << estatisticasCache.segundos
+                      << " s (" << (estatisticasCache.bytes >> 20) << " MB)" << std::endl;
+        } else {
+            MeshOBJ obj(argv[1], parametrosModelo.formato, parametrosModelo.otimizar);
+            if (obj.carregado()) {
+                const EstatisticasOBJ& e = obj.estatisticas;
+                std::cout << "OBJ: " << e.triangulos << " triangulos, " << e.vertices << " vertices em "
+                          << e.segundos << " s (" << e.mbPorSegundo() << " MB/s, " << e.threads
+                          << " threads, pico " << (e.picoMemoria >> 20) << " MB)" << std::endl;
+                std::cout << "Cache de vertices: ACMR " << e.cacheAntes.acmr << " -> " << e.cacheDepois.acmr
+                          << ", ATVR " << e.cacheAntes.atvr << " -> " << e.cacheDepois.atvr << std::endl;
+                salvarCacheMesh(caminhoCache, origem, obj);
+                modelo3D = std::move(obj);
+            }
+        }
+        minimoModelo = modelo3D.limiteMin;
+        maximoModelo = modelo3D.limiteMax;
+    }
+
+    // cabe num cubo de 2 unidades, centrado acima do chão
+    glm::vec3 extensaoModelo = maximoModelo - minimoModelo;
+    float maiorExtensao = std::max(extensaoModelo.x, std::max(extensaoModelo.y, extensaoModelo.z));
+    float escalaModelo = maiorExtensao > 0.0f ? 2.0f / maiorExtensao : 1.0f;
+    glm::vec3 centroModelo = (minimoModelo + maximoModelo) * 0.5f;
+
+    std::cout << "Indices na GPU: " << Mesh::estatisticasIndices.bytesEnviados << " bytes ("
+              << Mesh::estatisticasIndices.bytesEconomizados() << " economizados com indices de 8/16 bits)" << std::endl;
+    EstatisticasArena estatisticasArena = arena.estatisticas();
+    std::cout << "Arena: " << estatisticasArena.blocosVivos << " meshes em " << estatisticasArena.pools
+              << " VAO(s), vertices " << (estatisticasArena.bytesVerticesUsados >> 10) << "/"
+              << (estatisticasArena.bytesVerticesCapacidade >> 10) << " KB, indices "
+              << (estatisticasArena.bytesIndicesUsados >> 10) << "/"
+              << (estatisticasArena.bytesIndicesCapacidade >> 10) << " KB" << std::endl;
+
     LuzDirecional luzDirecional(
         glm::vec3(-0.2f, -1.0f, -0.3f),
         glm::vec3(0.1f, 0.1f, 0.15f),
@@ -126,6 +294,122 @@ int main() {
         16.0f
     );
 
+    // índices usados pelos shaders instanciados (uniform materiais[])
+    const Material* materiaisCena[3] = {&materialPadrao, &materialMetalico, &materialPlastico};
+    const GLuint MATERIAL_PADRAO = 0, MATERIAL_METALICO = 1, MATERIAL_PLASTICO = 2;
+
+    // atualizadas no começo de cada quadro
+    glm::mat4 projecao(1.0f), visao(1.0f);
+
+    // câmera, luzes e a tabela de materiais ficam em blocos de uniforms
+    // divididos por todos os programas (BlocosUniform.h)
+    BufferUniform<BlocoCamera> uboCamera;
+    BufferUniform<BlocoLuzes> uboLuzes;
+    BufferUniform<BlocoMateriais> uboMateriais;
+    uboCamera.iniciar(PONTO_BLOCO_CAMERA);
+    uboLuzes.iniciar(PONTO_BLOCO_LUZES);
+    uboMateriais.iniciar(PONTO_BLOCO_MATERIAIS);
+
+    // os materiais não mudam: um envio só
+    BlocoMateriais dadosMateriais = {};
+    for (size_t m = 0; m < 3; m++) dadosMateriais.materiais[m] = MaterialStd140(*materiaisCena[m]);
+    uboMateriais.enviar(dadosMateriais);
+
+    // as luzes também não: ligar e desligar a iluminação troca de variante
+    // de shader em vez de zerar o bloco
+    BlocoCamera dadosCamera = {};
+    BlocoLuzes dadosLuzes = {};
+    size_t numLuzesBloco = std::min(luzesPontuais.size(), (size_t)MAXIMO_LUZES_PONTUAIS);
+    for (size_t i = 0; i < numLuzesBloco; i++) dadosLuzes.luzesPontuais[i] = LuzPontualStd140(luzesPontuais[i]);
+    dadosLuzes.luzDirecional = LuzDirecionalStd140(luzDirecional);
+    dadosLuzes.numLuzesPontuais = (GLint)numLuzesBloco;
+    uboLuzes.enviar(dadosLuzes);
+
+    // materiais das luzes para o fragmentShader: só a difusa vira a cor
+    std::vector<Material> materiaisLuzes;
+    for (const LuzPontual& luz : luzesPontuais)
+        materiaisLuzes.push_back(Material(luz.ambiente, luz.difusa, luz.especular, 1.0f));
+
+    // Variantes de shader por permutação (PermutacoesShader.h). Toda variante
+    // vincula os blocos; as de desenho por objeto entram na fila com os
+    // uniforms de material dela (câmera e luzes vêm dos blocos), e as
+    // instanciadas dos cubos de luz recebem as cores uma vez só.
+    PermutacoesShader shadersIluminacao("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+        RECURSO_ILUMINACAO | RECURSO_VERTICE_COMPACTO | RECURSO_INSTANCIADO, 0,
+        [&](const Shader& shader, uint32_t chave) -> uint32_t {
+            blocos::vincular(shader);
+            if (chave & RECURSO_INSTANCIADO) return 0;
+            UniformsMaterial material(shader, "material");
+            return fila.registrarShader(shader, nullptr,
+                [material](const Shader&, const Material& m) { material.definir(m); });
+        });
+    PermutacoesShader shadersLuz("shaders/vertexShader.glsl", "shaders/fragmentShader.glsl",
+        RECURSO_VERTICE_COMPACTO | RECURSO_INSTANCIADO, 0,
+        [&](const Shader& shader, uint32_t chave) -> uint32_t {
+            blocos::vincular(shader);
+            if (chave & RECURSO_INSTANCIADO) {
+                shader.usar();
+                for (size_t i = 0; i < luzesPontuais.size(); i++)
+                    shader.uniform<glm::vec4>("cores[" + std::to_string(i) + "]")
+                        .definir(glm::vec4(luzesPontuais[i].difusa, 1.0f));
+                return 0;
+            }
+            Uniform<glm::vec4> cor = shader.uniform<glm::vec4>("cor");
+            return fila.registrarShader(shader, nullptr,
+                [cor](const Shader&, const Material& m) { cor.definir(glm::vec4(m.difusa, 1.0f)); }, 1);
+        });
+    // descarte na GPU: sempre instanciado
+    std::unique_ptr<PermutacoesShader> shadersIluminacaoGPU;
+    if (descarteGPU.pronto())
+        shadersIluminacaoGPU.reset(new PermutacoesShader("shaders/lightingVertDescarteGPU.glsl",
+            "shaders/lightingFrag.glsl", RECURSO_ILUMINACAO | RECURSO_VERTICE_COMPACTO, RECURSO_INSTANCIADO,
+            [](const Shader& shader, uint32_t) -> uint32_t {
+                blocos::vincular(shader);
+                return 0;
+            }));
+
+    // chave para o estado atual: tecla L e o formato dos vértices da mesh
+    auto chaveIluminacao = [&](const Mesh& mesh, uint32_t recursos) {
+        if (iluminacaoAtivada) recursos |= RECURSO_ILUMINACAO;
+        if (!mesh.quantizacao.identidade()) recursos |= RECURSO_VERTICE_COMPACTO;
+        return chavePermutacao(recursos, numLuzesBloco);
+    };
+    auto filaPara = [&](const Mesh& mesh) { return shadersIluminacao.identificador(chaveIluminacao(mesh, 0)); };
+
+    // Ligada e desligada, por objeto e instanciada, para a tecla L não
+    // compilar no meio da cena; vértices compactos (modelo do cache) ficam
+    // para o primeiro uso.
+    for (uint32_t iluminacao : {RECURSO_ILUMINACAO, 0u}) {
+        for (uint32_t instanciado : {0u, RECURSO_INSTANCIADO})
+            shadersIluminacao.preparar(chavePermutacao(iluminacao | instanciado, numLuzesBloco));
+        if (shadersIluminacaoGPU) shadersIluminacaoGPU->preparar(chavePermutacao(iluminacao, numLuzesBloco));
+    }
+    const uint32_t recursosCubo = cubo.quantizacao.identidade() ? 0 : RECURSO_VERTICE_COMPACTO;
+    uint32_t filaLuz = shadersLuz.identificador(chavePermutacao(recursosCubo, 0));
+    shadersLuz.preparar(chavePermutacao(recursosCubo | RECURSO_INSTANCIADO, 0));
+
+    // partida fria (sem shaders/cache) contra quente: só muda a origem dos programas
+    {
+        const EstatisticasCacheProgramas& e = Shader::estatisticasCache;
+        std::cout << "Shaders: " << e.carregados + e.compilados << " programas em " << e.segundos * 1000.0
+                  << " ms (" << e.carregados << " do cache, " << e.compilados << " compilados";
+        if (e.recusados > 0) std::cout << ", " << e.recusados << " recusados pelo driver";
+        if (!ExtensoesGL::temBinarioPrograma()) std::cout << "; driver sem binario de programa";
+        std::cout << ")" << std::endl;
+    }
+
+    PermutacoesShader* tabelasShader[] = {&shadersIluminacao, &shadersLuz, shadersIluminacaoGPU.get()};
+    size_t variantesRelatadas[3] = {};
+    std::cout << "Permutacoes:";
+    for (int t = 0; t < 3; t++) {
+        if (!tabelasShader[t]) continue;
+        const EstatisticasPermutacoes& p = tabelasShader[t]->estatisticas;
+        std::cout << " " << tabelasShader[t]->nome() << " " << p.compiladas << " de " << p.possiveis << " ("
+                  << p.segundos * 1000.0 << " ms)";
+        variantesRelatadas[t] = p.compiladas;
+    }
+    std::cout << std::endl;
+
     std::cout << "\n=== CONTROLES ===" << std::endl;
     std::cout << "WASD: Mover camera" << std::endl;
     std::cout << "Espaco/Shift: Subir/Descer" << std::endl;
@@ -133,6 +417,12 @@ int main() {
     std::cout << "Scroll: Zoom" << std::endl;
     std::cout << "L: Alternar iluminacao" << std::endl;
     std::cout << "F: Alternar wireframe" << std::endl;
+    std::cout << "N: Quantidade de esferas (4 a 1M)" << std::endl;
+    std::cout << "I: Modo de desenho (por objeto / instanciado / indireto / indireto 3.3 / descarte na GPU)"
+              << std::endl;
+    std::cout << "C: Descarte das esferas (desligado / linear / BVH)" << std::endl;
+    std::cout << "P: Selecionar a esfera no centro da tela (descarte por BVH)" << std::endl;
+    std::cout << "O: Descarte das esferas por oclusao (CPU)" << std::endl;
     std::cout << "ESC: Sair\n" << std::endl;
 
     while (!glfwWindowShouldClose(janela)) {
@@ -147,94 +437,354 @@ int main() {
 
         rotacaoObjetos += 20.0f * deltaTime;
 
-        shaderIluminacao.usar();
-
-        glm::mat4 projecao = glm::perspective(glm::radians(camera.zoom),
+        projecao = glm::perspective(glm::radians(camera.zoom),
             (float)LARGURA_JANELA / (float)ALTURA_JANELA, 0.1f, 100.0f);
-        glm::mat4 visao = camera.obterMatrizView();
-
-        shaderIluminacao.definirMat4("projecao", projecao);
-        shaderIluminacao.definirMat4("visao", visao);
-        shaderIluminacao.definirVec3("posicaoObservador", camera.posicao);
-
-        if (iluminacaoAtivada) {
-            shaderIluminacao.definirVec3("luzDirecional.direcao", luzDirecional.direcao);
-            shaderIluminacao.definirVec3("luzDirecional.ambiente", luzDirecional.ambiente);
-            shaderIluminacao.definirVec3("luzDirecional.difusa", luzDirecional.difusa);
-            shaderIluminacao.definirVec3("luzDirecional.especular", luzDirecional.especular);
-
-            // luzes pontuais
-            for (size_t i = 0; i < luzesPontuais.size(); i++) {
-                std::string base = "luzesPontuais[" + std::to_string(i) + "]";
-                shaderIluminacao.definirVec3(base + ".posicao", luzesPontuais[i].posicao);
-                shaderIluminacao.definirVec3(base + ".ambiente", luzesPontuais[i].ambiente);
-                shaderIluminacao.definirVec3(base + ".difusa", luzesPontuais[i].difusa);
-                shaderIluminacao.definirVec3(base + ".especular", luzesPontuais[i].especular);
-                shaderIluminacao.definirFloat(base + ".constante", luzesPontuais[i].constante);
-                shaderIluminacao.definirFloat(base + ".linear", luzesPontuais[i].linear);
-                shaderIluminacao.definirFloat(base + ".quadratica", luzesPontuais[i].quadratica);
-            }
-            shaderIluminacao.definirInt("numLuzesPontuais", luzesPontuais.size());
-        } else {
-            shaderIluminacao.definirInt("numLuzesPontuais", 0);
-            shaderIluminacao.definirVec3("luzDirecional.ambiente", glm::vec3(0.3f));
-            shaderIluminacao.definirVec3("luzDirecional.difusa", glm::vec3(0.0f));
-            shaderIluminacao.definirVec3("luzDirecional.especular", glm::vec3(0.0f));
-        }
+        visao = camera.obterMatrizView();
+
+        // um glBufferSubData por bloco, visto por todos os programas do quadro
+        dadosCamera.projecao = projecao;
+        dadosCamera.visao = visao;
+        dadosCamera.posicaoObservador = glm::vec4(camera.posicao, 1.0f);
+        dadosCamera.projecaoVisao = projecao * visao;
+        uboCamera.enviar(dadosCamera);
+        Frustum frustum = Frustum::daMatriz(projecao * visao);
+        auto visivel = [&](const Mesh& mesh, const glm::mat4& m) {
+            return modoDescarte == ModoDescarte::Desligado || frustum.visivel(mesh, m);
+        };
+
+        bool indireto = modoDesenho == ModoDesenho::Indireto || modoDesenho == ModoDesenho::IndiretoEmLaco;
+        bool descarteNaGPU = modoDesenho == ModoDesenho::DescarteGPU && descarteGPU.pronto();
+        if (indireto) cenaIndireta.limpar();
+        fila.iniciar(camera.posicao, camera.direcaoFrente, 100.0f);
+        if (oclusaoAtivada) oclusao.iniciar(projecao * visao);
+        double inicioCPU = glfwGetTime();
 
         // chão
         glm::mat4 modelo = glm::mat4(1.0f);
         modelo = glm::translate(modelo, glm::vec3(0.0f, -1.0f, 0.0f));
-        shaderIluminacao.definirMat4("modelo", modelo);
-        shaderIluminacao.definirVec3("material.ambiente", materialPlastico.ambiente);
-        shaderIluminacao.definirVec3("material.difusa", materialPlastico.difusa);
-        shaderIluminacao.definirVec3("material.especular", materialPlastico.especular);
-        shaderIluminacao.definirFloat("material.brilho", materialPlastico.brilho);
-        plano.desenhar();
+        if (visivel(plano, modelo)) {
+            if (indireto) cenaIndireta.adicionar(plano, modelo, MATERIAL_PLASTICO);
+            else fila.adicionar(filaPara(plano), plano, materialPlastico, modelo);
+        }
 
         // cubo central
         modelo = glm::mat4(1.0f);
         modelo = glm::translate(modelo, glm::vec3(0.0f, 1.0f, 0.0f));
         modelo = glm::rotate(modelo, glm::radians(rotacaoObjetos), glm::vec3(0.0f, 1.0f, 0.0f));
         modelo = glm::rotate(modelo, glm::radians(rotacaoObjetos * 0.5f), glm::vec3(1.0f, 0.0f, 0.0f));
-        shaderIluminacao.definirMat4("modelo", modelo);
-        shaderIluminacao.definirVec3("material.ambiente", materialMetalico.ambiente);
-        shaderIluminacao.definirVec3("material.difusa", materialMetalico.difusa);
-        shaderIluminacao.definirVec3("material.especular", materialMetalico.especular);
-        shaderIluminacao.definirFloat("material.brilho", materialMetalico.brilho);
-        cubo.desenhar();
+        if (visivel(cubo, modelo)) {
+            if (indireto) cenaIndireta.adicionar(cubo, modelo, MATERIAL_METALICO);
+            else fila.adicionar(filaPara(cubo), cubo, materialMetalico, modelo);
+            if (oclusaoAtivada) oclusao.adicionarOclusor(cubo, modelo);
+        }
+
+        if (modelo3D.numIndices > 0 || cenaGLB.carregado()) {
+            modelo = glm::mat4(1.0f);
+            modelo = glm::translate(modelo, glm::vec3(0.0f, 1.0f, -3.0f));
+            modelo = glm::scale(modelo, glm::vec3(escalaModelo));
+            modelo = glm::translate(modelo, -centroModelo);
+            bool modeloVisivel = modoDescarte == ModoDescarte::Desligado ||
+                (cenaGLB.carregado() ? frustum.caixaVisivel(cenaGLB.limiteMin, cenaGLB.limiteMax, modelo)
+                                     : frustum.visivel(modelo3D, modelo));
+            // o glTF e o OBJ lido do cache não têm cópia dos vértices na CPU e ficam de fora
+            if (modeloVisivel && oclusaoAtivada && !cenaGLB.carregado()) oclusao.adicionarOclusor(modelo3D, modelo);
+            if (!modeloVisivel) {
+                // fora do frustum
+            } else if (cenaGLB.carregado()) {
+                // as primitivas do glTF têm layouts próprios e ficam fora da lista indireta
+                cenaGLB.enfileirar(fila, filaPara, modelo, materialPadrao);
+            } else if (indireto) {
+                cenaIndireta.adicionar(modelo3D, modelo, MATERIAL_PADRAO);
+            } else {
+                fila.adicionar(filaPara(modelo3D), modelo3D, materialPadrao, modelo);
+            }
+        }
 
         // esferas orbitando
-        for (int i = 0; i < 4; i++) {
-            float angulo = i * 90.0f + rotacaoObjetos * 0.3f;
-            float raio = 3.5f;
+        size_t numEsferas = QUANTIDADES_ESFERAS[indiceQuantidadeEsferas];
+        if (orbitas.size() != numEsferas) {
+            orbitas = calcularOrbitas(numEsferas);
+            nivelEsferas.assign(numEsferas, -1);
+            bvhConstruida = false;
+            materiaisEsferas.resize(numEsferas);
+            for (size_t i = 0; i < numEsferas; i++) materiaisEsferas[i] = (GLuint)(i % 3);
+        }
+        lodEsfera.estatisticas.zerar();
+        for (size_t n = 0; n < modelosPorNivel.size(); n++) {
+            modelosPorNivel[n].clear();
+            materiaisPorNivel[n].clear();
+        }
+        // no descarte na GPU as esferas não passam pelo da CPU
+        ModoDescarte modoEsferas = descarteNaGPU ? ModoDescarte::Desligado : modoDescarte;
+        // primeiro todas as matrizes e limites, depois o teste em lote, e só as visíveis seguem
+        modelosEsferas.resize(numEsferas);
+        caixasEsferas.resize(numEsferas);
+        esferasAlteradas.clear();
+        descarteEsferas.limpar();
+        const float raioEsfera = lodEsfera.niveis[0].raioEsfera;
+        // o giro é o mesmo em todas: cada modelo é ele com a posição na quarta coluna
+        const glm::mat4 giroEsferas = glm::rotate(glm::mat4(1.0f), glm::radians(rotacaoObjetos),
+                                                  glm::vec3(1.0f, 1.0f, 0.0f));
+        for (size_t i = 0; i < numEsferas; i++) {
+            float angulo = orbitas[i].anguloBase + rotacaoObjetos * 0.3f;
+            float raio = orbitas[i].raio;
             float x = raio * cos(glm::radians(angulo));
             float z = raio * sin(glm::radians(angulo));
             float y = 0.5f + 0.3f * sin(glm::radians(rotacaoObjetos * 2.0f + i * 45.0f));
 
-            modelo = glm::mat4(1.0f);
-            modelo = glm::translate(modelo, glm::vec3(x, y, z));
-            modelo = glm::rotate(modelo, glm::radians(rotacaoObjetos), glm::vec3(1.0f, 1.0f, 0.0f));
-            shaderIluminacao.definirMat4("modelo", modelo);
-            shaderIluminacao.definirVec3("material.ambiente", materialPadrao.ambiente);
-            shaderIluminacao.definirVec3("material.difusa", materialPadrao.difusa);
-            shaderIluminacao.definirVec3("material.especular", materialPadrao.especular);
-            shaderIluminacao.definirFloat("material.brilho", materialPadrao.brilho);
-            esfera.desenhar();
+            modelo = giroEsferas;
+            modelo[3] = glm::vec4(x, y, z, 1.0f);
+            modelosEsferas[i] = modelo;
+            if (modoEsferas == ModoDescarte::Linear) {
+                descarteEsferas.adicionar(lodEsfera.niveis[0], modelo);
+            } else if (modoEsferas == ModoDescarte::BVH) {
+                glm::vec3 naOrbita(raio * cos(glm::radians(orbitas[i].anguloBase)), y,
+                                   raio * sin(glm::radians(orbitas[i].anguloBase)));
+                CaixaBVH caixa = CaixaBVH::daEsfera(naOrbita, raioEsfera);
+                if (caixa.minimo != caixasEsferas[i].minimo || caixa.maximo != caixasEsferas[i].maximo) {
+                    caixasEsferas[i] = caixa;
+                    esferasAlteradas.push_back((uint32_t)i);
+                }
+            }
+        }
+        size_t numVisiveis = numEsferas;
+        const uint32_t* esferasVisiveis = nullptr;
+        if (modoEsferas == ModoDescarte::Linear) {
+            const std::vector<uint32_t>& visiveis = descarteEsferas.recortar(frustum);
+            numVisiveis = visiveis.size();
+            esferasVisiveis = visiveis.data();
+            tempoDescarte += descarteEsferas.estatisticas.segundos;
+        } else if (modoEsferas == ModoDescarte::BVH) {
+            const EstatisticasBVH& e = bvhEsferas.estatisticas;
+            if (!bvhConstruida || bvhEsferas.degradacao() > 2.0f) {
+                bvhEsferas.construir(caixasEsferas);
+                bvhConstruida = true;
+                std::cout << "BVH: " << e.objetos << " esferas, " << e.nos << " nos, " << e.folhas
+                          << " folhas, profundidade " << e.profundidade << ", construcao "
+                          << e.segundosConstrucao * 1000.0 << " ms" << std::endl;
+            } else if (!esferasAlteradas.empty()) {
+                // poucas alteradas: sobe só pelos caminhos delas; muitas: uma passada paralela na árvore toda
+                if (esferasAlteradas.size() * 8 <= numEsferas) bvhEsferas.reajustar(caixasEsferas, esferasAlteradas);
+                else bvhEsferas.reajustar(caixasEsferas);
+                tempoReajuste += e.segundosReajuste;
+            }
+
+            // a órbita gira em torno de Y; o frustum vai para o referencial dela
+            glm::mat4 giroOrbita = glm::rotate(glm::mat4(1.0f), -glm::radians(rotacaoObjetos * 0.3f),
+                                               glm::vec3(0.0f, 1.0f, 0.0f));
+            bvhEsferas.recortar(Frustum::daMatriz(projecao * visao * giroOrbita), visiveisBVH);
+            numVisiveis = visiveisBVH.size();
+            esferasVisiveis = visiveisBVH.data();
+            tempoDescarte += e.segundosConsulta;
+
+            if (pedidoSelecao) {
+                glm::mat4 paraOrbita = glm::inverse(giroOrbita);
+                glm::vec3 origem = glm::vec3(paraOrbita * glm::vec4(camera.posicao, 1.0f));
+                glm::vec3 direcao = glm::vec3(paraOrbita * glm::vec4(camera.direcaoFrente, 0.0f));
+                AcertoRaio acerto = bvhEsferas.raio(origem, direcao, 100.0f, [&](uint32_t esfera) {
+                    // raio contra a esfera exata, centrada na caixa
+                    glm::vec3 oc = origem - caixasEsferas[esfera].centro();
+                    float b = glm::dot(oc, direcao);
+                    float delta = b * b - (glm::dot(oc, oc) - raioEsfera * raioEsfera);
+                    return delta < 0.0f ? -1.0f : -b - std::sqrt(delta);
+                });
+                double segundosRaio = e.segundosConsulta;
+                if (acerto.objeto < 0) {
+                    std::cout << "Selecao: nenhuma esfera (" << segundosRaio * 1000.0 << " ms)" << std::endl;
+                } else {
+                    bvhEsferas.esfera(caixasEsferas[acerto.objeto].centro(), 3.0f, vizinhasSelecao);
+                    std::cout << "Selecao: esfera " << acerto.objeto << " a " << acerto.distancia << " unidades ("
+                              << segundosRaio * 1000.0 << " ms); " << vizinhasSelecao.size()
+                              << " esferas a ate 3 unidades (" << e.segundosConsulta * 1000.0 << " ms)" << std::endl;
+                }
+            }
+        }
+        if (pedidoSelecao && modoDescarte != ModoDescarte::BVH)
+            std::cout << "Selecao: so no descarte por BVH (tecla C)" << std::endl;
+        pedidoSelecao = false;
+
+        if (descarteNaGPU) {
+            entradaGPU.atualizar(modelosEsferas, materiaisEsferas);
+            descarteGPU.recortar(lodEsfera, entradaGPU, projecao, visao, camera.posicao, camera.zoom,
+                                 (float)ALTURA_JANELA);
+            // um programa para todos os níveis: vale o formato do mais detalhado
+            shadersIluminacaoGPU->shader(chaveIluminacao(lodEsfera.niveis[0], 0)).usar();
+            descarteGPU.desenhar(lodEsfera, entradaGPU);
+            // a escolha de nível foi da GPU: as contagens são as instâncias de cada comando
+            const std::vector<GLuint>& porNivel = descarteGPU.estatisticas.visiveisPorNivel;
+            for (size_t n = 0; n < porNivel.size() && n < lodEsfera.niveis.size(); n++)
+                lodEsfera.estatisticas.desenhosPorNivel[n] = porNivel[n];
+            numVisiveis = 0;
+        }
+
+        // As primeiras esferas da lista (anéis internos) também ocluem, pelo
+        // nível mais simples, que fica inteiro dentro da esfera.
+        if (oclusaoAtivada && !descarteNaGPU) {
+            const Mesh& oclusoraEsfera = lodEsfera.niveis.back();
+            for (size_t k = 0; k < std::min(numVisiveis, MAXIMO_ESFERAS_OCLUSORAS); k++)
+                oclusao.adicionarOclusor(oclusoraEsfera, modelosEsferas[esferasVisiveis ? esferasVisiveis[k] : k]);
+            oclusao.rasterizar();
+
+            minimosOclusao.resize(numVisiveis);
+            maximosOclusao.resize(numVisiveis);
+            naoOcultas.resize(numVisiveis);
+            const Mesh& base = lodEsfera.niveis[0];
+            for (size_t k = 0; k < numVisiveis; k++) {
+                glm::vec3 centro, extensao;
+                Frustum::transformarCaixa(base.limiteMin, base.limiteMax,
+                                          modelosEsferas[esferasVisiveis ? esferasVisiveis[k] : k], centro, extensao);
+                minimosOclusao[k] = centro - extensao;
+                maximosOclusao[k] = centro + extensao;
+            }
+            oclusao.testarLote(minimosOclusao.data(), maximosOclusao.data(), numVisiveis, naoOcultas.data());
+
+            esferasNaoOcultas.clear();
+            for (size_t k = 0; k < numVisiveis; k++)
+                if (naoOcultas[k]) esferasNaoOcultas.push_back(esferasVisiveis ? esferasVisiveis[k] : (uint32_t)k);
+            numVisiveis = esferasNaoOcultas.size();
+            esferasVisiveis = esferasNaoOcultas.data();
+            tempoOclusao += oclusao.estatisticas.segundosRasterizacao + oclusao.estatisticas.segundosTeste;
+        }
+
+        for (size_t k = 0; k < numVisiveis; k++) {
+            size_t i = esferasVisiveis ? esferasVisiveis[k] : k;
+            modelo = modelosEsferas[i];
+            int nivel = lodEsfera.selecionar(modelo, 1.0f, camera.posicao, camera.zoom,
+                                             (float)ALTURA_JANELA, nivelEsferas[i]);
+
+            if (modoDesenho == ModoDesenho::Instanciado) {
+                modelosPorNivel[nivel].push_back(modelo);
+                materiaisPorNivel[nivel].push_back((GLuint)(i % 3));
+                continue;
+            }
+            if (indireto) {
+                cenaIndireta.adicionar(lodEsfera.usarNivel(nivel), modelo, (GLuint)(i % 3));
+                continue;
+            }
+            const Mesh& esfera = lodEsfera.usarNivel(nivel);
+            fila.adicionar(filaPara(esfera), esfera, *materiaisCena[i % 3], modelo, PasseRenderizacao::Opaco,
+                           (GLint)(i % 3));
+        }
+
+        if (modoDesenho == ModoDesenho::Instanciado) {
+            for (size_t n = 0; n < modelosPorNivel.size(); n++) {
+                shadersIluminacao.shader(chaveIluminacao(lodEsfera.niveis[n], RECURSO_INSTANCIADO)).usar();
+                instanciasEsferas[n].atualizar(modelosPorNivel[n], materiaisPorNivel[n]);
+                lodEsfera.desenharInstanciado((int)n, instanciasEsferas[n]);
+            }
+        } else if (indireto) {
+            // a variante compacta também desenha vértices em float, não o contrário
+            uint32_t recursos = RECURSO_INSTANCIADO | (cenaIndireta.quantizada() ? RECURSO_VERTICE_COMPACTO : 0);
+            if (iluminacaoAtivada) recursos |= RECURSO_ILUMINACAO;
+            shadersIluminacao.shader(chavePermutacao(recursos, numLuzesBloco)).usar();
+            cenaIndireta.enviar(modoDesenho == ModoDesenho::Indireto);
+            tempoEnvio += cenaIndireta.estatisticas.segundosEnvio;
         }
 
         // cubinhos indicadores de luz
-        shaderLuz.usar();
-        shaderLuz.definirMat4("projecao", projecao);
-        shaderLuz.definirMat4("visao", visao);
+        if (modoDesenho != ModoDesenho::PorObjeto) {
+            modelosLuzes.clear();
+            coresLuzes.clear();
+            shadersLuz.shader(chavePermutacao(recursosCubo | RECURSO_INSTANCIADO, 0)).usar();
+            for (size_t i = 0; i < luzesPontuais.size(); i++) {
+                modelo = glm::mat4(1.0f);
+                modelo = glm::translate(modelo, luzesPontuais[i].posicao);
+                modelo = glm::scale(modelo, glm::vec3(0.15f));
+                if (!visivel(cubo, modelo)) continue;
+                modelosLuzes.push_back(modelo);
+                coresLuzes.push_back((GLuint)i);
+            }
+            instanciasLuzes.atualizar(modelosLuzes, coresLuzes);
+            cubo.desenharInstanciado(instanciasLuzes);
+        } else {
+            for (size_t i = 0; i < luzesPontuais.size(); i++) {
+                modelo = glm::mat4(1.0f);
+                modelo = glm::translate(modelo, luzesPontuais[i].posicao);
+                modelo = glm::scale(modelo, glm::vec3(0.15f));
+                if (visivel(cubo, modelo)) fila.adicionar(filaLuz, cubo, materiaisLuzes[i], modelo);
+            }
+        }
 
-        for (size_t i = 0; i < luzesPontuais.size(); i++) {
-            modelo = glm::mat4(1.0f);
-            modelo = glm::translate(modelo, luzesPontuais[i].posicao);
-            modelo = glm::scale(modelo, glm::vec3(0.15f));
-            shaderLuz.definirMat4("modelo", modelo);
-            shaderLuz.definirVec4("cor", glm::vec4(luzesPontuais[i].difusa, 1.0f));
-            cubo.desenhar();
+        fila.executar();   // no modo indireto, só o glTF
+        tempoCPU += glfwGetTime() - inicioCPU;
+
+        // variante criada no meio da cena: o quadro dela inclui a compilação
+        for (int t = 0; t < 3; t++) {
+            if (!tabelasShader[t] || tabelasShader[t]->estatisticas.compiladas == variantesRelatadas[t]) continue;
+            const EstatisticasPermutacoes& p = tabelasShader[t]->estatisticas;
+            std::cout << "Permutacao nova: " << tabelasShader[t]->nome() << " ("
+                      << descreverPermutacao(p.ultimaChave) << ") em " << p.segundosUltima * 1000.0 << " ms, "
+                      << p.compiladas << " de " << p.possiveis << std::endl;
+            variantesRelatadas[t] = p.compiladas;
+        }
+
+        // média de um segundo: quadro inteiro, CPU da cena, o teste de frustum e, no modo indireto, só o envio
+        quadrosRelatorio++;
+        if (tempoAtual - inicioRelatorio >= 1.0f) {
+            double segundos = tempoAtual - inicioRelatorio;
+            std::cout << "Esferas: " << numEsferas << " (" << NOMES_MODO_DESENHO[(int)modoDesenho]
+                      << ") | quadro " << segundos * 1000.0 / quadrosRelatorio << " ms, CPU da cena "
+                      << tempoCPU * 1000.0 / quadrosRelatorio << " ms";
+            // desenhos de cada nível no último quadro, do mais detalhado ao mais simples
+            std::cout << " | LOD";
+            for (size_t n = 0; n < lodEsfera.estatisticas.desenhosPorNivel.size(); n++)
+                std::cout << (n == 0 ? " " : "/") << lodEsfera.estatisticas.desenhosPorNivel[n];
+            if (modoEsferas == ModoDescarte::Linear) {
+                const EstatisticasDescarte& d = descarteEsferas.estatisticas;
+                std::cout << " | visiveis " << d.visiveis << "/" << d.testados << ", descarte "
+                          << tempoDescarte * 1000.0 / quadrosRelatorio << " ms (" << d.threads << " threads)";
+            } else if (modoEsferas == ModoDescarte::BVH) {
+                std::cout << " | visiveis " << visiveisBVH.size() << "/" << numEsferas << ", BVH: consulta "
+                          << tempoDescarte * 1000.0 / quadrosRelatorio << " ms, reajuste "
+                          << tempoReajuste * 1000.0 / quadrosRelatorio << " ms, degradacao "
+                          << bvhEsferas.degradacao();
+            }
+            if (descarteNaGPU) {
+                const EstatisticasDescarteGPU& g = descarteGPU.estatisticas;
+                std::cout << " | GPU: visiveis " << g.visiveis << "/" << g.testados() << ", fora do frustum "
+                          << g.foraFrustum << ", ocultas " << g.ocultos << (g.hiZ ? "" : " (sem Hi-Z)")
+                          << ", CPU " << g.segundosCPU * 1000.0 << " ms";
+            }
+            if (oclusaoAtivada && !descarteNaGPU) {
+                const EstatisticasOclusao& o = oclusao.estatisticas;
+                std::cout << " | oclusao: " << o.rejeitados << "/" << o.testados << " ocultas ("
+                          << o.fracaoRejeitada() * 100.0 << "%), " << o.triangulos << " triangulos oclusores, "
+                          << tempoOclusao * 1000.0 / quadrosRelatorio << " ms (raster "
+                          << o.segundosRasterizacao * 1000.0 << ", teste " << o.segundosTeste * 1000.0 << ")";
+            }
+            if (indireto) {
+                const EstatisticasDesenhoIndireto& e = cenaIndireta.estatisticas;
+                std::cout << " | " << e.objetos << " objetos, " << e.comandos << " comandos, " << e.chamadasGL
+                          << " chamadas GL" << (e.multiDraw ? " (multi-draw)" : "") << ", envio "
+                          << tempoEnvio * 1000.0 / quadrosRelatorio << " ms";
+            } else {
+                const EstatisticasFila& f = fila.estatisticas;
+                std::cout << " | fila: " << f.desenhos << " desenhos, " << f.trocasPrograma << " programas ("
+                          << f.programasEvitados << " evitados), " << f.trocasVAO << " VAOs (" << f.vaosEvitados
+                          << " evitados), " << f.trocasMaterial << " materiais (" << f.uniformsEvitados
+                          << " uniforms evitados), ordenacao " << f.segundosOrdenacao * 1000.0 << " ms";
+            }
+            const EstatisticasAnel& a = fila.estatisticasAnel();
+            std::cout << " | anel " << (a.persistente ? "persistente" : "3.3") << ": espera "
+                      << fila.estatisticas.segundosEsperaAnel * 1000.0 << " ms, " << a.esperas
+                      << " regioes ocupadas, " << a.orfaos << " orfaos (de " << a.regioesUsadas << ")";
+            std::cout << std::endl;
+            inicioRelatorio = tempoAtual;
+            tempoCPU = 0.0;
+            tempoEnvio = 0.0;
+            tempoDescarte = 0.0;
+            tempoReajuste = 0.0;
+            tempoOclusao = 0.0;
+            quadrosRelatorio = 0;
+        }
+
+        // profundidade deste quadro para o teste de oclusão do próximo
+        if (descarteNaGPU) {
+            int larguraTela, alturaTela;
+            glfwGetFramebufferSize(janela, &larguraTela, &alturaTela);
+            descarteGPU.capturarProfundidade(larguraTela, alturaTela, projecao * visao);
+        } else {
+            descarteGPU.descartarHiZ();
         }
 
         glfwSwapBuffers(janela);
@@ -284,6 +834,62 @@ void processarEntrada(GLFWwindow* janela) {
     if (glfwGetKey(janela, GLFW_KEY_L) == GLFW_RELEASE) {
         teclaLPressionadaAntes = false;
     }
+
+    // quantidade de esferas
+    static bool teclaNPressionadaAntes = false;
+    if (glfwGetKey(janela, GLFW_KEY_N) == GLFW_PRESS && !teclaNPressionadaAntes) {
+        const size_t opcoes = sizeof(QUANTIDADES_ESFERAS) / sizeof(QUANTIDADES_ESFERAS[0]);
+        indiceQuantidadeEsferas = (indiceQuantidadeEsferas + 1) % opcoes;
+        teclaNPressionadaAntes = true;
+    }
+    if (glfwGetKey(janela, GLFW_KEY_N) == GLFW_RELEASE) {
+        teclaNPressionadaAntes = false;
+    }
+
+    // modo de desenho
+    static bool teclaIPressionadaAntes = false;
+    if (glfwGetKey(janela, GLFW_KEY_I) == GLFW_PRESS && !teclaIPressionadaAntes) {
+        modoDesenho = (ModoDesenho)(((int)modoDesenho + 1) % 5);
+        if (modoDesenho == ModoDesenho::DescarteGPU && !ExtensoesGL::temComputacao())
+            modoDesenho = ModoDesenho::PorObjeto;
+        teclaIPressionadaAntes = true;
+        std::cout << "Modo de desenho: " << NOMES_MODO_DESENHO[(int)modoDesenho] << std::endl;
+    }
+    if (glfwGetKey(janela, GLFW_KEY_I) == GLFW_RELEASE) {
+        teclaIPressionadaAntes = false;
+    }
+
+    // descarte por frustum
+    static bool teclaCPressionadaAntes = false;
+    if (glfwGetKey(janela, GLFW_KEY_C) == GLFW_PRESS && !teclaCPressionadaAntes) {
+        modoDescarte = (ModoDescarte)(((int)modoDescarte + 1) % 3);
+        teclaCPressionadaAntes = true;
+        std::cout << "Descarte: " << NOMES_MODO_DESCARTE[(int)modoDescarte] << std::endl;
+    }
+    if (glfwGetKey(janela, GLFW_KEY_C) == GLFW_RELEASE) {
+        teclaCPressionadaAntes = false;
+    }
+
+    // descarte por oclusão
+    static bool teclaOPressionadaAntes = false;
+    if (glfwGetKey(janela, GLFW_KEY_O) == GLFW_PRESS && !teclaOPressionadaAntes) {
+        oclusaoAtivada = !oclusaoAtivada;
+        teclaOPressionadaAntes = true;
+        std::cout << "Oclusao: " << (oclusaoAtivada ? "ligada" : "desligada") << std::endl;
+    }
+    if (glfwGetKey(janela, GLFW_KEY_O) == GLFW_RELEASE) {
+        teclaOPressionadaAntes = false;
+    }
+
+    // seleção por raio
+    static bool teclaPPressionadaAntes = false;
+    if (glfwGetKey(janela, GLFW_KEY_P) == GLFW_PRESS && !teclaPPressionadaAntes) {
+        pedidoSelecao = true;
+        teclaPPressionadaAntes = true;
+    }
+    if (glfwGetKey(janela, GLFW_KEY_P) == GLFW_RELEASE) {
+        teclaPPressionadaAntes = false;
+    }
 }
 
 void callbackRedimensionamento(GLFWwindow* janela, int largura, int altura) {
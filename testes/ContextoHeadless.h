@@ -0,0 +1,79 @@
+#ifndef CONTEXTO_HEADLESS_H
+#define CONTEXTO_HEADLESS_H
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <glad/glad.h>
+#include <cstdio>
+
+#include "ExtensoesGL.h"
+
+// Saída dos testes que precisam de OpenGL quando a máquina não tem EGL nem
+// driver: o CTest (SKIP_RETURN_CODE) e o make testes contam como pulado.
+const int TESTE_PULADO = 77;
+
+// Contexto OpenGL core sem janela: EGL na plataforma surfaceless do Mesa,
+// que sem GPU roda no llvmpipe. O framebuffer padrão é um pbuffer de
+// largura x altura com profundidade e stencil, como o da janela do GLFW.
+class ContextoHeadless {
+public:
+    ContextoHeadless() = default;
+    ContextoHeadless(const ContextoHeadless&) = delete;
+    ContextoHeadless& operator=(const ContextoHeadless&) = delete;
+
+    ~ContextoHeadless() {
+        if (display == EGL_NO_DISPLAY) return;
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (contexto != EGL_NO_CONTEXT) eglDestroyContext(display, contexto);
+        if (superficie != EGL_NO_SURFACE) eglDestroySurface(display, superficie);
+        eglTerminate(display);
+    }
+
+    // Cria o contexto (maior.menor core), carrega o glad e o ExtensoesGL.
+    bool iniciar(int largura, int altura, int maior = 4, int menor = 5) {
+        auto obterDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        display = obterDisplay ? obterDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                               : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+            display = EGL_NO_DISPLAY;
+            return falhar("EGL_INDISPONIVEL");
+        }
+
+        const EGLint atributos[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                    EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+                                    EGL_DEPTH_SIZE, 24, EGL_STENCIL_SIZE, 8, EGL_NONE};
+        EGLConfig configuracao;
+        EGLint encontradas = 0;
+        if (!eglChooseConfig(display, atributos, &configuracao, 1, &encontradas) || encontradas == 0)
+            return falhar("SEM_CONFIGURACAO");
+
+        const EGLint tamanho[] = {EGL_WIDTH, largura, EGL_HEIGHT, altura, EGL_NONE};
+        superficie = eglCreatePbufferSurface(display, configuracao, tamanho);
+        if (superficie == EGL_NO_SURFACE) return falhar("PBUFFER");
+
+        eglBindAPI(EGL_OPENGL_API);
+        const EGLint versao[] = {EGL_CONTEXT_MAJOR_VERSION, maior, EGL_CONTEXT_MINOR_VERSION, menor,
+                                 EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+        contexto = eglCreateContext(display, configuracao, EGL_NO_CONTEXT, versao);
+        if (contexto == EGL_NO_CONTEXT) return falhar("CONTEXTO");
+        if (!eglMakeCurrent(display, superficie, superficie, contexto)) return falhar("MAKE_CURRENT");
+
+        if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) return falhar("GLAD");
+        ExtensoesGL::carregar((GLADloadproc)eglGetProcAddress);
+        std::printf("contexto: %s, OpenGL %s\n", (const char*)glGetString(GL_RENDERER),
+                    (const char*)glGetString(GL_VERSION));
+        return true;
+    }
+
+private:
+    EGLDisplay display = EGL_NO_DISPLAY;
+    EGLSurface superficie = EGL_NO_SURFACE;
+    EGLContext contexto = EGL_NO_CONTEXT;
+
+    static bool falhar(const char* motivo) {
+        std::printf("ERRO::CONTEXTO_HEADLESS::%s (0x%x)\n", motivo, (unsigned)eglGetError());
+        return false;
+    }
+};
+
+#endif
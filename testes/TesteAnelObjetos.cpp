@@ -0,0 +1,184 @@
+// Anel de registros por desenho (AnelObjetos.h): 12 quadros, quatro voltas
+// nas três regiões, pelo caminho persistente (glBufferStorage) e pelo do
+// OpenGL 3.3 (ExtensoesGL::bufferStorage nulo), com o anel crescendo no meio.
+// A cada quadro um fragment shader lê a região pelo samplerBuffer, como os
+// de desenho, e grava um texel por fragmento numa textura RGBA32F daquele
+// quadro. No fim, cada textura tem de ter os registros do seu quadro: uma
+// região reescrita antes de a GPU terminar de lê-la apareceria como os
+// dados de um quadro seguinte. No llvmpipe os fragmentos só rodam fora da
+// thread que desenha com mais de uma thread de rasterização, então o teste
+// pede duas e põe uma carga no shader, para as cercas ainda estarem
+// pendentes quando o anel dá a volta; esperas e buffers órfãos são impressos.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <glm/glm.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "AnelObjetos.h"
+#include "RecursosGL.h"
+
+const int QUADROS = 12;
+const size_t TEXELS_POR_REGISTRO = sizeof(RegistroObjeto) / sizeof(glm::vec4);
+const int LARGURA_LEITURA = 1024;   // texels por linha da textura de cada quadro
+const int CARGA = 400;              // iterações por fragmento, só para ocupar a GPU
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// um fragmento por texel da região; a carga não muda o resultado
+static const char* VERTEX_LEITOR =
+    "#version 330 core\n"
+    "void main() {\n"
+    "    vec2 p[3] = vec2[](vec2(-1.0, -1.0), vec2(3.0, -1.0), vec2(-1.0, 3.0));\n"
+    "    gl_Position = vec4(p[gl_VertexID], 0.0, 1.0);\n"
+    "}\n";
+static const char* FRAGMENT_LEITOR =
+    "#version 330 core\n"
+    "uniform samplerBuffer objetos;\n"
+    "uniform int primeiroTexel;\n"
+    "uniform int carga;\n"
+    "out vec4 lido;\n"
+    "void main() {\n"
+    "    ivec2 p = ivec2(gl_FragCoord.xy);\n"
+    "    float s = 0.0;\n"
+    "    for (int i = 0; i < carga; i++) s = sin(s + float(i));\n"
+    "    lido = texelFetch(objetos, primeiroTexel + p.y * 1024 + p.x) + vec4(s > 2.0 ? 1.0 : 0.0);\n"
+    "}\n";
+
+static GLuint compilar(GLenum tipo, const char* fonte) {
+    GLuint shader = glCreateShader(tipo);
+    glShaderSource(shader, 1, &fonte, nullptr);
+    glCompileShader(shader);
+    return shader;
+}
+
+static GLuint criarLeitor() {
+    GLuint vertex = compilar(GL_VERTEX_SHADER, VERTEX_LEITOR);
+    GLuint fragment = compilar(GL_FRAGMENT_SHADER, FRAGMENT_LEITOR);
+    GLuint programa = glCreateProgram();
+    glAttachShader(programa, vertex);
+    glAttachShader(programa, fragment);
+    glLinkProgram(programa);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    GLint linkado = 0;
+    glGetProgramiv(programa, GL_LINK_STATUS, &linkado);
+    return linkado ? programa : 0;
+}
+
+// registros diferentes em cada quadro e em cada posição
+static RegistroObjeto esperado(int quadro, size_t i) {
+    float base = (float)(quadro * 100000 + (int)i * 10);
+    glm::vec4 normais[3] = {glm::vec4(base + 1.0f), glm::vec4(base + 2.0f), glm::vec4(base + 3.0f)};
+    RegistroObjeto r;
+    r.definir(glm::mat4(base), normais, (GLint)(quadro * 7 + (int)i % 16));
+    return r;
+}
+
+static size_t registrosNoQuadro(int quadro) { return quadro < QUADROS / 2 ? 300 : 5000; }
+
+static int linhasLeitura(size_t n) {
+    return (int)((n * TEXELS_POR_REGISTRO + LARGURA_LEITURA - 1) / LARGURA_LEITURA);
+}
+
+// Roda os quadros num anel novo; o caminho vem de ExtensoesGL no momento.
+static void conferirCaminho(const char* nome, GLuint leitor, bool persistenteEsperado) {
+    AnelObjetos anel;
+    VertexArrayGL vao;
+    vao.gerar();
+    glBindVertexArray(vao);
+    glUseProgram(leitor);
+    glUniform1i(glGetUniformLocation(leitor, "objetos"), (GLint)UNIDADE_TEXTURA_OBJETOS);
+    glUniform1i(glGetUniformLocation(leitor, "carga"), CARGA);
+    GLint localPrimeiro = glGetUniformLocation(leitor, "primeiroTexel");
+
+    std::vector<TexturaGL> lidos(QUADROS);
+    std::vector<GLuint> framebuffers(QUADROS);
+    glGenFramebuffers(QUADROS, framebuffers.data());
+    for (int quadro = 0; quadro < QUADROS; quadro++) {
+        const size_t n = registrosNoQuadro(quadro);
+        RegistroObjeto* registros = anel.mapear(n);
+        for (size_t i = 0; i < n; i++) registros[i] = esperado(quadro, i);
+        anel.desmapear();
+
+        lidos[quadro].gerar();
+        glBindTexture(GL_TEXTURE_2D, lidos[quadro]);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, LARGURA_LEITURA, linhasLeitura(n), 0, GL_RGBA, GL_FLOAT, nullptr);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[quadro]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, lidos[quadro], 0);
+        glViewport(0, 0, LARGURA_LEITURA, linhasLeitura(n));
+        glUniform1i(localPrimeiro, anel.primeiroRegistro() * (GLint)TEXELS_POR_REGISTRO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        anel.cercar();
+    }
+
+    bool iguais = true;
+    for (int quadro = 0; quadro < QUADROS && iguais; quadro++) {
+        const size_t n = registrosNoQuadro(quadro);
+        std::vector<glm::vec4> lido((size_t)LARGURA_LEITURA * linhasLeitura(n));
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[quadro]);
+        glReadPixels(0, 0, LARGURA_LEITURA, linhasLeitura(n), GL_RGBA, GL_FLOAT, lido.data());
+        for (size_t i = 0; i < n && iguais; i++) {
+            RegistroObjeto e = esperado(quadro, i);
+            const glm::vec4* texels = (const glm::vec4*)&e;
+            for (size_t t = 0; t < TEXELS_POR_REGISTRO; t++)
+                iguais = iguais && lido[i * TEXELS_POR_REGISTRO + t] == texels[t];
+            if (!iguais) std::printf("  %s: quadro %d, registro %zu diferente\n", nome, quadro, i);
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(QUADROS, framebuffers.data());
+
+    const EstatisticasAnel& e = anel.estatisticas;
+    std::printf("%s: %zu regioes, %zu esperas, %zu orfaos\n", nome, e.regioesUsadas, e.esperas, e.orfaos);
+    char descricao[128];
+    std::snprintf(descricao, sizeof(descricao), "%s: %s", nome,
+                  persistenteEsperado ? "mapeamento persistente" : "glMapBufferRange do 3.3");
+    verificar(e.persistente == persistenteEsperado, descricao);
+    std::snprintf(descricao, sizeof(descricao), "%s: cada quadro leu os proprios registros", nome);
+    verificar(iguais, descricao);
+    std::snprintf(descricao, sizeof(descricao), "%s: uma regiao por quadro, orfao so no 3.3", nome);
+    verificar(e.regioesUsadas == (size_t)QUADROS && (persistenteEsperado ? e.orfaos == 0 : e.orfaos == e.esperas),
+              descricao);
+    glBindVertexArray(0);
+}
+
+int main() {
+    setenv("LP_NUM_THREADS", "2", 0);   // só o llvmpipe lê
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(64, 64)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    GLuint leitor = criarLeitor();
+    verificar(leitor != 0, "leitor linka");
+    if (!leitor) {
+        std::printf("%d falha(s)\n", falhas);
+        return EXIT_FAILURE;
+    }
+
+    if (ExtensoesGL::temMapeamentoPersistente())
+        conferirCaminho("persistente", leitor, true);
+    else
+        std::printf("sem glBufferStorage: caminho persistente nao conferido\n");
+
+    // o mesmo contexto, como se fosse 3.3
+    FuncBufferStorage bufferStorage = ExtensoesGL::bufferStorage;
+    ExtensoesGL::bufferStorage = nullptr;
+    conferirCaminho("3.3", leitor, false);
+    ExtensoesGL::bufferStorage = bufferStorage;
+
+    glDeleteProgram(leitor);
+    verificar(glGetError() == GL_NO_ERROR, "sem erro de OpenGL");
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,151 @@
+// Compactação da arena de geometria (ArenaGeometria.h) com o driver de
+// verdade. Primeiro, blocos de tamanhos variados são alocados e um sim, um
+// não, liberados; compactar() tem de deixar os vivos seguidos na ordem em
+// que estavam, uma faixa livre por buffer e o conteúdo de cada bloco
+// intacto, lido de volta dos buffers do VAO. Depois, uma arena com os
+// índices cheios e capacidade que não é múltipla de 4: o arredondamento do
+// último bloco passa dela, então a compactação cresce o pool antes, e um
+// bloco alocado em seguida não pode cair em cima dos outros.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "ArenaGeometria.h"
+
+const size_t FLOATS_POR_VERTICE = 8;   // formato padrão: posição, normal e uv em float
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// conteúdo próprio de cada bloco, para uma cópia trocada aparecer
+struct DadosBloco {
+    std::vector<float> vertices;
+    std::vector<uint16_t> indices;
+};
+
+static DadosBloco gerar(int semente, size_t numVertices, size_t numIndices) {
+    DadosBloco d;
+    for (size_t v = 0; v < numVertices * FLOATS_POR_VERTICE; v++) d.vertices.push_back((float)(semente * 1000 + (int)v));
+    for (size_t i = 0; i < numIndices; i++) d.indices.push_back((uint16_t)(semente * 100 + (int)i));
+    return d;
+}
+
+static uint32_t alocar(ArenaGeometria& arena, const DadosBloco& d) {
+    return arena.alocar(FormatoVertice(), d.vertices.data(), d.vertices.size() / FLOATS_POR_VERTICE,
+                        d.indices.data(), d.indices.size() * sizeof(uint16_t));
+}
+
+// Lê o bloco dos buffers que o VAO dele usa agora.
+static bool igual(const ArenaGeometria& arena, uint32_t id, const DadosBloco& d) {
+    const BlocoArena& b = arena.bloco(id);
+    EstadoGL::vincularVAO(arena.vao(b));
+    GLint vbo = 0, ebo = 0;
+    glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &vbo);
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &ebo);
+    EstadoGL::vincularVAO(0);
+
+    std::vector<float> vertices(d.vertices.size());
+    std::vector<uint16_t> indices(d.indices.size());
+    glBindBuffer(GL_COPY_READ_BUFFER, (GLuint)vbo);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, b.baseVertice * FLOATS_POR_VERTICE * sizeof(float),
+                       vertices.size() * sizeof(float), vertices.data());
+    glBindBuffer(GL_COPY_READ_BUFFER, (GLuint)ebo);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, b.deslocIndices, indices.size() * sizeof(uint16_t), indices.data());
+    return vertices == d.vertices && indices == d.indices;
+}
+
+// Blocos de tamanhos variados, metade liberada, compactar.
+static void conferirFragmentada() {
+    ArenaGeometria arena(64 * FLOATS_POR_VERTICE * sizeof(float), 256);
+    std::vector<DadosBloco> dados;
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 24; i++) {
+        dados.push_back(gerar(i, 3 + (size_t)(i * 7) % 11, 3 + (size_t)(i * 5) % 13));
+        ids.push_back(alocar(arena, dados.back()));
+    }
+    for (int i = 0; i < 24; i += 2) arena.liberar(ids[i]);
+    EstatisticasArena antes = arena.estatisticas();
+
+    arena.compactar();
+    EstatisticasArena depois = arena.estatisticas();
+    std::printf("fragmentada: %zu -> %zu faixas livres, %zu crescimentos\n", antes.faixasLivres,
+                depois.faixasLivres, depois.crescimentos);
+    verificar(antes.faixasLivres > 2 && depois.faixasLivres == 2, "uma faixa livre por buffer depois de compactar");
+
+    // vivos seguidos, na ordem em que estavam, índices começando alinhados em 4
+    bool seguidos = true, conteudo = true;
+    size_t proximoVertice = 0, proximoIndice = 0;
+    for (int i = 1; i < 24; i += 2) {
+        const BlocoArena& b = arena.bloco(ids[i]);
+        seguidos = seguidos && b.baseVertice == proximoVertice && b.deslocIndices == proximoIndice;
+        proximoVertice += b.numVertices;
+        proximoIndice = (proximoIndice + b.bytesIndices + 3) & ~size_t(3);
+        conteudo = conteudo && igual(arena, ids[i], dados[i]);
+    }
+    verificar(seguidos, "blocos vivos seguidos, na ordem original");
+    verificar(conteudo, "conteudo de cada bloco intacto depois da copia");
+    verificar(depois.bytesVerticesUsados == antes.bytesVerticesUsados &&
+              depois.bytesIndicesUsados == antes.bytesIndicesUsados, "uso igual antes e depois");
+
+    // a faixa livre do fim recebe um bloco novo sem tocar nos outros
+    DadosBloco novo = gerar(99, 5, 9);
+    uint32_t idNovo = alocar(arena, novo);
+    verificar(arena.bloco(idNovo).baseVertice == proximoVertice && arena.bloco(idNovo).deslocIndices == proximoIndice,
+              "bloco novo logo depois dos compactados");
+    bool intactos = igual(arena, idNovo, novo);
+    for (int i = 1; i < 24; i += 2) intactos = intactos && igual(arena, ids[i], dados[i]);
+    verificar(intactos, "bloco novo e antigos com o proprio conteudo");
+}
+
+// Índices cheios, capacidade de 62 bytes: oito blocos de 6 bytes em 0, 8, ..., 56.
+static void conferirArredondamento() {
+    ArenaGeometria arena(64 * FLOATS_POR_VERTICE * sizeof(float), 62);
+    std::vector<DadosBloco> dados;
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 8; i++) {
+        dados.push_back(gerar(i, 4, 3));
+        ids.push_back(alocar(arena, dados.back()));
+    }
+    EstatisticasArena antes = arena.estatisticas();
+    verificar(antes.crescimentos == 0 && antes.bytesIndicesCapacidade == 62, "oito blocos cabem nos 62 bytes");
+
+    arena.compactar();
+    EstatisticasArena depois = arena.estatisticas();
+    std::printf("arredondamento: indices %zu -> %zu bytes, %zu crescimentos\n", antes.bytesIndicesCapacidade,
+                depois.bytesIndicesCapacidade, depois.crescimentos);
+    verificar(depois.crescimentos == 1 && depois.bytesIndicesCapacidade >= 64,
+              "compactar cresce os indices antes de passar da capacidade");
+
+    bool conteudo = true;
+    for (int i = 0; i < 8; i++) conteudo = conteudo && igual(arena, ids[i], dados[i]);
+    verificar(conteudo, "conteudo dos oito blocos intacto");
+
+    DadosBloco novo = gerar(42, 4, 3);
+    uint32_t idNovo = alocar(arena, novo);
+    verificar(arena.bloco(idNovo).deslocIndices >= 64, "bloco novo depois dos oito, nao em cima deles");
+    bool intactos = igual(arena, idNovo, novo);
+    for (int i = 0; i < 8; i++) intactos = intactos && igual(arena, ids[i], dados[i]);
+    verificar(intactos, "depois do bloco novo, todos com o proprio conteudo");
+}
+
+int main() {
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(64, 64)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    conferirFragmentada();
+    conferirArredondamento();
+    verificar(glGetError() == GL_NO_ERROR, "sem erro de OpenGL");
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
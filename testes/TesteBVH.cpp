@@ -0,0 +1,204 @@
+// Reajuste parcial da BVH (BVH.h): depois de mover alguns objetos, o custo
+// SAH mantido pela diferença de área tem de bater com o recalculado na árvore
+// toda, e as consultas têm de enxergar as caixas novas. Depois, com 10 mil,
+// 100 mil e 1 milhão de objetos, mede construção, reajuste completo e parcial
+// e as consultas por frustum, raio e esfera, conferindo algumas de cada
+// contra a força bruta; os tempos são só impressos.
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "BVH.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// ids das caixas que tocam a esfera, por força bruta
+static std::vector<uint32_t> tocamEsfera(const std::vector<CaixaBVH>& caixas, const glm::vec3& centro, float raio) {
+    std::vector<uint32_t> ids;
+    for (size_t i = 0; i < caixas.size(); i++) {
+        glm::vec3 maisPerto = glm::clamp(centro, caixas[i].minimo, caixas[i].maximo);
+        glm::vec3 d = maisPerto - centro;
+        if (glm::dot(d, d) <= raio * raio) ids.push_back((uint32_t)i);
+    }
+    return ids;
+}
+
+// ids das caixas que tocam o frustum, pelo teste de caixa do próprio Frustum
+static std::vector<uint32_t> tocamFrustum(const std::vector<CaixaBVH>& caixas, const Frustum& frustum) {
+    std::vector<uint32_t> ids;
+    for (size_t i = 0; i < caixas.size(); i++)
+        if (frustum.caixaVisivel(caixas[i].centro(), (caixas[i].maximo - caixas[i].minimo) * 0.5f))
+            ids.push_back((uint32_t)i);
+    return ids;
+}
+
+// distância de entrada do raio na caixa mais próxima (slabs), FLT_MAX sem acerto
+static float primeiraCaixa(const std::vector<CaixaBVH>& caixas, const glm::vec3& origem, const glm::vec3& direcao) {
+    glm::vec3 inverso = 1.0f / direcao;
+    float melhor = FLT_MAX;
+    for (const CaixaBVH& c : caixas) {
+        glm::vec3 t0 = (c.minimo - origem) * inverso, t1 = (c.maximo - origem) * inverso;
+        glm::vec3 perto = glm::min(t0, t1), longe = glm::max(t0, t1);
+        float entrada = std::max(std::max(perto.x, perto.y), std::max(perto.z, 0.0f));
+        float saida = std::min(std::min(longe.x, longe.y), longe.z);
+        if (entrada <= saida && entrada < melhor) melhor = entrada;
+    }
+    return melhor;
+}
+
+static double segundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+// Construção, reajustes e consultas com n objetos de raio 0.5, na mesma
+// densidade dos 2000 do começo (lado do cubo cresce com a raiz cúbica de n).
+static void medirEscala(size_t n) {
+    const float lado = 100.0f * std::cbrt((float)n / 2000.0f);
+    std::mt19937 gerador((unsigned)n);
+    std::uniform_real_distribution<float> posicao(-lado * 0.5f, lado * 0.5f);
+    std::uniform_real_distribution<float> unitario(-1.0f, 1.0f);
+    auto pontoAleatorio = [&] { return glm::vec3(posicao(gerador), posicao(gerador), posicao(gerador)); };
+    auto direcaoAleatoria = [&] {
+        glm::vec3 d(unitario(gerador), unitario(gerador), unitario(gerador));
+        return glm::length(d) > 0.01f ? glm::normalize(d) : glm::vec3(0.0f, 0.0f, 1.0f);
+    };
+
+    std::vector<CaixaBVH> caixas(n);
+    for (CaixaBVH& c : caixas) c = CaixaBVH::daEsfera(pontoAleatorio(), 0.5f);
+
+    BVHCena bvh;
+    bvh.construir(caixas);
+    const double construcao = bvh.estatisticas.segundosConstrucao;
+
+    // cada objeto em exatamente uma folha
+    std::vector<uint32_t> vistos(n, 0);
+    for (const NoBVH& no : bvh.nos)
+        for (uint32_t i = 0; i < no.quantidade; i++) vistos[bvh.objetos[no.filhoOuPrimeiro + i]]++;
+    char descricao[96];
+    std::snprintf(descricao, sizeof(descricao), "%zu objetos: cada um numa folha so", n);
+    verificar(std::all_of(vistos.begin(), vistos.end(), [](uint32_t v) { return v == 1; }), descricao);
+
+    // 1% dos objetos andam um pouco: reajuste parcial
+    std::vector<uint32_t> alterados;
+    for (uint32_t i = 0; i < n; i += 100) {
+        glm::vec3 c = caixas[i].centro() + direcaoAleatoria() * 2.0f;
+        caixas[i] = CaixaBVH::daEsfera(c, 0.5f);
+        alterados.push_back(i);
+    }
+    bvh.reajustar(caixas, alterados);
+    const double parcial = bvh.estatisticas.segundosReajuste;
+
+    // todos andam: reajuste completo
+    for (CaixaBVH& c : caixas) c = CaixaBVH::daEsfera(c.centro() + direcaoAleatoria() * 0.5f, 0.5f);
+    bvh.reajustar(caixas);
+    const double completo = bvh.estatisticas.segundosReajuste;
+
+    // consultas; as primeiras de cada tipo também pela força bruta
+    const int consultas = 200, conferidas = 4;
+    std::vector<uint32_t> resultado;
+    bool frustunsIguais = true, raiosIguais = true, esferasIguais = true;
+    double segundosFrustum = 0.0, segundosRaio = 0.0, segundosEsfera = 0.0;
+    size_t visitadosFrustum = 0;
+    for (int q = 0; q < consultas; q++) {
+        glm::vec3 olho = pontoAleatorio();
+        glm::mat4 visao = glm::lookAt(olho, olho + direcaoAleatoria() * 10.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum = Frustum::daMatriz(glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, lado * 0.25f) * visao);
+        auto inicio = std::chrono::steady_clock::now();
+        bvh.recortar(frustum, resultado);
+        segundosFrustum += segundosDesde(inicio);
+        visitadosFrustum += bvh.estatisticas.nosVisitados;
+        if (q < conferidas) {
+            std::sort(resultado.begin(), resultado.end());
+            frustunsIguais = frustunsIguais && resultado == tocamFrustum(caixas, frustum);
+        }
+
+        glm::vec3 direcao = direcaoAleatoria();
+        inicio = std::chrono::steady_clock::now();
+        AcertoRaio acerto = bvh.raio(olho, direcao);
+        segundosRaio += segundosDesde(inicio);
+        if (q < conferidas) {
+            float esperado = primeiraCaixa(caixas, olho, direcao);
+            raiosIguais = raiosIguais && (acerto.objeto < 0 ? esperado == FLT_MAX
+                                                           : std::fabs(acerto.distancia - esperado) <= 1e-3f);
+        }
+
+        inicio = std::chrono::steady_clock::now();
+        bvh.esfera(olho, 5.0f, resultado);
+        segundosEsfera += segundosDesde(inicio);
+        if (q < conferidas) {
+            std::sort(resultado.begin(), resultado.end());
+            esferasIguais = esferasIguais && resultado == tocamEsfera(caixas, olho, 5.0f);
+        }
+    }
+    std::snprintf(descricao, sizeof(descricao), "%zu objetos: frustum, raio e esfera iguais a forca bruta", n);
+    verificar(frustunsIguais && raiosIguais && esferasIguais, descricao);
+
+    std::printf("%8zu objetos  construir %8.2f ms  reajuste completo %7.2f ms  parcial (1%%) %7.3f ms  "
+                "frustum %7.1f us (%zu nos)  raio %5.2f us  esfera %5.2f us\n",
+                n, construcao * 1000.0, completo * 1000.0, parcial * 1000.0, segundosFrustum * 1e6 / consultas,
+                visitadosFrustum / consultas, segundosRaio * 1e6 / consultas, segundosEsfera * 1e6 / consultas);
+}
+
+int main() {
+    std::mt19937 gerador(7);
+    std::uniform_real_distribution<float> posicao(-50.0f, 50.0f);
+
+    std::vector<CaixaBVH> caixas(2000);
+    for (CaixaBVH& c : caixas) c = CaixaBVH::daEsfera(glm::vec3(posicao(gerador), posicao(gerador), posicao(gerador)), 0.5f);
+
+    BVHCena bvh;
+    bvh.construir(caixas);
+    verificar(bvh.degradacao() == 1.0f, "arvore recem-construida com degradacao 1");
+
+    // 100 objetos vão para longe: a árvore piora
+    std::vector<uint32_t> alterados;
+    for (uint32_t i = 0; i < 2000; i += 20) {
+        caixas[i] = CaixaBVH::daEsfera(glm::vec3(posicao(gerador), posicao(gerador), posicao(gerador)) * 1.5f, 0.5f);
+        alterados.push_back(i);
+    }
+    bvh.reajustar(caixas, alterados);
+    float parcial = bvh.degradacao();
+    verificar(parcial > 1.0f, "reajuste parcial atualiza a degradacao");
+
+    std::vector<uint32_t> resultado;
+    bool consultasIguais = true;
+    for (int consulta = 0; consulta < 50; consulta++) {
+        glm::vec3 centro(posicao(gerador), posicao(gerador), posicao(gerador));
+        bvh.esfera(centro, 10.0f, resultado);
+        std::sort(resultado.begin(), resultado.end());
+        if (resultado != tocamEsfera(caixas, centro, 10.0f)) consultasIguais = false;
+    }
+    verificar(consultasIguais, "consultas por esfera iguais a forca bruta depois do reajuste parcial");
+
+    // as mesmas caixas, agora pela passada completa que recalcula o custo do zero
+    bvh.reajustar(caixas);
+    float completo = bvh.degradacao();
+    std::printf("degradacao: parcial %.6f, completo %.6f\n", parcial, completo);
+    verificar(std::fabs(parcial - completo) <= 1e-4f * completo, "custo do reajuste parcial igual ao recalculado");
+
+    // e de volta às posições da construção (aproximadamente): o parcial acompanha a melhora
+    std::mt19937 mesmoGerador(7);
+    std::vector<CaixaBVH> originais(2000);
+    for (CaixaBVH& c : originais)
+        c = CaixaBVH::daEsfera(glm::vec3(posicao(mesmoGerador), posicao(mesmoGerador), posicao(mesmoGerador)), 0.5f);
+    for (uint32_t i : alterados) caixas[i] = originais[i];
+    bvh.reajustar(caixas, alterados);
+    verificar(std::fabs(bvh.degradacao() - 1.0f) <= 1e-4f, "voltar as caixas originais devolve a degradacao a 1");
+
+    for (size_t n : {10000, 100000, 1000000}) medirEscala(n);
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
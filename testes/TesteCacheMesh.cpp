@@ -0,0 +1,174 @@
+// Cache de meshes (CacheMesh.h): a primeira leitura de um OBJ passa pelo
+// parser, otimiza, envia e grava o cache; a segunda só mapeia o cache e envia.
+// As duas têm de mandar para a GPU exatamente os mesmos bytes de vértices e
+// índices, com as mesmas contagens, AABB e quantização, no formato padrão e no
+// compacto. Os tempos das duas leituras são impressos.
+//
+// Roda sem janela nem contexto: as funções do OpenGL que o upload usa são
+// trocadas por versões falsas, e glBufferData guarda uma cópia do que recebe.
+
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CarregadorOBJ.h"
+#include "CacheMesh.h"
+
+// (N+1)^2 vértices e 2 N^2 triângulos
+const int DIVISOES = 300;
+
+namespace falso {
+
+GLuint proximoId = 1;
+std::map<GLenum, GLuint> vinculados;
+std::map<GLuint, std::vector<unsigned char>> conteudo;
+
+void APIENTRY gerar(GLsizei n, GLuint* ids) { for (GLsizei i = 0; i < n; i++) ids[i] = proximoId++; }
+void APIENTRY apagar(GLsizei, const GLuint*) {}
+void APIENTRY vincularBuffer(GLenum alvo, GLuint id) { vinculados[alvo] = id; }
+void APIENTRY vincularVAO(GLuint) {}
+void APIENTRY dadosBuffer(GLenum alvo, GLsizeiptr bytes, const void* dados, GLenum) {
+    std::vector<unsigned char>& c = conteudo[vinculados[alvo]];
+    c.assign((size_t)bytes, 0);
+    if (dados) std::memcpy(c.data(), dados, (size_t)bytes);
+}
+void APIENTRY habilitarAtributo(GLuint) {}
+void APIENTRY ponteiroAtributo(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+void APIENTRY atributo3f(GLuint, GLfloat, GLfloat, GLfloat) {}
+void APIENTRY atributo4f(GLuint, GLfloat, GLfloat, GLfloat, GLfloat) {}
+
+void instalar() {
+    glad_glGenBuffers = gerar;
+    glad_glGenVertexArrays = gerar;
+    glad_glDeleteBuffers = apagar;
+    glad_glDeleteVertexArrays = apagar;
+    glad_glBindBuffer = vincularBuffer;
+    glad_glBindVertexArray = vincularVAO;
+    glad_glBufferData = dadosBuffer;
+    glad_glEnableVertexAttribArray = habilitarAtributo;
+    glad_glVertexAttribPointer = ponteiroAtributo;
+    glad_glVertexAttrib3f = atributo3f;
+    glad_glVertexAttrib4f = atributo4f;
+}
+
+}
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// o que foi para a GPU nos buffers da mesh
+struct Enviado {
+    std::vector<unsigned char> vertices, indices;
+};
+
+static Enviado enviadoPor(const Mesh& mesh) {
+    return {falso::conteudo[mesh.VBO], falso::conteudo[mesh.EBO]};
+}
+
+static bool mesmaMesh(const Mesh& a, const Enviado& enviadoA, const Mesh& b, const Enviado& enviadoB) {
+    return a.numVertices == b.numVertices && a.numIndices == b.numIndices && a.tipoIndice == b.tipoIndice &&
+           a.primitiva == b.primitiva && a.layout.tamanhoVertice == b.layout.tamanhoVertice &&
+           a.limiteMin == b.limiteMin && a.limiteMax == b.limiteMax &&
+           a.quantizacao.origem == b.quantizacao.origem && a.quantizacao.escala == b.quantizacao.escala &&
+           a.quantizacao.normalOctaedrica == b.quantizacao.normalOctaedrica &&
+           enviadoA.vertices == enviadoB.vertices && enviadoA.indices == enviadoB.indices;
+}
+
+static double segundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+int main() {
+    falso::instalar();
+
+    namespace fs = std::filesystem;
+    const fs::path diretorio = fs::temp_directory_path() / "svg-teste-cache-mesh";
+    fs::remove_all(diretorio);
+    fs::create_directories(diretorio);
+    const std::string modelo = (diretorio / "malha.obj").string();
+
+    {
+        std::FILE* f = std::fopen(modelo.c_str(), "w");
+        if (!f) {
+            std::printf("ERRO::TESTE_CACHE::ARQUIVO_NAO_CRIADO: %s\n", modelo.c_str());
+            return EXIT_FAILURE;
+        }
+        const int lado = DIVISOES + 1;
+        for (int j = 0; j < lado; j++)
+            for (int i = 0; i < lado; i++) {
+                float x = (float)i / DIVISOES, z = (float)j / DIVISOES;
+                std::fprintf(f, "v %.6f %.6f %.6f\nvt %.6f %.6f\n", x * 10.0f - 5.0f,
+                             0.5f * std::sin(x * 7.0f) * std::cos(z * 5.0f), z * 10.0f - 5.0f, x, z);
+            }
+        for (int j = 0; j < DIVISOES; j++)
+            for (int i = 0; i < DIVISOES; i++) {
+                int a = j * lado + i + 1, b = a + 1, c = a + lado + 1, d = a + lado;
+                std::fprintf(f, "f %d/%d %d/%d %d/%d %d/%d\n", a, a, b, b, c, c, d, d);
+            }
+        std::fclose(f);
+    }
+
+    const FormatoVertice formatos[2] = {FormatoVertice(), FormatoVertice::compacto()};
+    const char* nomes[2] = {"padrao", "compacto"};
+    for (int f = 0; f < 2; f++) {
+        ParametrosCacheMesh parametros;
+        parametros.formato = formatos[f];
+        const std::string caminhoCache = (diretorio / (std::string("malha.") + nomes[f] + ".cache")).string();
+        std::printf("formato %s\n", nomes[f]);
+
+        // fria: sem cache, lê o OBJ e grava
+        auto inicio = std::chrono::steady_clock::now();
+        OrigemCache origem = OrigemCache::arquivo(modelo, parametros);
+        Mesh semCache;
+        verificar(!carregarCacheMesh(caminhoCache, origem, semCache), "sem cache na primeira leitura");
+        MeshOBJ fria(modelo, parametros.formato, parametros.otimizar);
+        bool gravado = salvarCacheMesh(caminhoCache, origem, fria);
+        double segundosFria = segundosDesde(inicio);
+        verificar(fria.carregado() && gravado, "OBJ lido e cache gravado");
+        Enviado enviadoFria = enviadoPor(fria);
+
+        // quente: só o cache
+        inicio = std::chrono::steady_clock::now();
+        OrigemCache origemQuente = OrigemCache::arquivo(modelo, parametros);
+        Mesh quente;
+        EstatisticasCacheMesh estatisticas;
+        bool acerto = carregarCacheMesh(caminhoCache, origemQuente, quente, &estatisticas);
+        double segundosQuente = segundosDesde(inicio);
+        verificar(acerto && estatisticas.acerto && !estatisticas.hashCalculado, "segunda leitura vem do cache, sem hash");
+        verificar(quente.vertices.empty() && quente.indices.empty(), "mesh do cache sem copia na CPU");
+        verificar(mesmaMesh(fria, enviadoFria, quente, enviadoPor(quente)),
+                  "mesmos bytes, contagens, AABB e quantizacao enviados nas duas leituras");
+        std::printf("fria %.1f ms (OBJ %.1f ms), quente %.1f ms: %.0fx; cache de %.1f MB\n", segundosFria * 1000.0,
+                    fria.estatisticas.segundos * 1000.0, segundosQuente * 1000.0, segundosFria / segundosQuente,
+                    estatisticas.bytes / (1024.0 * 1024.0));
+    }
+
+    // a data muda e o conteúdo não: o hash confirma e o cache continua valendo
+    ParametrosCacheMesh parametros;
+    const std::string caminhoCache = (diretorio / "malha.padrao.cache").string();
+    fs::last_write_time(modelo, fs::last_write_time(modelo) + std::chrono::seconds(5));
+    OrigemCache tocada = OrigemCache::arquivo(modelo, parametros);
+    Mesh mesh;
+    EstatisticasCacheMesh estatisticas;
+    verificar(carregarCacheMesh(caminhoCache, tocada, mesh, &estatisticas) && estatisticas.hashCalculado,
+              "so a data mudou: hash confere e o cache vale");
+
+    // outros parâmetros de montagem não aproveitam o cache
+    parametros.otimizar = false;
+    OrigemCache outra = OrigemCache::arquivo(modelo, parametros);
+    verificar(!carregarCacheMesh(caminhoCache, outra, mesh), "cache de outros parametros refeito");
+
+    fs::remove_all(diretorio);
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
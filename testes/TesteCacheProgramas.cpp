@@ -0,0 +1,172 @@
+// Cache de programas em disco (CacheProgramas.h) com o driver de verdade: as
+// dez variantes de iluminação são criadas com o diretório vazio (compila,
+// linka e grava) e de novo com ele cheio (glProgramBinary), e os dois tempos
+// são impressos (o cache de shaders do Mesa começa vazio, para o frio ser
+// frio). Um arquivo truncado volta a ser compilado e regravado.
+// Antes disso, quatro processos criam as mesmas variantes ao mesmo tempo num
+// diretório comum: cada gravação usa um temporário próprio, então nenhuma
+// falha, nenhum temporário sobra e todas as entradas carregam depois.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Shader.h"
+#include "PermutacoesShader.h"
+
+namespace fs = std::filesystem;
+
+const int PROCESSOS = 4;
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// iluminação ligada com 0 a 4 luzes, por objeto e instanciada
+static std::vector<uint32_t> chaves() {
+    std::vector<uint32_t> c;
+    for (uint32_t recursos : {RECURSO_ILUMINACAO, RECURSO_ILUMINACAO | RECURSO_INSTANCIADO})
+        for (int luzes = 0; luzes <= MAXIMO_LUZES_PONTUAIS; luzes++) c.push_back(chavePermutacao(recursos, luzes));
+    return c;
+}
+
+// Cria todas as variantes; devolve os segundos e deixa as contagens em
+// Shader::estatisticasCache, zeradas antes.
+static double criarVariantes(bool* todasLinkadas = nullptr) {
+    Shader::estatisticasCache = EstatisticasCacheProgramas();
+    std::vector<std::unique_ptr<Shader>> programas;
+    auto inicio = std::chrono::steady_clock::now();
+    for (uint32_t chave : chaves())
+        programas.emplace_back(new Shader("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+                                          definicoesPermutacao(chave)));
+    glFinish();
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    if (todasLinkadas) {
+        *todasLinkadas = true;
+        for (const std::unique_ptr<Shader>& p : programas) {
+            GLint linkado = 0;
+            glGetProgramiv(p->idPrograma, GL_LINK_STATUS, &linkado);
+            *todasLinkadas = *todasLinkadas && linkado;
+        }
+    }
+    return segundos;
+}
+
+static size_t contarArquivos(const fs::path& diretorio, const char* extensao) {
+    size_t n = 0;
+    std::error_code erro;
+    for (const fs::directory_entry& e : fs::directory_iterator(diretorio, erro))
+        if (e.path().extension() == extensao) n++;
+    return n;
+}
+
+// Cada filho abre o próprio contexto e grava no diretório comum; sai com 0
+// se todas as variantes foram compiladas e gravadas.
+static bool gravarEmParalelo(const fs::path& diretorio) {
+    std::vector<pid_t> filhos;
+    for (int p = 0; p < PROCESSOS; p++) {
+        pid_t filho = fork();
+        if (filho == 0) {
+            ContextoHeadless contexto;
+            if (!contexto.iniciar(64, 64)) std::_Exit(TESTE_PULADO);
+            cache::diretorioProgramas = diretorio.string();
+            bool linkadas = false;
+            criarVariantes(&linkadas);
+            const EstatisticasCacheProgramas& e = Shader::estatisticasCache;
+            std::fflush(stdout);
+            std::_Exit(linkadas && e.carregados + e.gravados == chaves().size() ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        if (filho > 0) filhos.push_back(filho);
+    }
+    bool certo = filhos.size() == (size_t)PROCESSOS;
+    for (pid_t filho : filhos) {
+        int status = 0;
+        waitpid(filho, &status, 0);
+        certo = certo && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+    }
+    return certo;
+}
+
+int main() {
+    const fs::path base = fs::temp_directory_path() / "svg-teste-cache-programas";
+    const fs::path comum = base / "comum", proprio = base / "proprio";
+    fs::remove_all(base);
+    fs::create_directories(base / "mesa-filhos");
+    fs::create_directories(base / "mesa");
+
+    // antes de qualquer contexto neste processo: os filhos herdam só a memória
+    setenv("MESA_SHADER_CACHE_DIR", (base / "mesa-filhos").c_str(), 1);
+    const bool paralelo = gravarEmParalelo(comum);
+
+    // o binário de programa do Mesa depende do cache de shaders dele; um
+    // diretório vazio deixa o frio frio sem desligá-lo
+    setenv("MESA_SHADER_CACHE_DIR", (base / "mesa").c_str(), 1);
+
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(64, 64)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        fs::remove_all(base);
+        return TESTE_PULADO;
+    }
+    if (!ExtensoesGL::temBinarioPrograma()) {
+        std::printf("PULADO: driver sem formatos de binario de programa\n");
+        fs::remove_all(base);
+        return TESTE_PULADO;
+    }
+    const size_t variantes = chaves().size();
+
+    verificar(caminhoTemporario("a.bin") != caminhoTemporario("a.bin"), "temporarios diferentes a cada gravacao");
+    verificar(caminhoTemporario("a.bin").find("." + std::to_string(getpid()) + ".") != std::string::npos,
+              "temporario com o pid do processo");
+
+    verificar(paralelo, "4 processos gravando o mesmo cache: todos compilaram e gravaram");
+    verificar(contarArquivos(comum, ".tmp") == 0 && contarArquivos(comum, ".bin") == variantes,
+              "nenhum temporario sobrou, uma entrada por variante");
+    cache::diretorioProgramas = comum.string();
+    criarVariantes();
+    verificar(Shader::estatisticasCache.carregados == variantes, "entradas gravadas em paralelo carregam");
+
+    // frio e quente num diretório só deste processo
+    cache::diretorioProgramas = proprio.string();
+    bool linkadas = false;
+    double frio = criarVariantes(&linkadas);
+    const EstatisticasCacheProgramas antes = Shader::estatisticasCache;
+    verificar(linkadas && antes.compilados == variantes && antes.gravados == variantes,
+              "diretorio vazio: todas compiladas e gravadas");
+    double quente = criarVariantes(&linkadas);
+    const EstatisticasCacheProgramas depois = Shader::estatisticasCache;
+    verificar(linkadas && depois.carregados == variantes && depois.compilados == 0,
+              "diretorio cheio: todas do cache, nenhuma compilada");
+    std::printf("%zu variantes: frio %.1f ms, quente %.1f ms (%.1fx)\n", variantes, frio * 1000.0, quente * 1000.0,
+                frio / quente);
+
+    // uma entrada truncada: mensagem, compila de novo e regrava
+    fs::path truncada;
+    for (const fs::directory_entry& e : fs::directory_iterator(proprio)) truncada = e.path();
+    fs::resize_file(truncada, fs::file_size(truncada) - 1);
+    std::printf("(o ERRO::CACHE_PROGRAMA a seguir e esperado)\n");
+    criarVariantes(&linkadas);
+    const EstatisticasCacheProgramas corrompido = Shader::estatisticasCache;
+    verificar(linkadas && corrompido.carregados == variantes - 1 && corrompido.compilados == 1 &&
+              corrompido.gravados == 1, "entrada truncada: compilada e regravada");
+    criarVariantes();
+    verificar(Shader::estatisticasCache.carregados == variantes, "depois de regravada, carrega");
+    verificar(glGetError() == GL_NO_ERROR, "sem erro de OpenGL");
+
+    fs::remove_all(base);
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
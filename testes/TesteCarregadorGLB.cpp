@@ -0,0 +1,254 @@
+// Importação de glTF binário (CarregadorGLB.h): um .glb pequeno, montado aqui,
+// com uma primitiva que vai direto do BIN para a GPU e três com acessores
+// esparsos. As substituições de sparse.indices/values têm de aparecer nos
+// vértices, também sobre uma base sem bufferView (zeros), e um sparse
+// malformado descarta a primitiva em vez de sumir com o atributo. Depois mede
+// a leitura de uma malha grande: tempo, MB/s, bytes enviados em relação ao
+// arquivo e pico de memória residente de um processo filho (só impressos; o
+// pico inclui as páginas do arquivo mapeado e a cópia do glBufferData falso).
+//
+// Roda sem janela nem contexto: as funções do OpenGL que o upload usa são
+// trocadas por versões falsas, e glBufferData guarda uma cópia do que recebe.
+
+#include <glad/glad.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CarregadorGLB.h"
+
+// malha grande: (N+1)^2 vértices intercalados e 2 N^2 triângulos
+const int DIVISOES = 700;
+
+namespace falso {
+
+GLuint proximoId = 1;
+std::map<GLenum, GLuint> vinculados;
+std::map<GLuint, std::vector<unsigned char>> conteudo;
+
+void APIENTRY gerar(GLsizei n, GLuint* ids) { for (GLsizei i = 0; i < n; i++) ids[i] = proximoId++; }
+void APIENTRY apagar(GLsizei, const GLuint*) {}
+void APIENTRY vincularBuffer(GLenum alvo, GLuint id) { vinculados[alvo] = id; }
+void APIENTRY vincularVAO(GLuint) {}
+void APIENTRY dadosBuffer(GLenum alvo, GLsizeiptr bytes, const void* dados, GLenum) {
+    std::vector<unsigned char>& c = conteudo[vinculados[alvo]];
+    c.assign((size_t)bytes, 0);
+    if (dados) std::memcpy(c.data(), dados, (size_t)bytes);
+}
+void APIENTRY habilitarAtributo(GLuint) {}
+void APIENTRY ponteiroAtributo(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+void APIENTRY atributo3f(GLuint, GLfloat, GLfloat, GLfloat) {}
+void APIENTRY atributo4f(GLuint, GLfloat, GLfloat, GLfloat, GLfloat) {}
+
+void instalar() {
+    glad_glGenBuffers = gerar;
+    glad_glGenVertexArrays = gerar;
+    glad_glDeleteBuffers = apagar;
+    glad_glDeleteVertexArrays = apagar;
+    glad_glBindBuffer = vincularBuffer;
+    glad_glBindVertexArray = vincularVAO;
+    glad_glBufferData = dadosBuffer;
+    glad_glEnableVertexAttribArray = habilitarAtributo;
+    glad_glVertexAttribPointer = ponteiroAtributo;
+    glad_glVertexAttrib3f = atributo3f;
+    glad_glVertexAttrib4f = atributo4f;
+}
+
+}
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// cabeçalho, chunk JSON (completado com espaços) e chunk BIN (com zeros)
+static bool escreverGLB(const std::string& caminho, std::string json, std::vector<unsigned char> bin) {
+    while (json.size() % 4) json += ' ';
+    while (bin.size() % 4) bin.push_back(0);
+    uint32_t cabecalho[3] = {glb::MAGICA, 2, (uint32_t)(12 + 8 + json.size() + 8 + bin.size())};
+    uint32_t chunkJSON[2] = {(uint32_t)json.size(), glb::CHUNK_JSON};
+    uint32_t chunkBIN[2] = {(uint32_t)bin.size(), glb::CHUNK_BIN};
+    std::FILE* f = std::fopen(caminho.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(cabecalho, 12, 1, f) == 1 && std::fwrite(chunkJSON, 8, 1, f) == 1 &&
+              std::fwrite(json.data(), json.size(), 1, f) == 1 && std::fwrite(chunkBIN, 8, 1, f) == 1 &&
+              std::fwrite(bin.data(), bin.size(), 1, f) == 1;
+    return std::fclose(f) == 0 && ok;
+}
+
+template <typename T>
+static size_t anexar(std::vector<unsigned char>& bin, const std::vector<T>& dados) {
+    while (bin.size() % 4) bin.push_back(0);
+    size_t inicio = bin.size();
+    bin.resize(inicio + dados.size() * sizeof(T));
+    std::memcpy(bin.data() + inicio, dados.data(), dados.size() * sizeof(T));
+    return inicio;
+}
+
+static std::string vista(size_t inicio, size_t tamanho, size_t stride = 0) {
+    std::string v = "{\"buffer\":0,\"byteOffset\":" + std::to_string(inicio) + ",\"byteLength\":" + std::to_string(tamanho);
+    if (stride) v += ",\"byteStride\":" + std::to_string(stride);
+    return v + "}";
+}
+
+struct Medida {
+    double segundos = 0.0;
+    size_t bytesEnviados = 0;
+    size_t picoMemoria = 0;   // do processo filho
+};
+
+// Roda a leitura num filho; o resultado volta por um pipe e o pico de
+// memória vem do rusage do filho.
+template <typename F>
+static Medida medirEmFilho(F leitura) {
+    Medida m;
+    int canal[2];
+    if (pipe(canal) != 0) return m;
+    pid_t filho = fork();
+    if (filho == 0) {
+        close(canal[0]);
+        Medida r = leitura();
+        bool escrito = write(canal[1], &r, sizeof(r)) == (ssize_t)sizeof(r);
+        _exit(escrito ? 0 : 1);
+    }
+    close(canal[1]);
+    if (filho < 0 || read(canal[0], &m, sizeof(m)) != (ssize_t)sizeof(m)) m = Medida();
+    close(canal[0]);
+    int estado = 0;
+    struct rusage uso;
+    if (filho > 0 && wait4(filho, &estado, 0, &uso) == filho) m.picoMemoria = (size_t)uso.ru_maxrss * 1024;
+    return m;
+}
+
+int main() {
+    falso::instalar();
+
+    namespace fs = std::filesystem;
+    const fs::path diretorio = fs::temp_directory_path() / "svg-teste-glb";
+    fs::create_directories(diretorio);
+    const std::string pequeno = (diretorio / "esparso.glb").string();
+    const std::string grande = (diretorio / "malha.glb").string();
+
+    // um quadrado; as substituições levam os vértices 1 e 3 para z = 1 e z = 2
+    std::vector<unsigned char> bin;
+    size_t posicoes = anexar(bin, std::vector<glm::vec3>{{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}});
+    size_t normais = anexar(bin, std::vector<glm::vec3>(4, glm::vec3(0, 0, 1)));
+    size_t indices = anexar(bin, std::vector<uint16_t>{0, 1, 2, 2, 3, 0});
+    size_t esparsos = anexar(bin, std::vector<uint8_t>{1, 3});
+    size_t valores = anexar(bin, std::vector<glm::vec3>{{1, 0, 1}, {0, 1, 2}});
+    size_t desordenados = anexar(bin, std::vector<uint8_t>{3, 1});
+
+    const std::string limites = "\"min\":[0,0,0],\"max\":[1,1,2]";
+    const std::string sparse = "\"sparse\":{\"count\":2,\"indices\":{\"bufferView\":3,\"componentType\":5121},"
+                               "\"values\":{\"bufferView\":4}}";
+    std::string json = "{\"asset\":{\"version\":\"2.0\"},\"bufferViews\":[" + vista(posicoes, 48) + "," +
+                       vista(normais, 48) + "," + vista(indices, 12) + "," + vista(esparsos, 2) + "," +
+                       vista(valores, 24) + "," + vista(desordenados, 2) + "],\"accessors\":[" +
+                       // 0 posição, 1 normal, 2 índices
+                       "{\"bufferView\":0,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\"," + limites + "}," +
+                       "{\"bufferView\":1,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\"}," +
+                       "{\"bufferView\":2,\"componentType\":5123,\"count\":6,\"type\":\"SCALAR\"}," +
+                       // 3 posição esparsa sobre o bufferView 0, 4 sobre zeros
+                       "{\"bufferView\":0,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\"," + limites + "," + sparse + "}," +
+                       "{\"componentType\":5126,\"count\":4,\"type\":\"VEC3\"," + limites + "," + sparse + "}," +
+                       // 5 normal com sparse.indices fora de ordem
+                       "{\"bufferView\":1,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\",\"sparse\":{\"count\":2,"
+                       "\"indices\":{\"bufferView\":5,\"componentType\":5121},\"values\":{\"bufferView\":4}}}],"
+                       "\"meshes\":["
+                       "{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1},\"indices\":2}]},"
+                       "{\"primitives\":[{\"attributes\":{\"POSITION\":3,\"NORMAL\":1},\"indices\":2}]},"
+                       "{\"primitives\":[{\"attributes\":{\"POSITION\":4,\"NORMAL\":1},\"indices\":2}]},"
+                       "{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":5},\"indices\":2}]}],"
+                       "\"nodes\":[{\"mesh\":0},{\"mesh\":1},{\"mesh\":2},{\"mesh\":3}],"
+                       "\"scenes\":[{\"nodes\":[0,1,2,3]}],\"scene\":0}";
+    verificar(escreverGLB(pequeno, json, bin), "glb pequeno gravado");
+
+    ModeloGLB modelo(pequeno);
+    verificar(modelo.meshes.size() == 3 && modelo.instancias.size() == 3,
+              "sparse malformado descarta so a primitiva dele");
+    verificar(modelo.estatisticas.primitivasDiretas == 1 && modelo.estatisticas.primitivasReempacotadas == 2,
+              "esparsos vao pelo reempacotamento");
+    if (modelo.meshes.size() == 3) {
+        const Mesh& direta = modelo.meshes[0];
+        const std::vector<unsigned char>& enviado = falso::conteudo[direta.VBO];
+        verificar(enviado.size() == 96 && std::memcmp(enviado.data(), bin.data() + posicoes, 96) == 0,
+                  "primitiva direta envia a faixa do BIN como esta");
+
+        const std::vector<Vertice>& sobreBase = modelo.meshes[1].vertices;
+        verificar(sobreBase.size() == 4 && sobreBase[0].posicao == glm::vec3(0, 0, 0) &&
+                      sobreBase[1].posicao == glm::vec3(1, 0, 1) && sobreBase[2].posicao == glm::vec3(1, 1, 0) &&
+                      sobreBase[3].posicao == glm::vec3(0, 1, 2),
+                  "sparse.values substitui os vertices de sparse.indices sobre o bufferView");
+        const std::vector<Vertice>& sobreZeros = modelo.meshes[2].vertices;
+        verificar(sobreZeros.size() == 4 && sobreZeros[0].posicao == glm::vec3(0) &&
+                      sobreZeros[1].posicao == glm::vec3(1, 0, 1) && sobreZeros[2].posicao == glm::vec3(0) &&
+                      sobreZeros[3].posicao == glm::vec3(0, 1, 2),
+                  "sem bufferView a base e zeros e as substituicoes valem");
+    }
+
+    // malha grande intercalada (posição, normal, UV) com índices de 32 bits
+    {
+        const int lado = DIVISOES + 1;
+        std::vector<Vertice> vertices((size_t)lado * lado);
+        for (int j = 0; j < lado; j++)
+            for (int i = 0; i < lado; i++) {
+                float x = (float)i / DIVISOES, z = (float)j / DIVISOES;
+                vertices[(size_t)j * lado + i] = {glm::vec3(x, 0.1f * std::sin(x * 9.0f), z), glm::vec3(0, 1, 0),
+                                                  glm::vec2(x, z)};
+            }
+        std::vector<uint32_t> triangulos;
+        triangulos.reserve((size_t)DIVISOES * DIVISOES * 6);
+        for (int j = 0; j < DIVISOES; j++)
+            for (int i = 0; i < DIVISOES; i++) {
+                uint32_t a = j * lado + i, b = a + 1, c = a + lado + 1, d = a + lado;
+                triangulos.insert(triangulos.end(), {a, b, c, c, d, a});
+            }
+        std::vector<unsigned char> binGrande;
+        size_t inicioVertices = anexar(binGrande, vertices);
+        size_t inicioIndices = anexar(binGrande, triangulos);
+        const std::string n = std::to_string(vertices.size());
+        std::string jsonGrande =
+            "{\"asset\":{\"version\":\"2.0\"},\"bufferViews\":[" +
+            vista(inicioVertices, vertices.size() * sizeof(Vertice), sizeof(Vertice)) + "," +
+            vista(inicioIndices, triangulos.size() * 4) + "],\"accessors\":[" +
+            "{\"bufferView\":0,\"byteOffset\":0,\"componentType\":5126,\"count\":" + n +
+            ",\"type\":\"VEC3\",\"min\":[0,-0.1,0],\"max\":[1,0.1,1]}," +
+            "{\"bufferView\":0,\"byteOffset\":12,\"componentType\":5126,\"count\":" + n + ",\"type\":\"VEC3\"}," +
+            "{\"bufferView\":0,\"byteOffset\":24,\"componentType\":5126,\"count\":" + n + ",\"type\":\"VEC2\"}," +
+            "{\"bufferView\":1,\"componentType\":5125,\"count\":" + std::to_string(triangulos.size()) +
+            ",\"type\":\"SCALAR\"}],\"meshes\":[{\"primitives\":[{\"attributes\":"
+            "{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],\"nodes\":[{\"mesh\":0}]}";
+        verificar(escreverGLB(grande, jsonGrande, binGrande), "glb grande gravado");
+    }
+    const double megabytes = fs::file_size(grande) / (1024.0 * 1024.0);
+
+    Medida base = medirEmFilho([] { return Medida(); });
+    Medida leitura = medirEmFilho([&] {
+        ModeloGLB m(grande);
+        Medida r;
+        r.segundos = m.estatisticas.segundos;
+        r.bytesEnviados = m.carregado() && m.estatisticas.primitivasDiretas == 1 ? m.estatisticas.bytesEnviados : 0;
+        return r;
+    });
+    double proporcao = leitura.bytesEnviados / (megabytes * 1024.0 * 1024.0);
+    verificar(leitura.bytesEnviados > 0, "malha grande enviada direto do mapeamento");
+    verificar(proporcao > 0.99 && proporcao <= 1.0, "bytes enviados ~ tamanho do arquivo");
+    std::printf("arquivo: %.1f MB, %zu triangulos\n", megabytes, (size_t)DIVISOES * DIVISOES * 2);
+    std::printf("leitura: %.1f ms, %.0f MB/s; enviados %.3f do arquivo; pico %.1f MB (%+.1f MB sobre o processo vazio)\n",
+                leitura.segundos * 1000.0, megabytes / leitura.segundos, proporcao,
+                leitura.picoMemoria / (1024.0 * 1024.0),
+                ((double)leitura.picoMemoria - (double)base.picoMemoria) / (1024.0 * 1024.0));
+
+    fs::remove_all(diretorio);
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
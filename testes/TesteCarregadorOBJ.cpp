@@ -0,0 +1,192 @@
+// Leitura de OBJ (CarregadorOBJ.h) contra um parser ingênuo com std::ifstream:
+// a mesma malha de quadriláteros, gerada num arquivo temporário, tem de sair
+// com os mesmos triângulos, posições, normais e UVs pelos dois caminhos. Cada
+// leitura roda num processo filho, para medir o MB/s e o pico de memória
+// residente (wait4) de cada uma sem que uma herde a memória da outra; os
+// números são só impressos, já que dependem da máquina. Índices negativos
+// são conferidos num arquivo pequeno à parte. Não usa OpenGL.
+
+#include <glad/glad.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "CarregadorOBJ.h"
+
+// (N+1)^2 vértices e N^2 quadriláteros, ~40 MB de texto
+const int DIVISOES = 500;
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// O leitor de tutorial: getline, istringstream e um Vertice por canto, sem
+// deduplicar. Os índices ficam 0, 1, 2, ... na ordem dos cantos.
+static bool carregarIngenuo(const std::string& caminho, std::vector<Vertice>& vertices) {
+    std::ifstream arquivo(caminho);
+    if (!arquivo) return false;
+    std::vector<glm::vec3> posicoes, normais;
+    std::vector<glm::vec2> uvs;
+    std::string linha, tipo, canto;
+    while (std::getline(arquivo, linha)) {
+        std::istringstream leitor(linha);
+        leitor >> tipo;
+        if (tipo == "v") {
+            glm::vec3 p;
+            leitor >> p.x >> p.y >> p.z;
+            posicoes.push_back(p);
+        } else if (tipo == "vn") {
+            glm::vec3 n;
+            leitor >> n.x >> n.y >> n.z;
+            normais.push_back(n);
+        } else if (tipo == "vt") {
+            glm::vec2 t;
+            leitor >> t.x >> t.y;
+            uvs.push_back(t);
+        } else if (tipo == "f") {
+            std::vector<Vertice> poligono;
+            while (leitor >> canto) {
+                int v = 0, t = 0, n = 0;
+                if (std::sscanf(canto.c_str(), "%d/%d/%d", &v, &t, &n) != 3) return false;
+                poligono.push_back({posicoes[v - 1], normais[n - 1], uvs[t - 1]});
+            }
+            for (size_t k = 1; k + 1 < poligono.size(); k++)
+                vertices.insert(vertices.end(), {poligono[0], poligono[k], poligono[k + 1]});
+        }
+    }
+    return true;
+}
+
+struct Medida {
+    double segundos = 0.0;
+    size_t cantos = 0;
+    size_t picoMemoria = 0;   // do processo filho
+};
+
+// Roda a leitura num filho; o tempo e o número de cantos voltam por um pipe e
+// o pico de memória vem do rusage do filho.
+template <typename F>
+static Medida medirEmFilho(F leitura) {
+    Medida m;
+    int canal[2];
+    if (pipe(canal) != 0) return m;
+    pid_t filho = fork();
+    if (filho == 0) {
+        close(canal[0]);
+        auto inicio = std::chrono::steady_clock::now();
+        Medida r;
+        r.cantos = leitura();
+        r.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        bool escrito = write(canal[1], &r, sizeof(r)) == (ssize_t)sizeof(r);
+        _exit(escrito ? 0 : 1);
+    }
+    close(canal[1]);
+    if (filho < 0 || read(canal[0], &m, sizeof(m)) != (ssize_t)sizeof(m)) m = Medida();
+    close(canal[0]);
+    int estado = 0;
+    struct rusage uso;
+    if (filho > 0 && wait4(filho, &estado, 0, &uso) == filho) m.picoMemoria = (size_t)uso.ru_maxrss * 1024;
+    return m;
+}
+
+int main() {
+    namespace fs = std::filesystem;
+    const fs::path diretorio = fs::temp_directory_path() / "svg-teste-obj";
+    fs::create_directories(diretorio);
+    const std::string malha = (diretorio / "malha.obj").string();
+    const std::string relativa = (diretorio / "relativa.obj").string();
+
+    {
+        std::FILE* f = std::fopen(malha.c_str(), "w");
+        if (!f) {
+            std::printf("ERRO::TESTE_OBJ::ARQUIVO_NAO_CRIADO: %s\n", malha.c_str());
+            return EXIT_FAILURE;
+        }
+        const int lado = DIVISOES + 1;
+        for (int j = 0; j < lado; j++)
+            for (int i = 0; i < lado; i++) {
+                float x = (float)i / DIVISOES, z = (float)j / DIVISOES;
+                std::fprintf(f, "v %.6f %.6f %.6f\n", x * 10.0f - 5.0f, 0.25f * std::sin(x * 12.0f) * std::cos(z * 9.0f),
+                             z * 10.0f - 5.0f);
+                std::fprintf(f, "vt %.6f %.6f\n", x, z);
+                std::fprintf(f, "vn %.6f %.6f %.6f\n", 0.0f, 1.0f, 0.0f);
+            }
+        for (int j = 0; j < DIVISOES; j++)
+            for (int i = 0; i < DIVISOES; i++) {
+                int a = j * lado + i + 1, b = a + 1, c = a + lado + 1, d = a + lado;
+                std::fprintf(f, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, b, b, b, c, c, c, d, d, d);
+            }
+        std::fclose(f);
+    }
+    const double megabytes = fs::file_size(malha) / (1024.0 * 1024.0);
+
+    // tempo e pico de memória, cada leitura no seu processo; antes das
+    // comparações, para o processo pai ainda estar pequeno quando for copiado
+    Medida base = medirEmFilho([] { return size_t(0); });
+    Medida rapido = medirEmFilho([&] {
+        std::vector<Vertice> v;
+        std::vector<GLuint> i;
+        return carregarOBJ(malha, v, i) ? i.size() : 0;
+    });
+    Medida ingenuo = medirEmFilho([&] {
+        std::vector<Vertice> v;
+        return carregarIngenuo(malha, v) ? v.size() : 0;
+    });
+    verificar(rapido.cantos == ingenuo.cantos && rapido.cantos > 0, "as duas leituras medidas terminaram");
+
+    // os mesmos triângulos pelos dois caminhos
+    std::vector<Vertice> vertices, ingenuos;
+    std::vector<GLuint> indices;
+    EstatisticasOBJ estatisticas;
+    verificar(carregarOBJ(malha, vertices, indices, &estatisticas), "malha lida pelo CarregadorOBJ");
+    verificar(carregarIngenuo(malha, ingenuos), "malha lida pelo parser ingenuo");
+    verificar(indices.size() == (size_t)DIVISOES * DIVISOES * 6 && indices.size() == ingenuos.size(),
+              "dois triangulos por quadrilatero nos dois");
+    verificar(vertices.size() == (size_t)(DIVISOES + 1) * (DIVISOES + 1), "cantos repetidos deduplicados");
+    bool iguais = indices.size() == ingenuos.size();
+    for (size_t i = 0; iguais && i < indices.size(); i++) {
+        const Vertice& a = vertices[indices[i]];
+        const Vertice& b = ingenuos[i];
+        iguais = a.posicao == b.posicao && a.normal == b.normal && a.coordTextura == b.coordTextura;
+    }
+    verificar(iguais, "mesma posicao, normal e UV em cada canto de cada triangulo");
+    std::vector<Vertice>().swap(vertices);
+    std::vector<GLuint>().swap(indices);
+    std::vector<Vertice>().swap(ingenuos);
+
+    // índices negativos contam a partir do fim do que já foi lido
+    {
+        std::ofstream f(relativa);
+        f << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf -4 -3 -2 -1\nv 2 0 0\nf 2 -1 3\n";
+    }
+    verificar(carregarOBJ(relativa, vertices, indices) && indices.size() == 9 &&
+                  vertices[indices[7]].posicao == glm::vec3(2.0f, 0.0f, 0.0f) &&
+                  vertices[indices[2]].posicao == glm::vec3(1.0f, 1.0f, 0.0f),
+              "indices negativos resolvidos");
+
+    auto imprimir = [&](const char* nome, const Medida& m) {
+        std::printf("%-14s %7.1f MB/s  %7.3f s  pico %6.1f MB (%+.1f MB sobre o processo vazio)\n", nome,
+                    megabytes / m.segundos, m.segundos, m.picoMemoria / (1024.0 * 1024.0),
+                    ((double)m.picoMemoria - (double)base.picoMemoria) / (1024.0 * 1024.0));
+    };
+    std::printf("arquivo: %.1f MB, %zu triangulos, %u thread(s)\n", megabytes, (size_t)DIVISOES * DIVISOES * 2,
+                estatisticas.threads);
+    imprimir("CarregadorOBJ", rapido);
+    imprimir("ifstream", ingenuo);
+    std::printf("CarregadorOBJ %.1fx mais rapido\n", ingenuo.segundos / rapido.segundos);
+
+    fs::remove_all(diretorio);
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,367 @@
+// Descarte na GPU (DescarteGPU.h) num contexto sem janela: uma cena fixa de
+// esferas e um oclusor conhecido, conferidos contra o Frustum e a
+// OclusaoSoftware da CPU. Cobre a pirâmide Hi-Z com tamanhos ímpares, os
+// contadores em dois buffers alternados (lidos dois quadros depois, com as
+// instâncias de cada nível), as faixas de cada nível em visiveis[]
+// (instanciaBase = nível * capacidade) e o desenho pelo
+// lightingVertDescarteGPU.glsl.
+//
+// Sem EGL ou sem OpenGL 4.3 o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "DescarteGPU.h"
+#include "OclusaoSoftware.h"
+#include "BlocosUniform.h"
+#include "PermutacoesShader.h"
+
+// ímpares nos dois eixos: todo nível da pirâmide dobra uma linha e uma coluna
+const int LARGURA = 317;
+const int ALTURA = 179;
+const float FOV = 60.0f;
+const size_t NUM_OBJETOS = 3000;
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+struct Objeto {
+    glm::mat4 modelo;
+    float escala;
+    glm::vec3 minimo, maximo;   // AABB em espaço de mundo, como no compute shader
+    bool foraFrustum = false, ambiguoFrustum = false;
+    bool oculto = false;        // inteiro atrás do oclusor, pela geometria
+    int nivel = -1;             // LOD esperado; -1 se ficar perto de um limiar
+};
+
+struct NivelPiramide {
+    int largura, altura;
+    std::vector<float> texels;
+};
+
+// O teste de descarteHiZCompute.glsl, na CPU, sobre a pirâmide lida de volta
+static bool ocultoNaPiramide(const Objeto& o, const glm::mat4& projecaoVisao, const std::vector<NivelPiramide>& piramide) {
+    float minimoX = 1.0f, minimoY = 1.0f, maximoX = 0.0f, maximoY = 0.0f, maisPerto = 1.0f;
+    for (int c = 0; c < 8; c++) {
+        glm::vec3 canto((c & 1) ? o.maximo.x : o.minimo.x, (c & 2) ? o.maximo.y : o.minimo.y,
+                        (c & 4) ? o.maximo.z : o.minimo.z);
+        glm::vec4 clip = projecaoVisao * glm::vec4(canto, 1.0f);
+        if (clip.w < 1e-4f) return false;
+        float x = clip.x / clip.w * 0.5f + 0.5f, y = clip.y / clip.w * 0.5f + 0.5f;
+        minimoX = std::min(minimoX, x);
+        minimoY = std::min(minimoY, y);
+        maximoX = std::max(maximoX, x);
+        maximoY = std::max(maximoY, y);
+        maisPerto = std::min(maisPerto, clip.z / clip.w * 0.5f + 0.5f);
+    }
+    if (maximoX < 0.0f || maximoY < 0.0f || minimoX > 1.0f || minimoY > 1.0f) return false;
+
+    auto texel = [](float t, int tamanho) { return std::clamp((int)(std::clamp(t, 0.0f, 1.0f) * tamanho), 0, tamanho - 1); };
+    int ax = texel(minimoX, LARGURA), ay = texel(minimoY, ALTURA);
+    int bx = texel(maximoX, LARGURA), by = texel(maximoY, ALTURA);
+    const int niveis = (int)piramide.size();
+    int nivel = std::clamp((int)std::ceil(std::log2((float)(std::max(bx - ax, by - ay) + 1))) - 1, 0, niveis - 1);
+    int tax, tay, tbx, tby;
+    while (true) {
+        const NivelPiramide& p = piramide[nivel];
+        tax = std::min(ax >> (nivel + 1), p.largura - 1);
+        tay = std::min(ay >> (nivel + 1), p.altura - 1);
+        tbx = std::min(bx >> (nivel + 1), p.largura - 1);
+        tby = std::min(by >> (nivel + 1), p.altura - 1);
+        if ((tbx - tax <= 1 && tby - tay <= 1) || nivel == niveis - 1) break;
+        nivel++;
+    }
+    float maisDistante = 0.0f;
+    for (int y = tay; y <= tby; y++)
+        for (int x = tax; x <= tbx; x++)
+            maisDistante = std::max(maisDistante, piramide[nivel].texels[(size_t)y * piramide[nivel].largura + x]);
+    return maisPerto > maisDistante;
+}
+
+template <typename T>
+static std::vector<T> lerBuffer(GLuint buffer, size_t quantidade) {
+    std::vector<T> dados(quantidade);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, quantidade * sizeof(T), dados.data());
+    return dados;
+}
+
+// objetos visíveis de um recortar(), lidos das faixas de cada nível
+static std::vector<int> lerVisiveis(const DescarteGPU& descarte, bool& faixasCertas) {
+    std::vector<int> nivelDe(NUM_OBJETOS, -1);
+    std::vector<ComandoDesenhoIndireto> comandos =
+        lerBuffer<ComandoDesenhoIndireto>(descarte.bufferComandosGPU(), (size_t)descarte.niveisLOD());
+    std::vector<GLuint> visiveis =
+        lerBuffer<GLuint>(descarte.bufferVisiveisGPU(), descarte.capacidadeNivel() * DescarteGPU::MAXIMO_NIVEIS_LOD);
+
+    faixasCertas = true;
+    for (int n = 0; n < descarte.niveisLOD(); n++) {
+        const ComandoDesenhoIndireto& c = comandos[n];
+        if (c.instanciaBase != n * descarte.capacidadeNivel() || c.numInstancias > descarte.capacidadeNivel()) {
+            faixasCertas = false;
+            continue;
+        }
+        for (GLuint k = 0; k < c.numInstancias; k++) {
+            GLuint objeto = visiveis[c.instanciaBase + k];
+            if (objeto >= NUM_OBJETOS || nivelDe[objeto] != -1) faixasCertas = false;
+            else nivelDe[objeto] = n;
+        }
+    }
+    return nivelDe;
+}
+
+int main() {
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(LARGURA, ALTURA)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    if (!ExtensoesGL::temComputacao()) {
+        std::printf("PULADO: contexto sem OpenGL 4.3\n");
+        return TESTE_PULADO;
+    }
+    cache::diretorioProgramas = (std::filesystem::temp_directory_path() / "svg-teste-descarte-gpu").string();
+
+    DescarteGPU descarte;
+    verificar(descarte.iniciar(), "compute shaders compilados");
+
+    const float pixelsMinimos[3] = {40.0f, 12.0f, 0.0f};
+    GrupoLOD lod = GrupoLOD::esfera(0.5f, {{24, 12, pixelsMinimos[0]}, {12, 6, pixelsMinimos[1]}, {6, 4, 0.0f}});
+
+    // câmera na origem olhando para -z; oclusor de 4x4 em z = -5
+    glm::mat4 projecao = glm::perspective(glm::radians(FOV), (float)LARGURA / ALTURA, 0.1f, 100.0f);
+    glm::mat4 visao = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projecaoVisao = projecao * visao;
+    Frustum frustum = Frustum::daMatriz(projecaoVisao);
+
+    std::mt19937 gerador(19);
+    std::uniform_real_distribution<float> lateral(-16.0f, 16.0f), profundidade(-60.0f, 8.0f), escala(0.5f, 2.0f);
+    std::vector<Objeto> objetos(NUM_OBJETOS);
+    std::vector<glm::mat4> modelos(NUM_OBJETOS);
+    const Mesh& base = lod.niveis[0];
+    for (size_t i = 0; i < NUM_OBJETOS; i++) {
+        Objeto& o = objetos[i];
+        o.escala = escala(gerador);
+        o.modelo = glm::scale(glm::translate(glm::mat4(1.0f),
+                                             glm::vec3(lateral(gerador), lateral(gerador) * 0.6f, profundidade(gerador))),
+                              glm::vec3(o.escala));
+        modelos[i] = o.modelo;
+
+        glm::vec3 centro, extensao;
+        Frustum::transformarCaixa(base.limiteMin, base.limiteMax, o.modelo, centro, extensao);
+        o.minimo = centro - extensao;
+        o.maximo = centro + extensao;
+
+        float folga = 1e30f;
+        for (const glm::vec4& p : frustum.planos)
+            folga = std::min(folga, glm::dot(glm::vec3(p), centro) + p.w + glm::dot(glm::abs(glm::vec3(p)), extensao));
+        o.foraFrustum = folga < 0.0f;
+        o.ambiguoFrustum = std::fabs(folga) < 1e-3f;
+
+        // atrás do plano do oclusor e projetado dentro dele (|x|, |y| <= 2 em z = -5)
+        o.oculto = o.maximo.z < -5.0f;
+        for (int c = 0; c < 8 && o.oculto; c++) {
+            glm::vec3 canto((c & 1) ? o.maximo.x : o.minimo.x, (c & 2) ? o.maximo.y : o.minimo.y,
+                            (c & 4) ? o.maximo.z : o.minimo.z);
+            o.oculto = std::fabs(canto.x / -canto.z) <= 0.4f && std::fabs(canto.y / -canto.z) <= 0.4f;
+        }
+
+        float pixels = lod.tamanhoProjetado(o.modelo, o.escala, glm::vec3(0.0f), FOV, (float)ALTURA);
+        bool perto = false;
+        for (int n = 0; n < 2; n++) perto = perto || std::fabs(pixels - pixelsMinimos[n]) < 1e-3f * pixelsMinimos[n];
+        int anterior = -1;
+        if (!perto) o.nivel = lod.selecionar(pixels, anterior);
+    }
+
+    BufferInstancias entrada;
+    entrada.escalaUniforme = true;
+    entrada.atualizar(modelos, {});
+
+    // o oclusor entra só na profundidade: um glClear com tesoura na
+    // profundidade do plano z = -5, arredondada para dentro do quadrado
+    glm::vec4 clip = projecaoVisao * glm::vec4(0.0f, 0.0f, -5.0f, 1.0f);
+    float profundidadeOclusor = clip.z / clip.w * 0.5f + 0.5f;
+    auto pixelX = [&](float x) { return ((projecao[0][0] * x / 5.0f) * 0.5f + 0.5f) * LARGURA; };
+    auto pixelY = [&](float y) { return ((projecao[1][1] * y / 5.0f) * 0.5f + 0.5f) * ALTURA; };
+    int x0 = (int)std::ceil(pixelX(-2.0f)), x1 = (int)std::floor(pixelX(2.0f));
+    int y0 = (int)std::ceil(pixelY(-2.0f)), y1 = (int)std::floor(pixelY(2.0f));
+
+    glEnable(GL_DEPTH_TEST);
+    glClearDepth(1.0);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x0, y0, x1 - x0, y1 - y0);
+    glClearDepth(profundidadeOclusor);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+    glClearDepth(1.0);
+
+    std::vector<float> profundidadeTela((size_t)LARGURA * ALTURA);
+    glReadPixels(0, 0, LARGURA, ALTURA, GL_DEPTH_COMPONENT, GL_FLOAT, profundidadeTela.data());
+
+    // quadro A: sem pirâmide, só o frustum
+    descarte.recortar(lod, entrada, projecao, visao, glm::vec3(0.0f), FOV, (float)ALTURA);
+    bool faixasA = false;
+    std::vector<int> nivelA = lerVisiveis(descarte, faixasA);
+    verificar(faixasA, "faixas por nivel com instanciaBase = nivel * capacidade, sem repeticao");
+
+    size_t visiveisA = 0, foraA = 0, diferencasFrustum = 0, diferencasNivel = 0;
+    for (size_t i = 0; i < NUM_OBJETOS; i++) {
+        const Objeto& o = objetos[i];
+        bool visivel = nivelA[i] >= 0;
+        visiveisA += visivel;
+        foraA += !visivel;
+        if (visivel == o.foraFrustum && !o.ambiguoFrustum) diferencasFrustum++;
+        if (visivel && o.nivel >= 0 && nivelA[i] != o.nivel) diferencasNivel++;
+    }
+    std::printf("quadro A: %zu visiveis, %zu fora do frustum\n", visiveisA, foraA);
+    verificar(diferencasFrustum == 0, "frustum na GPU igual ao Frustum da CPU");
+    verificar(diferencasNivel == 0, "nivel de LOD igual ao do GrupoLOD (sem histerese)");
+
+    // pirâmide: o texel t da tela cai em min(t >> (n + 1), tamanho - 1) no
+    // nível n, e esse texel não pode estar mais perto que ele
+    descarte.capturarProfundidade(LARGURA, ALTURA, projecaoVisao);
+    verificar(glGetError() == GL_NO_ERROR, "copia da profundidade e reducao sem erro de OpenGL");
+    bool piramideConservadora = descarte.niveisPiramide() > 0;
+    bool tamanhosCertos = true;
+    int larguraEsperada = LARGURA, alturaEsperada = ALTURA;
+    std::vector<NivelPiramide> piramide(descarte.niveisPiramide());
+    glBindTexture(GL_TEXTURE_2D, descarte.texturaHiZ());
+    for (int n = 0; n < descarte.niveisPiramide(); n++) {
+        NivelPiramide& p = piramide[n];
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, n, GL_TEXTURE_WIDTH, &p.largura);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, n, GL_TEXTURE_HEIGHT, &p.altura);
+        larguraEsperada = std::max(1, larguraEsperada / 2);
+        alturaEsperada = std::max(1, alturaEsperada / 2);
+        if (p.largura != larguraEsperada || p.altura != alturaEsperada) tamanhosCertos = false;
+
+        p.texels.resize((size_t)p.largura * p.altura);
+        glGetTexImage(GL_TEXTURE_2D, n, GL_RED, GL_FLOAT, p.texels.data());
+        for (int y = 0; y < ALTURA && piramideConservadora; y++)
+            for (int x = 0; x < LARGURA; x++) {
+                int tx = std::min(x >> (n + 1), p.largura - 1), ty = std::min(y >> (n + 1), p.altura - 1);
+                if (p.texels[(size_t)ty * p.largura + tx] < profundidadeTela[(size_t)y * LARGURA + x]) {
+                    piramideConservadora = false;
+                    break;
+                }
+            }
+    }
+    std::printf("piramide: %d niveis a partir de %dx%d\n", descarte.niveisPiramide(), LARGURA / 2, ALTURA / 2);
+    verificar(tamanhosCertos && larguraEsperada == 1 && alturaEsperada == 1, "niveis com metade do anterior ate 1x1");
+    verificar(piramideConservadora, "cada texel da piramide cobre os da tela, inclusive a linha e a coluna impares");
+
+    // quadro B: com a pirâmide
+    descarte.recortar(lod, entrada, projecao, visao, glm::vec3(0.0f), FOV, (float)ALTURA);
+    bool faixasB = false;
+    std::vector<int> nivelB = lerVisiveis(descarte, faixasB);
+    size_t visiveisB = 0, ocultosB = 0, ocultosErrados = 0, diferencasPiramide = 0;
+    for (size_t i = 0; i < NUM_OBJETOS; i++) {
+        if (nivelB[i] >= 0) {
+            visiveisB++;
+        } else if (nivelA[i] >= 0) {
+            ocultosB++;
+            if (!objetos[i].oculto) ocultosErrados++;
+        }
+        if (nivelA[i] >= 0 && (nivelB[i] < 0) != ocultoNaPiramide(objetos[i], projecaoVisao, piramide))
+            diferencasPiramide++;
+    }
+    verificar(faixasB, "faixas certas com a piramide");
+    verificar(ocultosErrados == 0, "nada descartado pela piramide sem estar atras do oclusor");
+    verificar(diferencasPiramide == 0, "mesmos ocultos que o teste do shader refeito na CPU sobre a piramide");
+
+    // a mesma cena pela oclusão na CPU, entre os que passaram pelo frustum
+    const glm::vec3 quadrado[4] = {{-2.0f, -2.0f, -5.0f}, {2.0f, -2.0f, -5.0f}, {2.0f, 2.0f, -5.0f}, {-2.0f, 2.0f, -5.0f}};
+    const uint32_t indicesQuadrado[6] = {0, 1, 2, 2, 3, 0};
+    OclusaoSoftware oclusao;
+    oclusao.iniciar(projecaoVisao);
+    oclusao.adicionarOclusor(quadrado, sizeof(glm::vec3), 4, indicesQuadrado, 6, glm::mat4(1.0f));
+    oclusao.rasterizar();
+    std::vector<glm::vec3> minimos, maximos;
+    for (size_t i = 0; i < NUM_OBJETOS; i++)
+        if (nivelA[i] >= 0) {
+            minimos.push_back(objetos[i].minimo);
+            maximos.push_back(objetos[i].maximo);
+        }
+    std::vector<uint8_t> naoOcultos(minimos.size());
+    oclusao.testarLote(minimos.data(), maximos.data(), minimos.size(), naoOcultos.data());
+    size_t ocultosCPU = oclusao.estatisticas.rejeitados, ocultosGeometria = 0, ocultosErradosCPU = 0;
+    for (size_t i = 0, k = 0; i < NUM_OBJETOS; i++) {
+        if (nivelA[i] < 0) continue;
+        ocultosGeometria += objetos[i].oculto;
+        ocultosErradosCPU += !naoOcultos[k++] && !objetos[i].oculto;
+    }
+    verificar(ocultosErradosCPU == 0, "nada descartado pela CPU sem estar atras do oclusor");
+    std::printf("ocultos: GPU %zu, CPU %zu, pela geometria %zu (de %zu no frustum)\n", ocultosB, ocultosCPU,
+                ocultosGeometria, visiveisA);
+    // as duas perdem objetos na borda do oclusor; a pirâmide mais, por testar 2x2 texels de um nível grosso
+    verificar(ocultosB > 0 && ocultosB * 10 >= ocultosCPU * 8, "GPU descarta pelo menos 80% do que a CPU descarta");
+
+    // contadores: cada leitura é a do quadro retrasado, zerada depois de lida;
+    // as instâncias por nível são as que as faixas daquele quadro tinham
+    auto porNivel = [&](const std::vector<int>& nivel) {
+        std::vector<GLuint> contagem(descarte.niveisLOD(), 0);
+        for (int n : nivel)
+            if (n >= 0) contagem[n]++;
+        return contagem;
+    };
+    descarte.recortar(lod, entrada, projecao, visao, glm::vec3(0.0f), FOV, (float)ALTURA);
+    const EstatisticasDescarteGPU& e = descarte.estatisticas;
+    verificar(e.visiveis == visiveisA && e.foraFrustum == foraA && e.ocultos == 0,
+              "quadro C le os contadores do quadro A");
+    verificar(e.visiveisPorNivel == porNivel(nivelA), "quadro C le as instancias por nivel do quadro A");
+    descarte.recortar(lod, entrada, projecao, visao, glm::vec3(0.0f), FOV, (float)ALTURA);
+    verificar(e.visiveis == visiveisB && e.foraFrustum == foraA && e.ocultos == ocultosB,
+              "quadro D le os contadores do quadro B");
+    verificar(e.visiveisPorNivel == porNivel(nivelB), "quadro D le as instancias por nivel do quadro B");
+    descarte.recortar(lod, entrada, projecao, visao, glm::vec3(0.0f), FOV, (float)ALTURA);
+    verificar(e.visiveis == visiveisB && e.ocultos == ocultosB && e.testados() == NUM_OBJETOS,
+              "quadro E le o C, sem somar o A (contador zerado)");
+
+    // desenho com os comandos do quadro E, pelo programa da cena
+    Shader programa("shaders/lightingVertDescarteGPU.glsl", "shaders/lightingFrag.glsl",
+                    definicoesPermutacao(chavePermutacao(RECURSO_ILUMINACAO | RECURSO_INSTANCIADO, 0)));
+    blocos::vincular(programa);
+    BufferUniform<BlocoCamera> uboCamera;
+    BufferUniform<BlocoLuzes> uboLuzes;
+    BufferUniform<BlocoMateriais> uboMateriais;
+    uboCamera.iniciar(PONTO_BLOCO_CAMERA);
+    uboLuzes.iniciar(PONTO_BLOCO_LUZES);
+    uboMateriais.iniciar(PONTO_BLOCO_MATERIAIS);
+    BlocoCamera camera = {projecao, visao, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f), projecaoVisao};
+    uboCamera.enviar(camera);
+    BlocoLuzes luzes = {};
+    luzes.luzDirecional.ambiente = glm::vec3(1.0f);
+    uboLuzes.enviar(luzes);
+    BlocoMateriais materiais = {};
+    for (MaterialStd140& m : materiais.materiais) m.ambiente = glm::vec3(1.0f);
+    uboMateriais.enviar(materiais);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    programa.usar();
+    descarte.desenhar(lod, entrada);
+    verificar(glGetError() == GL_NO_ERROR, "glMultiDrawElementsIndirect sem erro de OpenGL");
+
+    std::vector<unsigned char> cor((size_t)LARGURA * ALTURA * 4);
+    glReadPixels(0, 0, LARGURA, ALTURA, GL_RGBA, GL_UNSIGNED_BYTE, cor.data());
+    size_t pixelsAcesos = 0;
+    for (size_t p = 0; p < cor.size(); p += 4) pixelsAcesos += cor[p] > 0;
+    std::printf("desenho: %zu pixels acesos\n", pixelsAcesos);
+    verificar(pixelsAcesos > 0, "esferas visiveis chegam a tela");
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,152 @@
+// Lista de desenho indireto (DesenhoIndireto.h): com 16 a 4096 meshes
+// distintas na mesma arena, a cena vai num glMultiDrawElementsIndirect só ou,
+// no caminho do OpenGL 3.3, num glDrawElementsInstancedBaseVertex por mesh. As
+// duas formas têm de desenhar a mesma imagem; o tempo de CPU do envio e o do
+// quadro inteiro (com glFinish) de cada uma são impressos por quantidade de
+// desenhos. Também confere que o mapa de grupos por endereço de mesh só guarda
+// as meshes do quadro: trocando as meshes a cada quadro ele não cresce.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+#include "Mesh.h"
+#include "DesenhoIndireto.h"
+#include "BlocosUniform.h"
+#include "PermutacoesShader.h"
+
+const int LARGURA = 320;
+const int ALTURA = 180;
+const int LADO_GRADE = 64;   // até 64 x 64 meshes
+const int REPETICOES = 10;
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+struct Medida {
+    double envio = 1e9;    // CPU em enviar()
+    double quadro = 1e9;   // limpar, adicionar, enviar e glFinish
+};
+
+int main() {
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(LARGURA, ALTURA)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    cache::diretorioProgramas = (std::filesystem::temp_directory_path() / "svg-teste-indireto").string();
+    verificar(ExtensoesGL::temMultiDrawIndireto(), "multi-draw indireto no contexto 4.5");
+
+    Shader programa("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+                    definicoesPermutacao(chavePermutacao(RECURSO_ILUMINACAO | RECURSO_INSTANCIADO, 0)));
+    blocos::vincular(programa);
+    const glm::vec3 olho(0.0f, 0.0f, 12.0f);
+    glm::mat4 projecao = glm::perspective(glm::radians(60.0f), (float)LARGURA / ALTURA, 0.1f, 100.0f);
+    glm::mat4 visao = glm::lookAt(olho, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    BufferUniform<BlocoCamera> uboCamera;
+    BufferUniform<BlocoLuzes> uboLuzes;
+    BufferUniform<BlocoMateriais> uboMateriais;
+    uboCamera.iniciar(PONTO_BLOCO_CAMERA);
+    uboLuzes.iniciar(PONTO_BLOCO_LUZES);
+    uboMateriais.iniciar(PONTO_BLOCO_MATERIAIS);
+    uboCamera.enviar(BlocoCamera{projecao, visao, glm::vec4(olho, 1.0f), projecao * visao});
+    BlocoLuzes luzes = {};
+    luzes.luzDirecional.direcao = glm::vec3(-0.3f, -0.5f, -1.0f);
+    luzes.luzDirecional.ambiente = glm::vec3(0.2f);
+    luzes.luzDirecional.difusa = glm::vec3(0.8f);
+    uboLuzes.enviar(luzes);
+    BlocoMateriais materiais = {};
+    const glm::vec3 cores[3] = {glm::vec3(1.0f, 0.3f, 0.3f), glm::vec3(0.3f, 1.0f, 0.3f), glm::vec3(0.3f, 0.3f, 1.0f)};
+    for (int m = 0; m < 3; m++) materiais.materiais[m].ambiente = materiais.materiais[m].difusa = cores[m];
+    uboMateriais.enviar(materiais);
+    glEnable(GL_DEPTH_TEST);
+    programa.usar();
+
+    // meshes distintas, todas na mesma arena: um VAO e um lote só
+    ArenaGeometria arena;
+    Mesh::arenaAtiva = &arena;
+    std::vector<Esfera> esferas;
+    std::vector<glm::mat4> modelos;
+    esferas.reserve(LADO_GRADE * LADO_GRADE);
+    for (int i = 0; i < LADO_GRADE * LADO_GRADE; i++) {
+        esferas.emplace_back(0.06f, 8, 6);
+        float x = (float)(i % LADO_GRADE) - (LADO_GRADE - 1) * 0.5f;
+        float y = (float)(i / LADO_GRADE) - (LADO_GRADE - 1) * 0.5f;
+        modelos.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x, y, 0.0f) * 0.15f));
+    }
+
+    ListaDesenhoIndireto lista;
+    auto desenhar = [&](size_t quantidade, bool multiDraw, Medida& medida) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        auto inicio = std::chrono::steady_clock::now();
+        lista.limpar();
+        for (size_t i = 0; i < quantidade; i++) lista.adicionar(esferas[i], modelos[i], (GLuint)(i % 3));
+        lista.enviar(multiDraw);
+        glFinish();
+        medida.quadro = std::min(medida.quadro,
+                                 std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count());
+        medida.envio = std::min(medida.envio, lista.estatisticas.segundosEnvio);
+    };
+    auto lerImagem = [] {
+        std::vector<unsigned char> imagem((size_t)LARGURA * ALTURA * 4);
+        glReadPixels(0, 0, LARGURA, ALTURA, GL_RGBA, GL_UNSIGNED_BYTE, imagem.data());
+        return imagem;
+    };
+
+    std::printf("%8s  %22s  %22s\n", "desenhos", "multi-draw envio/quadro", "3.3 em laco envio/quadro");
+    bool contagens = true, imagensIguais = true;
+    for (size_t quantidade = 16; quantidade <= esferas.size(); quantidade *= 4) {
+        Medida multi, laco;
+        std::vector<unsigned char> imagemMulti, imagemLaco;
+        for (int r = 0; r < REPETICOES; r++) {
+            desenhar(quantidade, true, multi);
+            const EstatisticasDesenhoIndireto& e = lista.estatisticas;
+            contagens = contagens && e.multiDraw && e.comandos == quantidade && e.lotes == 1 && e.chamadasGL == 1;
+            if (r == 0) imagemMulti = lerImagem();
+
+            desenhar(quantidade, false, laco);
+            contagens = contagens && !e.multiDraw && e.comandos == quantidade && e.chamadasGL == quantidade;
+            if (r == 0) imagemLaco = lerImagem();
+        }
+        imagensIguais = imagensIguais && imagemMulti == imagemLaco;
+        std::printf("%8zu  %9.1f / %8.1f us  %9.1f / %8.1f us\n", quantidade, multi.envio * 1e6, multi.quadro * 1e6,
+                    laco.envio * 1e6, laco.quadro * 1e6);
+    }
+    verificar(contagens, "um comando por mesh; uma chamada no multi-draw, uma por comando no laco");
+    verificar(imagensIguais, "mesma imagem pelos dois caminhos");
+    verificar(glGetError() == GL_NO_ERROR, "sem erro de OpenGL");
+
+    // meshes novas a cada quadro (as do quadro anterior já destruídas): o
+    // mapa por endereço só tem as do quadro atual
+    bool semCrescer = true;
+    for (int quadro = 0; quadro < 50; quadro++) {
+        std::vector<Esfera> temporarias;
+        temporarias.reserve(20);
+        for (int i = 0; i < 20; i++) temporarias.emplace_back(0.06f, 8 + quadro % 4, 6);
+        lista.limpar();
+        for (int i = 0; i < 20; i++) lista.adicionar(temporarias[i], modelos[i], 0);
+        lista.adicionar(esferas[0], modelos[20], 1);
+        lista.enviar();
+        semCrescer = semCrescer && lista.numGrupos() == 21 && lista.estatisticas.comandos == 21;
+    }
+    verificar(semCrescer, "50 quadros com meshes novas: grupos so das 21 meshes do quadro");
+    lista.limpar();
+    verificar(lista.numGrupos() == 0 && !lista.quantizada(), "limpar() esquece todas as meshes");
+
+    Mesh::arenaAtiva = nullptr;
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
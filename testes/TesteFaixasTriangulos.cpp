@@ -0,0 +1,233 @@
+// Faixas de triângulos com reinício de primitiva (Topologia::Faixas): os
+// índices de Plano e Esfera têm a contagem de contarIndices*, um marcador por
+// fim de linha e os mesmos triângulos da lista, na mesma orientação. No buffer
+// da GPU o marcador é o maior valor do tipo escolhido, e a consulta
+// GL_PRIMITIVES_GENERATED confere que o OpenGL monta o mesmo número de
+// triângulos pelos dois caminhos. Num Plano de 4096 x 4096 divisões (33,5
+// milhões de triângulos) lista e faixas são desenhadas e comparadas em bytes de
+// índice e tempo de quadro; os tempos são só impressos, e no llvmpipe medem a
+// CPU fazendo o papel da GPU.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+#include "Mesh.h"
+#include "Instancias.h"
+#include "BlocosUniform.h"
+#include "PermutacoesShader.h"
+
+const int LARGURA = 320;
+const int ALTURA = 180;
+// 15 x 15 divisões = 256 vértices: a lista cabe em GL_UNSIGNED_BYTE, as
+// faixas não, porque 0xFF fica reservado para o reinício
+const int DIVISOES_PEQUENO = 15;
+const int DIVISOES_GRANDE = 4096;
+const int QUADROS = 2;
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// índices como estão no buffer de elementos da GPU, já em 32 bits
+static std::vector<GLuint> indicesNaGPU(const Mesh& mesh) {
+    const size_t tamanho = tamanhoTipoIndice(mesh.tipoIndice);
+    std::vector<unsigned char> bytes((size_t)mesh.numIndices * tamanho);
+    EstadoGL::vincularVAO(mesh.VAO);
+    glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, (GLsizeiptr)bytes.size(), bytes.data());
+    std::vector<GLuint> indices(mesh.numIndices);
+    for (size_t i = 0; i < indices.size(); i++) {
+        const unsigned char* p = bytes.data() + i * tamanho;
+        indices[i] = tamanho == 1 ? *p : tamanho == 2 ? *(const GLushort*)p : *(const GLuint*)p;
+    }
+    return indices;
+}
+
+// triângulos girados para começar pelo menor índice (a orientação fica) e ordenados
+static std::vector<std::array<GLuint, 3>> triangulosCanonicos(const std::vector<GLuint>& indices, GLenum primitiva) {
+    std::vector<std::array<GLuint, 3>> triangulos;
+    paraCadaTriangulo(indices, primitiva, [&](GLuint a, GLuint b, GLuint c) {
+        if (b < a && b < c) triangulos.push_back({b, c, a});
+        else if (c < a && c < b) triangulos.push_back({c, a, b});
+        else triangulos.push_back({a, b, c});
+    });
+    std::sort(triangulos.begin(), triangulos.end());
+    return triangulos;
+}
+
+// marcadores em fim de linha: depois de cada (colunas + 1) * 2 índices
+static bool marcadoresPorLinha(const std::vector<GLuint>& indices, int colunas, int linhas, GLuint marcador) {
+    const size_t porLinha = (size_t)(colunas + 1) * 2 + 1;
+    size_t encontrados = 0;
+    for (size_t i = 0; i < indices.size(); i++) {
+        bool esperado = (i + 1) % porLinha == 0;
+        if ((indices[i] == marcador) != esperado) return false;
+        encontrados += esperado;
+    }
+    return encontrados == (size_t)(linhas - 1);
+}
+
+int main() {
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(LARGURA, ALTURA, 3, 3)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    cache::diretorioProgramas = (std::filesystem::temp_directory_path() / "svg-teste-faixas").string();
+
+    Shader programa("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+                    definicoesPermutacao(chavePermutacao(RECURSO_ILUMINACAO | RECURSO_INSTANCIADO, 0)));
+    blocos::vincular(programa);
+    glm::mat4 projecao = glm::perspective(glm::radians(60.0f), (float)LARGURA / ALTURA, 0.1f, 100.0f);
+    glm::mat4 visao = glm::lookAt(glm::vec3(0.0f, 6.0f, 8.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    BufferUniform<BlocoCamera> uboCamera;
+    BufferUniform<BlocoLuzes> uboLuzes;
+    BufferUniform<BlocoMateriais> uboMateriais;
+    uboCamera.iniciar(PONTO_BLOCO_CAMERA);
+    uboLuzes.iniciar(PONTO_BLOCO_LUZES);
+    uboMateriais.iniciar(PONTO_BLOCO_MATERIAIS);
+    uboCamera.enviar(BlocoCamera{projecao, visao, glm::vec4(0.0f, 6.0f, 8.0f, 1.0f), projecao * visao});
+    BlocoLuzes luzes = {};
+    luzes.luzDirecional.direcao = glm::vec3(-0.3f, -1.0f, -0.2f);
+    luzes.luzDirecional.ambiente = glm::vec3(0.2f);
+    luzes.luzDirecional.difusa = glm::vec3(0.8f);
+    uboLuzes.enviar(luzes);
+    BlocoMateriais materiais = {};
+    for (MaterialStd140& m : materiais.materiais) m.ambiente = m.difusa = glm::vec3(1.0f);
+    uboMateriais.enviar(materiais);
+    BufferInstancias instancia;
+    glm::mat4 identidade(1.0f);
+    instancia.atualizar(&identidade, nullptr, 1);
+    glEnable(GL_DEPTH_TEST);
+    programa.usar();
+
+    GLuint consulta = 0;
+    glGenQueries(1, &consulta);
+    // desenha um quadro e devolve os triângulos montados pelo OpenGL; o
+    // melhor tempo de QUADROS desenhos vai em segundos, se pedido
+    auto desenhar = [&](const Mesh& mesh, double* segundos = nullptr) {
+        GLuint primitivas = 0;
+        double melhor = 1e9;
+        for (int q = 0; q < (segundos ? QUADROS : 1); q++) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            auto inicio = std::chrono::steady_clock::now();
+            glBeginQuery(GL_PRIMITIVES_GENERATED, consulta);
+            mesh.desenharInstanciado(instancia);
+            glEndQuery(GL_PRIMITIVES_GENERATED);
+            glGetQueryObjectuiv(consulta, GL_QUERY_RESULT, &primitivas);
+            melhor = std::min(melhor,
+                              std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count());
+        }
+        if (segundos) *segundos = melhor;
+        return primitivas;
+    };
+    auto lerImagem = [] {
+        std::vector<unsigned char> imagem((size_t)LARGURA * ALTURA * 4);
+        glReadPixels(0, 0, LARGURA, ALTURA, GL_RGBA, GL_UNSIGNED_BYTE, imagem.data());
+        return imagem;
+    };
+
+    // plano pequeno: contagens, marcadores e tipo de índice
+    {
+        const int n = DIVISOES_PEQUENO;
+        Plano lista(10.0f, 10.0f, n, n);
+        Plano faixas(10.0f, 10.0f, n, n, Topologia::Faixas);
+        verificar(faixas.primitiva == GL_TRIANGLE_STRIP && faixas.reinicioPrimitiva, "plano em faixas com reinicio");
+        verificar(faixas.indices.size() == contarIndicesPlano(n, n, Topologia::Faixas) &&
+                      faixas.indices.size() == (size_t)n * (n + 1) * 2 + (n - 1),
+                  "faixas com 2 indices por coluna e um marcador por linha");
+        verificar(marcadoresPorLinha(faixas.indices, n, n, INDICE_REINICIO), "INDICE_REINICIO no fim de cada linha");
+        verificar(triangulosCanonicos(faixas.indices, GL_TRIANGLE_STRIP) ==
+                      triangulosCanonicos(lista.indices, GL_TRIANGLES),
+                  "faixas com os mesmos triangulos da lista, na mesma orientacao");
+        verificar(lista.tipoIndice == GL_UNSIGNED_BYTE && faixas.tipoIndice == GL_UNSIGNED_SHORT,
+                  "256 vertices: lista em bytes, faixas em shorts (0xFF reservado)");
+
+        const std::vector<GLuint> naGPU = indicesNaGPU(faixas);
+        verificar(marcadoresPorLinha(naGPU, n, n, 0xFFFFu), "no buffer da GPU o marcador e 0xFFFF");
+        std::vector<GLuint> marcadorDaCPU = naGPU;
+        std::replace(marcadorDaCPU.begin(), marcadorDaCPU.end(), (GLuint)0xFFFFu, INDICE_REINICIO);
+        verificar(marcadorDaCPU == faixas.indices, "resto do buffer da GPU igual aos indices da CPU");
+
+        GLuint primitivasLista = desenhar(lista);
+        std::vector<unsigned char> imagemLista = lerImagem();
+        GLuint primitivasFaixas = desenhar(faixas);
+        verificar(primitivasLista == (GLuint)(2 * n * n) && primitivasFaixas == primitivasLista,
+                  "OpenGL monta 2 triangulos por celula nos dois caminhos");
+        verificar(lerImagem() == imagemLista, "mesma imagem por lista e por faixas");
+
+        // a lista em ordem de grade convertida volta às faixas do gerador
+        lista.definirTopologia(Topologia::Faixas);
+        verificar(lista.indices == faixas.indices && lista.tipoIndice == GL_UNSIGNED_SHORT,
+                  "lista convertida em faixas igual ao gerador, reenviada em shorts");
+    }
+
+    // esfera: na lista a primeira e a última pilha têm um triângulo por setor
+    {
+        Esfera lista(1.0f, 36, 18);
+        Esfera faixas(1.0f, 36, 18, Topologia::Faixas);
+        verificar(faixas.indices.size() == contarIndicesEsfera(36, 18, Topologia::Faixas) &&
+                      marcadoresPorLinha(faixas.indices, 36, 18, INDICE_REINICIO) &&
+                      marcadoresPorLinha(indicesNaGPU(faixas), 36, 18, indiceReinicioPara(faixas.tipoIndice)),
+                  "esfera em faixas com um marcador por pilha, na CPU e na GPU");
+        // nos polos a faixa também passa pelo triângulo com dois vértices no
+        // polo (índices diferentes, mesma posição), que a lista pula
+        const auto triangulosFaixas = triangulosCanonicos(faixas.indices, GL_TRIANGLE_STRIP);
+        const auto triangulosLista = triangulosCanonicos(lista.indices, GL_TRIANGLES);
+        verificar(triangulosFaixas.size() == triangulosLista.size() + 2 * 36 &&
+                      std::includes(triangulosFaixas.begin(), triangulosFaixas.end(), triangulosLista.begin(),
+                                    triangulosLista.end()),
+                  "esfera: os triangulos da lista e um degenerado por setor em cada polo");
+        verificar(desenhar(faixas) == desenhar(lista) + 2u * 36u,
+                  "OpenGL monta os mesmos degenerados dos polos");
+    }
+
+    // plano grande: bytes de índice e tempo de quadro
+    {
+        const int n = DIVISOES_GRANDE;
+        const GLuint triangulos = 2u * n * n;
+        double segundosLista = 0.0, segundosFaixas = 0.0;
+        size_t bytesLista = 0, bytesFaixas = 0;
+        GLuint primitivasLista = 0, primitivasFaixas = 0;
+        std::vector<unsigned char> imagemLista;
+        {
+            Plano plano(10.0f, 10.0f, n, n);
+            plano.definirFormato(FormatoVertice::compacto());
+            bytesLista = (size_t)plano.numIndices * tamanhoTipoIndice(plano.tipoIndice);
+            primitivasLista = desenhar(plano, &segundosLista);
+            imagemLista = lerImagem();
+        }
+        {
+            Plano plano(10.0f, 10.0f, n, n, Topologia::Faixas);
+            plano.definirFormato(FormatoVertice::compacto());
+            bytesFaixas = (size_t)plano.numIndices * tamanhoTipoIndice(plano.tipoIndice);
+            primitivasFaixas = desenhar(plano, &segundosFaixas);
+        }
+        verificar(glGetError() == GL_NO_ERROR, "plano grande enviado e desenhado sem erro de OpenGL");
+        verificar(primitivasLista == triangulos && primitivasFaixas == triangulos,
+                  "plano grande: mesmos triangulos montados por lista e por faixas");
+        verificar(lerImagem() == imagemLista, "plano grande: mesma imagem por lista e por faixas");
+        std::printf("plano %dx%d, %u triangulos\n", n, n, triangulos);
+        std::printf("lista   %7.1f MB de indices  %8.1f ms/quadro  %6.1f Mtri/s\n", bytesLista / (1024.0 * 1024.0),
+                    segundosLista * 1000.0, triangulos / segundosLista / 1e6);
+        std::printf("faixas  %7.1f MB de indices  %8.1f ms/quadro  %6.1f Mtri/s\n", bytesFaixas / (1024.0 * 1024.0),
+                    segundosFaixas * 1000.0, triangulos / segundosFaixas / 1e6);
+    }
+
+    glDeleteQueries(1, &consulta);
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
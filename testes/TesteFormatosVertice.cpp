@@ -0,0 +1,150 @@
+// Formatos de vértice (FormatoVertice.h) num plano de 5 milhões de triângulos:
+// para cada formato, os bytes na CPU e na GPU (o tamanho do buffer lido do
+// próprio OpenGL tem de bater com Mesh::bytesVerticesGPU) e o tempo de
+// desenho, pelo programa da cena com ou sem VERTICE_COMPACTO. A imagem de
+// cada formato compacto é comparada com a do formato padrão. Os tempos são só
+// impressos: no llvmpipe medem a CPU fazendo o papel da GPU, não a banda de
+// uma placa de vídeo.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+#include "Mesh.h"
+#include "Instancias.h"
+#include "BlocosUniform.h"
+#include "PermutacoesShader.h"
+
+const int LARGURA = 320;
+const int ALTURA = 180;
+// 2 * 1581^2 = 4.999.122 triângulos
+const int DIVISOES = 1581;
+const int QUADROS = 3;
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+struct Caso {
+    const char* nome;
+    FormatoVertice formato;
+    GLsizei bytesPorVertice;
+};
+
+int main() {
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(LARGURA, ALTURA, 3, 3)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    cache::diretorioProgramas = (std::filesystem::temp_directory_path() / "svg-teste-formatos").string();
+
+    FormatoVertice posicaoCompacta;
+    posicaoCompacta.posicao = FormatoPosicao::Snorm16;
+    FormatoVertice normal2101010 = FormatoVertice::compacto();
+    normal2101010.normal = FormatoNormal::Int2101010;
+    const Caso casos[] = {{"padrao", FormatoVertice(), 32},
+                          {"posicao snorm16", posicaoCompacta, 28},
+                          {"compacto", FormatoVertice::compacto(), 16},
+                          {"compacto 2_10_10_10", normal2101010, 16}};
+
+    Plano plano(10.0f, 10.0f, DIVISOES, DIVISOES);
+    const size_t bytesCPU = plano.vertices.size() * sizeof(Vertice) + plano.indices.size() * sizeof(GLuint);
+    std::printf("plano: %zu vertices, %zu triangulos; na CPU %.1f MB\n", plano.vertices.size(),
+                plano.indices.size() / 3, bytesCPU / (1024.0 * 1024.0));
+
+    Shader padrao("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+                  definicoesPermutacao(chavePermutacao(RECURSO_ILUMINACAO | RECURSO_INSTANCIADO, 0)));
+    Shader compacto("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+                    definicoesPermutacao(chavePermutacao(RECURSO_ILUMINACAO | RECURSO_INSTANCIADO |
+                                                         RECURSO_VERTICE_COMPACTO, 0)));
+    blocos::vincular(padrao);
+    blocos::vincular(compacto);
+
+    glm::mat4 projecao = glm::perspective(glm::radians(60.0f), (float)LARGURA / ALTURA, 0.1f, 100.0f);
+    glm::mat4 visao = glm::lookAt(glm::vec3(0.0f, 6.0f, 8.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    BufferUniform<BlocoCamera> uboCamera;
+    BufferUniform<BlocoLuzes> uboLuzes;
+    BufferUniform<BlocoMateriais> uboMateriais;
+    uboCamera.iniciar(PONTO_BLOCO_CAMERA);
+    uboLuzes.iniciar(PONTO_BLOCO_LUZES);
+    uboMateriais.iniciar(PONTO_BLOCO_MATERIAIS);
+    uboCamera.enviar(BlocoCamera{projecao, visao, glm::vec4(0.0f, 6.0f, 8.0f, 1.0f), projecao * visao});
+    BlocoLuzes luzes = {};
+    luzes.luzDirecional.direcao = glm::vec3(-0.3f, -1.0f, -0.2f);
+    luzes.luzDirecional.ambiente = glm::vec3(0.2f);
+    luzes.luzDirecional.difusa = glm::vec3(0.8f);
+    uboLuzes.enviar(luzes);
+    BlocoMateriais materiais = {};
+    for (MaterialStd140& m : materiais.materiais) m.ambiente = m.difusa = glm::vec3(1.0f);
+    uboMateriais.enviar(materiais);
+
+    BufferInstancias instancia;
+    glm::mat4 identidade(1.0f);
+    instancia.atualizar(&identidade, nullptr, 1);
+
+    glEnable(GL_DEPTH_TEST);
+    std::vector<unsigned char> imagemPadrao;
+    for (const Caso& c : casos) {
+        plano.definirFormato(c.formato);
+
+        GLint tamanhoVBO = 0, tamanhoEBO = 0;
+        glBindBuffer(GL_ARRAY_BUFFER, plano.VBO);
+        glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &tamanhoVBO);
+        EstadoGL::vincularVAO(plano.VAO);
+        glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &tamanhoEBO);
+        const size_t bytesGPU = (size_t)tamanhoVBO + (size_t)tamanhoEBO;
+
+        const Shader& programa = c.formato.padrao() ? padrao : compacto;
+        programa.usar();
+        std::vector<unsigned char> imagem((size_t)LARGURA * ALTURA * 4);
+        double melhor = 1e9;
+        for (int q = 0; q < QUADROS; q++) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            auto inicio = std::chrono::steady_clock::now();
+            plano.desenharInstanciado(instancia);
+            glFinish();
+            melhor = std::min(melhor,
+                              std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count());
+        }
+        glReadPixels(0, 0, LARGURA, ALTURA, GL_RGBA, GL_UNSIGNED_BYTE, imagem.data());
+
+        std::printf("%-20s %2d B/vertice  GPU %6.1f MB (vertices %6.1f, indices %6.1f)  %7.1f ms/quadro\n", c.nome,
+                    plano.layout.tamanhoVertice, bytesGPU / (1024.0 * 1024.0), tamanhoVBO / (1024.0 * 1024.0),
+                    tamanhoEBO / (1024.0 * 1024.0), melhor * 1000.0);
+        verificar(glGetError() == GL_NO_ERROR, "upload e desenho sem erro de OpenGL");
+        verificar((size_t)tamanhoVBO == plano.bytesVerticesGPU() &&
+                      (size_t)tamanhoEBO == plano.indices.size() * tamanhoTipoIndice(plano.tipoIndice),
+                  "buffers na GPU com o tamanho que a Mesh calcula");
+        verificar(plano.layout.tamanhoVertice == c.bytesPorVertice &&
+                      (size_t)tamanhoVBO == plano.vertices.size() * (size_t)c.bytesPorVertice,
+                  "bytes por vertice esperados para o formato");
+
+        if (c.formato.padrao()) {
+            imagemPadrao = imagem;
+            continue;
+        }
+        // a quantização move a borda do plano em menos de um pixel
+        size_t diferentes = 0;
+        for (size_t p = 0; p < imagem.size(); p += 4)
+            diferentes += std::abs(imagem[p] - imagemPadrao[p]) > 8 || std::abs(imagem[p + 1] - imagemPadrao[p + 1]) > 8 ||
+                          std::abs(imagem[p + 2] - imagemPadrao[p + 2]) > 8;
+        std::printf("%-20s %zu pixel(s) diferentes do padrao\n", "", diferentes);
+        verificar(diferentes * 200 < (size_t)LARGURA * ALTURA, "imagem igual a do padrao (menos de 0.5% dos pixels)");
+    }
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
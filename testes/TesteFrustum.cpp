@@ -0,0 +1,97 @@
+// Descarte em lote (Frustum.h): DescarteFrustum::recortar, com SIMD, blocos
+// e threads, devolve exatamente os objetos que o teste escalar, objeto por
+// objeto, deixa passar. Também mede o recorte de 1 milhão de objetos (a
+// meta é ficar abaixo de 1 ms num desktop; aqui só é impresso, já que o
+// tempo depende da máquina). Não usa OpenGL.
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Frustum.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+struct Objeto {
+    glm::vec3 centro, extensao;
+    float raio;
+};
+
+// a regra do lote, um objeto por vez: sai quando, em algum plano, fica fora
+// pela esfera ou pela AABB (o que for mais justo)
+static bool visivelEscalar(const Frustum& frustum, const Objeto& o) {
+    for (const glm::vec4& p : frustum.planos) {
+        float distancia = (p.x * o.centro.x + p.y * o.centro.y) + (p.z * o.centro.z + p.w);
+        float projecao = (std::fabs(p.x) * o.extensao.x + std::fabs(p.y) * o.extensao.y) + std::fabs(p.z) * o.extensao.z;
+        if (distancia + std::min(o.raio, projecao) < 0.0f) return false;
+    }
+    return true;
+}
+
+int main() {
+    // câmera na origem olhando para -z, como a Camera na posição inicial
+    glm::mat4 projecao = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    glm::mat4 visao = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum = Frustum::daMatriz(projecao * visao);
+
+    verificar(frustum.esferaVisivel(glm::vec3(0.0f, 0.0f, -10.0f), 1.0f), "esfera na frente da camera visivel");
+    verificar(!frustum.esferaVisivel(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f), "esfera atras da camera descartada");
+    verificar(!frustum.caixaVisivel(glm::vec3(0.0f, 0.0f, -150.0f), glm::vec3(1.0f)), "caixa alem do plano longe descartada");
+
+    // 1 milhão de objetos em volta da câmera: vários blocos e um resto fora dos registradores
+    const size_t NUM_OBJETOS = 1000003;
+    std::mt19937 gerador(16);
+    std::uniform_real_distribution<float> posicao(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> tamanho(0.1f, 3.0f);
+
+    std::vector<Objeto> objetos(NUM_OBJETOS);
+    DescarteFrustum descarte;
+    descarte.reservar(NUM_OBJETOS);
+    for (Objeto& o : objetos) {
+        o.centro = glm::vec3(posicao(gerador), posicao(gerador), posicao(gerador));
+        o.extensao = glm::vec3(tamanho(gerador), tamanho(gerador), tamanho(gerador));
+        o.raio = glm::length(o.extensao) * 0.9f;   // esfera menor que a diagonal, como numa mesh arredondada
+        descarte.adicionar(o.centro, o.extensao, o.raio);
+    }
+
+    std::vector<uint32_t> esperados;
+    for (size_t i = 0; i < NUM_OBJETOS; i++)
+        if (visivelEscalar(frustum, objetos[i])) esperados.push_back((uint32_t)i);
+
+    const std::vector<uint32_t>& visiveis = descarte.recortar(frustum);
+    std::printf("visiveis: %zu de %zu\n", visiveis.size(), NUM_OBJETOS);
+    verificar(visiveis == esperados, "lote igual ao teste escalar objeto por objeto");
+    verificar(descarte.estatisticas.testados == NUM_OBJETOS && descarte.estatisticas.visiveis == esperados.size(),
+              "estatisticas do recorte");
+
+    bool contidoNosTestes = true;
+    for (uint32_t i : visiveis) {
+        // folga para a ordem diferente das contas em caixaVisivel/esferaVisivel
+        glm::vec3 extensao = objetos[i].extensao + glm::vec3(1e-3f);
+        if (!frustum.caixaVisivel(objetos[i].centro, extensao) || !frustum.esferaVisivel(objetos[i].centro, objetos[i].raio + 1e-3f))
+            contidoNosTestes = false;
+    }
+    verificar(contidoNosTestes, "nada que a AABB ou a esfera descartam passa no lote");
+
+    // o melhor de 20 recortes, já com os dados na cache
+    double melhor = 1e9;
+    for (int repeticao = 0; repeticao < 20; repeticao++) {
+        descarte.recortar(frustum);
+        melhor = std::min(melhor, descarte.estatisticas.segundos);
+    }
+    std::printf("recorte de %zu objetos: %.3f ms (%u thread(s))\n", NUM_OBJETOS, melhor * 1000.0,
+                descarte.estatisticas.threads);
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,157 @@
+// Desenho instanciado (Instancias.h) contra um desenho por objeto pela
+// FilaRenderizacao: de 100 a 10 mil esferas iguais, com a matriz e o
+// material de cada uma, desenhadas pelos dois caminhos com as variantes
+// INSTANCIADO e por objeto do mesmo par de shaders. As imagens têm de ser
+// iguais. O tempo de CPU da submissão e o do quadro inteiro (com glFinish)
+// são impressos por quantidade de objetos, medidos com GL_RASTERIZER_DISCARD
+// para o custo dos fragmentos no llvmpipe não encobrir o da submissão.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <vector>
+
+#include "Mesh.h"
+#include "Instancias.h"
+#include "FilaRenderizacao.h"
+#include "BlocosUniform.h"
+#include "PermutacoesShader.h"
+#include "Light.h"
+
+const int LARGURA = 320;
+const int ALTURA = 180;
+const int LADO_GRADE = 100;   // até 100 x 100 esferas
+const int REPETICOES = 5;
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+struct Medida {
+    double envio = 1e9;    // CPU até a última chamada de desenho
+    double quadro = 1e9;   // com glFinish
+};
+
+static double segundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+int main() {
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(LARGURA, ALTURA)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    cache::diretorioProgramas = (std::filesystem::temp_directory_path() / "svg-teste-instanciado").string();
+
+    FilaRenderizacao fila;
+    Shader instanciado("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+                       definicoesPermutacao(chavePermutacao(RECURSO_ILUMINACAO | RECURSO_INSTANCIADO, 0)));
+    Shader porObjeto("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+                     definicoesPermutacao(chavePermutacao(RECURSO_ILUMINACAO, 0)));
+    blocos::vincular(instanciado);
+    blocos::vincular(porObjeto);
+    UniformsMaterial uniformsMaterial(porObjeto, "material");
+    const uint32_t filaPorObjeto = fila.registrarShader(porObjeto, nullptr,
+        [uniformsMaterial](const Shader&, const Material& m) { uniformsMaterial.definir(m); });
+
+    const glm::vec3 olho(0.0f, 0.0f, 12.0f);
+    glm::mat4 projecao = glm::perspective(glm::radians(60.0f), (float)LARGURA / ALTURA, 0.1f, 100.0f);
+    glm::mat4 visao = glm::lookAt(olho, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    BufferUniform<BlocoCamera> uboCamera;
+    BufferUniform<BlocoLuzes> uboLuzes;
+    BufferUniform<BlocoMateriais> uboMateriais;
+    uboCamera.iniciar(PONTO_BLOCO_CAMERA);
+    uboLuzes.iniciar(PONTO_BLOCO_LUZES);
+    uboMateriais.iniciar(PONTO_BLOCO_MATERIAIS);
+    uboCamera.enviar(BlocoCamera{projecao, visao, glm::vec4(olho, 1.0f), projecao * visao});
+    BlocoLuzes luzes = {};
+    luzes.luzDirecional.direcao = glm::vec3(-0.3f, -0.5f, -1.0f);
+    luzes.luzDirecional.ambiente = glm::vec3(0.2f);
+    luzes.luzDirecional.difusa = glm::vec3(0.8f);
+    uboLuzes.enviar(luzes);
+    BlocoMateriais materiais = {};
+    const glm::vec3 cores[3] = {glm::vec3(1.0f, 0.3f, 0.3f), glm::vec3(0.3f, 1.0f, 0.3f), glm::vec3(0.3f, 0.3f, 1.0f)};
+    for (int m = 0; m < 3; m++) materiais.materiais[m].ambiente = materiais.materiais[m].difusa = cores[m];
+    uboMateriais.enviar(materiais);
+    glEnable(GL_DEPTH_TEST);
+
+    Esfera esfera(0.04f, 12, 8);
+    std::vector<glm::mat4> modelos;
+    std::vector<GLuint> indicesMaterial;
+    for (int i = 0; i < LADO_GRADE * LADO_GRADE; i++) {
+        float x = (float)(i % LADO_GRADE) - (LADO_GRADE - 1) * 0.5f;
+        float y = (float)(i / LADO_GRADE) - (LADO_GRADE - 1) * 0.5f;
+        modelos.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x * 0.16f, y * 0.09f, 0.0f)));
+        indicesMaterial.push_back((GLuint)(i % 3));
+    }
+    const Material material;   // não usado: cada objeto lê o seu do BlocoMateriais
+
+    BufferInstancias instancias;
+    auto desenharInstanciado = [&](size_t quantidade, Medida& medida) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        auto inicio = std::chrono::steady_clock::now();
+        instanciado.usar();
+        instancias.atualizar(modelos.data(), indicesMaterial.data(), quantidade);
+        esfera.desenharInstanciado(instancias);
+        medida.envio = std::min(medida.envio, segundosDesde(inicio));
+        glFinish();
+        medida.quadro = std::min(medida.quadro, segundosDesde(inicio));
+    };
+    auto desenharPorObjeto = [&](size_t quantidade, Medida& medida) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        auto inicio = std::chrono::steady_clock::now();
+        fila.iniciar(olho, glm::vec3(0.0f, 0.0f, -1.0f), 100.0f);
+        for (size_t i = 0; i < quantidade; i++)
+            fila.adicionar(filaPorObjeto, esfera, material, modelos[i], PasseRenderizacao::Opaco,
+                           (GLint)indicesMaterial[i]);
+        fila.executar();
+        medida.envio = std::min(medida.envio, segundosDesde(inicio));
+        glFinish();
+        medida.quadro = std::min(medida.quadro, segundosDesde(inicio));
+    };
+    auto lerImagem = [] {
+        std::vector<unsigned char> imagem((size_t)LARGURA * ALTURA * 4);
+        glReadPixels(0, 0, LARGURA, ALTURA, GL_RGBA, GL_UNSIGNED_BYTE, imagem.data());
+        return imagem;
+    };
+
+    std::printf("%8s  %24s  %24s\n", "objetos", "instanciado envio/quadro", "por objeto envio/quadro");
+    bool imagensIguais = true, desenhos = true;
+    for (size_t quantidade : {(size_t)100, (size_t)1000, (size_t)LADO_GRADE * LADO_GRADE}) {
+        Medida umaChamada, umaPorObjeto, descartada;
+        desenharInstanciado(quantidade, descartada);
+        const std::vector<unsigned char> imagemInstanciada = lerImagem();
+        desenharPorObjeto(quantidade, descartada);
+        imagensIguais = imagensIguais && lerImagem() == imagemInstanciada;
+
+        // medidas sem rasterizar: no llvmpipe os fragmentos custariam mais que a submissão
+        glEnable(GL_RASTERIZER_DISCARD);
+        for (int r = 0; r < REPETICOES; r++) {
+            desenharInstanciado(quantidade, umaChamada);
+            desenharPorObjeto(quantidade, umaPorObjeto);
+            desenhos = desenhos && fila.estatisticas.desenhos == quantidade;
+        }
+        glDisable(GL_RASTERIZER_DISCARD);
+        std::printf("%8zu  %10.1f / %9.1f us  %10.1f / %9.1f us  (envio %.1fx)\n", quantidade,
+                    umaChamada.envio * 1e6, umaChamada.quadro * 1e6, umaPorObjeto.envio * 1e6,
+                    umaPorObjeto.quadro * 1e6, umaPorObjeto.envio / umaChamada.envio);
+    }
+    verificar(desenhos, "fila com um desenho por objeto");
+    verificar(imagensIguais, "mesma imagem instanciada e por objeto");
+    verificar(glGetError() == GL_NO_ERROR, "sem erro de OpenGL");
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
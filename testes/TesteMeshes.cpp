@@ -0,0 +1,122 @@
+// Meshes move-only (Mesh.h): montar um std::vector com 10 mil meshes, sem
+// reserve, só move os vetores de vértices. Nenhuma alocação do tamanho do
+// bloco de vértices acontece e cada mesh termina com o mesmo ponteiro de
+// dados com que foi criada.
+//
+// Roda sem janela nem contexto: as funções do OpenGL que o upload usa são
+// trocadas por versões falsas que só entregam ids.
+
+#include <glad/glad.h>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// operator new contando alocações enquanto contarAlocacoes estiver ligado;
+// as do tamanho de tamanhoVigiado são contadas à parte
+static size_t alocacoes = 0;
+static size_t alocacoesVigiadas = 0;
+static size_t tamanhoVigiado = 0;
+static bool contarAlocacoes = false;
+
+void* operator new(size_t tamanho) {
+    if (contarAlocacoes) {
+        alocacoes++;
+        if (tamanho == tamanhoVigiado) alocacoesVigiadas++;
+    }
+    void* p = std::malloc(tamanho ? tamanho : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+// fora de linha pelo mesmo motivo de TesteUniforms.cpp (-Wmismatched-new-delete)
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+#include "Mesh.h"
+
+namespace falso {
+
+GLuint proximoId = 1;
+
+void APIENTRY gerar(GLsizei n, GLuint* ids) { for (GLsizei i = 0; i < n; i++) ids[i] = proximoId++; }
+void APIENTRY apagar(GLsizei, const GLuint*) {}
+void APIENTRY vincularBuffer(GLenum, GLuint) {}
+void APIENTRY vincularVAO(GLuint) {}
+void APIENTRY dadosBuffer(GLenum, GLsizeiptr, const void*, GLenum) {}
+void APIENTRY habilitarAtributo(GLuint) {}
+void APIENTRY ponteiroAtributo(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) {}
+
+void instalar() {
+    glad_glGenBuffers = gerar;
+    glad_glGenVertexArrays = gerar;
+    glad_glDeleteBuffers = apagar;
+    glad_glDeleteVertexArrays = apagar;
+    glad_glBindBuffer = vincularBuffer;
+    glad_glBindVertexArray = vincularVAO;
+    glad_glBufferData = dadosBuffer;
+    glad_glEnableVertexAttribArray = habilitarAtributo;
+    glad_glVertexAttribPointer = ponteiroAtributo;
+}
+
+}
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+int main() {
+    falso::instalar();
+
+    // 37 vértices: um bloco de 1184 bytes, que nada mais no teste aloca
+    const size_t NUM_MESHES = 10000;
+    const size_t NUM_VERTICES = 37;
+    tamanhoVigiado = NUM_VERTICES * sizeof(Vertice);
+
+    std::vector<std::vector<Vertice>> fontesVertices(NUM_MESHES);
+    std::vector<std::vector<GLuint>> fontesIndices(NUM_MESHES);
+    std::vector<const Vertice*> dadosOriginais(NUM_MESHES);
+    for (size_t m = 0; m < NUM_MESHES; m++) {
+        std::vector<Vertice>& v = fontesVertices[m];
+        v.resize(NUM_VERTICES);
+        for (size_t i = 0; i < NUM_VERTICES; i++)
+            v[i] = {glm::vec3((float)i, (float)m, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec2(0.0f)};
+        for (GLuint i = 0; i + 2 < NUM_VERTICES; i++) fontesIndices[m].insert(fontesIndices[m].end(), {0, i + 1, i + 2});
+        dadosOriginais[m] = v.data();
+    }
+
+    verificar(std::is_nothrow_move_constructible<Mesh>::value,
+              "Mesh move sem excecao (o vector move em vez de copiar ao crescer)");
+
+    // sem reserve: o vetor cresce várias vezes e realoca as meshes já dentro
+    std::vector<Mesh> meshes;
+    contarAlocacoes = true;
+    for (size_t m = 0; m < NUM_MESHES; m++)
+        meshes.emplace_back(std::move(fontesVertices[m]), std::move(fontesIndices[m]));
+    contarAlocacoes = false;
+
+    bool mesmosDados = meshes.size() == NUM_MESHES;
+    for (size_t m = 0; mesmosDados && m < NUM_MESHES; m++)
+        mesmosDados = meshes[m].vertices.data() == dadosOriginais[m] && meshes[m].vertices.size() == NUM_VERTICES;
+
+    std::printf("alocacoes: %zu no total, %zu do tamanho dos vertices\n", alocacoes, alocacoesVigiadas);
+    verificar(alocacoesVigiadas == 0, "10 mil meshes sem copiar o armazenamento de vertices");
+    verificar(mesmosDados, "cada mesh guarda o mesmo bloco de vertices com que foi criada");
+
+    // mover o vetor inteiro e uma mesh avulsa também não copia
+    contarAlocacoes = true;
+    std::vector<Mesh> movidas = std::move(meshes);
+    Mesh avulsa = std::move(movidas.back());
+    movidas.back() = std::move(movidas.front());
+    contarAlocacoes = false;
+
+    verificar(alocacoesVigiadas == 0 && avulsa.vertices.data() == dadosOriginais[NUM_MESHES - 1],
+              "mover o vetor e meshes avulsas mantem os dados");
+    verificar(movidas.back().vertices.data() == dadosOriginais[0], "atribuicao por movimento leva o bloco junto");
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+// Descarte por oclusão na CPU (OclusaoSoftware.h): um quadrado conhecido
+// rasterizado como oclusor esconde a caixa atrás dele, e não a que está ao
+// lado nem a que está na frente. Não usa OpenGL.
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+
+#include "OclusaoSoftware.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+int main() {
+    // câmera na origem olhando para -z, como a Camera na posição inicial
+    glm::mat4 projecao = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    glm::mat4 visao = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // quadrado de 4x4 em z = -5, centrado no eixo de visão
+    const glm::vec3 quadrado[4] = {{-2.0f, -2.0f, 0.0f}, {2.0f, -2.0f, 0.0f}, {2.0f, 2.0f, 0.0f}, {-2.0f, 2.0f, 0.0f}};
+    const uint32_t indices[6] = {0, 1, 2, 2, 3, 0};
+    glm::mat4 modelo = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+
+    OclusaoSoftware oclusao;
+    oclusao.iniciar(projecao * visao);
+    oclusao.adicionarOclusor(quadrado, sizeof(glm::vec3), 4, indices, 6, modelo);
+    oclusao.rasterizar();
+
+    verificar(oclusao.estatisticas.oclusores == 1 && oclusao.estatisticas.triangulos == 2,
+              "oclusor com dois triangulos");
+
+    const int centro = oclusao.alturaBuffer() / 2 * oclusao.larguraBuffer() + oclusao.larguraBuffer() / 2;
+    verificar(oclusao.buffer()[centro] < 1.0f, "centro da tela coberto pelo oclusor");
+    verificar(oclusao.buffer()[0] == 1.0f, "canto da tela livre");
+
+    // atrás do quadrado, dentro da sombra dele
+    glm::vec3 atrasMin(-0.5f, -0.5f, -10.0f), atrasMax(0.5f, 0.5f, -9.0f);
+    // à direita: a tela vai até |x| ~ 10 em z = -10, e o quadrado cobre |x| <= 4 ali
+    glm::vec3 ladoMin(6.0f, -0.5f, -10.0f), ladoMax(7.0f, 0.5f, -9.0f);
+    // entre a câmera e o quadrado
+    glm::vec3 frenteMin(-0.5f, -0.5f, -3.0f), frenteMax(0.5f, 0.5f, -2.0f);
+    // metade atrás, metade fora da sombra
+    glm::vec3 parcialMin(1.5f, -0.5f, -10.0f), parcialMax(5.0f, 0.5f, -9.0f);
+
+    verificar(!oclusao.visivel(atrasMin, atrasMax), "caixa atras do oclusor e descartada");
+    verificar(oclusao.visivel(ladoMin, ladoMax), "caixa ao lado do oclusor continua visivel");
+    verificar(oclusao.visivel(frenteMin, frenteMax), "caixa na frente do oclusor continua visivel");
+    verificar(oclusao.visivel(parcialMin, parcialMax), "caixa parcialmente coberta continua visivel");
+
+    // o lote dá o mesmo resultado e conta os descartes
+    glm::vec3 minimos[4] = {atrasMin, ladoMin, frenteMin, parcialMin};
+    glm::vec3 maximos[4] = {atrasMax, ladoMax, frenteMax, parcialMax};
+    uint8_t visiveis[4];
+    oclusao.testarLote(minimos, maximos, 4, visiveis);
+    verificar(!visiveis[0] && visiveis[1] && visiveis[2] && visiveis[3], "testarLote igual a visivel");
+    verificar(oclusao.estatisticas.testados == 4 && oclusao.estatisticas.rejeitados == 1, "estatisticas do lote");
+
+    // outro quadrado com a aresta esquerda em x = 120.3 pixels: o pixel 120 tem o
+    // centro coberto, mas a caixa que começa em x = 120.1 fica em parte fora dele
+    auto mundoX = [&](float pixel, float z) {
+        return (pixel / oclusao.larguraBuffer() * 2.0f - 1.0f) * -z * std::tan(glm::radians(30.0f)) * 16.0f / 9.0f;
+    };
+    const glm::vec3 borda[4] = {{mundoX(120.3f, -5.0f), -2.0f, -5.0f}, {mundoX(200.0f, -5.0f), -2.0f, -5.0f},
+                                {mundoX(200.0f, -5.0f), 2.0f, -5.0f}, {mundoX(120.3f, -5.0f), 2.0f, -5.0f}};
+    OclusaoSoftware oclusaoBorda;
+    oclusaoBorda.iniciar(projecao * visao);
+    oclusaoBorda.adicionarOclusor(borda, sizeof(glm::vec3), 4, indices, 6, glm::mat4(1.0f));
+    oclusaoBorda.rasterizar();
+    verificar(oclusaoBorda.visivel(glm::vec3(mundoX(120.1f, -10.0f), -0.5f, -10.0f), glm::vec3(mundoX(150.0f, -10.0f), 0.5f, -9.99f)),
+              "caixa que passa da aresta por uma fracao de pixel continua visivel");
+    verificar(!oclusaoBorda.visivel(glm::vec3(mundoX(122.0f, -10.0f), -0.5f, -10.0f), glm::vec3(mundoX(150.0f, -10.0f), 0.5f, -9.99f)),
+              "caixa inteira dentro da aresta e descartada");
+
+    // a caixa cruzando o plano perto não pode ser descartada
+    verificar(oclusao.visivel(glm::vec3(-1.0f, -1.0f, -20.0f), glm::vec3(1.0f, 1.0f, 1.0f)),
+              "caixa que cruza o plano perto continua visivel");
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,111 @@
+// Otimização de cache de vértices (OtimizacaoMesh.h): o ACMR (vértices
+// transformados por triângulo, num FIFO de TAMANHO_CACHE_PADRAO entradas) é
+// calculado antes e depois do Tipsify numa grade em ordem de linhas, na mesma
+// grade com os triângulos embaralhados e numa esfera, e tem de cair. Os
+// triângulos continuam os mesmos, na mesma orientação, e depois da
+// renumeração os vértices aparecem nos índices em ordem crescente. Os tempos
+// do Tipsify são só impressos. Não usa OpenGL.
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeradoresMesh.h"
+#include "OtimizacaoMesh.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// triângulos pelas posições dos vértices (a renumeração troca os índices),
+// girados para começar pelo menor e ordenados; a orientação fica
+static std::vector<std::array<float, 9>> triangulosPorPosicao(const std::vector<Vertice>& vertices,
+                                                               const std::vector<GLuint>& indices) {
+    std::vector<std::array<float, 9>> triangulos;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        std::array<std::array<float, 3>, 3> cantos;
+        for (int c = 0; c < 3; c++) {
+            const glm::vec3& p = vertices[indices[t + c]].posicao;
+            cantos[c] = {p.x, p.y, p.z};
+        }
+        int menor = (int)(std::min_element(cantos.begin(), cantos.end()) - cantos.begin());
+        std::array<float, 9> triangulo;
+        for (int c = 0; c < 3; c++)
+            for (int e = 0; e < 3; e++) triangulo[c * 3 + e] = cantos[(menor + c) % 3][e];
+        triangulos.push_back(triangulo);
+    }
+    std::sort(triangulos.begin(), triangulos.end());
+    return triangulos;
+}
+
+// cada vértice novo nos índices é o seguinte ao maior já visto
+static bool primeiroUsoCrescente(const std::vector<GLuint>& indices) {
+    GLuint proximo = 0;
+    for (GLuint v : indices) {
+        if (v > proximo) return false;
+        if (v == proximo) proximo++;
+    }
+    return true;
+}
+
+// Otimiza e confere uma mesh; maximoDepois é o ACMR que o Tipsify tem de atingir.
+static void conferir(const char* nome, std::vector<Vertice> vertices, std::vector<GLuint> indices,
+                     float maximoDepois) {
+    const AnaliseCache antes = analisarCache(indices, vertices.size());
+    const auto triangulosAntes = triangulosPorPosicao(vertices, indices);
+
+    auto inicio = std::chrono::steady_clock::now();
+    otimizarMesh(vertices, indices);
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    const AnaliseCache depois = analisarCache(indices, vertices.size());
+
+    std::printf("%-22s %8zu triangulos  ACMR %.3f -> %.3f  ATVR %.3f -> %.3f  %7.1f ms\n", nome, antes.triangulos,
+                antes.acmr, depois.acmr, antes.atvr, depois.atvr, segundos * 1000.0);
+    auto verificarMesh = [&](bool condicao, const char* descricao) {
+        verificar(condicao, (std::string(nome) + ": " + descricao).c_str());
+    };
+    verificarMesh(depois.acmr < antes.acmr && depois.acmr <= maximoDepois, "ACMR cai com o Tipsify");
+    verificarMesh(depois.atvr <= antes.atvr && depois.verticesUsados == antes.verticesUsados,
+                  "ATVR nao piora e os mesmos vertices sao usados");
+    verificarMesh(triangulosPorPosicao(vertices, indices) == triangulosAntes, "mesmos triangulos, mesma orientacao");
+    verificarMesh(primeiroUsoCrescente(indices), "vertices renumerados na ordem do primeiro uso");
+}
+
+int main() {
+    // grade em ordem de linhas: cada linha nova já expulsou a anterior do cache
+    const int divisoes = 300;
+    std::vector<Vertice> plano(contarVerticesPlano(divisoes, divisoes));
+    std::vector<GLuint> indicesPlano(contarIndicesPlano(divisoes, divisoes, Topologia::Triangulos));
+    gerarPlano(10.0f, 10.0f, divisoes, divisoes, Topologia::Triangulos, plano.data(), indicesPlano.data());
+    conferir("grade", plano, indicesPlano, 0.8f);
+
+    // a mesma grade com os triângulos fora de ordem, como sai de muitos exportadores
+    std::vector<size_t> ordem(indicesPlano.size() / 3);
+    for (size_t t = 0; t < ordem.size(); t++) ordem[t] = t;
+    std::shuffle(ordem.begin(), ordem.end(), std::mt19937(42));
+    std::vector<GLuint> embaralhados;
+    embaralhados.reserve(indicesPlano.size());
+    for (size_t t : ordem) embaralhados.insert(embaralhados.end(), &indicesPlano[t * 3], &indicesPlano[t * 3 + 3]);
+    conferir("grade embaralhada", plano, embaralhados, 0.8f);
+
+    const int setores = 128, pilhas = 64;
+    std::vector<Vertice> esfera(contarVerticesEsfera(setores, pilhas));
+    std::vector<GLuint> indicesEsfera(contarIndicesEsfera(setores, pilhas, Topologia::Triangulos));
+    gerarEsfera(1.0f, setores, pilhas, Topologia::Triangulos, esfera.data(), indicesEsfera.data());
+    conferir("esfera", esfera, indicesEsfera, 0.8f);
+
+    // com cache de uma entrada cada vértice é transformado em cada canto
+    verificar(analisarCache(indicesPlano, plano.size(), 1).acmr == 3.0f, "FIFO de 1 entrada: ACMR 3");
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,175 @@
+// Pool de threads (Paralelo.h): cada parte de executar() roda exatamente uma
+// vez, inclusive quando uma parte chama executar() de novo no mesmo pool e
+// quando várias threads chamam executar() ao mesmo tempo, com todos os
+// trabalhadores ocupados. Um vigia encerra o teste como falha se alguma dessas
+// chamadas travar. No fim, o custo por chamada do pool é comparado com o de
+// abrir uma std::thread por parte, como os geradores faziam antes; os tempos
+// são só impressos. Não usa OpenGL.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "Paralelo.h"
+
+// o pool próprio tem trabalhadores mesmo numa máquina de um núcleo
+const unsigned TRABALHADORES = 3;
+const auto TEMPO_LIMITE = std::chrono::seconds(30);
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+// roda o caso numa thread à parte; travado, não há como voltar, então sai
+template <typename Funcao>
+static bool semTravar(const char* nome, Funcao caso) {
+    std::packaged_task<bool()> tarefa(caso);
+    std::future<bool> resultado = tarefa.get_future();
+    std::thread(std::move(tarefa)).detach();
+    if (resultado.wait_for(TEMPO_LIMITE) != std::future_status::ready) {
+        std::printf("FALHOU: %s travou\n", nome);
+        std::fflush(stdout);
+        std::_Exit(EXIT_FAILURE);
+    }
+    return resultado.get();
+}
+
+// cada posição de vezes[] vista exatamente uma vez
+static bool todasUmaVez(const std::vector<std::atomic<int>>& vezes) {
+    for (const std::atomic<int>& v : vezes)
+        if (v.load() != 1) return false;
+    return true;
+}
+
+static double segundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+int main() {
+    paralelo::PoolThreads pool(TRABALHADORES);
+
+    verificar(semTravar("partes", [&] {
+        std::vector<std::atomic<int>> vezes(1000);
+        auto parte = [&](size_t p) { vezes[p]++; };
+        pool.executar(vezes.size(), parte);
+        return todasUmaVez(vezes);
+    }), "cada parte roda uma vez");
+
+    // a parte 0 roda em quem chamou e espera uma das outras aparecer em
+    // outra thread: sem trabalhadores de verdade ela esperaria até o limite
+    verificar(semTravar("trabalhadores", [&] {
+        std::mutex m;
+        std::set<std::thread::id> threads;
+        std::atomic<bool> outraThread{false};
+        const std::thread::id chamadora = std::this_thread::get_id();
+        auto parte = [&](size_t p) {
+            {
+                std::lock_guard<std::mutex> trava(m);
+                threads.insert(std::this_thread::get_id());
+            }
+            if (std::this_thread::get_id() != chamadora) outraThread = true;
+            if (p != 0) return;
+            auto inicio = std::chrono::steady_clock::now();
+            while (!outraThread && std::chrono::steady_clock::now() - inicio < std::chrono::seconds(5))
+                std::this_thread::yield();
+        };
+        pool.executar(8, parte);
+        return outraThread.load() && threads.size() >= 2;
+    }), "partes distribuidas entre quem chama e os trabalhadores");
+
+    // cada parte externa abre um lote interno no mesmo pool; com os
+    // trabalhadores presos nas externas, as internas só andam porque quem
+    // espera também tira partes da fila
+    verificar(semTravar("aninhadas", [&] {
+        const size_t externas = 16, internas = 64;
+        std::vector<std::atomic<int>> vezes(externas * internas);
+        auto externa = [&](size_t e) {
+            auto interna = [&](size_t i) { vezes[e * internas + i]++; };
+            pool.executar(internas, interna);
+        };
+        pool.executar(externas, externa);
+        return todasUmaVez(vezes);
+    }), "executar aninhado: todas as partes internas rodam uma vez, sem travar");
+
+    verificar(semTravar("tres niveis", [&] {
+        std::atomic<size_t> folhas{0};
+        auto n1 = [&](size_t) {
+            auto n2 = [&](size_t) {
+                auto n3 = [&](size_t) { folhas++; };
+                pool.executar(4, n3);
+            };
+            pool.executar(4, n2);
+        };
+        pool.executar(4, n1);
+        return folhas.load() == 64;
+    }), "executar aninhado em tres niveis");
+
+    // várias threads de fora chamando o mesmo pool ao mesmo tempo, cada
+    // chamada com seu próprio lote (e um aninhado a cada tantas)
+    verificar(semTravar("concorrentes", [&] {
+        const size_t chamadoras = 8, chamadas = 200, partes = 32;
+        std::vector<std::atomic<int>> vezes(chamadoras * chamadas * partes);
+        std::atomic<size_t> aninhadas{0};
+        std::vector<std::thread> threads;
+        for (size_t c = 0; c < chamadoras; c++)
+            threads.emplace_back([&, c] {
+                for (size_t k = 0; k < chamadas; k++) {
+                    const size_t base = (c * chamadas + k) * partes;
+                    auto parte = [&](size_t p) {
+                        vezes[base + p]++;
+                        if (p == 0 && k % 16 == 0) {
+                            auto interna = [&](size_t) { aninhadas++; };
+                            pool.executar(4, interna);
+                        }
+                    };
+                    pool.executar(partes, parte);
+                }
+            });
+        for (std::thread& t : threads) t.join();
+        return todasUmaVez(vezes) && aninhadas.load() == chamadoras * ((chamadas + 15) / 16) * 4;
+    }), "executar de 8 threads ao mesmo tempo: cada parte de cada lote roda uma vez");
+
+    verificar(semTravar("blocos", [&] {
+        std::vector<std::atomic<int>> vezes(100003);
+        paraleloEmBlocos(vezes.size(), 1000, [&](size_t inicio, size_t fim) {
+            for (size_t i = inicio; i < fim; i++) vezes[i]++;
+        });
+        return todasUmaVez(vezes);
+    }), "paraleloEmBlocos cobre [0, total) uma vez");
+
+    // custo por chamada com trabalho quase nulo: o que sobra é a distribuição
+    const int chamadas = 2000;
+    const size_t partes = TRABALHADORES + 1;
+    std::atomic<size_t> soma{0};
+    auto parte = [&](size_t p) { soma += p; };
+
+    auto inicio = std::chrono::steady_clock::now();
+    for (int c = 0; c < chamadas; c++) pool.executar(partes, parte);
+    double segundosPool = segundosDesde(inicio);
+
+    inicio = std::chrono::steady_clock::now();
+    for (int c = 0; c < chamadas; c++) {
+        std::vector<std::thread> threads;
+        for (size_t p = 1; p < partes; p++) threads.emplace_back(parte, p);
+        parte(0);
+        for (std::thread& t : threads) t.join();
+    }
+    double segundosThreads = segundosDesde(inicio);
+    verificar(soma.load() == 2 * (size_t)chamadas * (partes * (partes - 1) / 2), "as duas formas rodaram tudo");
+
+    std::printf("%d chamadas de %zu partes: pool %.1f us/chamada, thread por parte %.1f us/chamada (%.1fx)\n",
+                chamadas, partes, segundosPool * 1e6 / chamadas, segundosThreads * 1e6 / chamadas,
+                segundosThreads / segundosPool);
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
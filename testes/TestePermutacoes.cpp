@@ -0,0 +1,191 @@
+// Permutações de shader (PermutacoesShader.h) com o driver de verdade: as 64
+// chaves possíveis são pedidas aos três pares da cena (iluminação, luzes e o
+// vertex shader do descarte na GPU), sem o cache de programas. Cada chave
+// tem de cair numa variante que linka, chaves equivalentes na mesma variante
+// e o total criado tem de ser o que o par anuncia. Depois, a mesma cena
+// instanciada é desenhada com cada variante de iluminação, e com a de 4
+// luzes e o bloco de luzes zerado, que é o que a tecla L fazia antes das
+// variantes; os tempos de quadro são só impressos.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Mesh.h"
+#include "Instancias.h"
+#include "BlocosUniform.h"
+#include "PermutacoesShader.h"
+
+const int LARGURA = 640;
+const int ALTURA = 360;
+const int LADO_GRADE = 20;
+const int REPETICOES = 5;
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+static void verificar(bool condicao, const std::string& descricao) { verificar(condicao, descricao.c_str()); }
+
+static bool linkado(const Shader& shader) {
+    GLint status = 0;
+    glGetProgramiv(shader.idPrograma, GL_LINK_STATUS, &status);
+    return status != 0;
+}
+
+// Pede as 64 chaves a um par e confere as variantes criadas.
+static void conferirPar(PermutacoesShader& par) {
+    bool todas = true, equivalentes = true;
+    for (uint32_t chave = 0; chave < NUM_CHAVES_PERMUTACAO; chave++) {
+        const Shader& shader = par.shader(chave);
+        todas = todas && linkado(shader);
+        // a chave normalizada é a própria variante
+        equivalentes = equivalentes && &par.shader(par.normalizar(chave)) == &shader;
+    }
+    // luzes acima do máximo e luzes sem iluminação não criam variantes
+    equivalentes = equivalentes &&
+        &par.shader(chavePermutacao(RECURSO_ILUMINACAO, 0) | 7u << DESLOCAMENTO_LUZES) ==
+            &par.shader(chavePermutacao(RECURSO_ILUMINACAO, MAXIMO_LUZES_PONTUAIS)) &&
+        &par.shader(3u << DESLOCAMENTO_LUZES) == &par.shader(0);
+
+    const EstatisticasPermutacoes& e = par.estatisticas;
+    std::printf("%s: %zu variantes de %zu, %.1f ms\n", par.nome(), e.compiladas, e.possiveis, e.segundos * 1000.0);
+    verificar(todas, std::string(par.nome()) + ": as 64 chaves caem em variantes que linkam");
+    verificar(equivalentes, std::string(par.nome()) + ": chaves equivalentes na mesma variante");
+    verificar(e.compiladas == e.possiveis, std::string(par.nome()) + ": criadas todas as variantes anunciadas");
+}
+
+int main() {
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(LARGURA, ALTURA)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    const std::filesystem::path cacheTeste = std::filesystem::temp_directory_path() / "svg-teste-permutacoes";
+    std::filesystem::remove_all(cacheTeste);
+    cache::diretorioProgramas = cacheTeste.string();
+
+    auto iniciar = [](const Shader& shader, uint32_t) -> uint32_t {
+        blocos::vincular(shader);
+        return 0;
+    };
+    PermutacoesShader iluminacao("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+        RECURSO_ILUMINACAO | RECURSO_VERTICE_COMPACTO | RECURSO_INSTANCIADO, 0, iniciar);
+    PermutacoesShader luzes("shaders/vertexShader.glsl", "shaders/fragmentShader.glsl",
+        RECURSO_VERTICE_COMPACTO | RECURSO_INSTANCIADO, 0, iniciar);
+    conferirPar(iluminacao);
+    conferirPar(luzes);
+    if (ExtensoesGL::temComputacao()) {
+        PermutacoesShader descarteGPU("shaders/lightingVertDescarteGPU.glsl", "shaders/lightingFrag.glsl",
+            RECURSO_ILUMINACAO | RECURSO_VERTICE_COMPACTO, RECURSO_INSTANCIADO, iniciar);
+        conferirPar(descarteGPU);
+    } else {
+        std::printf("sem compute shaders: par do descarte na GPU nao conferido\n");
+    }
+
+    // cena: esferas instanciadas cobrindo a tela, quatro luzes pontuais
+    const glm::vec3 olho(0.0f, 0.0f, 10.0f);
+    glm::mat4 projecao = glm::perspective(glm::radians(60.0f), (float)LARGURA / ALTURA, 0.1f, 100.0f);
+    glm::mat4 visao = glm::lookAt(olho, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    BufferUniform<BlocoCamera> uboCamera;
+    BufferUniform<BlocoLuzes> uboLuzes;
+    BufferUniform<BlocoMateriais> uboMateriais;
+    uboCamera.iniciar(PONTO_BLOCO_CAMERA);
+    uboLuzes.iniciar(PONTO_BLOCO_LUZES);
+    uboMateriais.iniciar(PONTO_BLOCO_MATERIAIS);
+    uboCamera.enviar(BlocoCamera{projecao, visao, glm::vec4(olho, 1.0f), projecao * visao});
+    BlocoLuzes dadosLuzes = {};
+    dadosLuzes.luzDirecional.direcao = glm::vec3(-0.3f, -0.5f, -1.0f);
+    dadosLuzes.luzDirecional.ambiente = glm::vec3(0.1f);
+    dadosLuzes.luzDirecional.difusa = glm::vec3(0.6f);
+    dadosLuzes.luzDirecional.especular = glm::vec3(0.3f);
+    for (int i = 0; i < MAXIMO_LUZES_PONTUAIS; i++) {
+        LuzPontualStd140& luz = dadosLuzes.luzesPontuais[i];
+        luz.posicao = glm::vec3((i % 2) * 8.0f - 4.0f, (i / 2) * 4.0f - 2.0f, 2.0f);
+        luz.ambiente = glm::vec3(0.05f);
+        luz.difusa = luz.especular = glm::vec3(0.8f);
+        luz.constante = 1.0f;
+        luz.linear = 0.09f;
+        luz.quadratica = 0.032f;
+    }
+    dadosLuzes.numLuzesPontuais = MAXIMO_LUZES_PONTUAIS;
+    BlocoMateriais materiais = {};
+    for (int m = 0; m < 3; m++) {
+        materiais.materiais[m].ambiente = materiais.materiais[m].difusa = glm::vec3(m == 0, m == 1, m == 2);
+        materiais.materiais[m].especular = glm::vec3(0.5f);
+        materiais.materiais[m].brilho = 32.0f;
+    }
+    uboMateriais.enviar(materiais);
+    glEnable(GL_DEPTH_TEST);
+
+    Esfera esfera(0.45f, 16, 12);
+    std::vector<glm::mat4> modelos;
+    std::vector<GLuint> indicesMaterial;
+    for (int i = 0; i < LADO_GRADE * LADO_GRADE; i++) {
+        float x = (float)(i % LADO_GRADE) - (LADO_GRADE - 1) * 0.5f;
+        float y = (float)(i / LADO_GRADE) - (LADO_GRADE - 1) * 0.5f;
+        modelos.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x * 0.62f, y * 0.35f, 0.0f)));
+        indicesMaterial.push_back((GLuint)(i % 3));
+    }
+    BufferInstancias instancias;
+    instancias.escalaUniforme = true;
+    instancias.atualizar(modelos.data(), indicesMaterial.data(), modelos.size());
+
+    // menor tempo de quadro com glFinish; devolve se algo foi desenhado
+    auto medir = [&](uint32_t chave, double& segundos) {
+        const Shader& shader = iluminacao.shader(chave | RECURSO_INSTANCIADO);
+        shader.usar();
+        segundos = 1e9;
+        for (int r = 0; r < REPETICOES; r++) {
+            auto inicio = std::chrono::steady_clock::now();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            esfera.desenharInstanciado(instancias);
+            glFinish();
+            segundos = std::min(segundos,
+                                std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count());
+        }
+        std::vector<unsigned char> imagem((size_t)LARGURA * ALTURA * 4);
+        glReadPixels(0, 0, LARGURA, ALTURA, GL_RGBA, GL_UNSIGNED_BYTE, imagem.data());
+        size_t acesos = 0;
+        for (size_t p = 0; p < imagem.size(); p += 4) acesos += (imagem[p] | imagem[p + 1] | imagem[p + 2]) != 0;
+        return acesos;
+    };
+
+    std::printf("%-34s %10s\n", "variante", "quadro");
+    bool desenhou = true;
+    double segundos = 0.0, semIluminacao = 0.0, zerado = 0.0;
+    uboLuzes.enviar(dadosLuzes);
+    desenhou = desenhou && medir(chavePermutacao(0, 0), semIluminacao) > 0;
+    std::printf("%-34s %7.2f ms\n", descreverPermutacao(chavePermutacao(0, 0)).c_str(), semIluminacao * 1000.0);
+    for (int n = 0; n <= MAXIMO_LUZES_PONTUAIS; n++) {
+        const uint32_t chave = chavePermutacao(RECURSO_ILUMINACAO, n);
+        desenhou = desenhou && medir(chave, segundos) > 0;
+        std::printf("%-34s %7.2f ms\n", descreverPermutacao(chave).c_str(), segundos * 1000.0);
+    }
+    // a tecla L antes das variantes: toda a conta roda com as luzes zeradas
+    BlocoLuzes apagadas = {};
+    uboLuzes.enviar(apagadas);
+    medir(chavePermutacao(RECURSO_ILUMINACAO, MAXIMO_LUZES_PONTUAIS), zerado);
+    std::printf("%-34s %7.2f ms\n", "4 luzes, bloco zerado (antes)", zerado * 1000.0);
+    std::printf("desligar a iluminacao: %.2f ms por variante contra %.2f ms zerando o bloco (%.1fx)\n",
+                semIluminacao * 1000.0, zerado * 1000.0, zerado / semIluminacao);
+    verificar(desenhou, "todas as variantes de iluminacao desenham");
+    verificar(glGetError() == GL_NO_ERROR, "sem erro de OpenGL");
+
+    std::filesystem::remove_all(cacheTeste);
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
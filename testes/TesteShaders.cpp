@@ -0,0 +1,153 @@
+// Shaders de verdade num contexto sem janela: cada programa que a cena monta
+// (iluminação e luzes, por objeto e instanciados, o vertex shader do
+// descarte na GPU e os compute shaders do Hi-Z) tem de compilar e linkar,
+// sem o cache de programas. Em cada bloco de uniforms declarado,
+// blocos::conferir compara os deslocamentos do driver com os dos espelhos
+// std140 em C++ (BlocosUniform.h): cada membro da lista existe no programa,
+// o bloco não tem membros fora dela e blocos::vincular o liga ao ponto fixo.
+// Um espelho com um deslocamento errado tem de ser recusado.
+//
+// Sem EGL o teste é pulado.
+
+#include "ContextoHeadless.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Shader.h"
+#include "BlocosUniform.h"
+#include "PermutacoesShader.h"
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+static void verificar(bool condicao, const std::string& descricao) { verificar(condicao, descricao.c_str()); }
+
+static bool linkado(const Shader& shader) {
+    GLint status = 0;
+    glGetProgramiv(shader.idPrograma, GL_LINK_STATUS, &status);
+    return status != 0;
+}
+
+struct Bloco {
+    const char* nome;
+    GLuint ponto;
+    size_t tamanho;
+    std::vector<blocos::Membro> membros;
+};
+
+// Confere um programa de desenho; devolve quantos blocos ele declara.
+static int conferirPrograma(const std::string& nome, const Shader& shader, const std::vector<Bloco>& todos) {
+    verificar(linkado(shader), nome + ": compila e linka");
+    verificar(blocos::vincular(shader), nome + ": vincular confere os tres blocos");
+
+    int declarados = 0;
+    for (const Bloco& bloco : todos) {
+        GLuint indice = glGetUniformBlockIndex(shader.idPrograma, bloco.nome);
+        if (indice == GL_INVALID_INDEX) continue;
+        declarados++;
+        const std::string prefixo = nome + ": " + bloco.nome;
+
+        verificar(blocos::conferir(shader, bloco.nome, bloco.tamanho, bloco.membros),
+                  prefixo + " com os deslocamentos do espelho std140");
+
+        // conferir pula nomes que o programa não tem; aqui todos têm de existir
+        bool todosExistem = true;
+        for (const blocos::Membro& membro : bloco.membros) {
+            const GLchar* n = membro.nome.c_str();
+            GLuint indiceMembro = GL_INVALID_INDEX;
+            glGetUniformIndices(shader.idPrograma, 1, &n, &indiceMembro);
+            if (indiceMembro == GL_INVALID_INDEX) {
+                std::printf("  %s sem o membro %s\n", bloco.nome, n);
+                todosExistem = false;
+            }
+        }
+        verificar(todosExistem, prefixo + ": todos os membros do espelho existem no GLSL");
+
+        GLint ativos = 0, ponto = -1, tamanho = 0;
+        glGetActiveUniformBlockiv(shader.idPrograma, indice, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &ativos);
+        glGetActiveUniformBlockiv(shader.idPrograma, indice, GL_UNIFORM_BLOCK_BINDING, &ponto);
+        glGetActiveUniformBlockiv(shader.idPrograma, indice, GL_UNIFORM_BLOCK_DATA_SIZE, &tamanho);
+        std::printf("  %s: %d membros, %d bytes no GLSL, %zu no C++\n", bloco.nome, ativos, tamanho, bloco.tamanho);
+        verificar((size_t)ativos == bloco.membros.size(), prefixo + ": nenhum membro do GLSL fora do espelho");
+        verificar((GLuint)ponto == bloco.ponto, prefixo + " ligado ao ponto fixo");
+    }
+    return declarados;
+}
+
+int main() {
+    ContextoHeadless contexto;
+    if (!contexto.iniciar(64, 64)) {
+        std::printf("PULADO: sem contexto OpenGL\n");
+        return TESTE_PULADO;
+    }
+    // diretório vazio: tudo compila de novo, nada vem de um binário antigo
+    const std::filesystem::path cacheTeste = std::filesystem::temp_directory_path() / "svg-teste-shaders";
+    std::filesystem::remove_all(cacheTeste);
+    cache::diretorioProgramas = cacheTeste.string();
+
+    const std::vector<Bloco> todos = {
+        {"BlocoCamera", PONTO_BLOCO_CAMERA, sizeof(BlocoCamera), blocos::membrosCamera()},
+        {"BlocoLuzes", PONTO_BLOCO_LUZES, sizeof(BlocoLuzes), blocos::membrosLuzes()},
+        {"BlocoMateriais", PONTO_BLOCO_MATERIAIS, sizeof(BlocoMateriais), blocos::membrosMateriais()},
+    };
+
+    // as variantes que a cena prepara na partida, nos dois pares
+    struct Par {
+        const char* vertex;
+        const char* fragment;
+        uint32_t recursos;
+        int blocosMinimos;   // a iluminação ligada precisa dos três
+    };
+    const Par pares[] = {
+        {"shaders/lightingVert.glsl", "shaders/lightingFrag.glsl", RECURSO_ILUMINACAO, 3},
+        {"shaders/lightingVert.glsl", "shaders/lightingFrag.glsl", RECURSO_ILUMINACAO | RECURSO_INSTANCIADO, 3},
+        {"shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+         RECURSO_ILUMINACAO | RECURSO_INSTANCIADO | RECURSO_VERTICE_COMPACTO, 3},
+        {"shaders/lightingVert.glsl", "shaders/lightingFrag.glsl", 0, 1},
+        {"shaders/vertexShader.glsl", "shaders/fragmentShader.glsl", 0, 1},
+        {"shaders/vertexShader.glsl", "shaders/fragmentShader.glsl", RECURSO_INSTANCIADO | RECURSO_VERTICE_COMPACTO, 1},
+    };
+    for (const Par& par : pares) {
+        const uint32_t chave = chavePermutacao(par.recursos, MAXIMO_LUZES_PONTUAIS);
+        Shader shader(par.vertex, par.fragment, definicoesPermutacao(chave));
+        const std::string nome = std::string(par.vertex) + " (" + descreverPermutacao(chave) + ")";
+        verificar(conferirPrograma(nome, shader, todos) >= par.blocosMinimos, nome + ": declara os blocos que usa");
+    }
+
+    if (ExtensoesGL::temComputacao()) {
+        const uint32_t chave = chavePermutacao(RECURSO_ILUMINACAO | RECURSO_INSTANCIADO, MAXIMO_LUZES_PONTUAIS);
+        Shader descarte("shaders/lightingVertDescarteGPU.glsl", "shaders/lightingFrag.glsl",
+                        definicoesPermutacao(chave));
+        verificar(conferirPrograma("shaders/lightingVertDescarteGPU.glsl", descarte, todos) == 3,
+                  "descarte na GPU: declara os tres blocos");
+        for (const char* caminho : {"shaders/reducaoHiZCompute.glsl", "shaders/descarteHiZCompute.glsl"})
+            verificar(linkado(Shader(caminho)), std::string(caminho) + ": compila e linka");
+    } else {
+        std::printf("sem compute shaders: descarte na GPU nao conferido\n");
+    }
+    verificar(Shader::estatisticasCache.carregados == 0, "nenhum programa veio do cache");
+
+    // o mesmo programa contra espelhos errados
+    Shader iluminacao("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl",
+                      definicoesPermutacao(chavePermutacao(RECURSO_ILUMINACAO, MAXIMO_LUZES_PONTUAIS)));
+    std::vector<blocos::Membro> deslocado = blocos::membrosLuzes();
+    deslocado.back().deslocamento += 4;
+    std::printf("(os dois ERRO::UBO a seguir sao esperados)\n");
+    verificar(!blocos::conferir(iluminacao, "BlocoLuzes", sizeof(BlocoLuzes), deslocado),
+              "membro deslocado 4 bytes e recusado");
+    verificar(!blocos::conferir(iluminacao, "BlocoCamera", sizeof(BlocoCamera) - 16, blocos::membrosCamera()),
+              "espelho menor que o bloco e recusado");
+    verificar(glGetError() == GL_NO_ERROR, "sem erro de OpenGL");
+
+    std::filesystem::remove_all(cacheTeste);
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,203 @@
+// Matrizes normais em lote (Transformacoes.h): o caminho SSE2, quatro
+// objetos por vez, tem de dar o mesmo que o escalar de um objeto e o mesmo
+// que transpose(inverse(mat3(modelo))) do glm, em matrizes aleatórias, em
+// matrizes quase singulares (uma coluna quase no plano das outras duas) e,
+// no caminho da escala uniforme, em rotações com escala. A tolerância contra
+// o glm cresce com o número de condição da matriz, e a saída também tem de
+// inverter a entrada: transpose(N) * mat3(modelo) = I. Os tempos do lote e
+// do glm, objeto por objeto, são só impressos. Não usa OpenGL.
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Transformacoes.h"
+
+const size_t QUANTIDADE = 4099;        // não múltiplo de 4: sobra resto escalar
+const size_t QUANTIDADE_TEMPO = 1000000;
+const float FATOR_TOLERANCIA = 32.0f;  // em FLT_EPSILON * condição
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+static float normaFrobenius(const glm::mat3& m) {
+    float soma = 0.0f;
+    for (int c = 0; c < 3; c++) soma += glm::dot(m[c], m[c]);
+    return std::sqrt(soma);
+}
+
+static float maiorDiferenca(const glm::vec4* n, const glm::mat3& referencia) {
+    float maior = 0.0f;
+    for (int c = 0; c < 3; c++)
+        for (int l = 0; l < 3; l++) maior = std::max(maior, std::fabs(n[c][l] - referencia[c][l]));
+    return maior;
+}
+
+struct Conferencia {
+    bool igualEscalar = true, igualGlm = true, inverte = true, finita = true;
+    float piorErroRelativo = 0.0f, maiorCondicao = 0.0f;
+};
+
+// Calcula em lote e confere cada saída contra o escalar, o glm e a identidade.
+static Conferencia conferir(const std::vector<glm::mat4>& modelos, bool escalaUniforme) {
+    std::vector<glm::vec4> normais(modelos.size() * 3);
+    transformacoes::calcularNormais(modelos.data(), modelos.size(), normais.data(), escalaUniforme);
+
+    Conferencia r;
+    for (size_t i = 0; i < modelos.size(); i++) {
+        const glm::vec4* n = &normais[i * 3];
+        const glm::mat3 m(modelos[i]);
+        const glm::mat3 referencia = glm::transpose(glm::inverse(m));
+        const float escala = normaFrobenius(referencia);
+        const float condicao = normaFrobenius(m) * escala;
+        const float tolerancia = FATOR_TOLERANCIA * FLT_EPSILON * condicao;
+        r.maiorCondicao = std::max(r.maiorCondicao, condicao);
+
+        glm::vec4 escalar[3];
+        transformacoes::detalhe::calcularUma(modelos[i], escalar, escalaUniforme);
+        r.igualEscalar = r.igualEscalar && maiorDiferenca(n, glm::mat3(glm::vec3(escalar[0]), glm::vec3(escalar[1]),
+                                                                       glm::vec3(escalar[2]))) <= 4.0f * FLT_EPSILON * escala;
+
+        const float erro = maiorDiferenca(n, referencia) / escala;
+        r.piorErroRelativo = std::max(r.piorErroRelativo, erro);
+        r.igualGlm = r.igualGlm && erro <= tolerancia;
+
+        for (int c = 0; c < 3; c++) {
+            r.finita = r.finita && std::isfinite(n[c].x) && std::isfinite(n[c].y) && std::isfinite(n[c].z);
+            r.finita = r.finita && n[c].w == 0.0f;
+            for (int l = 0; l < 3; l++) {
+                float produto = glm::dot(glm::vec3(n[c]), m[l]);
+                r.inverte = r.inverte && std::fabs(produto - (c == l ? 1.0f : 0.0f)) <= tolerancia;
+            }
+        }
+    }
+    return r;
+}
+
+static void relatar(const char* nome, const Conferencia& r) {
+    std::printf("%-22s condicao ate %9.1f  pior erro relativo %.2e\n", nome, r.maiorCondicao, r.piorErroRelativo);
+    char descricao[128];
+    std::snprintf(descricao, sizeof(descricao), "%s: lote igual ao escalar", nome);
+    verificar(r.igualEscalar, descricao);
+    std::snprintf(descricao, sizeof(descricao), "%s: igual a transpose(inverse(mat3)) do glm", nome);
+    verificar(r.igualGlm, descricao);
+    std::snprintf(descricao, sizeof(descricao), "%s: transpose(N) * mat3(modelo) = I", nome);
+    verificar(r.inverte, descricao);
+    std::snprintf(descricao, sizeof(descricao), "%s: saida finita, w = 0", nome);
+    verificar(r.finita, descricao);
+}
+
+static double segundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+int main() {
+#if defined(TRANSFORMACOES_SSE2)
+    std::printf("caminho SSE2 ligado\n");
+#else
+    std::printf("sem SSE2: so o caminho escalar\n");
+#endif
+    std::mt19937 gerador(7);
+    std::uniform_real_distribution<float> entrada(-2.0f, 2.0f), angulo(0.0f, 6.2831853f), escala(0.05f, 20.0f);
+    auto vetorAleatorio = [&] { return glm::vec3(entrada(gerador), entrada(gerador), entrada(gerador)); };
+    auto comTranslacao = [&](glm::mat3 m) {
+        glm::mat4 modelo(1.0f);
+        for (int c = 0; c < 3; c++) modelo[c] = glm::vec4(m[c], 0.0f);
+        modelo[3] = glm::vec4(vetorAleatorio() * 50.0f, 1.0f);
+        return modelo;
+    };
+
+    // entradas quaisquer, descartando as que já são quase singulares
+    std::vector<glm::mat4> aleatorias;
+    while (aleatorias.size() < QUANTIDADE) {
+        glm::mat3 m(vetorAleatorio(), vetorAleatorio(), vetorAleatorio());
+        if (normaFrobenius(m) * normaFrobenius(glm::inverse(m)) < 100.0f) aleatorias.push_back(comTranslacao(m));
+    }
+    relatar("aleatorias", conferir(aleatorias, false));
+
+    // terceira coluna a uma distância delta do plano das duas primeiras
+    for (float delta : {1e-2f, 1e-3f, 1e-4f}) {
+        std::vector<glm::mat4> quaseSingulares;
+        while (quaseSingulares.size() < QUANTIDADE) {
+            glm::vec3 a = vetorAleatorio(), b = vetorAleatorio();
+            glm::vec3 normal = glm::cross(a, b);
+            if (glm::length(normal) < 0.5f) continue;
+            glm::vec3 c = a * entrada(gerador) + b * entrada(gerador) + glm::normalize(normal) * delta;
+            quaseSingulares.push_back(comTranslacao(glm::mat3(a, b, c)));
+        }
+        char nome[32];
+        std::snprintf(nome, sizeof(nome), "quase singulares %.0e", delta);
+        relatar(nome, conferir(quaseSingulares, false));
+    }
+
+    // rotação com escala uniforme: o caminho sem produto vetorial
+    std::vector<glm::mat4> uniformes;
+    for (size_t i = 0; i < QUANTIDADE; i++) {
+        glm::mat4 r = glm::rotate(glm::mat4(1.0f), angulo(gerador), vetorAleatorio() + glm::vec3(0.0f, 0.0f, 4.1f));
+        uniformes.push_back(glm::translate(glm::mat4(1.0f), vetorAleatorio()) * glm::scale(r, glm::vec3(escala(gerador))));
+    }
+    relatar("escala uniforme", conferir(uniformes, true));
+    relatar("escala uniforme geral", conferir(uniformes, false));
+
+    // passo de struct: matriz seguida de outros campos, saída com folga
+    struct Objeto {
+        glm::mat4 modelo;
+        glm::vec4 cor;
+    };
+    std::vector<Objeto> objetos(QUANTIDADE);
+    for (size_t i = 0; i < QUANTIDADE; i++) objetos[i] = {aleatorias[i], glm::vec4(1e30f)};
+    std::vector<glm::vec4> saidaComFolga(QUANTIDADE * 4, glm::vec4(-1.0f));
+    std::vector<glm::vec4> saidaContigua(QUANTIDADE * 3);
+    transformacoes::calcularNormais(&objetos[0].modelo, sizeof(Objeto), saidaComFolga.data(), 4 * sizeof(glm::vec4),
+                                    QUANTIDADE, false);
+    transformacoes::calcularNormais(aleatorias.data(), QUANTIDADE, saidaContigua.data(), false);
+    bool passos = true;
+    for (size_t i = 0; i < QUANTIDADE; i++) {
+        for (int c = 0; c < 3; c++) passos = passos && saidaComFolga[i * 4 + c] == saidaContigua[i * 3 + c];
+        passos = passos && saidaComFolga[i * 4 + 3] == glm::vec4(-1.0f);
+    }
+    verificar(passos, "passos de struct: mesma saida e a folga intacta");
+
+    // tempo: lote (SSE2 e threads) contra o glm, um objeto por vez
+    std::vector<glm::mat4> muitas(QUANTIDADE_TEMPO);
+    for (size_t i = 0; i < QUANTIDADE_TEMPO; i++) muitas[i] = i < QUANTIDADE ? aleatorias[i] : muitas[i - QUANTIDADE];
+    std::vector<glm::vec4> normais(QUANTIDADE_TEMPO * 3);
+    double lote = 1e9, loteUniforme = 1e9, glmUmPorVez = 1e9;
+    float soma = 0.0f;
+    for (int r = 0; r < 3; r++) {
+        auto inicio = std::chrono::steady_clock::now();
+        transformacoes::calcularNormais(muitas.data(), QUANTIDADE_TEMPO, normais.data(), false);
+        lote = std::min(lote, segundosDesde(inicio));
+        soma += normais[r].x;
+
+        inicio = std::chrono::steady_clock::now();
+        transformacoes::calcularNormais(muitas.data(), QUANTIDADE_TEMPO, normais.data(), true);
+        loteUniforme = std::min(loteUniforme, segundosDesde(inicio));
+        soma += normais[r].x;
+
+        inicio = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < QUANTIDADE_TEMPO; i++) {
+            glm::mat3 n = glm::transpose(glm::inverse(glm::mat3(muitas[i])));
+            for (int c = 0; c < 3; c++) normais[i * 3 + c] = glm::vec4(n[c], 0.0f);
+        }
+        glmUmPorVez = std::min(glmUmPorVez, segundosDesde(inicio));
+        soma += normais[r].x;
+    }
+    std::printf("%zu matrizes: lote %.2f ms, lote escala uniforme %.2f ms, glm um por vez %.2f ms (%.1fx) [%g]\n",
+                QUANTIDADE_TEMPO, lote * 1000.0, loteUniforme * 1000.0, glmUmPorVez * 1000.0, glmUmPorVez / lote,
+                soma);
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
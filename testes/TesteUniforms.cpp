@@ -0,0 +1,175 @@
+// Uniforms resolvidos uma vez (Shader.h): depois da reflexão, definir valores
+// no laço de desenho não aloca memória nem consulta glGetUniformLocation.
+//
+// Roda sem janela nem contexto: as funções do OpenGL que o Shader usa são
+// trocadas por versões falsas que descrevem um programa com uniforms
+// conhecidos e guardam os valores recebidos.
+
+#include <glad/glad.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+// operator new contando alocações enquanto contarAlocacoes estiver ligado
+static size_t alocacoes = 0;
+static bool contarAlocacoes = false;
+
+void* operator new(size_t tamanho) {
+    if (contarAlocacoes) alocacoes++;
+    void* p = std::malloc(tamanho ? tamanho : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+// fora de linha: inlinado, o GCC vê o free() de um ponteiro vindo de
+// operator new e avisa (-Wmismatched-new-delete), sem saber que os dois são
+// os desta substituição
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+#include "Light.h"
+
+namespace falso {
+
+struct UniformAtivo {
+    std::string nome;
+    GLenum tipo;
+    GLint tamanho;
+};
+
+std::vector<UniformAtivo> ativos;
+std::map<std::string, GLint> locais;
+float valores[64][16];
+int consultasLocal = 0;
+
+void adicionar(const std::string& nome, GLenum tipo, GLint tamanho = 1) {
+    GLint local = 0;
+    for (const UniformAtivo& u : ativos) local += u.tamanho;
+    ativos.push_back({nome, tipo, tamanho});
+    locais[nome] = local;
+}
+
+GLuint APIENTRY criarShader(GLenum) { return 1; }
+void APIENTRY fonteShader(GLuint, GLsizei, const GLchar* const*, const GLint*) {}
+void APIENTRY semEfeito(GLuint) {}
+void APIENTRY anexar(GLuint, GLuint) {}
+void APIENTRY parametroShader(GLuint, GLenum, GLint* v) { *v = GL_TRUE; }
+GLuint APIENTRY criarPrograma() { return 7; }
+
+void APIENTRY parametroPrograma(GLuint, GLenum nome, GLint* v) {
+    if (nome == GL_ACTIVE_UNIFORMS) *v = (GLint)ativos.size();
+    else if (nome == GL_ACTIVE_UNIFORM_MAX_LENGTH) *v = 64;
+    else *v = GL_TRUE;
+}
+
+void APIENTRY uniformAtivo(GLuint, GLuint i, GLsizei, GLsizei* comprimento, GLint* tamanho, GLenum* tipo, GLchar* nome) {
+    std::strcpy(nome, ativos[i].nome.c_str());
+    *comprimento = (GLsizei)ativos[i].nome.size();
+    *tamanho = ativos[i].tamanho;
+    *tipo = ativos[i].tipo;
+}
+
+GLint APIENTRY localUniform(GLuint, const GLchar* nome) {
+    consultasLocal++;
+    auto it = locais.find(nome);
+    return it == locais.end() ? -1 : it->second;
+}
+
+void APIENTRY uniform1i(GLint local, GLint v) { if (local >= 0) valores[local][0] = (float)v; }
+void APIENTRY uniform1f(GLint local, GLfloat v) { if (local >= 0) valores[local][0] = v; }
+void APIENTRY uniform3fv(GLint local, GLsizei, const GLfloat* v) { if (local >= 0) std::memcpy(valores[local], v, 12); }
+void APIENTRY uniform4fv(GLint local, GLsizei, const GLfloat* v) { if (local >= 0) std::memcpy(valores[local], v, 16); }
+void APIENTRY uniformMatriz4fv(GLint local, GLsizei, GLboolean, const GLfloat* v) {
+    if (local >= 0) std::memcpy(valores[local], v, 64);
+}
+
+void instalar() {
+    glad_glCreateShader = criarShader;
+    glad_glShaderSource = fonteShader;
+    glad_glCompileShader = semEfeito;
+    glad_glGetShaderiv = parametroShader;
+    glad_glDeleteShader = semEfeito;
+    glad_glCreateProgram = criarPrograma;
+    glad_glAttachShader = anexar;
+    glad_glLinkProgram = semEfeito;
+    glad_glGetProgramiv = parametroPrograma;
+    glad_glGetActiveUniform = uniformAtivo;
+    glad_glGetUniformLocation = localUniform;
+    glad_glUniform1i = uniform1i;
+    glad_glUniform1f = uniform1f;
+    glad_glUniform3fv = uniform3fv;
+    glad_glUniform4fv = uniform4fv;
+    glad_glUniformMatrix4fv = uniformMatriz4fv;
+}
+
+}
+
+static int falhas = 0;
+
+static void verificar(bool condicao, const char* descricao) {
+    std::printf("%s: %s\n", condicao ? "OK" : "FALHOU", descricao);
+    if (!condicao) falhas++;
+}
+
+int main() {
+    falso::adicionar("modelo", GL_FLOAT_MAT4);
+    falso::adicionar("material.ambiente", GL_FLOAT_VEC3);
+    falso::adicionar("material.difusa", GL_FLOAT_VEC3);
+    falso::adicionar("material.especular", GL_FLOAT_VEC3);
+    falso::adicionar("material.brilho", GL_FLOAT);
+    falso::adicionar("numLuzesPontuais", GL_INT);
+    falso::adicionar("cores[0]", GL_FLOAT_VEC4, 4);
+    falso::adicionar("sombra", GL_SAMPLER_2D_SHADOW);
+    falso::adicionar("objetos", GL_SAMPLER_BUFFER);
+    falso::adicionar("destino", GL_IMAGE_1D + 1);   // image2D
+    falso::adicionar("usarHiZ", GL_BOOL);
+    falso::adicionar("faixa", GL_UNSIGNED_INT_VEC2);
+    falso::adicionar("escala", GL_DOUBLE);
+    falso::adicionar("inclinacao", GL_FLOAT_MAT3x4);
+    falso::instalar();
+
+    // as fontes são lidas e preprocessadas de verdade; só compilação e link são falsos
+    Shader shader("shaders/lightingVert.glsl", "shaders/lightingFrag.glsl");
+
+    Uniform<glm::mat4> modelo = shader.uniform<glm::mat4>("modelo");
+    Uniform<int> numLuzes = shader.uniform<int>("numLuzesPontuais");
+    Uniform<glm::vec4> cor2 = shader.uniform<glm::vec4>("cores[2]");
+    UniformsMaterial material(shader, "material");
+
+    verificar(cor2.local == falso::locais["cores[0]"] + 2, "elemento de array com local seguido ao primeiro");
+    verificar(shader.uniform<float>("modelo").local == -1, "tipo diferente do GLSL e recusado");
+    verificar(shader.localizacao("naoExiste") == -1, "uniform inexistente tem local -1");
+    // int vale para int, bool, samplers e imagens; o resto, mesmo inteiro, é recusado
+    verificar(numLuzes.local >= 0 && shader.uniform<int>("sombra").local >= 0 &&
+              shader.uniform<int>("objetos").local >= 0 && shader.uniform<int>("destino").local >= 0 &&
+              shader.uniform<int>("usarHiZ").local >= 0, "int aceito em int, bool, sampler e imagem");
+    std::printf("(os tres ERRO::SHADER::UNIFORM_TIPO a seguir sao esperados)\n");
+    verificar(shader.uniform<int>("faixa").local == -1 && shader.uniform<int>("escala").local == -1 &&
+              shader.uniform<int>("inclinacao").local == -1, "int recusado em uvec2, double e mat3x4");
+
+    Material dados(glm::vec3(0.1f), glm::vec3(0.2f, 0.4f, 0.6f), glm::vec3(0.5f), 16.0f);
+    const int consultasAntes = falso::consultasLocal;
+
+    contarAlocacoes = true;
+    for (int quadro = 0; quadro < 100; quadro++) {
+        modelo.definir(glm::mat4((float)quadro));
+        numLuzes.definir(quadro % 5);
+        cor2.definir(glm::vec4(1.0f, 2.0f, 3.0f, (float)quadro));
+        material.definir(dados);
+        shader.definirFloat("material.brilho", 32.0f);   // por nome: busca na tabela
+    }
+    contarAlocacoes = false;
+
+    verificar(alocacoes == 0, "100 quadros sem alocacao");
+    verificar(falso::consultasLocal == consultasAntes, "100 quadros sem glGetUniformLocation");
+    verificar(falso::valores[falso::locais["modelo"]][0] == 99.0f, "matriz chega ao local do uniform");
+    verificar(falso::valores[falso::locais["cores[0]"] + 2][3] == 99.0f, "elemento de array chega ao local certo");
+    verificar(falso::valores[falso::locais["material.difusa"]][2] == 0.6f, "membro de struct chega ao local certo");
+    verificar(falso::valores[falso::locais["material.brilho"]][0] == 32.0f, "definir por nome usa a tabela");
+
+    std::printf("%d falha(s)\n", falhas);
+    return falhas == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -25,6 +25,33 @@ check_file "src/main.cpp"
 check_file "src/Shader.h"
 check_file "src/Camera.h"
 check_file "src/Mesh.h"
+check_file "src/Instancias.h"
+check_file "src/DesenhoIndireto.h"
+check_file "src/FilaRenderizacao.h"
+check_file "src/AnelObjetos.h"
+check_file "src/Frustum.h"
+check_file "src/BVH.h"
+check_file "src/OclusaoSoftware.h"
+check_file "src/DescarteGPU.h"
+check_file "src/ExtensoesGL.h"
+check_file "src/FormatoVertice.h"
+check_file "src/OtimizacaoMesh.h"
+check_file "src/EstadoGL.h"
+check_file "src/RecursosGL.h"
+check_file "src/ArenaGeometria.h"
+check_file "src/GeradoresMesh.h"
+check_file "src/Paralelo.h"
+check_file "src/LOD.h"
+check_file "src/Simplificacao.h"
+check_file "src/CarregadorOBJ.h"
+check_file "src/CacheMesh.h"
+check_file "src/CacheProgramas.h"
+check_file "src/Hash.h"
+check_file "src/CarregadorGLB.h"
+check_file "src/ArquivoMapeado.h"
+check_file "src/BlocosUniform.h"
+check_file "src/Transformacoes.h"
+check_file "src/PermutacoesShader.h"
 check_file "src/Light.h"
 
 echo ""
@@ -32,13 +59,43 @@ echo "Shaders"
 check_file "shaders/vertexShader.glsl"
 check_file "shaders/fragmentShader.glsl"
 check_file "shaders/lightingVert.glsl"
+check_file "shaders/lightingVertDescarteGPU.glsl"
+check_file "shaders/reducaoHiZCompute.glsl"
+check_file "shaders/descarteHiZCompute.glsl"
 check_file "shaders/lightingFrag.glsl"
+check_file "shaders/comum/vertice.glsl"
+check_file "shaders/comum/blocoCamera.glsl"
 
 echo ""
 echo "Build"
 check_file "CMakeLists.txt"
 check_file "Makefile"
 
+echo ""
+echo "Testes"
+check_file "testes/TesteUniforms.cpp"
+check_file "testes/TesteOclusao.cpp"
+check_file "testes/TesteBVH.cpp"
+check_file "testes/TesteMeshes.cpp"
+check_file "testes/TesteFrustum.cpp"
+check_file "testes/TesteCarregadorOBJ.cpp"
+check_file "testes/TesteCacheMesh.cpp"
+check_file "testes/TesteCarregadorGLB.cpp"
+check_file "testes/TesteOtimizacaoMesh.cpp"
+check_file "testes/TesteParalelo.cpp"
+check_file "testes/TesteTransformacoes.cpp"
+check_file "testes/ContextoHeadless.h"
+check_file "testes/TesteDescarteGPU.cpp"
+check_file "testes/TesteFormatosVertice.cpp"
+check_file "testes/TesteFaixasTriangulos.cpp"
+check_file "testes/TesteDesenhoIndireto.cpp"
+check_file "testes/TesteInstanciado.cpp"
+check_file "testes/TesteShaders.cpp"
+check_file "testes/TesteAnelObjetos.cpp"
+check_file "testes/TesteCacheProgramas.cpp"
+check_file "testes/TestePermutacoes.cpp"
+check_file "testes/TesteArenaGeometria.cpp"
+
 echo ""
 echo "GLAD (gerar em https://glad.dav1d.de/ — OpenGL 3.3 Core)"
 if [ -f "glad/src/glad.c" ]; then